@@ -69,7 +69,7 @@ namespace CATHODE
   public:
     static D3D* Singleton()
     {
-      return *(D3D**)(util::offsets::GetOffset("OFFSET_D3D"));
+      return *(D3D**)(util::offsets::GetOffset(OFFSET_D3D));
     }
   };
 
@@ -84,7 +84,7 @@ namespace CATHODE
   public:
     static Main* Singleton()
     {
-      return *(Main**)(util::offsets::GetOffset("OFFSET_MAIN"));
+      return *(Main**)(util::offsets::GetOffset(OFFSET_MAIN));
     }
   };
 
@@ -313,7 +313,7 @@ namespace CATHODE
   public:
     static PostProcessSystem* Singleton()
     {
-      return (PostProcessSystem*)(util::offsets::GetOffset("OFFSET_POSTPROCESS"));
+      return (PostProcessSystem*)(util::offsets::GetOffset(OFFSET_POSTPROCESS));
     }
   };
 
@@ -337,14 +337,14 @@ namespace CATHODE
   public:
     static Scaleform* Singleton()
     {
-      return *(Scaleform**)(util::offsets::GetOffset("OFFSET_SCALEFORM"));
+      return *(Scaleform**)(util::offsets::GetOffset(OFFSET_SCALEFORM));
     }
   };
 
   static XMFLOAT4X4* GetCameraMatrix()
   {
     typedef XMFLOAT4X4*(__thiscall* tGetMatrix)(int _this);
-    tGetMatrix GetMatrix = (tGetMatrix)(util::offsets::GetOffset("OFFSET_GETCAMERAMATRIX"));
+    tGetMatrix GetMatrix = (tGetMatrix)(util::offsets::GetOffset(OFFSET_GETCAMERAMATRIX));
 
     int unkPointer = *(int*)((int)GetModuleHandleA("AI.exe") + 0x1366A00);
     return GetMatrix(unkPointer);
@@ -352,7 +352,7 @@ namespace CATHODE
 
   static void ShowMouse(bool val)
   {
-    int ptr1 = *(int*)(util::offsets::GetOffset("OFFSET_SHOWMOUSE"));
+    int ptr1 = *(int*)(util::offsets::GetOffset(OFFSET_SHOWMOUSE));
     int ptr2 = *(int*)(ptr1 + 0x4A70);
 
     bool* pShowMouse = (bool*)(ptr2 + 0x10);
@@ -0,0 +1,149 @@
+#include "CameraIntegrator.h"
+
+#include <cmath>
+
+namespace
+{
+  // After a long hitch the lost time is dropped instead of trying
+  // to catch up with hundreds of steps in one frame
+  const int g_MaxStepsPerAdvance = 32;
+
+  // Same order as XMQuaternionMultiply(q1, q2), q1 rotation followed by q2
+  void Multiply(float const* q1, float const* q2, float* pResult)
+  {
+    float x = q2[3] * q1[0] + q2[0] * q1[3] + q2[1] * q1[2] - q2[2] * q1[1];
+    float y = q2[3] * q1[1] - q2[0] * q1[2] + q2[1] * q1[3] + q2[2] * q1[0];
+    float z = q2[3] * q1[2] + q2[0] * q1[1] - q2[1] * q1[0] + q2[2] * q1[3];
+    float w = q2[3] * q1[3] - q2[0] * q1[0] - q2[1] * q1[1] - q2[2] * q1[2];
+
+    pResult[0] = x;
+    pResult[1] = y;
+    pResult[2] = z;
+    pResult[3] = w;
+  }
+
+  void Normalize(float* q)
+  {
+    float length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    if (length <= 0)
+      return;
+
+    for (int i = 0; i < 4; ++i)
+      q[i] /= length;
+  }
+
+  // Rotation around a single axis, 0 = X (pitch), 1 = Y (yaw), 2 = Z (roll)
+  void AxisRotation(int axis, float angle, float* pResult)
+  {
+    pResult[0] = pResult[1] = pResult[2] = 0;
+    pResult[axis] = std::sin(angle * 0.5f);
+    pResult[3] = std::cos(angle * 0.5f);
+  }
+}
+
+CameraIntegrator::CameraIntegrator(float stepSize /* = 1 / 240.f */) :
+  m_StepSize(stepSize),
+  m_Accumulator(0)
+{
+
+}
+
+void CameraIntegrator::Reset(CameraPose const& pose)
+{
+  m_Previous = pose;
+  m_Current = pose;
+  m_Accumulator = 0;
+}
+
+void CameraIntegrator::SetPosition(float const* pPosition)
+{
+  for (int i = 0; i < 3; ++i)
+    m_Previous.Position[i] = m_Current.Position[i] = pPosition[i];
+}
+
+void CameraIntegrator::SetRotation(float const* pRotation)
+{
+  for (int i = 0; i < 4; ++i)
+    m_Previous.Rotation[i] = m_Current.Rotation[i] = pRotation[i];
+}
+
+CameraPose CameraIntegrator::Advance(float dt)
+{
+  if (dt > 0)
+    m_Accumulator += dt;
+
+  int steps = 0;
+  while (m_Accumulator >= m_StepSize)
+  {
+    if (steps == g_MaxStepsPerAdvance)
+    {
+      m_Accumulator = 0;
+      break;
+    }
+
+    m_Previous = m_Current;
+    Step(m_Current, m_Input, m_StepSize);
+    m_Accumulator -= m_StepSize;
+    steps++;
+  }
+
+  return Interpolate(m_Previous, m_Current, m_Accumulator / m_StepSize);
+}
+
+void CameraIntegrator::Step(CameraPose& pose, CameraInput const& input, float dt)
+{
+  float qPitch[4], qYaw[4], qRoll[4];
+  AxisRotation(0, -input.Turn[0] * dt * input.RotationSpeed, qPitch);
+  AxisRotation(1, -input.Turn[1] * dt * input.RotationSpeed, qYaw);
+  AxisRotation(2, input.Turn[2] * dt * input.RollSpeed, qRoll);
+
+  float* q = pose.Rotation;
+  Multiply(qPitch, q, q);
+  Multiply(q, qYaw, q);
+  Multiply(qRoll, q, q);
+  Normalize(q);
+
+  // Rows of XMMatrixRotationQuaternion
+  float right[3] = {
+    1 - 2 * (q[1] * q[1] + q[2] * q[2]),
+    2 * (q[0] * q[1] + q[2] * q[3]),
+    2 * (q[0] * q[2] - q[1] * q[3]) };
+
+  float up[3] = {
+    2 * (q[0] * q[1] - q[2] * q[3]),
+    1 - 2 * (q[0] * q[0] + q[2] * q[2]),
+    2 * (q[1] * q[2] + q[0] * q[3]) };
+
+  float forward[3] = {
+    2 * (q[0] * q[2] + q[1] * q[3]),
+    2 * (q[1] * q[2] - q[0] * q[3]),
+    1 - 2 * (q[0] * q[0] + q[1] * q[1]) };
+
+  float distance = dt * input.MovementSpeed;
+  for (int i = 0; i < 3; ++i)
+  {
+    pose.Position[i] += input.Move[0] * right[i] * distance;
+    pose.Position[i] += input.Move[1] * up[i] * distance;
+    pose.Position[i] -= input.Move[2] * forward[i] * distance;
+  }
+}
+
+CameraPose CameraIntegrator::Interpolate(CameraPose const& from, CameraPose const& to, float t)
+{
+  CameraPose result;
+  for (int i = 0; i < 3; ++i)
+    result.Position[i] = from.Position[i] + (to.Position[i] - from.Position[i]) * t;
+
+  // Steps are small, so a normalized lerp is as good as a slerp.
+  // Take the short way around if the signs flipped.
+  float dot = 0;
+  for (int i = 0; i < 4; ++i)
+    dot += from.Rotation[i] * to.Rotation[i];
+
+  float sign = dot < 0 ? -1.f : 1.f;
+  for (int i = 0; i < 4; ++i)
+    result.Rotation[i] = from.Rotation[i] + (sign * to.Rotation[i] - from.Rotation[i]) * t;
+
+  Normalize(result.Rotation);
+  return result;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+// Camera position and rotation quaternion relative to the target
+struct CameraPose
+{
+  float Position[3]{ 0,0,0 };
+  float Rotation[4]{ 0,0,0,1 };
+};
+
+// Input rates held until the next input update. Move is right/up/backward
+// and Turn is pitch/yaw/roll, in the same units as Camera::dX etc.
+struct CameraInput
+{
+  float Move[3]{ 0,0,0 };
+  float Turn[3]{ 0,0,0 };
+
+  float MovementSpeed{ 1.f };
+  float RotationSpeed{ 1.f };
+  float RollSpeed{ 1.f };
+};
+
+// Moves the free camera in fixed size steps, so the path it takes is the
+// same whatever the frame rate is. Frames that fall between two steps get
+// a pose interpolated between them.
+//
+// The step math matches CameraManager::UpdateCamera, only written out
+// without DirectXMath so the results are identical on every compiler.
+class CameraIntegrator
+{
+public:
+  explicit CameraIntegrator(float stepSize = 1 / 240.f);
+
+  // Jumps to the pose without interpolating from the old one
+  void Reset(CameraPose const& pose);
+  void SetInput(CameraInput const& input) { m_Input = input; }
+
+  // Same as Reset but only for one half of the pose, used when a
+  // camera track drives the position and maybe the rotation
+  void SetPosition(float const* pPosition);
+  void SetRotation(float const* pRotation);
+
+  // Runs as many steps as fit in the elapsed time. Leftover time is
+  // carried over to the next call.
+  CameraPose Advance(float dt);
+
+  // Pose after the last whole step
+  CameraPose const& GetPose() const { return m_Current; }
+  float GetStepSize() const { return m_StepSize; }
+
+  static void Step(CameraPose& pose, CameraInput const& input, float dt);
+  static CameraPose Interpolate(CameraPose const& from, CameraPose const& to, float t);
+
+private:
+  float m_StepSize;
+  float m_Accumulator;
+
+  CameraPose m_Previous;
+  CameraPose m_Current;
+  CameraInput m_Input;
+};
@@ -1,18 +1,40 @@
 #include "CameraManager.h"
+#include "OSCReceiver.h"
 #include "../Main.h"
 #include "../Util/ImGuiEXT.h"
 #include "../inih/cpp/INIReader.h"
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/filesystem.hpp>
-#include <boost/range/iterator_range.hpp>
+#include <cstring>
 #include <iostream>
 #include <Windows.h>
 
+static const std::string g_profileDir = "./Cinematic Tools/Profiles/";
+static const char* g_profileStore = "./Cinematic Tools/profiles.db";
+
+// Mouse sensitivity is per count at this many updates per second
+static const float g_mouseReferenceRate = 60.f;
+
+// Pose of the OSC tracker relative to its origin, nothing if tracking is
+// off. Only the thread that moves the camera reads the tracker.
+static void ReadOSCPose(OSCReceiver* pReceiver, PoseFilterSettings const& settings, XMFLOAT3& position, XMFLOAT4& rotation)
+{
+  position = XMFLOAT3(0, 0, 0);
+  rotation = XMFLOAT4(0, 0, 0, 1);
+  if (!pReceiver) return;
+
+  pReceiver->SetFilterSettings(settings);
+  OSCTransform transform = pReceiver->GetTransformData();
+  position = transform.Position;
+  rotation = transform.Rotation;
+}
+
 // Helper for ImGui combo
-static auto ProfileNameGetter = [](void* vec, int idx, const char** out_text)
+static auto ProfileNameGetter = [](void* store, int idx, const char** out_text)
 {
-  std::vector<CameraProfile>* v = reinterpret_cast<std::vector<CameraProfile>*>(vec);
-  *out_text = v->at(idx).Name.c_str();
+  util::RecordStore* pStore = reinterpret_cast<util::RecordStore*>(store);
+  *out_text = pStore->GetNames().at(idx).c_str();
   return true;
 };
 
@@ -23,13 +45,25 @@ CameraManager::CameraManager() :
   m_UIRequestReset(false),
   m_GamepadDisabled(true),
   m_KbmDisabled(true),
-  m_SmoothMouse(true),
   m_Camera(),
   m_TrackPlayer(),
+  m_StateChannel(CameraState()),
+  m_ViewChannel(CameraView()),
+  m_IntegrateInHook(false),
+  m_PoseGeneration(0),
+  m_HookIntegrated(false),
+  m_HookOwnsCamera(false),
+  m_HookIntegrating(false),
+  m_HookPoseGeneration(0),
+  m_WheelAverage(25.f / 60),
   m_CharacterIndex(0),
   m_LockToCharacter(false),
   m_pCharacter(nullptr),
   m_HideUI(false),
+  m_UseOSC(false),
+  m_UIRequestOSCReset(false),
+  m_OSCPosition(0, 0, 0),
+  m_OSCRotation(0, 0, 0, 1),
   m_ShowProfileModal(false),
   m_ModalProfileName("New profile\0"),
   m_SelectedProfile(0),
@@ -43,60 +77,41 @@ CameraManager::~CameraManager()
 
 }
 
-void CameraManager::HotkeyUpdate()
+void CameraManager::SubscribeHotkeys(InputSystem* pInput)
 {
-  InputSystem* pInput = g_mainHandle->GetInputSystem();
-
-  if (pInput->IsActionDown(Action::ToggleCamera))
-  {
-    ToggleCamera();
-    while (pInput->IsActionDown(Action::ToggleCamera))
-      Sleep(100);
-  }
-
-  if (pInput->IsActionDown(Action::ToggleHUD))
-  {
-    ToggleHUD();
-
-    while (pInput->IsActionDown(Action::ToggleHUD))
-      Sleep(100);
-  }
+  // Handlers run once per key press on the hotkey thread
+  pInput->SubscribeAction(Action::ToggleCamera, [this](ActionEvent const&) { ToggleCamera(); });
+  pInput->SubscribeAction(Action::ToggleHUD, [this](ActionEvent const&) { ToggleHUD(); });
 
-  if (pInput->IsActionDown(Action::ToggleFreezeTime))
+  pInput->SubscribeAction(Action::ToggleFreezeTime, [](ActionEvent const&)
   {
-    bool* pFreezeTime = (bool*)(*(bool**)util::offsets::GetOffset("OFFSET_FREEZETIME"));
+    bool* pFreezeTime = (bool*)(*(bool**)util::offsets::GetOffset(OFFSET_FREEZETIME));
     *pFreezeTime = !*pFreezeTime;
+  });
 
-    while (pInput->IsActionDown(Action::ToggleFreezeTime))
-      Sleep(100);
-  }
-
-  if (m_CameraEnabled)
+  pInput->SubscribeAction(Action::Track_CreateNode, [this](ActionEvent const&)
   {
-    if (pInput->IsActionDown(Action::Track_CreateNode))
-    {
+    if (m_CameraEnabled)
       m_TrackPlayer.CreateNode(m_Camera);
+  });
 
-      while (pInput->IsActionDown(Action::Track_CreateNode))
-        Sleep(100);
-    }
-
-    if (pInput->IsActionDown(Action::Track_DeleteNode))
-    {
+  pInput->SubscribeAction(Action::Track_DeleteNode, [this](ActionEvent const&)
+  {
+    if (m_CameraEnabled)
       m_TrackPlayer.DeleteNode();
+  });
 
-      while (pInput->IsActionDown(Action::Track_DeleteNode))
-        Sleep(100);
-    }
-
-    if (pInput->IsActionDown(Action::Track_Play))
-    {
+  pInput->SubscribeAction(Action::Track_Play, [this](ActionEvent const&)
+  {
+    if (m_CameraEnabled)
       m_TrackPlayer.Toggle();
+  });
 
-      while (pInput->IsActionDown(Action::Track_Play))
-        Sleep(100);
-    }
-  }
+  pInput->SubscribeAction(Action::Track_Record, [this](ActionEvent const&)
+  {
+    if (m_CameraEnabled)
+      m_TrackPlayer.ToggleRecording();
+  });
 }
 
 XMFLOAT4 savedRotations[3];
@@ -104,16 +119,67 @@ XMFLOAT3 savedPositions[3];
 
 void CameraManager::OnCameraUpdateBegin()
 {
-  if (!m_CameraEnabled) return;
+  // Both Begin and End use the state read here
+  m_StateChannel.TryLoad(m_CameraHookState);
+  CameraState const& state = m_CameraHookState;
+
+  // Time since the previous game frame
+  boost::chrono::high_resolution_clock::time_point now = boost::chrono::high_resolution_clock::now();
+  boost::chrono::duration<float> frameTime = now - m_dtCameraUpdate;
+  m_dtCameraUpdate = now;
+
+  if (!state.Enabled)
+  {
+    m_HookIntegrating = false;
+    m_TrackPlayer.StopRecording();
+    return;
+  }
+
+  CameraView view;
+  view.LocalPosition = state.Position;
+  view.LocalRotation = state.Rotation;
+  view.PoseGeneration = state.PoseGeneration;
+  view.FieldOfView = state.FieldOfView;
+  view.FocusDistance = state.FocusDistance;
+  view.DofScale = state.DofScale;
+  view.DofStrength = state.DofStrength;
+  view.Integrated = state.IntegrateInHook;
+  view.OSCPosition = state.OSCPosition;
+  view.OSCRotation = state.OSCRotation;
+
+  if (state.IntegrateInHook)
+  {
+    // Long pauses, like loading screens, shouldn't fling the camera
+    float dt = frameTime.count();
+    IntegrateCamera(state, dt < 0.1f ? dt : 0.1f, view);
+  }
+  else
+    m_HookIntegrating = false;
+
+  // The tracker moves the camera in its own space. It's added here
+  // instead of to the local pose, so it doesn't build up.
+  XMVECTOR vPosition = XMLoadFloat3(&view.LocalPosition);
+  XMVECTOR qRotation = XMLoadFloat4(&view.LocalRotation);
+  vPosition += XMVector3Rotate(XMLoadFloat3(&view.OSCPosition), qRotation);
+  qRotation = XMQuaternionMultiply(XMLoadFloat4(&view.OSCRotation), qRotation);
+
+  // Takes are recorded once per game frame, in the same target
+  // relative space as the nodes
+  CatmullRomNode frame;
+  XMStoreFloat3(&frame.Position, vPosition);
+  XMStoreFloat4(&frame.Rotation, qRotation);
+  frame.FieldOfView = view.FieldOfView;
+  frame.FocusDistance = view.FocusDistance;
+  frame.DofScale = view.DofScale;
+  frame.DofStrength = view.DofStrength;
+  m_TrackPlayer.RecordFrame(frame, frameTime.count());
 
   // Final camera position and rotation calculations are done here
   // because character locked cameras stutter if they are updated
   // outside the game thread.
 
-  XMMATRIX targetMatrix = m_LockToCharacter ? GetTargetMatrix() : XMMatrixIdentity();
+  XMMATRIX targetMatrix = state.LockToCharacter ? GetTargetMatrix(state.pCharacter) : XMMatrixIdentity();
   XMVECTOR targetRotation = XMQuaternionRotationMatrix(targetMatrix);
-  XMVECTOR vPosition = XMLoadFloat3(&m_Camera.Position);
-  XMVECTOR qRotation = XMLoadFloat4(&m_Camera.Rotation);
 
   XMVECTOR finalPosition = targetMatrix.r[3];
   finalPosition += targetMatrix.r[0] * vPosition.m128_f32[0];
@@ -122,8 +188,9 @@ void CameraManager::OnCameraUpdateBegin()
 
   XMVECTOR finalRotation = XMQuaternionMultiply(qRotation, targetRotation);
 
-  XMStoreFloat3(&m_Camera.AbsolutePosition, finalPosition);
-  XMStoreFloat4(&m_Camera.AbsoluteRotation, finalRotation);
+  XMStoreFloat3(&view.Position, finalPosition);
+  XMStoreFloat4(&view.Rotation, finalRotation);
+  m_ViewChannel.Store(view);
 
   CATHODE::AICamera* pCamera = CATHODE::Main::Singleton()->m_CameraManager->m_ActiveCamera;
   for (int i = 0; i < 3; ++i)
@@ -133,13 +200,69 @@ void CameraManager::OnCameraUpdateBegin()
 
     XMStoreFloat3(&pCamera->m_State[i].m_Position, finalPosition);
     XMStoreFloat4(&pCamera->m_State[i].m_Rotation, finalRotation);
-    pCamera->m_State[i].m_FieldOfView = m_Camera.Profile.FieldOfView;
+    pCamera->m_State[i].m_FieldOfView = view.FieldOfView;
+  }
+}
+
+void CameraManager::IntegrateCamera(CameraState const& state, float dt, CameraView& view)
+{
+  // Start from the tools thread's pose when this mode is turned on
+  // or when the camera was reset or moved
+  if (!m_HookIntegrating || state.PoseGeneration != m_HookPoseGeneration)
+  {
+    CameraPose pose;
+    memcpy(pose.Position, &state.Position, sizeof(pose.Position));
+    memcpy(pose.Rotation, &state.Rotation, sizeof(pose.Rotation));
+
+    m_Integrator.Reset(pose);
+    m_HookPoseGeneration = state.PoseGeneration;
+    m_HookIntegrating = true;
+  }
+
+  bool playing = m_TrackPlayer.IsPlaying();
+
+  // Tracks drive the position, but the rotation can still be free
+  CameraInput input = state.Input;
+  if (playing)
+    input.Move[0] = input.Move[1] = input.Move[2] = 0;
+
+  m_Integrator.SetInput(input);
+  CameraPose pose = m_Integrator.Advance(dt);
+
+  // Read at the same time as the camera moves
+  ReadOSCPose(state.pOSCReceiver, state.OSCFilter, view.OSCPosition, view.OSCRotation);
+
+  if (playing)
+  {
+    CatmullRomNode node = m_TrackPlayer.PlayForwardSmooth(dt);
+
+    memcpy(pose.Position, &node.Position, sizeof(pose.Position));
+    m_Integrator.SetPosition(pose.Position);
+
+    if (m_TrackPlayer.IsRotationLocked())
+    {
+      memcpy(pose.Rotation, &node.Rotation, sizeof(pose.Rotation));
+      m_Integrator.SetRotation(pose.Rotation);
+    }
+
+    if (m_TrackPlayer.IsFovLocked())
+      view.FieldOfView = node.FieldOfView;
+
+    if (m_TrackPlayer.IsDofLocked())
+    {
+      view.FocusDistance = node.FocusDistance;
+      view.DofScale = node.DofScale;
+      view.DofStrength = node.DofStrength;
+    }
   }
+
+  memcpy(&view.LocalPosition, pose.Position, sizeof(pose.Position));
+  memcpy(&view.LocalRotation, pose.Rotation, sizeof(pose.Rotation));
 }
 
 void CameraManager::OnCameraUpdateEnd()
 {
-  if (!m_CameraEnabled) return;
+  if (!m_CameraHookState.Enabled) return;
 
   CATHODE::AICamera* pCamera = CATHODE::Main::Singleton()->m_CameraManager->m_ActiveCamera;
   for (int i = 0; i < 3; ++i)
@@ -151,10 +274,19 @@ void CameraManager::OnCameraUpdateEnd()
 
 void CameraManager::OnPostProcessUpdate(CATHODE::PostProcess* pPostProcess)
 {
-  if (!m_CameraEnabled) return;
-  pPostProcess->m_DofFocusDistance = m_Camera.Profile.FocusDistance;
-  pPostProcess->m_DofStrength = m_Camera.Profile.DofStrength;
-  pPostProcess->m_DofScale = m_Camera.Profile.DofScale;
+  m_StateChannel.TryLoad(m_PostProcessHookState);
+  CameraState const& state = m_PostProcessHookState;
+
+  if (!state.Enabled) return;
+
+  // Tracks played in the camera hook set the DoF there
+  m_ViewChannel.TryLoad(m_PostProcessHookView);
+  CameraView const& view = m_PostProcessHookView;
+  bool useView = state.IntegrateInHook && view.PoseGeneration == state.PoseGeneration;
+
+  pPostProcess->m_DofFocusDistance = useView ? view.FocusDistance : state.FocusDistance;
+  pPostProcess->m_DofStrength = useView ? view.DofStrength : state.DofStrength;
+  pPostProcess->m_DofScale = useView ? view.DofScale : state.DofScale;
 }
 
 void CameraManager::OnMapChange()
@@ -164,11 +296,40 @@ void CameraManager::OnMapChange()
 
 void CameraManager::Update(float dt)
 {
-  if (!m_CameraEnabled) return;
-  if (m_UIRequestReset) ResetCamera();
+  if (m_UseOSC && !m_pOSCReceiver)
+    m_pOSCReceiver = std::make_unique<OSCReceiver>();
+
+  if (m_UIRequestOSCReset)
+  {
+    m_UIRequestOSCReset = false;
+    if (m_pOSCReceiver)
+      m_pOSCReceiver->ResetOrigin();
+  }
+
+  // The setting is changed by the UI, so it's read once here and
+  // published with the state the hook acts on. Switching back to
+  // this thread waits until the hook has stopped integrating.
+  bool integrateInHook = m_IntegrateInHook;
+
+  CameraView view;
+  bool hasView = m_ViewChannel.TryLoad(view);
+  if (hasView)
+    m_HookIntegrated = view.Integrated;
+
+  m_HookOwnsCamera = integrateInHook || m_HookIntegrated;
+
+  if (m_CameraEnabled)
+  {
+    if (m_UIRequestReset) ResetCamera();
+    if (m_HookOwnsCamera && hasView) FollowHookCamera(view);
+
+    UpdateInput(dt);
+    PreviewTrack();
+    UpdateCamera(dt);
+  }
 
-  UpdateInput(dt);
-  UpdateCamera(dt);
+  m_TrackPlayer.Update();
+  PublishState(integrateInHook);
 }
 
 void CameraManager::DrawUI()
@@ -213,9 +374,43 @@ void CameraManager::DrawUI()
   ImGui::Checkbox("Disable player KBM input", &m_KbmDisabled);
   ImGui::Checkbox("Disable player gamepad input", &m_GamepadDisabled);
   configChanged |= ImGui::Checkbox("Reset camera automatically", &m_AutoReset);
-  ImGui::Checkbox("Smooth mouse", &m_SmoothMouse);
+  configChanged |= ImGui::Checkbox("Update camera on game thread", &m_IntegrateInHook);
+  configChanged |= ImGui::Checkbox("OSC tracking", &m_UseOSC);
   ImGui::PopStyleVar();
 
+  if (m_UseOSC)
+  {
+    m_UIRequestOSCReset |= ImGui::Button("Reset OSC origin");
+
+    ImGui::Text("OSC prediction");
+    configChanged |= ImGui::Combo("##OSCPrediction", &m_OSCFilter.Prediction, "None\0Constant velocity\0Kalman\0");
+    ImGui::Text("OSC delay");
+    configChanged |= ImGui::InputFloat("##OSCDelay", &m_OSCFilter.Delay, 0.005f, 0.01f, 3);
+    if (m_OSCFilter.Delay < 0)
+      m_OSCFilter.Delay = 0;
+  }
+
+  ImGui::Text("Mouse filter");
+  configChanged |= ImGui::Combo("##MouseFilter", &m_Camera.Profile.MouseFilter, "None\0Average\0One Euro\0");
+  if (m_Camera.Profile.MouseFilter == MouseFilter_Average)
+  {
+    ImGui::Text("Smoothing time");
+    configChanged |= ImGui::InputFloat("##MouseSmoothTime", &m_Camera.Profile.MouseSmoothTime, 0.05f, 0.1f, 2);
+    if (m_Camera.Profile.MouseSmoothTime < 0.01f)
+      m_Camera.Profile.MouseSmoothTime = 0.01f;
+  }
+  else if (m_Camera.Profile.MouseFilter == MouseFilter_OneEuro)
+  {
+    ImGui::Text("Minimum cutoff");
+    configChanged |= ImGui::InputFloat("##MouseMinCutoff", &m_Camera.Profile.MouseMinCutoff, 0.1f, 1.f, 2);
+    ImGui::Text("Speed coefficient");
+    configChanged |= ImGui::InputFloat("##MouseBeta", &m_Camera.Profile.MouseBeta, 0.001f, 0.01f, 4);
+    if (m_Camera.Profile.MouseMinCutoff < 0.01f)
+      m_Camera.Profile.MouseMinCutoff = 0.01f;
+    if (m_Camera.Profile.MouseBeta < 0)
+      m_Camera.Profile.MouseBeta = 0;
+  }
+
   /////////////////////////////////////////////////
   ////////////////////////////////////////////////
 
@@ -245,7 +440,7 @@ void CameraManager::DrawUI()
       m_TimeScale = 0;
   }
 
-  double* pTimescale = reinterpret_cast<double*>(util::offsets::GetOffset("OFFSET_TIMESCALE"));
+  double* pTimescale = reinterpret_cast<double*>(util::offsets::GetOffset(OFFSET_TIMESCALE));
   *pTimescale = static_cast<double>(m_TimeScale);
 
 
@@ -284,24 +479,29 @@ void CameraManager::DrawUI()
   ImGui::SetColumnOffset(-1, 814);
   ImGui::PushItemWidth(200);
 
-  ImGui::Text("Camera profiles");
-  if (ImGui::Combo("##CameraProfile", &m_SelectedProfile, ProfileNameGetter, static_cast<void*>(&m_Profiles), (int)m_Profiles.size()))
-    m_Camera.Profile = m_Profiles[m_SelectedProfile];
+  {
+    std::lock_guard<std::mutex> lock(m_ProfileMutex);
+
+    ImGui::Text("Camera profiles");
+    int selectedProfile = m_SelectedProfile;
+    if (ImGui::Combo("##CameraProfile", &selectedProfile, ProfileNameGetter, static_cast<void*>(&m_ProfileStore), (int)m_ProfileStore.GetCount()))
+      SelectProfile(selectedProfile);
 
-  if (ImGui::Button("Save profile"))
-    ImGui::OpenPopup("CameraProfileModal");
+    if (ImGui::Button("Save profile"))
+      ImGui::OpenPopup("CameraProfileModal");
 
-  if (ImGui::BeginPopupModal("CameraProfileModal"))
-  {
-    ImGui::Text("Profile name");
-    ImGui::InputText("##ProfileName", m_ModalProfileName, 50);
-    if (ImGui::Button("Save"))
+    if (ImGui::BeginPopupModal("CameraProfileModal"))
     {
-      CreateProfile();
-      ImGui::CloseCurrentPopup();
+      ImGui::Text("Profile name");
+      ImGui::InputText("##ProfileName", m_ModalProfileName, 50);
+      if (ImGui::Button("Save"))
+      {
+        CreateProfile();
+        ImGui::CloseCurrentPopup();
+      }
+
+      ImGui::EndPopup();
     }
-
-    ImGui::EndPopup();
   }
 
   ImGui::PopFont();
@@ -312,36 +512,65 @@ void CameraManager::DrawUI()
 
 void CameraManager::ReadConfig(INIReader* pReader)
 {
-  LoadProfiles();
+  std::lock_guard<std::mutex> lock(m_ProfileMutex);
+
+  // The store is opened once, after that ReloadProfile
+  // imports profile files as they change
+  if (!m_ProfileStore.IsOpen())
+    LoadProfiles();
+
   m_AutoReset = pReader->GetBoolean("Camera", "AutoReset", false);
+  m_IntegrateInHook = pReader->GetBoolean("Camera", "UpdateOnGameThread", false);
+  m_UseOSC = pReader->GetBoolean("Camera", "UseOSC", false);
+  m_OSCFilter.Prediction = static_cast<int>( pReader->GetInteger("Camera", "OSCPrediction", PosePrediction_Kalman) );
+  m_OSCFilter.Delay = static_cast<float>( pReader->GetReal("Camera", "OSCDelay", 0.0) );
+
+  if (m_OSCFilter.Prediction < 0 || m_OSCFilter.Prediction >= PosePrediction_Count)
+    m_OSCFilter.Prediction = PosePrediction_Kalman;
   
   std::string sSelectedProfile = pReader->Get("Camera", "SelectedProfile", "");
   if (sSelectedProfile.empty()) return;
 
-  for (size_t i = 0; i < m_Profiles.size(); ++i)
-  {
-    if (m_Profiles[i].Name == sSelectedProfile)
-    {
-      m_SelectedProfile = static_cast<unsigned int>( i );
-      m_Camera.Profile = m_Profiles[i];
-      break;
-    }
-  }
+  int index = m_ProfileStore.Find(sSelectedProfile);
+  if (index >= 0)
+    SelectProfile(index);
 }
 
 const std::string CameraManager::GetConfig()
 {
-  SaveProfiles();
+  std::lock_guard<std::mutex> lock(m_ProfileMutex);
+
+  // Profiles are saved to the store as they're created
+  std::vector<std::string> const& profileNames = m_ProfileStore.GetNames();
+  std::string selectedProfile = m_Camera.Profile.Name;
+  if (m_SelectedProfile >= 0 && m_SelectedProfile < static_cast<int>(profileNames.size()))
+    selectedProfile = profileNames[m_SelectedProfile];
 
   std::string config = "[Camera]\n";
-  config += "SelectedProfile = " + m_Profiles[m_SelectedProfile].Name + "\n";
+  config += "SelectedProfile = " + selectedProfile + "\n";
   config += "AutoReset = " + std::to_string(m_AutoReset) + "\n";
+  config += "UpdateOnGameThread = " + std::to_string(m_IntegrateInHook) + "\n";
+  config += "UseOSC = " + std::to_string(m_UseOSC) + "\n";
+  config += "OSCPrediction = " + std::to_string(m_OSCFilter.Prediction) + "\n";
+  config += "OSCDelay = " + std::to_string(m_OSCFilter.Delay) + "\n";
 
   return config;
 }
 
 void CameraManager::UpdateCamera(float dt)
 {
+  m_Camera.Profile.FieldOfView += m_Camera.dFov * dt * m_Camera.Profile.FovSpeed;
+  m_Camera.Profile.FocusDistance += m_Camera.dFocus * dt * 1;
+  m_Camera.Profile.DofScale += m_Camera.dDofScale * dt * 1;
+  m_Camera.Profile.DofStrength += m_Camera.dDofStrength * dt * 0.01f;
+
+  // The camera hook moves the camera, plays tracks and reads
+  // the tracker instead
+  if (m_HookOwnsCamera)
+    return;
+
+  ReadOSCPose(m_UseOSC ? m_pOSCReceiver.get() : nullptr, m_OSCFilter, m_OSCPosition, m_OSCRotation);
+
   XMVECTOR qPitch = XMQuaternionRotationRollPitchYaw(-m_Camera.dPitch * dt * m_Camera.Profile.RotationSpeed, 0, 0);
   XMVECTOR qYaw = XMQuaternionRotationRollPitchYaw(0, -m_Camera.dYaw* dt * m_Camera.Profile.RotationSpeed, 0);
   XMVECTOR qRoll = XMQuaternionRotationRollPitchYaw(0, 0, m_Camera.dRoll* dt * m_Camera.Profile.RollSpeed);
@@ -356,11 +585,6 @@ void CameraManager::UpdateCamera(float dt)
 
   // Make sure it's normalized
   qRotation = XMQuaternionNormalize(qRotation);
-  
-  m_Camera.Profile.FieldOfView += m_Camera.dFov * dt * m_Camera.Profile.FovSpeed;
-  m_Camera.Profile.FocusDistance += m_Camera.dFocus * dt * 1;
-  m_Camera.Profile.DofScale += m_Camera.dDofScale * dt * 1;
-  m_Camera.Profile.DofStrength += m_Camera.dDofStrength * dt * 0.01f;
 
   // If a camera track is being played, get the current
   // state and overwrite position/rotation/FoV.
@@ -401,7 +625,12 @@ void CameraManager::UpdateCamera(float dt)
 
   XMStoreFloat3(&m_Camera.Position, vPosition);
   XMStoreFloat4(&m_Camera.Rotation, qRotation);
+}
 
+void CameraManager::UpdateInput(float dt)
+{
+  // Deltas are also published to the camera hook,
+  // so they're cleared here instead of after use
   m_Camera.dX = 0;
   m_Camera.dY = 0;
   m_Camera.dZ = 0;
@@ -412,10 +641,7 @@ void CameraManager::UpdateCamera(float dt)
   m_Camera.dFocus = 0;
   m_Camera.dDofScale = 0;
   m_Camera.dDofStrength = 0;
-}
 
-void CameraManager::UpdateInput(float dt)
-{
   InputSystem* pInput = g_mainHandle->GetInputSystem();
   if (!g_hasFocus || g_mainHandle->GetUI()->HasKeyboardFocus())
     return;
@@ -453,21 +679,123 @@ void CameraManager::UpdateInput(float dt)
   if (m_Camera.Profile.MovementSpeed < 0.1f)
     m_Camera.Profile.MovementSpeed = 0.1f;
 
-  if (m_KbmDisabled && !g_mainHandle->GetUI()->IsEnabled())
+  if (m_KbmDisabled && !g_mainHandle->GetUI()->IsEnabled() && dt > 0)
   {
     XMFLOAT3 state = pInput->GetMouseState();
     float sensitivity = pInput->GetMouseSensitivity();
+    CameraProfile const& profile = m_Camera.Profile;
+
+    // Filters take x, y and wheel counts as arrays and give counts
+    // per second
+    float delta[3] = { state.x, state.y, state.z };
+    float velocity[3] = { state.x / dt, state.y / dt, state.z / dt };
+    float wheelVelocity[3];
 
-    m_MouseBuffer.AddValue(state);
-    XMFLOAT3 smoothState = m_MouseBuffer.CalcAverage();
+    if (profile.MouseFilter == MouseFilter_Average)
+    {
+      m_MouseAverage.SetWindow(profile.MouseSmoothTime);
+      m_MouseAverage.Update(delta, dt, velocity);
+    }
+    else if (profile.MouseFilter == MouseFilter_OneEuro)
+    {
+      m_MouseOneEuro.SetParameters(profile.MouseMinCutoff, profile.MouseBeta);
+      m_MouseOneEuro.Update(delta, dt, velocity);
+    }
 
-    if (m_SmoothMouse)
-      state = smoothState;
+    // The wheel is always smoothed, single notches would jump the FoV
+    m_WheelAverage.Update(delta, dt, wheelVelocity);
 
-    m_Camera.dPitch -= state.y * sensitivity;
-    m_Camera.dYaw -= state.x * sensitivity;
-    m_Camera.dFov += smoothState.z;
+    // Sensitivity was tuned for counts per frame at 60 fps
+    m_Camera.dPitch -= velocity[1] * sensitivity / g_mouseReferenceRate;
+    m_Camera.dYaw -= velocity[0] * sensitivity / g_mouseReferenceRate;
+    m_Camera.dFov += wheelVelocity[2] / g_mouseReferenceRate;
   }
+  else
+  {
+    // Start over instead of releasing old movement later
+    m_MouseAverage.Reset();
+    m_MouseOneEuro.Reset();
+    m_WheelAverage.Reset();
+  }
+}
+
+void CameraManager::PublishState(bool integrateInHook)
+{
+  CameraState state;
+  state.Enabled = m_CameraEnabled;
+  state.LockToCharacter = m_LockToCharacter;
+  state.pCharacter = m_pCharacter;
+  state.Position = m_Camera.Position;
+  state.Rotation = m_Camera.Rotation;
+  state.FieldOfView = m_Camera.Profile.FieldOfView;
+  state.FocusDistance = m_Camera.Profile.FocusDistance;
+  state.DofScale = m_Camera.Profile.DofScale;
+  state.DofStrength = m_Camera.Profile.DofStrength;
+
+  state.IntegrateInHook = integrateInHook;
+  state.pOSCReceiver = m_UseOSC ? m_pOSCReceiver.get() : nullptr;
+  state.OSCFilter = m_OSCFilter;
+  state.OSCPosition = m_OSCPosition;
+  state.OSCRotation = m_OSCRotation;
+  state.PoseGeneration = m_PoseGeneration;
+  state.Input.Move[0] = m_Camera.dX;
+  state.Input.Move[1] = m_Camera.dY;
+  state.Input.Move[2] = m_Camera.dZ;
+  state.Input.Turn[0] = m_Camera.dPitch;
+  state.Input.Turn[1] = m_Camera.dYaw;
+  state.Input.Turn[2] = m_Camera.dRoll;
+  state.Input.MovementSpeed = m_Camera.Profile.MovementSpeed;
+  state.Input.RotationSpeed = m_Camera.Profile.RotationSpeed;
+  state.Input.RollSpeed = m_Camera.Profile.RollSpeed;
+
+  m_StateChannel.Store(state);
+}
+
+void CameraManager::FollowHookCamera(CameraView const& view)
+{
+  // The hook hasn't caught up with a reset yet
+  if (view.PoseGeneration != m_PoseGeneration)
+    return;
+
+  m_Camera.Position = view.LocalPosition;
+  m_Camera.Rotation = view.LocalRotation;
+
+  if (m_TrackPlayer.IsPlaying())
+  {
+    if (m_TrackPlayer.IsFovLocked())
+      m_Camera.Profile.FieldOfView = view.FieldOfView;
+
+    if (m_TrackPlayer.IsDofLocked())
+    {
+      m_Camera.Profile.FocusDistance = view.FocusDistance;
+      m_Camera.Profile.DofScale = view.DofScale;
+      m_Camera.Profile.DofStrength = view.DofStrength;
+    }
+  }
+}
+
+void CameraManager::PreviewTrack()
+{
+  CatmullRomNode node;
+  if (!m_TrackPlayer.TakeSeekedNode(node))
+    return;
+
+  m_Camera.Position = node.Position;
+  if (m_TrackPlayer.IsRotationLocked())
+    m_Camera.Rotation = node.Rotation;
+
+  if (m_TrackPlayer.IsFovLocked())
+    m_Camera.Profile.FieldOfView = node.FieldOfView;
+
+  if (m_TrackPlayer.IsDofLocked())
+  {
+    m_Camera.Profile.FocusDistance = node.FocusDistance;
+    m_Camera.Profile.DofScale = node.DofScale;
+    m_Camera.Profile.DofStrength = node.DofStrength;
+  }
+
+  // The camera hook has to jump there as well
+  m_PoseGeneration++;
 }
 
 void CameraManager::ToggleCamera()
@@ -480,6 +808,7 @@ void CameraManager::ToggleCamera()
     util::log::Write("First pos: %.2f %.2f %.2f", m_Camera.Position.x, m_Camera.Position.y, m_Camera.Position.z);
     m_Camera.Rotation = XMFLOAT4(0, 0, 0, 1);
     m_FirstEnable = false;
+    m_PoseGeneration++;
   }
 
   m_CameraEnabled = !m_CameraEnabled;
@@ -494,14 +823,18 @@ void CameraManager::ResetCamera()
   Sleep(100);
   m_FirstEnable = true;
   ToggleCamera();
+
+  // The tracker starts over from where it is now
+  if (m_pOSCReceiver)
+    m_pOSCReceiver->ResetOrigin();
 }
 
-XMMATRIX CameraManager::GetTargetMatrix()
+XMMATRIX CameraManager::GetTargetMatrix(CATHODE::Character* pCharacter)
 {
   XMMATRIX result = XMMatrixIdentity();
 
-  if (!m_pCharacter) return result;
-  result = XMLoadFloat4x4(&m_pCharacter->m_Transform);
+  if (!pCharacter) return result;
+  result = XMLoadFloat4x4(&pCharacter->m_Transform);
 
   return result;
 }
@@ -517,38 +850,48 @@ void CameraManager::ChangeCamRelativity()
     CATHODE::AICamera* pCamera = CATHODE::Main::Singleton()->m_CameraManager->m_ActiveCamera;
     m_Camera.Position = pCamera->m_State[2].m_Position;
   }
+
+  m_PoseGeneration++;
 }
 
 void CameraManager::LoadProfiles()
 {
-  boost::filesystem::path profileDir("./Cinematic Tools/Profiles/");
-  for (auto& entry : boost::make_iterator_range(boost::filesystem::directory_iterator(profileDir), {}))
+  std::string error;
+  if (!m_ProfileStore.Open(g_profileStore, &error))
   {
-    const boost::filesystem::path &profilePath = entry.path();
-    
-    INIReader reader(profilePath.generic_string().c_str());
+    util::log::Error("Camera profiles could not be opened. %s", error.c_str());
+    return;
+  }
+
+  if (m_ProfileStore.GetDamagedBytes() > 0)
+  {
+    util::log::Warning("Camera profiles were damaged, %llu bytes could not be read. The damaged file was kept as %s.damaged",
+      static_cast<unsigned long long>(m_ProfileStore.GetDamagedBytes()), g_profileStore);
+  }
 
-    // Make sure the opened file is actually a camera profile
-    if (!reader.GetBoolean("CameraProfile", "IsProfile", false))
-      continue;
+  // Profiles used to be saved one file each
+  if (m_ProfileStore.GetCount() == 0)
+    ImportProfiles();
 
-    CameraProfile profile;
-    profile.Name = reader.Get("CameraProfile", "Name", "UNKNOWN");
-    profile.MovementSpeed = static_cast<float>( reader.GetReal("CameraProfile", "MovementSpeed", 1.0f) );
-    profile.RotationSpeed = static_cast<float>( reader.GetReal("CameraProfile", "RotationSpeed", XM_PI / 4) );
-    profile.RollSpeed = static_cast<float>( reader.GetReal("CameraProfile", "RollSpeed", XM_PI / 8) );
-    profile.FovSpeed = static_cast<float>( reader.GetReal("CameraProfile", "FovSpeed", 5.0f) );
-    profile.FieldOfView = static_cast<float>( reader.GetReal("CameraProfile", "FieldOfView", 50.0f) );
-    profile.FocusDistance = static_cast<float>( reader.GetReal("CameraProfile", "FocusDistance", 2.0f) );
-    profile.DofStrength = static_cast<float>( reader.GetReal("CameraProfile", "DofStrength", 0.04f) );
-    profile.DofScale = static_cast<float>( reader.GetReal("CameraProfile", "DofScale", 1.0f) );
+  // If there were no profiles, save current one as default
+  if (m_ProfileStore.GetCount() == 0)
+    StoreProfile(m_Camera.Profile);
+
+  m_ProfileStore.Sync();
+}
 
-    m_Profiles.emplace_back(profile);
+void CameraManager::ImportProfiles()
+{
+  boost::system::error_code error;
+  for (boost::filesystem::directory_iterator itr(g_profileDir, error), end; !error && itr != end; itr.increment(error))
+  {
+    CameraProfile profile;
+    if (ReadProfile(itr->path().generic_string(), profile))
+      StoreProfile(profile);
   }
 
-  // If there were no profiles, save current one as default
-  if (m_Profiles.size() == 0)
-    m_Profiles.emplace_back(m_Camera.Profile);
+  if (m_ProfileStore.GetCount() > 0)
+    util::log::Ok("Imported %u camera profiles", static_cast<unsigned int>(m_ProfileStore.GetCount()));
 }
 
 void CameraManager::CreateProfile()
@@ -556,41 +899,143 @@ void CameraManager::CreateProfile()
   CameraProfile profile = m_Camera.Profile;
   profile.Name = std::string(m_ModalProfileName);
 
-  m_Profiles.emplace_back(profile);
-  m_SelectedProfile = m_Profiles.size() - 1;
+  if (profile.Name.empty())
+  {
+    util::log::Warning("Camera profile needs a name");
+    return;
+  }
+
+  if (!StoreProfile(profile))
+    return;
+
+  m_ProfileStore.Sync();
+  m_SelectedProfile = m_ProfileStore.Find(profile.Name);
   m_Camera.Profile = profile;
 
   g_mainHandle->OnConfigChanged();
 }
 
-void CameraManager::SaveProfiles()
+bool CameraManager::StoreProfile(CameraProfile const& profile, bool* pChanged /* = nullptr */)
 {
-  for (auto& profile : m_Profiles)
+  std::string error;
+  if (!m_ProfileStore.Put(profile.Name, PackProfile(profile), pChanged, &error))
   {
-    std::string path = "./Cinematic Tools/Profiles/" + profile.Name + ".ini";
-    std::fstream file;
+    util::log::Error("Could not save camera profile %s. %s", profile.Name.c_str(), error.c_str());
+    return false;
+  }
 
-    file.open(path.c_str(), std::ios_base::out | std::ios_base::trunc);
-    if (!file.is_open())
-    {
-      util::log::Error("Could not open file to save profile %s", path.c_str());
-      continue;
-    }
+  return true;
+}
 
-    file << "[CameraProfile]" << std::endl;
-    file << "Name = " << profile.Name << std::endl;
-    file << "FieldOfView = " << std::to_string(profile.FieldOfView) << std::endl;
-    file << "MovementSpeed = " << std::to_string(profile.MovementSpeed) << std::endl;
-    file << "RotationSpeed = " << std::to_string(profile.RotationSpeed) << std::endl;
-    file << "RollSpeed = " << std::to_string(profile.RollSpeed) << std::endl;
-    file << "FovSpeed = " << std::to_string(profile.FovSpeed) << std::endl;
-    file << "DofScale = " << std::to_string(profile.DofScale) << std::endl;
-    file << "DofStrength = " << std::to_string(profile.DofStrength) << std::endl;
-    file << "FocusDistance = " << std::to_string(profile.FocusDistance) << std::endl;
-    file << "IsProfile = true" << std::endl;
+void CameraManager::SelectProfile(int index)
+{
+  std::string const& name = m_ProfileStore.GetNames().at(index);
 
-    file.close();
+  std::string data;
+  CameraProfile profile;
+  if (!m_ProfileStore.Get(name, data) || !UnpackProfile(name, data, profile))
+  {
+    util::log::Error("Camera profile %s could not be read", name.c_str());
+    return;
   }
+
+  m_SelectedProfile = index;
+  m_Camera.Profile = profile;
+}
+
+void CameraManager::ReloadProfile(std::string const& fileName)
+{
+  if (!boost::iequals(boost::filesystem::path(fileName).extension().string(), ".ini"))
+    return;
+
+  // Deleting the file doesn't delete the profile, the store has its own copy
+  CameraProfile profile;
+  if (!ReadProfile(g_profileDir + fileName, profile))
+    return;
+
+  std::lock_guard<std::mutex> lock(m_ProfileMutex);
+  if (!m_ProfileStore.IsOpen())
+    return;
+
+  bool changed = false;
+  if (!StoreProfile(profile, &changed) || !changed)
+    return;
+
+  m_ProfileStore.Sync();
+  if (m_ProfileStore.Find(profile.Name) == m_SelectedProfile)
+    m_Camera.Profile = profile;
+
+  util::log::Ok("Imported camera profile %s", profile.Name.c_str());
+}
+
+bool CameraManager::ReadProfile(std::string const& path, CameraProfile& profile)
+{
+  INIReader reader(path);
+
+  // Make sure the opened file is actually a camera profile
+  if (!reader.GetBoolean("CameraProfile", "IsProfile", false))
+    return false;
+
+  profile.Name = reader.Get("CameraProfile", "Name", "UNKNOWN");
+  profile.MovementSpeed = static_cast<float>( reader.GetReal("CameraProfile", "MovementSpeed", 1.0f) );
+  profile.RotationSpeed = static_cast<float>( reader.GetReal("CameraProfile", "RotationSpeed", XM_PI / 4) );
+  profile.RollSpeed = static_cast<float>( reader.GetReal("CameraProfile", "RollSpeed", XM_PI / 8) );
+  profile.FovSpeed = static_cast<float>( reader.GetReal("CameraProfile", "FovSpeed", 5.0f) );
+  profile.FieldOfView = static_cast<float>( reader.GetReal("CameraProfile", "FieldOfView", 50.0f) );
+  profile.FocusDistance = static_cast<float>( reader.GetReal("CameraProfile", "FocusDistance", 2.0f) );
+  profile.DofStrength = static_cast<float>( reader.GetReal("CameraProfile", "DofStrength", 0.04f) );
+  profile.DofScale = static_cast<float>( reader.GetReal("CameraProfile", "DofScale", 1.0f) );
+  profile.MouseFilter = static_cast<int>( reader.GetInteger("CameraProfile", "MouseFilter", MouseFilter_Average) );
+  profile.MouseSmoothTime = static_cast<float>( reader.GetReal("CameraProfile", "MouseSmoothTime", 0.2f) );
+  profile.MouseMinCutoff = static_cast<float>( reader.GetReal("CameraProfile", "MouseMinCutoff", 1.0f) );
+  profile.MouseBeta = static_cast<float>( reader.GetReal("CameraProfile", "MouseBeta", 0.005f) );
+
+  if (profile.MouseFilter < 0 || profile.MouseFilter >= MouseFilter_Count)
+    profile.MouseFilter = MouseFilter_Average;
+
+  return true;
+}
+
+std::string CameraManager::PackProfile(CameraProfile const& profile)
+{
+  const float fields[] =
+  {
+    profile.FieldOfView, profile.MovementSpeed, profile.RotationSpeed, profile.RollSpeed,
+    profile.FovSpeed, profile.DofScale, profile.DofStrength, profile.FocusDistance,
+    static_cast<float>(profile.MouseFilter), profile.MouseSmoothTime, profile.MouseMinCutoff, profile.MouseBeta
+  };
+
+  return std::string(reinterpret_cast<const char*>(fields), sizeof(fields));
+}
+
+bool CameraManager::UnpackProfile(std::string const& name, std::string const& data, CameraProfile& profile)
+{
+  if (data.size() % sizeof(float) != 0)
+    return false;
+
+  float mouseFilter = static_cast<float>(profile.MouseFilter);
+  float* fields[] =
+  {
+    &profile.FieldOfView, &profile.MovementSpeed, &profile.RotationSpeed, &profile.RollSpeed,
+    &profile.FovSpeed, &profile.DofScale, &profile.DofStrength, &profile.FocusDistance,
+    &mouseFilter, &profile.MouseSmoothTime, &profile.MouseMinCutoff, &profile.MouseBeta
+  };
+
+  // Fields are only ever added to the end, profiles saved
+  // before that keep the defaults for the new ones
+  size_t count = data.size() / sizeof(float);
+  if (count > sizeof(fields) / sizeof(fields[0]))
+    count = sizeof(fields) / sizeof(fields[0]);
+
+  for (size_t i = 0; i < count; ++i)
+    memcpy(fields[i], data.data() + i * sizeof(float), sizeof(float));
+
+  profile.Name = name;
+  profile.MouseFilter = static_cast<int>(mouseFilter);
+  if (profile.MouseFilter < 0 || profile.MouseFilter >= MouseFilter_Count)
+    profile.MouseFilter = MouseFilter_Average;
+
+  return true;
 }
 
 void CameraManager::ToggleHUD()
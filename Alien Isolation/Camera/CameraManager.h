@@ -1,35 +1,79 @@
 #pragma once
+#include "CameraIntegrator.h"
+#include "PoseFilter.h"
 #include "TrackPlayer.h"
 #include "../inih/cpp/INIReader.h"
 #include "../AlienIsolation.h"
+#include "../Util/RecordStore.h"
+#include "../Util/SeqLock.h"
 
-#include <array>
+#include <atomic>
 #include <boost/chrono/chrono.hpp>
+#include <memory>
+#include <mutex>
 
-struct MouseBuffer
+class InputSystem;
+class OSCReceiver;
+
+// Everything the game thread hooks need to place the camera. A complete
+// copy is published after every update so hooks never see a camera that
+// is halfway through being updated.
+struct CameraState
+{
+  bool Enabled{ false };
+  bool LockToCharacter{ false };
+  CATHODE::Character* pCharacter{ nullptr };
+
+  DirectX::XMFLOAT3 Position{ 0,0,0 };
+  DirectX::XMFLOAT4 Rotation{ 0,0,0,1 };
+
+  float FieldOfView{ 0 };
+  float FocusDistance{ 0 };
+  float DofScale{ 0 };
+  float DofStrength{ 0 };
+
+  // Move the camera in the camera hook with the game's frame time
+  // instead of on the tools thread
+  bool IntegrateInHook{ false };
+  CameraInput Input;
+
+  // Changes whenever the tools thread moves the camera somewhere,
+  // so the hook knows to jump there
+  unsigned int PoseGeneration{ 0 };
+
+  // Set while OSC tracking is on. The hook reads the tracker itself
+  // when it integrates, otherwise it uses the pose read on the tools
+  // thread, relative to the camera.
+  OSCReceiver* pOSCReceiver{ nullptr };
+  PoseFilterSettings OSCFilter;
+  DirectX::XMFLOAT3 OSCPosition{ 0,0,0 };
+  DirectX::XMFLOAT4 OSCRotation{ 0,0,0,1 };
+};
+
+// Camera as it was applied to the game by OnCameraUpdateBegin
+struct CameraView
 {
-  std::array<DirectX::XMFLOAT3, 25> Values{ DirectX::XMFLOAT3(0,0,0) };
-
-  void AddValue(DirectX::XMFLOAT3 const& val)
-  {
-    for (int i = 24; i > 0; i -= 1)
-      Values[i] = Values[i - 1];
-
-    Values[0] = val;
-  }
-
-  DirectX::XMFLOAT3 CalcAverage()
-  {
-    DirectX::XMFLOAT3 avg{ 0,0,0 };
-    for (int i = 0; i < 25; ++i)
-    {
-      avg.x += Values[i].x / 25;
-      avg.y += Values[i].y / 25;
-      avg.z += Values[i].z / 25;
-    }
-
-    return avg;
-  }
+  // Final transform after it's been made relative to the target
+  DirectX::XMFLOAT3 Position{ 0,0,0 };
+  DirectX::XMFLOAT4 Rotation{ 0,0,0,1 };
+
+  // Relative to the target like Camera::Position/Rotation, so the tools
+  // thread can follow a camera that is moved by the hook
+  DirectX::XMFLOAT3 LocalPosition{ 0,0,0 };
+  DirectX::XMFLOAT4 LocalRotation{ 0,0,0,1 };
+  unsigned int PoseGeneration{ 0 };
+
+  // The hook moved the camera and advanced the track for this view
+  bool Integrated{ false };
+
+  // Tracker pose on top of the local one, not part of it
+  DirectX::XMFLOAT3 OSCPosition{ 0,0,0 };
+  DirectX::XMFLOAT4 OSCRotation{ 0,0,0,1 };
+
+  float FieldOfView{ 0 };
+  float FocusDistance{ 0 };
+  float DofScale{ 0 };
+  float DofStrength{ 0 };
 };
 
 class CameraManager
@@ -48,7 +92,7 @@ public:
   void OnPostProcessUpdate(CATHODE::PostProcess* pPostProcess);
   void OnMapChange();
 
-  void HotkeyUpdate();
+  void SubscribeHotkeys(InputSystem* pInput);
   void Update(float dt);
   void DrawUI();
   void DrawTrack() { if(m_CameraEnabled) m_TrackPlayer.DrawNodes(); }
@@ -60,7 +104,11 @@ public:
   void ReadConfig(INIReader* pReader);
   const std::string GetConfig();
 
-  Camera const& GetCamera() { return m_Camera; }
+  // Imports a profile file that was added or edited in the profiles folder
+  void ReloadProfile(std::string const& fileName);
+
+  // Returns false if the view is being written, keep the previous one then
+  bool GetCameraView(CameraView& view) const { return m_ViewChannel.TryLoad(view); }
 
 private:
   // Updates camera position and rotation
@@ -69,6 +117,19 @@ private:
   // Updates camera input states
   void UpdateInput(float dt);
 
+  // Copies the camera for the game thread hooks
+  void PublishState(bool integrateInHook);
+
+  // Moves the camera on the game thread in fixed steps, when
+  // IntegrateInHook is set
+  void IntegrateCamera(CameraState const& state, float dt, CameraView& view);
+
+  // Takes over the pose the hook moved the camera to
+  void FollowHookCamera(CameraView const& view);
+
+  // Moves the camera to where the track was scrubbed to
+  void PreviewTrack();
+
   void ToggleCamera();
   void ResetCamera();
 
@@ -77,15 +138,27 @@ private:
   void ChangeCamRelativity();
 
   // Gets target character transform
-  XMMATRIX GetTargetMatrix();
+  XMMATRIX GetTargetMatrix(CATHODE::Character* pCharacter);
 
-  // Creates a new profile based on current camera settings
+  // Creates a new profile based on current camera settings,
+  // m_ProfileMutex has to be held
   void CreateProfile();
 
-  // Loads camera profiles from files
+  // Opens the profile store, the first time it's
+  // filled from the old profile files
   void LoadProfiles();
-  // Saves camera profiles to files
-  void SaveProfiles();
+  void ImportProfiles();
+
+  // m_ProfileMutex has to be held for these
+  bool StoreProfile(CameraProfile const& profile, bool* pChanged = nullptr);
+  void SelectProfile(int index);
+
+  // Returns false if the file isn't a camera profile
+  static bool ReadProfile(std::string const& path, CameraProfile& profile);
+
+  // Profiles are kept in the store as their fields in binary
+  static std::string PackProfile(CameraProfile const& profile);
+  static bool UnpackProfile(std::string const& name, std::string const& data, CameraProfile& profile);
 
   void ToggleHUD();
 
@@ -104,18 +177,61 @@ private:
 
   bool m_HideUI;
 
+  // The receiver listens on a UDP port, so it's only created once
+  // OSC tracking is turned on. It's kept until shutdown after that.
+  bool m_UseOSC;
+  bool m_UIRequestOSCReset;
+  std::unique_ptr<OSCReceiver> m_pOSCReceiver;
+  PoseFilterSettings m_OSCFilter;
+
+  // Read by UpdateCamera while the tools thread moves the camera
+  DirectX::XMFLOAT3 m_OSCPosition;
+  DirectX::XMFLOAT4 m_OSCRotation;
+
   Camera m_Camera;
   TrackPlayer m_TrackPlayer;
 
+  // Written by Update on the tools thread. Each hook keeps the last
+  // state it read, in case a read overlaps a write.
+  util::SeqLock<CameraState> m_StateChannel;
+  CameraState m_CameraHookState;
+  CameraState m_PostProcessHookState;
+
+  // Written by OnCameraUpdateBegin, read by the renderer
+  // and the tools thread
+  util::SeqLock<CameraView> m_ViewChannel;
+  CameraView m_PostProcessHookView;
+
+  bool m_IntegrateInHook;
+  std::atomic<unsigned int> m_PoseGeneration;
+
+  // Only used by the tools thread. The hook keeps moving the camera
+  // and playing tracks until it has shown a view without doing so,
+  // so both threads never advance playback in the same frame.
+  bool m_HookIntegrated;
+  bool m_HookOwnsCamera;
+
+  // Only used by the camera hook
+  CameraIntegrator m_Integrator;
+  bool m_HookIntegrating;
+  unsigned int m_HookPoseGeneration;
   boost::chrono::high_resolution_clock::time_point m_dtCameraUpdate;
-  MouseBuffer m_MouseBuffer;
-  bool m_SmoothMouse;
+
+  // Mouse filters, updated by UpdateInput on the tools thread
+  WindowedAverage m_MouseAverage;
+  OneEuroFilter m_MouseOneEuro;
+  WindowedAverage m_WheelAverage;
 
   bool m_ShowProfileModal;
   char m_ModalProfileName[50];
-  std::vector<CameraProfile> m_Profiles;
+  // Only the names are kept in memory, a profile
+  // is read from the store when it's selected
+  util::RecordStore m_ProfileStore;
   int m_SelectedProfile;
 
+  // Profiles are imported on the tools thread while the UI shows them
+  std::mutex m_ProfileMutex;
+
   float m_TimeScale;
 
 public:
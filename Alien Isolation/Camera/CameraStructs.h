@@ -1,10 +1,16 @@
 #pragma once
+#include "MouseFilter.h"
+#include "TrackPreview.h"
+#include "../Rendering/CTRenderer.h"
 #include <d3d11.h>
 #include <DirectXMath.h>
+#include <memory>
 #include <vector>
 #include <VertexTypes.h>
 #include <wrl.h>
 
+class TrackSnapshot;
+
 struct CatmullRomNode
 {
   DirectX::XMFLOAT3 Position;
@@ -28,6 +34,10 @@ struct CameraProfile
   float DofScale{ 1.0f };
   float DofStrength{ 0.04f };
   float FocusDistance{ 2.f };
+  int MouseFilter{ MouseFilter_Average };
+  float MouseSmoothTime{ 0.2f }; // Seconds
+  float MouseMinCutoff{ 1.f };
+  float MouseBeta{ 0.005f };
 };
 
 struct Camera
@@ -48,28 +58,19 @@ struct Camera
   float dDofStrength{ 0 };
   float dDofScale{ 0 };
 
-  DirectX::XMFLOAT3 AbsolutePosition{ 0,0,0 };
-  DirectX::XMFLOAT4 AbsoluteRotation{ 0,0,0,1 };
   DirectX::XMFLOAT4X4 TargetMatrix{ 1,0,0,0,
     0,1,0,0,
     0,0,1,0,
     0,0,0,1 };
 };
 
-// Structure for interpolating irregularly timed nodes
-struct SmoothNode
-{
-  float Time;
-  float Value;
-};
-
 struct CameraTrack
 {
   std::string Name;
-  std::vector<CatmullRomNode> Nodes;
-  std::vector<SmoothNode> SmoothNodes;
-  Microsoft::WRL::ComPtr<ID3D11Buffer> Vertices;
-  Microsoft::WRL::ComPtr<ID3D11Buffer> Indices;
+  std::shared_ptr<TrackSnapshot const> Snapshot; // Replaced as a whole on every edit
+  TrackPreview Preview;
+  GrowableBuffer Vertices;
+  GrowableBuffer Indices;
   unsigned int IndexCount{ 0 };
 
   CameraTrack(std::string const& name)
@@ -0,0 +1,81 @@
+#pragma once
+
+enum MouseFilterType
+{
+  MouseFilter_None,
+  MouseFilter_Average,
+  MouseFilter_OneEuro,
+  MouseFilter_Count
+};
+
+// Filters take the mouse counts moved since the last update and the
+// time that passed, and give back a velocity in counts per second.
+// Working with time instead of sample counts keeps the smoothing the
+// same whatever the frame rate is.
+//
+// Doesn't depend on Windows or DirectX headers, values are x, y, wheel.
+
+// Average velocity over the last Window seconds. Samples are kept in a
+// ring with running sums, so an update costs the same for any window.
+class WindowedAverage
+{
+public:
+  // Enough for a half second window at 1000 fps. With more samples
+  // than this in the window the oldest are dropped early.
+  static const int MaxSamples = 512;
+
+  explicit WindowedAverage(float window = 0.2f);
+
+  void SetWindow(float window) { m_Window = window; }
+  void Reset();
+
+  void Update(float const* pDelta, float dt, float* pVelocity);
+
+private:
+  void RemoveOldest();
+
+private:
+  struct Sample
+  {
+    float Delta[3];
+    float dt;
+  };
+
+  float m_Window;
+
+  Sample m_Samples[MaxSamples];
+  int m_First;
+  int m_Count;
+
+  double m_SumDelta[3];
+  double m_SumTime;
+};
+
+// One Euro filter (Casiez et al. 2012) on the position the mouse has
+// moved to. Slow movement gets a low cutoff and is smoothed a lot, fast
+// movement raises the cutoff so pans don't lag behind.
+//
+// MinCutoff is in Hz, Beta is how much the cutoff rises per count/s.
+class OneEuroFilter
+{
+public:
+  OneEuroFilter(float minCutoff = 1.f, float beta = 0.005f, float derivativeCutoff = 1.f);
+
+  void SetParameters(float minCutoff, float beta);
+  void Reset();
+
+  void Update(float const* pDelta, float dt, float* pVelocity);
+
+  static float Alpha(float cutoff, float dt);
+
+private:
+  float m_MinCutoff;
+  float m_Beta;
+  float m_DerivativeCutoff;
+
+  // Only the distance between the raw and filtered positions is kept,
+  // so precision doesn't run out however far the mouse travels
+  float m_Lag[3];
+  float m_Velocity[3]; // Filtered derivative that drives the cutoff
+  bool m_First;
+};
@@ -0,0 +1,392 @@
+#include "OSCDispatcher.h"
+#include <cstring>
+
+namespace
+{
+  bool IsPatternChar(char c)
+  {
+    return c == '?' || c == '*' || c == '[' || c == ']' || c == '{' || c == '}' || c == ',';
+  }
+
+  // FNV-1a
+  uint32_t Hash(const char* pData, size_t length)
+  {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; ++i)
+    {
+      hash ^= static_cast<unsigned char>(pData[i]);
+      hash *= 16777619u;
+    }
+
+    return hash;
+  }
+
+  bool IsPattern(const char* pSegment, size_t length)
+  {
+    for (size_t i = 0; i < length; ++i)
+    {
+      if (IsPatternChar(pSegment[i]))
+        return true;
+    }
+
+    return false;
+  }
+}
+
+OSCDispatcher::OSCDispatcher() :
+  m_Nodes(1)
+{
+
+}
+
+bool OSCDispatcher::BindFloat(std::string const& address, float* pValue)
+{
+  Method method;
+  method.Type = Method_Float;
+  method.pFloat = pValue;
+  return AddMethod(address, method);
+}
+
+bool OSCDispatcher::BindBool(std::string const& address, bool* pValue)
+{
+  Method method;
+  method.Type = Method_Bool;
+  method.pBool = pValue;
+  return AddMethod(address, method);
+}
+
+bool OSCDispatcher::BindButton(std::string const& address, std::function<void()> const& func)
+{
+  Method method;
+  method.Type = Method_Button;
+  method.Button = func;
+  return AddMethod(address, method);
+}
+
+bool OSCDispatcher::Bind(std::string const& address, OSCMessageHandler const& handler)
+{
+  Method method;
+  method.Type = Method_Handler;
+  method.Handler = handler;
+  return AddMethod(address, method);
+}
+
+bool OSCDispatcher::AddMethod(std::string const& address, Method& method)
+{
+  if (address.empty() || address[0] != '/' || IsPattern(address.c_str(), address.size()))
+    return false;
+
+  method.Address = address;
+  method.Hash = Hash(address.c_str(), address.size());
+
+  int methodIndex = FindMethod(address.c_str(), address.size(), method.Hash);
+  if (methodIndex >= 0)
+  {
+    m_Methods[methodIndex] = method;
+    return true;
+  }
+
+  // Add the path to the trie first, it can still turn out to be invalid
+  int nodeIndex = 0;
+  size_t segmentStart = 1;
+
+  while (segmentStart <= address.size())
+  {
+    size_t segmentEnd = address.find('/', segmentStart);
+    if (segmentEnd == std::string::npos)
+      segmentEnd = address.size();
+
+    if (segmentEnd == segmentStart)
+      return false;
+
+    std::string name = address.substr(segmentStart, segmentEnd - segmentStart);
+
+    int childIndex = -1;
+    for (int i : m_Nodes[nodeIndex].Children)
+    {
+      if (m_Nodes[i].Name == name)
+        childIndex = i;
+    }
+
+    if (childIndex < 0)
+    {
+      childIndex = static_cast<int>(m_Nodes.size());
+      m_Nodes[nodeIndex].Children.push_back(childIndex);
+
+      m_Nodes.emplace_back();
+      m_Nodes.back().Name = name;
+    }
+
+    nodeIndex = childIndex;
+    segmentStart = segmentEnd + 1;
+  }
+
+  m_Nodes[nodeIndex].MethodIndex = static_cast<int>(m_Methods.size());
+  m_Methods.push_back(method);
+  Rehash();
+
+  return true;
+}
+
+int OSCDispatcher::FindMethod(const char* address, size_t length, uint32_t hash) const
+{
+  if (m_Slots.empty())
+    return -1;
+
+  size_t mask = m_Slots.size() - 1;
+  for (size_t slot = hash & mask; m_Slots[slot] >= 0; slot = (slot + 1) & mask)
+  {
+    Method const& method = m_Methods[m_Slots[slot]];
+    if (method.Hash == hash && method.Address.size() == length
+      && memcmp(method.Address.data(), address, length) == 0)
+      return m_Slots[slot];
+  }
+
+  return -1;
+}
+
+void OSCDispatcher::Rehash()
+{
+  // Bindings are rare, so everything is simply inserted again
+  size_t size = 16;
+  while (size < m_Methods.size() * 2)
+    size *= 2;
+
+  m_Slots.assign(size, -1);
+  size_t mask = size - 1;
+
+  for (int methodIndex = 0; methodIndex < static_cast<int>(m_Methods.size()); ++methodIndex)
+  {
+    size_t slot = m_Methods[methodIndex].Hash & mask;
+    while (m_Slots[slot] >= 0)
+      slot = (slot + 1) & mask;
+
+    m_Slots[slot] = methodIndex;
+  }
+}
+
+int OSCDispatcher::Dispatch(OSCMessage const& message, std::vector<Call>* pCalls /* = nullptr */) const
+{
+  const char* address = message.GetAddress();
+  if (address[0] != '/')
+    return 0;
+
+  // Hash and look for pattern characters in one pass
+  uint32_t hash = 2166136261u;
+  bool isPattern = false;
+
+  size_t length = 0;
+  for (char c = address[0]; c != '\0'; c = address[++length])
+  {
+    isPattern |= IsPatternChar(c);
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 16777619u;
+  }
+
+  if (isPattern)
+    return Walk(0, address + 1, message, pCalls);
+
+  int methodIndex = FindMethod(address, length, hash);
+  if (methodIndex < 0)
+    return 0;
+
+  Invoke(m_Methods[methodIndex], message, pCalls);
+  return 1;
+}
+
+int OSCDispatcher::Walk(int nodeIndex, const char* pSegment, OSCMessage const& message, std::vector<Call>* pCalls) const
+{
+  bool isPattern = false;
+  size_t length = 0;
+  for (char c = pSegment[0]; c != '\0' && c != '/'; c = pSegment[++length])
+    isPattern |= IsPatternChar(c);
+
+  const char* pNext = pSegment[length] == '/' ? pSegment + length + 1 : nullptr;
+
+  int count = 0;
+  auto visit = [&](int childIndex)
+  {
+    if (pNext)
+      count += Walk(childIndex, pNext, message, pCalls);
+    else if (m_Nodes[childIndex].MethodIndex >= 0)
+    {
+      Invoke(m_Methods[m_Nodes[childIndex].MethodIndex], message, pCalls);
+      count++;
+    }
+  };
+
+  if (isPattern)
+  {
+    for (int childIndex : m_Nodes[nodeIndex].Children)
+    {
+      std::string const& name = m_Nodes[childIndex].Name;
+      if (MatchSegment(pSegment, length, name.c_str(), name.size()))
+        visit(childIndex);
+    }
+  }
+  else
+  {
+    for (int childIndex : m_Nodes[nodeIndex].Children)
+    {
+      std::string const& name = m_Nodes[childIndex].Name;
+      if (name.size() == length && memcmp(name.data(), pSegment, length) == 0)
+      {
+        visit(childIndex);
+        break;
+      }
+    }
+  }
+
+  return count;
+}
+
+void OSCDispatcher::Invoke(Method const& method, OSCMessage const& message, std::vector<Call>* pCalls) const
+{
+  // Every method reads the arguments from the start
+  OSCMessage args = message;
+
+  switch (method.Type)
+  {
+  case Method_Float:
+    args.ReadFloat(*method.pFloat);
+    break;
+  case Method_Bool:
+    args.ReadBool(*method.pBool);
+    break;
+  case Method_Button:
+  {
+    bool pressed = true;
+    if (args.HasMoreArguments())
+      args.ReadBool(pressed);
+
+    if (!pressed)
+      break;
+
+    if (pCalls)
+      pCalls->emplace_back(method.Button, nullptr, message);
+    else
+      method.Button();
+    break;
+  }
+  case Method_Handler:
+    if (pCalls)
+      pCalls->emplace_back(nullptr, method.Handler, message);
+    else
+      method.Handler(args);
+    break;
+  }
+}
+
+void OSCDispatcher::Call::Run()
+{
+  if (Button)
+    Button();
+  else if (Handler)
+    Handler(Message);
+}
+
+bool OSCDispatcher::MatchSegment(const char* pattern, size_t patternLength, const char* name, size_t nameLength)
+{
+  while (patternLength > 0)
+  {
+    switch (*pattern)
+    {
+    case '?':
+      if (nameLength == 0)
+        return false;
+
+      pattern++; patternLength--;
+      name++; nameLength--;
+      break;
+
+    case '*':
+    {
+      while (patternLength > 0 && *pattern == '*')
+      {
+        pattern++;
+        patternLength--;
+      }
+
+      if (patternLength == 0)
+        return true;
+
+      for (size_t skip = 0; skip <= nameLength; ++skip)
+      {
+        if (MatchSegment(pattern, patternLength, name + skip, nameLength - skip))
+          return true;
+      }
+
+      return false;
+    }
+
+    case '[':
+    {
+      const char* pClose = static_cast<const char*>(memchr(pattern + 1, ']', patternLength - 1));
+      if (!pClose || nameLength == 0)
+        return false;
+
+      const char* p = pattern + 1;
+      bool negate = p < pClose && *p == '!';
+      if (negate)
+        p++;
+
+      bool found = false;
+      while (p < pClose)
+      {
+        if (p + 2 < pClose && p[1] == '-')
+        {
+          found |= *name >= p[0] && *name <= p[2];
+          p += 3;
+        }
+        else
+          found |= *name == *p++;
+      }
+
+      if (found == negate)
+        return false;
+
+      patternLength -= pClose + 1 - pattern;
+      pattern = pClose + 1;
+      name++; nameLength--;
+      break;
+    }
+
+    case '{':
+    {
+      const char* pClose = static_cast<const char*>(memchr(pattern + 1, '}', patternLength - 1));
+      if (!pClose)
+        return false;
+
+      const char* pRest = pClose + 1;
+      size_t restLength = patternLength - (pRest - pattern);
+
+      const char* pOption = pattern + 1;
+      while (true)
+      {
+        const char* pComma = static_cast<const char*>(memchr(pOption, ',', pClose - pOption));
+        const char* pOptionEnd = pComma ? pComma : pClose;
+        size_t optionLength = pOptionEnd - pOption;
+
+        if (optionLength <= nameLength && memcmp(pOption, name, optionLength) == 0
+          && MatchSegment(pRest, restLength, name + optionLength, nameLength - optionLength))
+          return true;
+
+        if (!pComma)
+          return false;
+
+        pOption = pComma + 1;
+      }
+    }
+
+    default:
+      if (nameLength == 0 || *name != *pattern)
+        return false;
+
+      pattern++; patternLength--;
+      name++; nameLength--;
+      break;
+    }
+  }
+
+  return nameLength == 0;
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "OSCPacket.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+// Sends OSC messages to the methods bound to their address, nothing is
+// allocated per message. Plain addresses are looked up whole in an open
+// addressing hash table.
+//
+// Incoming addresses may also use the OSC 1.0 patterns ? * [a-z] [!abc]
+// and {foo,bar} inside a segment, the message then goes to every method
+// that matches. Those walk a trie of the bound path segments.
+//
+// Doesn't depend on Windows headers.
+class OSCDispatcher
+{
+public:
+  // A button or handler that a message went to. Their code can do
+  // anything, including binding, so the caller may want to run them
+  // after letting go of its locks.
+  struct Call
+  {
+    Call(std::function<void()> const& button, OSCMessageHandler const& handler, OSCMessage const& message) :
+      Button(button), Handler(handler), Message(message) { }
+
+    std::function<void()> Button;
+    OSCMessageHandler Handler;
+    OSCMessage Message; // Points into the packet, run before it's reused
+
+    void Run();
+  };
+
+  OSCDispatcher();
+
+  // Addresses have to start with / and can't contain pattern characters
+  // or empty segments, returns false if they do. Binding an address again
+  // replaces the old method.
+  bool BindFloat(std::string const& address, float* pValue);
+  bool BindBool(std::string const& address, bool* pValue);
+
+  // Called when the first argument is true, or if there are no arguments.
+  // Control surfaces send false when the button is released again.
+  bool BindButton(std::string const& address, std::function<void()> const& func);
+
+  bool Bind(std::string const& address, OSCMessageHandler const& handler);
+
+  // Returns how many methods the message went to. Floats and bools are
+  // written right away. Buttons and handlers are added to pCalls if
+  // it's given, otherwise they're called right away too.
+  int Dispatch(OSCMessage const& message, std::vector<Call>* pCalls = nullptr) const;
+
+  static bool MatchSegment(const char* pattern, size_t patternLength, const char* name, size_t nameLength);
+
+private:
+  enum MethodType
+  {
+    Method_Float,
+    Method_Bool,
+    Method_Button,
+    Method_Handler
+  };
+
+  struct Method
+  {
+    std::string Address;
+    uint32_t Hash;
+    MethodType Type;
+    float* pFloat{ nullptr };
+    bool* pBool{ nullptr };
+    std::function<void()> Button;
+    OSCMessageHandler Handler;
+  };
+
+  struct Node
+  {
+    std::string Name;
+    std::vector<int> Children;
+    int MethodIndex{ -1 };
+  };
+
+  bool AddMethod(std::string const& address, Method& method);
+  int FindMethod(const char* address, size_t length, uint32_t hash) const;
+  void Rehash();
+
+  int Walk(int nodeIndex, const char* pSegment, OSCMessage const& message, std::vector<Call>* pCalls) const;
+  void Invoke(Method const& method, OSCMessage const& message, std::vector<Call>* pCalls) const;
+
+private:
+  std::vector<Node> m_Nodes; // Root is at 0
+  std::vector<Method> m_Methods;
+
+  // Method indices, -1 if empty. Size is a power of two and kept at
+  // least twice the number of methods so probes stay short.
+  std::vector<int> m_Slots;
+};
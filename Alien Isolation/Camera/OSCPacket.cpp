@@ -0,0 +1,245 @@
+#include "OSCPacket.h"
+#include <cstring>
+
+namespace
+{
+  // Bundles inside bundles deeper than this are treated as malformed
+  const int MaxBundleDepth = 8;
+
+  const char BundleTag[8] = { '#', 'b', 'u', 'n', 'd', 'l', 'e', '\0' };
+
+  // Everything in OSC is big endian and padded to four bytes
+  uint32_t ReadUInt32(const char* pData)
+  {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(pData);
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+  }
+
+  uint64_t ReadUInt64(const char* pData)
+  {
+    return (uint64_t(ReadUInt32(pData)) << 32) | ReadUInt32(pData + 4);
+  }
+
+  size_t Pad(size_t size)
+  {
+    return (size + 3) & ~size_t(3);
+  }
+
+  // Size of the string at the start of the range including padding,
+  // or 0 if it isn't terminated inside the range
+  size_t StringSize(const char* pData, size_t length)
+  {
+    const void* pNull = memchr(pData, '\0', length);
+    if (!pNull)
+      return 0;
+
+    size_t size = Pad(static_cast<const char*>(pNull) - pData + 1);
+    return size <= length ? size : 0;
+  }
+
+  bool ParseMessage(const char* pData, size_t length, uint64_t timeTag, OSCMessageHandler const& handler)
+  {
+    if (pData[0] != '/')
+      return false;
+
+    size_t addressSize = StringSize(pData, length);
+    if (addressSize == 0)
+      return false;
+
+    // Very old senders leave out the type tags, then there are no
+    // arguments that could be read safely
+    const char* types = "";
+    size_t argsOffset = length;
+
+    if (addressSize < length && pData[addressSize] == ',')
+    {
+      size_t typesSize = StringSize(pData + addressSize, length - addressSize);
+      if (typesSize == 0)
+        return false;
+
+      types = pData + addressSize + 1;
+      argsOffset = addressSize + typesSize;
+    }
+
+    OSCMessage message(pData, types, pData + argsOffset, pData + length, timeTag);
+    handler(message);
+    return true;
+  }
+
+  bool ParsePacket(const char* pData, size_t length, uint64_t timeTag, int depth, OSCMessageHandler const& handler)
+  {
+    if (length == 0)
+      return false;
+
+    if (length < sizeof(BundleTag) || memcmp(pData, BundleTag, sizeof(BundleTag)) != 0)
+      return ParseMessage(pData, length, timeTag, handler);
+
+    if (depth >= MaxBundleDepth || length < 16)
+      return false;
+
+    uint64_t bundleTimeTag = ReadUInt64(pData + 8);
+
+    size_t offset = 16;
+    while (offset < length)
+    {
+      if (length - offset < 4)
+        return false;
+
+      size_t elementSize = ReadUInt32(pData + offset);
+      offset += 4;
+
+      if (elementSize > length - offset)
+        return false;
+
+      if (!ParsePacket(pData + offset, elementSize, bundleTimeTag, depth + 1, handler))
+        return false;
+
+      offset += elementSize;
+    }
+
+    return true;
+  }
+}
+
+OSCMessage::OSCMessage(const char* address, const char* types, const char* pArgs, const char* pEnd, uint64_t timeTag) :
+  m_Address(address),
+  m_Types(types),
+  m_pNextType(types),
+  m_pNextArg(pArgs),
+  m_pEnd(pEnd),
+  m_TimeTag(timeTag)
+{
+
+}
+
+char OSCMessage::NextArgument(const char*& pArg)
+{
+  char type = *m_pNextType;
+  if (type == '\0')
+    return 0;
+
+  size_t available = m_pEnd - m_pNextArg;
+  size_t size = 0;
+
+  switch (type)
+  {
+  case 'i': case 'f': case 'c': case 'r': case 'm':
+    size = 4;
+    break;
+  case 'h': case 't': case 'd':
+    size = 8;
+    break;
+  case 's': case 'S':
+    size = available > 0 ? StringSize(m_pNextArg, available) : 0;
+    if (size == 0)
+      size = available + 1; // Unterminated, fails below
+    break;
+  case 'b':
+    if (available >= 4 && ReadUInt32(m_pNextArg) <= available - 4)
+      size = 4 + Pad(ReadUInt32(m_pNextArg));
+    else
+      size = available + 1;
+    break;
+  case 'T': case 'F': case 'N': case 'I': case '[': case ']':
+    break;
+  default:
+    // Can't know how much to skip, so the rest can't be read
+    size = available + 1;
+    break;
+  }
+
+  if (size > available)
+  {
+    m_pNextType = "";
+    return 0;
+  }
+
+  pArg = m_pNextArg;
+  m_pNextArg += size;
+  m_pNextType++;
+  return type;
+}
+
+bool OSCMessage::ReadFloat(float& value)
+{
+  const char* pArg = nullptr;
+  switch (NextArgument(pArg))
+  {
+  case 'f':
+  {
+    uint32_t bits = ReadUInt32(pArg);
+    memcpy(&value, &bits, sizeof(value));
+    return true;
+  }
+  case 'd':
+  {
+    uint64_t bits = ReadUInt64(pArg);
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    value = static_cast<float>(d);
+    return true;
+  }
+  case 'i':
+    value = static_cast<float>(static_cast<int32_t>(ReadUInt32(pArg)));
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool OSCMessage::ReadInt32(int32_t& value)
+{
+  const char* pArg = nullptr;
+  switch (NextArgument(pArg))
+  {
+  case 'i':
+    value = static_cast<int32_t>(ReadUInt32(pArg));
+    return true;
+  case 'T':
+    value = 1;
+    return true;
+  case 'F':
+    value = 0;
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool OSCMessage::ReadBool(bool& value)
+{
+  const char* pArg = nullptr;
+  switch (NextArgument(pArg))
+  {
+  case 'T':
+    value = true;
+    return true;
+  case 'F':
+    value = false;
+    return true;
+  case 'i':
+    value = ReadUInt32(pArg) != 0;
+    return true;
+  case 'f':
+  {
+    // Faders and buttons on control surfaces often send floats
+    uint32_t bits = ReadUInt32(pArg);
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    value = f != 0;
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+bool ParseOSCPacket(const char* pData, size_t length, OSCMessageHandler const& handler)
+{
+  return ParsePacket(pData, length, OSCTimeTagImmediately, 0, handler);
+}
+
+double OSCTimeTagToSeconds(uint64_t timeTag)
+{
+  return (timeTag >> 32) + (timeTag & 0xFFFFFFFF) / 4294967296.0;
+}
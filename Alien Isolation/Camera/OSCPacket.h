@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// OSC 1.0 packet parsing. Works in place on the received datagram,
+// nothing is copied or allocated.
+//
+// Doesn't depend on Windows headers.
+
+// NTP format, seconds since 1900 in the high 32 bits and the fraction
+// in the low 32 bits. Messages outside of a bundle get Immediately.
+const uint64_t OSCTimeTagImmediately = 1;
+
+class OSCMessage
+{
+public:
+  OSCMessage(const char* address, const char* types, const char* pArgs, const char* pEnd, uint64_t timeTag);
+
+  const char* GetAddress() const { return m_Address; }
+  const char* GetTypes() const { return m_Types; } // Without the leading comma
+  uint64_t GetTimeTag() const { return m_TimeTag; }
+
+  // Each read takes the next argument. They return false and leave
+  // value untouched if there are no arguments left or the next one
+  // can't be converted, the argument is skipped either way.
+  bool ReadFloat(float& value);
+  bool ReadInt32(int32_t& value);
+  bool ReadBool(bool& value);
+
+  bool HasMoreArguments() const { return *m_pNextType != '\0'; }
+
+private:
+  // Returns the type of the next argument and points pArg at its data,
+  // or returns 0 if there's nothing left
+  char NextArgument(const char*& pArg);
+
+private:
+  const char* m_Address;
+  const char* m_Types;
+  const char* m_pNextType;
+  const char* m_pNextArg;
+  const char* m_pEnd;
+  uint64_t m_TimeTag;
+};
+
+typedef std::function<void(OSCMessage&)> OSCMessageHandler;
+
+// Calls handler for every message in the packet in order, including
+// the messages in nested bundles. Messages get the time tag of the
+// innermost bundle they're in.
+//
+// Returns false if the packet is malformed. Messages before the error
+// have been handled by then.
+bool ParseOSCPacket(const char* pData, size_t length, OSCMessageHandler const& handler);
+
+// Seconds since 1900
+double OSCTimeTagToSeconds(uint64_t timeTag);
@@ -0,0 +1,81 @@
+#include "OSCPose.h"
+#include <cstring>
+
+const uint32_t OSCPoseHistory::Size;
+
+OSCPoseStream::OSCPoseStream() :
+  m_Pending(),
+  m_Changed(false),
+  m_History()
+{
+  m_Pending.Rotation[3] = 1;
+  m_Pending.TimeTag = OSCTimeTagImmediately;
+}
+
+bool OSCPoseStream::HandleMessage(OSCMessage& message)
+{
+  const char* address = message.GetAddress();
+
+  float* pTarget = nullptr;
+  int count = 0;
+
+  if (strcmp(address, "/position") == 0)
+  {
+    pTarget = m_Pending.Position;
+    count = 3;
+  }
+  else if (strcmp(address, "/rotation") == 0)
+  {
+    pTarget = m_Pending.Rotation;
+    count = 4;
+  }
+  else
+    return false;
+
+  // Only take messages that have every component
+  float values[4];
+  for (int i = 0; i < count; ++i)
+  {
+    if (!message.ReadFloat(values[i]))
+      return true;
+  }
+
+  memcpy(pTarget, values, count * sizeof(float));
+  m_Pending.TimeTag = message.GetTimeTag();
+  m_Changed = true;
+  return true;
+}
+
+void OSCPoseStream::EndPacket(double receiveTime)
+{
+  if (!m_Changed)
+    return;
+
+  m_Pending.ReceiveTime = receiveTime;
+  m_Pending.Sequence++;
+
+  m_History.Poses[m_Pending.Sequence % OSCPoseHistory::Size] = m_Pending;
+  m_History.Newest = m_Pending.Sequence;
+  m_Channel.Store(m_History);
+  m_Changed = false;
+}
+
+bool OSCPoseStream::TryLoad(OSCPose& pose) const
+{
+  OSCPoseHistory history;
+  if (!TryLoadHistory(history))
+    return false;
+
+  pose = history.Poses[history.Newest % OSCPoseHistory::Size];
+  return true;
+}
+
+bool OSCPoseStream::TryLoadHistory(OSCPoseHistory& history) const
+{
+  OSCPoseHistory loaded;
+  if (!m_Channel.TryLoad(loaded) || loaded.Newest == 0)
+    return false;
+
+  history = loaded;
+  return true;
+}
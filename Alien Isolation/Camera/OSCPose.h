@@ -0,0 +1,57 @@
+#pragma once
+#include "OSCPacket.h"
+#include "../Util/SeqLock.h"
+
+// Pose of the tracked device as it was sent, before any rebasing
+struct OSCPose
+{
+  float Position[3];
+  float Rotation[4]; // Quaternion, x y z w
+  uint64_t TimeTag;   // Of the bundle it came in, OSCTimeTagImmediately if none
+  double ReceiveTime; // Seconds, on the receiver's clock
+  uint32_t Sequence;  // Number of poses published so far
+};
+
+// The latest poses, so a reader that's slower than the tracker
+// doesn't miss any
+struct OSCPoseHistory
+{
+  static const uint32_t Size = 16;
+
+  OSCPose Poses[Size]; // Pose n is at n % Size
+  uint32_t Newest;     // 0 if nothing has been received
+};
+
+// Collects /position and /rotation messages on the receive thread and
+// publishes them as whole poses. Everything from one datagram, usually
+// a bundle, goes out at once so readers never get the position of one
+// sample with the rotation of another.
+//
+// Doesn't depend on Windows headers.
+class OSCPoseStream
+{
+public:
+  OSCPoseStream();
+
+  // Receive thread. Returns false if the message isn't part of a pose.
+  bool HandleMessage(OSCMessage& message);
+
+  // Receive thread, after every datagram
+  void EndPacket(double receiveTime);
+
+  // Any thread. Return false if nothing has been received yet or
+  // the read kept overlapping writes.
+  bool TryLoad(OSCPose& pose) const;
+  bool TryLoadHistory(OSCPoseHistory& history) const;
+
+private:
+  OSCPose m_Pending;
+  bool m_Changed;
+
+  OSCPoseHistory m_History;
+  util::SeqLock<OSCPoseHistory> m_Channel;
+
+public:
+  OSCPoseStream(OSCPoseStream const&) = delete;
+  void operator=(OSCPoseStream const&) = delete;
+};
@@ -1,17 +1,38 @@
 #include "OSCReceiver.h"
+#include <WinSock2.h>
 #include "../Main.h"
 #include "../Util/Util.h"
+#include <boost/chrono/chrono.hpp>
+#include <cstring>
 #include <thread>
 
 #pragma comment(lib,"Ws2_32.lib")
 
-const size_t BUFLEN = 512;
+const size_t BUFLEN = 65536;
 const USHORT PORT = 8001;
 const u_long MODE = 1; // If != 0, non-blocking is enabled
+const double UNKNOWN_WARNING_INTERVAL = 1.0; // Seconds
 
+double OSCReceiver::GetTime()
+{
+  static const auto startTime = boost::chrono::high_resolution_clock::now();
+  boost::chrono::duration<double> time = boost::chrono::high_resolution_clock::now() - startTime;
+  return time.count();
+}
 
-OSCReceiver::OSCReceiver()
+OSCReceiver::OSCReceiver() :
+  m_Buffer(BUFLEN),
+  m_PoseHistory(),
+  m_LastSequence(0),
+  m_OriginPosition(0, 0, 0),
+  m_OriginRotation(0, 0, 0, 1),
+  m_OriginRequested(true),
+  m_UnknownCount(0),
+  m_UnknownWarningTime(-UNKNOWN_WARNING_INTERVAL)
 {
+  // Made once here so packets don't have to
+  m_MessageHandler = [this](OSCMessage& message) { ParseMessage(message); };
+
   WSAData wsa{ 0 };
   if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0)
     util::log::Error("Failed to initialize WSA, error code %d", WSAGetLastError());
@@ -26,15 +47,63 @@ OSCReceiver::~OSCReceiver()
 
 void OSCReceiver::ResetOrigin()
 {
-  m_OriginPosition = m_TransformData.Position;
-  
-  XMVECTOR qYaw = util::math::ExtractYaw(XMLoadFloat4(&m_TransformData.Rotation));
-  XMStoreFloat4(&m_OriginRotation, qYaw);
+  // The origin is only used by the thread reading poses,
+  // so it's moved there
+  m_OriginRequested = true;
 }
 
-OSCTransform OSCReceiver::GetTransformData()
+void OSCReceiver::UpdatePoseFilter()
 {
-  OSCTransform data = m_TransformData;
+  // Nothing new gets added if the read overlapped a write,
+  // the poses are still there for the next one
+  if (!m_Poses.TryLoadHistory(m_PoseHistory))
+    return;
+
+  uint32_t newest = m_PoseHistory.Newest;
+  uint32_t first = m_LastSequence + 1;
+  if (newest - m_LastSequence > OSCPoseHistory::Size)
+    first = newest - OSCPoseHistory::Size + 1;
+
+  for (uint32_t sequence = first; sequence != newest + 1; ++sequence)
+  {
+    OSCPose const& pose = m_PoseHistory.Poses[sequence % OSCPoseHistory::Size];
+
+    // Time tags say when the pose was taken, arrival times
+    // also have the network jitter in them
+    PoseSample sample;
+    if (pose.TimeTag == OSCTimeTagImmediately)
+      sample.Time = pose.ReceiveTime;
+    else
+      sample.Time = m_SenderClock.ToLocal(OSCTimeTagToSeconds(pose.TimeTag), pose.ReceiveTime);
+
+    memcpy(sample.Position, pose.Position, sizeof(sample.Position));
+    memcpy(sample.Rotation, pose.Rotation, sizeof(sample.Rotation));
+    m_PoseFilter.AddSample(sample);
+  }
+
+  m_LastSequence = newest;
+}
+
+OSCTransform OSCReceiver::GetTransformData(double time)
+{
+  UpdatePoseFilter();
+
+  OSCTransform data;
+
+  PoseSample sample;
+  if (m_PoseFilter.Evaluate(time, sample))
+  {
+    data.Position = XMFLOAT3(sample.Position);
+    data.Rotation = XMFLOAT4(sample.Rotation);
+
+    // Stays requested until there's a pose to take it from
+    if (m_OriginRequested.exchange(false))
+    {
+      m_OriginPosition = data.Position;
+      XMVECTOR qYaw = util::math::ExtractYaw(XMLoadFloat4(&data.Rotation));
+      XMStoreFloat4(&m_OriginRotation, qYaw);
+    }
+  }
 
   XMVECTOR absolutePos = XMLoadFloat3(&data.Position);
   XMVECTOR absoluteRot = XMLoadFloat4(&data.Rotation);
@@ -53,9 +122,25 @@ OSCTransform OSCReceiver::GetTransformData()
   return data;
 }
 
+void OSCReceiver::BindFloat(std::string const& address, float* pValue)
+{
+  std::lock_guard<std::mutex> lock(m_BindingMutex);
+  if (!m_Dispatcher.BindFloat(address, pValue))
+    util::log::Error("Invalid OSC address %s", address.c_str());
+}
+
+void OSCReceiver::BindBool(std::string const& address, bool* pValue)
+{
+  std::lock_guard<std::mutex> lock(m_BindingMutex);
+  if (!m_Dispatcher.BindBool(address, pValue))
+    util::log::Error("Invalid OSC address %s", address.c_str());
+}
+
 void OSCReceiver::BindButton(std::string const& address, std::function<void()> const& func)
 {
-  m_buttonBindings.emplace(address, func);
+  std::lock_guard<std::mutex> lock(m_BindingMutex);
+  if (!m_Dispatcher.BindButton(address, func))
+    util::log::Error("Invalid OSC address %s", address.c_str());
 }
 
 bool OSCReceiver::CreateSocket()
@@ -78,6 +163,7 @@ bool OSCReceiver::CreateSocket()
   if (bind(m_socket, reinterpret_cast<struct sockaddr*>(&sin), sizeof(sockaddr_in)) == SOCKET_ERROR)
   {
     util::log::Error("Failed to bind socket, WSAGetLastError 0x%X\n", WSAGetLastError());
+    closesocket(m_socket);
     return false;
   }
 
@@ -89,7 +175,6 @@ void OSCReceiver::ReadData()
   if (!CreateSocket())
     return;
   
-  char buffer[BUFLEN];
   while (!g_shutdown)
   {
     fd_set readSet;
@@ -103,64 +188,58 @@ void OSCReceiver::ReadData()
       int sa_len = sizeof(sockaddr_in);
       int len = 0;
 
-      while ((len = (int)recvfrom(m_socket, buffer, BUFLEN, 0, &sa, &sa_len)) > 0)
+      while ((len = (int)recvfrom(m_socket, m_Buffer.data(), (int)m_Buffer.size(), 0, &sa, &sa_len)) > 0)
       {
-        if (!tosc_isBundle(buffer))
+        double receiveTime = GetTime();
+
+        bool parsed = false;
         {
-          tosc_message osc;
-          tosc_parseMessage(&osc, buffer, len);
-          ParseMessage(osc);
+          std::lock_guard<std::mutex> lock(m_BindingMutex);
+          parsed = ParseOSCPacket(m_Buffer.data(), len, m_MessageHandler);
         }
+
+        // Buttons and handlers run without the lock, they may bind
+        // addresses themselves. The buffer isn't reused until they're done.
+        for (OSCDispatcher::Call& call : m_Calls)
+          call.Run();
+        m_Calls.clear();
+
+        if (!parsed)
+          util::log::Warning("OSC received a malformed packet of %d bytes", len);
+
+        m_Poses.EndPacket(receiveTime);
+        WarnUnknownAddresses(receiveTime);
       }
     }
   }
+
+  closesocket(m_socket);
 }
 
-void OSCReceiver::ParseMessage(tosc_message& msg)
+void OSCReceiver::ParseMessage(OSCMessage& msg)
 {
-  std::string address = tosc_getAddress(&msg);
+  if (m_Poses.HandleMessage(msg))
+    return;
 
-  if (address == "/position")
-  {
-    XMVECTOR vPosition;
-    for (int i = 0; i < 3; ++i)
-      vPosition.m128_f32[i] = tosc_getNextFloat(&msg);
+  if (m_Dispatcher.Dispatch(msg, &m_Calls) > 0)
+    return;
 
-    XMStoreFloat3(&m_TransformData.Position, vPosition);
-  }
-  else if (address == "/rotation")
-  {
-    XMVECTOR qRotation;
-    for (int i = 0; i < 4; ++i)
-      qRotation.m128_f32[i] = tosc_getNextFloat(&msg);
+  // Only the first one is named in the warning, so this
+  // allocates at most once per warning
+  if (m_UnknownCount++ == 0)
+    m_UnknownAddress = msg.GetAddress();
+}
 
-    XMStoreFloat4(&m_TransformData.Rotation, qRotation);
-  }
-  else
-  {
-    auto floatBind = m_floatBindings.find(address);
-    if (floatBind != m_floatBindings.end())
-    {
-      float* pFloat = floatBind->second;
-      *pFloat = tosc_getNextFloat(&msg);
-      return;
-    }
+void OSCReceiver::WarnUnknownAddresses(double time)
+{
+  if (m_UnknownCount == 0 || time - m_UnknownWarningTime < UNKNOWN_WARNING_INTERVAL)
+    return;
 
-    auto boolBind = m_boolBindings.find(address);
-    if (boolBind != m_boolBindings.end())
-    {
-      bool* pBool = boolBind->second;
-      *pBool = tosc_getNextInt32(&msg);
-      return;
-    }
+  if (m_UnknownCount == 1)
+    util::log::Warning("OSC received a message with an unknown address %s", m_UnknownAddress.c_str());
+  else
+    util::log::Warning("OSC received %u messages with unknown addresses, like %s", m_UnknownCount, m_UnknownAddress.c_str());
 
-    auto buttonBind = m_buttonBindings.find(address);
-    if (buttonBind != m_buttonBindings.end())
-    {
-      std::function<void()>& func = buttonBind->second;
-      func();
-    }
-    else
-      util::log::Warning("OSC received a message with an unknown address %s", address.c_str());
-  }
+  m_UnknownCount = 0;
+  m_UnknownWarningTime = time;
 }
\ No newline at end of file
@@ -1,8 +1,15 @@
 #pragma once
-#include "../tinyosc/tinyosc.h"
+#include "OSCDispatcher.h"
+#include "OSCPacket.h"
+#include "OSCPose.h"
+#include "PoseFilter.h"
+#include <atomic>
 #include <DirectXMath.h>
-#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
 struct OSCTransform
 {
@@ -27,11 +34,24 @@ public:
   OSCReceiver();
   ~OSCReceiver();
 
+  // Seconds, the clock poses are received and evaluated on
+  static double GetTime();
+
+  // Makes the next pose the origin, can be called from any thread
   void ResetOrigin();
 
-  OSCTransform GetTransformData();
+  // Pose relative to the origin at the given time, interpolated
+  // between samples or predicted past the newest one. Can be called
+  // from any one thread other than the receive thread.
+  OSCTransform GetTransformData(double time);
+  OSCTransform GetTransformData() { return GetTransformData(GetTime()); }
+
+  void SetFilterSettings(PoseFilterSettings const& settings) { m_PoseFilter.SetSettings(settings); }
   OSCUIData GetUIData() { return m_UIData; }
  
+  // Can be called from any thread
+  void BindFloat(std::string const&, float*);
+  void BindBool(std::string const&, bool*);
   void BindButton(std::string const&, std::function<void()> const&);
 
 private:
@@ -39,23 +59,48 @@ private:
   bool CreateSocket();
   void ReadData();
 
-  void ParseMessage(tosc_message&);
+  void ParseMessage(OSCMessage&);
+  void WarnUnknownAddresses(double time);
+
+  void UpdatePoseFilter();
 
 private:
   int m_socket;
 
-  OSCTransform m_TransformData;
+  // Big enough for any UDP datagram
+  std::vector<char> m_Buffer;
+  OSCMessageHandler m_MessageHandler;
+
+  // Written by the receive thread
+  OSCPoseStream m_Poses;
+
+  // Only used by the thread calling GetTransformData
+  OSCPoseHistory m_PoseHistory;
+  uint32_t m_LastSequence;
+  PoseFilter m_PoseFilter;
+  ClockOffsetEstimator m_SenderClock;
+
   OSCUIData m_UIData;
 
   DirectX::XMFLOAT3 m_OriginPosition;
   DirectX::XMFLOAT4 m_OriginRotation;
+  std::atomic<bool> m_OriginRequested;
 
   std::thread m_oscThread;
 
-  std::unordered_map<std::string, float*> m_floatBindings;
-  std::unordered_map<std::string, bool*> m_boolBindings;
+  // Locked once per datagram by the receive thread, only
+  // while the packet is parsed
+  std::mutex m_BindingMutex;
+  OSCDispatcher m_Dispatcher;
+
+  // Buttons and handlers the current packet went to
+  std::vector<OSCDispatcher::Call> m_Calls;
 
-  std::unordered_map<std::string, std::function<void()>> m_buttonBindings;
+  // Unknown addresses are counted and reported at most once a second,
+  // a control surface can send hundreds per second
+  std::string m_UnknownAddress;
+  unsigned int m_UnknownCount;
+  double m_UnknownWarningTime;
 
 public:
   OSCReceiver(OSCReceiver const&) = delete;
@@ -0,0 +1,287 @@
+#include "PoseFilter.h"
+#include <algorithm>
+#include <cmath>
+
+const int PoseFilter::BufferSize;
+
+namespace
+{
+  // Quaternions are x y z w like DirectXMath's, so the
+  // result of Multiply(a, b) applies a first and then b
+  void Multiply(float const* a, float const* b, float* pOut)
+  {
+    float x = b[3] * a[0] + b[0] * a[3] + b[1] * a[2] - b[2] * a[1];
+    float y = b[3] * a[1] - b[0] * a[2] + b[1] * a[3] + b[2] * a[0];
+    float z = b[3] * a[2] + b[0] * a[1] - b[1] * a[0] + b[2] * a[3];
+    float w = b[3] * a[3] - b[0] * a[0] - b[1] * a[1] - b[2] * a[2];
+
+    pOut[0] = x;
+    pOut[1] = y;
+    pOut[2] = z;
+    pOut[3] = w;
+  }
+
+  void Normalize(float* q)
+  {
+    float length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    if (length <= 0)
+    {
+      q[0] = q[1] = q[2] = 0;
+      q[3] = 1;
+      return;
+    }
+
+    for (int i = 0; i < 4; ++i)
+      q[i] /= length;
+  }
+
+  // Rotation that takes from to to, as a rotation vector
+  void Difference(float const* from, float const* to, float* pRotation)
+  {
+    float inverse[4] = { -from[0], -from[1], -from[2], from[3] };
+    float q[4];
+    Multiply(inverse, to, q);
+
+    // Shortest way around
+    if (q[3] < 0)
+    {
+      for (int i = 0; i < 4; ++i)
+        q[i] = -q[i];
+    }
+
+    float sinHalf = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2]);
+    float scale = sinHalf > 1e-6f ? 2 * std::atan2(sinHalf, q[3]) / sinHalf : 2.f;
+
+    for (int i = 0; i < 3; ++i)
+      pRotation[i] = q[i] * scale;
+  }
+
+  // Applies a rotation vector after q
+  void Rotate(float const* q, float const* rotation, float* pOut)
+  {
+    float angle = std::sqrt(rotation[0] * rotation[0] + rotation[1] * rotation[1] + rotation[2] * rotation[2]);
+    float scale = angle > 1e-6f ? std::sin(angle / 2) / angle : 0.5f;
+
+    float r[4] = { rotation[0] * scale, rotation[1] * scale, rotation[2] * scale, std::cos(angle / 2) };
+    Multiply(q, r, pOut);
+    Normalize(pOut);
+  }
+
+  void Slerp(float const* a, float const* b, float t, float* pOut)
+  {
+    float rotation[3];
+    Difference(a, b, rotation);
+
+    for (int i = 0; i < 3; ++i)
+      rotation[i] *= t;
+
+    Rotate(a, rotation, pOut);
+  }
+}
+
+void PoseFilter::Kalman::Reset(double value)
+{
+  Value = value;
+  Velocity = 0;
+
+  // Nothing is known about the velocity yet
+  P[0][0] = 1;
+  P[0][1] = P[1][0] = 0;
+  P[1][1] = 100;
+}
+
+void PoseFilter::Kalman::Predict(double dt, double processNoise)
+{
+  Value += Velocity * dt;
+
+  double p00 = P[0][0] + dt * (P[0][1] + P[1][0]) + dt * dt * P[1][1];
+  double p01 = P[0][1] + dt * P[1][1];
+  double p10 = P[1][0] + dt * P[1][1];
+
+  // Acceleration is white noise
+  P[0][0] = p00 + processNoise * dt * dt * dt / 3;
+  P[0][1] = p01 + processNoise * dt * dt / 2;
+  P[1][0] = p10 + processNoise * dt * dt / 2;
+  P[1][1] += processNoise * dt;
+}
+
+void PoseFilter::Kalman::Update(double measurement, double measurementNoise)
+{
+  double residual = measurement - Value;
+  double s = P[0][0] + measurementNoise;
+  double k0 = P[0][0] / s;
+  double k1 = P[1][0] / s;
+
+  Value += k0 * residual;
+  Velocity += k1 * residual;
+
+  double p00 = P[0][0], p01 = P[0][1];
+  P[0][0] = (1 - k0) * p00;
+  P[0][1] = (1 - k0) * p01;
+  P[1][0] -= k1 * p00;
+  P[1][1] -= k1 * p01;
+}
+
+PoseFilter::PoseFilter(PoseFilterSettings const& settings /* = PoseFilterSettings() */) :
+  m_Settings(settings)
+{
+  Reset();
+}
+
+void PoseFilter::Reset()
+{
+  m_Newest = 0;
+  m_Count = 0;
+
+  for (int i = 0; i < 3; ++i)
+  {
+    m_LinearVelocity[i] = 0;
+    m_AngularVelocity[i] = 0;
+  }
+}
+
+PoseSample const& PoseFilter::GetSample(int age) const
+{
+  return m_Samples[(m_Newest - age + BufferSize) % BufferSize];
+}
+
+void PoseFilter::AddSample(PoseSample const& sample)
+{
+  if (m_Count > 0 && sample.Time <= GetSample(0).Time)
+    return;
+
+  m_Newest = (m_Newest + 1) % BufferSize;
+  m_Samples[m_Newest] = sample;
+  Normalize(m_Samples[m_Newest].Rotation);
+
+  if (m_Count < BufferSize)
+    m_Count++;
+
+  if (m_Count == 1)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      m_PositionFilter[i].Reset(sample.Position[i]);
+      m_RotationFilter[i].Reset(0);
+    }
+  }
+  else
+    UpdateVelocity(GetSample(1), GetSample(0));
+}
+
+void PoseFilter::UpdateVelocity(PoseSample const& previous, PoseSample const& sample)
+{
+  float dt = static_cast<float>(sample.Time - previous.Time);
+
+  float rotation[3];
+  Difference(previous.Rotation, sample.Rotation, rotation);
+
+  for (int i = 0; i < 3; ++i)
+  {
+    m_LinearVelocity[i] = (sample.Position[i] - previous.Position[i]) / dt;
+    m_AngularVelocity[i] = rotation[i] / dt;
+
+    m_PositionFilter[i].Predict(dt, m_Settings.ProcessNoise);
+    m_PositionFilter[i].Update(sample.Position[i], m_Settings.MeasurementNoise);
+
+    // Rotation is measured from the previous sample, and then
+    // the filter is moved along to measure from this one
+    m_RotationFilter[i].Predict(dt, m_Settings.ProcessNoise);
+    m_RotationFilter[i].Update(rotation[i], m_Settings.MeasurementNoise);
+    m_RotationFilter[i].Value -= rotation[i];
+  }
+}
+
+bool PoseFilter::Evaluate(double time, PoseSample& pose) const
+{
+  if (m_Count == 0)
+    return false;
+
+  double t = time - m_Settings.Delay;
+  pose.Time = t;
+
+  PoseSample const& newest = GetSample(0);
+  if (t >= newest.Time)
+  {
+    float dt = static_cast<float>(std::min<double>(t - newest.Time, m_Settings.MaxPrediction));
+
+    float linear[3] = { 0, 0, 0 };
+    float angular[3] = { 0, 0, 0 };
+
+    for (int i = 0; i < 3; ++i)
+    {
+      if (m_Settings.Prediction == PosePrediction_ConstantVelocity)
+      {
+        linear[i] = m_LinearVelocity[i];
+        angular[i] = m_AngularVelocity[i];
+      }
+      else if (m_Settings.Prediction == PosePrediction_Kalman)
+      {
+        linear[i] = static_cast<float>(m_PositionFilter[i].Velocity);
+        angular[i] = static_cast<float>(m_RotationFilter[i].Velocity);
+      }
+
+      pose.Position[i] = newest.Position[i] + linear[i] * dt;
+      angular[i] *= dt;
+    }
+
+    Rotate(newest.Rotation, angular, pose.Rotation);
+    return true;
+  }
+
+  // Find the samples on either side, older than the buffer holds
+  // gets the oldest one
+  int age = 0;
+  while (age < m_Count - 1 && GetSample(age).Time > t)
+    age++;
+
+  PoseSample const& before = GetSample(age);
+  if (age == 0 || before.Time > t)
+  {
+    for (int i = 0; i < 3; ++i)
+      pose.Position[i] = before.Position[i];
+    for (int i = 0; i < 4; ++i)
+      pose.Rotation[i] = before.Rotation[i];
+
+    return true;
+  }
+
+  PoseSample const& after = GetSample(age - 1);
+  float blend = static_cast<float>((t - before.Time) / (after.Time - before.Time));
+
+  for (int i = 0; i < 3; ++i)
+    pose.Position[i] = before.Position[i] + (after.Position[i] - before.Position[i]) * blend;
+
+  Slerp(before.Rotation, after.Rotation, blend, pose.Rotation);
+  return true;
+}
+
+ClockOffsetEstimator::ClockOffsetEstimator(double drift /* = 0.001 */) :
+  m_Drift(drift)
+{
+  Reset();
+}
+
+void ClockOffsetEstimator::Reset()
+{
+  m_Offset = 0;
+  m_LastReceiveTime = 0;
+  m_Valid = false;
+}
+
+double ClockOffsetEstimator::ToLocal(double senderTime, double receiveTime)
+{
+  double offset = receiveTime - senderTime;
+
+  if (m_Valid)
+    m_Offset += m_Drift * (receiveTime - m_LastReceiveTime);
+
+  // Start over if the sender's clock jumped
+  if (!m_Valid || offset < m_Offset || offset - m_Offset > 1.0)
+    m_Offset = offset;
+
+  m_LastReceiveTime = receiveTime;
+  m_Valid = true;
+
+  return senderTime + m_Offset;
+}
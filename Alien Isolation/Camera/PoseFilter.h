@@ -0,0 +1,113 @@
+#pragma once
+#include <cstddef>
+
+// Turns poses that arrive from a tracker at their own rate and with
+// network jitter into a pose for any given render time. Samples are
+// buffered and interpolated, and the pose is predicted past the newest
+// sample to cover transport and frame latency.
+//
+// Doesn't depend on Windows or DirectX headers.
+
+enum PosePrediction
+{
+  PosePrediction_None,             // Hold the newest sample
+  PosePrediction_ConstantVelocity, // Velocity between the newest two samples
+  PosePrediction_Kalman,           // Velocity from a constant velocity Kalman filter
+  PosePrediction_Count
+};
+
+struct PoseSample
+{
+  double Time{ 0 }; // Seconds, local clock
+  float Position[3]{ 0, 0, 0 };
+  float Rotation[4]{ 0, 0, 0, 1 }; // Quaternion, x y z w
+};
+
+struct PoseFilterSettings
+{
+  int Prediction{ PosePrediction_Kalman };
+
+  // Output is held back this long so that jittery samples can still be
+  // interpolated. Prediction makes up for it again.
+  float Delay{ 0 };
+
+  // Prediction never goes further past the newest sample than this
+  float MaxPrediction{ 0.1f };
+
+  // Kalman only. Lower process noise trusts the velocity more, lower
+  // measurement noise trusts the samples more.
+  float ProcessNoise{ 50.f };
+  float MeasurementNoise{ 0.0001f };
+};
+
+class PoseFilter
+{
+public:
+  static const int BufferSize = 64;
+
+  explicit PoseFilter(PoseFilterSettings const& settings = PoseFilterSettings());
+
+  void SetSettings(PoseFilterSettings const& settings) { m_Settings = settings; }
+  PoseFilterSettings const& GetSettings() const { return m_Settings; }
+
+  void Reset();
+
+  // Samples that aren't newer than the newest one are dropped
+  void AddSample(PoseSample const& sample);
+
+  // Returns false if there are no samples yet
+  bool Evaluate(double time, PoseSample& pose) const;
+
+private:
+  // Position and velocity along one axis
+  struct Kalman
+  {
+    double Value;
+    double Velocity;
+    double P[2][2];
+
+    void Reset(double value);
+    void Predict(double dt, double processNoise);
+    void Update(double measurement, double measurementNoise);
+  };
+
+  PoseSample const& GetSample(int age) const; // 0 is the newest
+  void UpdateVelocity(PoseSample const& previous, PoseSample const& sample);
+
+private:
+  PoseFilterSettings m_Settings;
+
+  PoseSample m_Samples[BufferSize];
+  int m_Newest;
+  int m_Count;
+
+  // Between the newest two samples
+  float m_LinearVelocity[3];
+  float m_AngularVelocity[3]; // Rotation vector per second
+
+  // Both always run so the prediction can be switched any time. The
+  // rotation filters measure from the newest sample, so they stay
+  // close to 0 and only their velocity matters.
+  Kalman m_PositionFilter[3];
+  Kalman m_RotationFilter[3];
+};
+
+// Maps sender timestamps onto the local clock. The offset is the lowest
+// delay seen, so jitter only ever makes samples late. It slowly creeps
+// up to follow the two clocks drifting apart.
+class ClockOffsetEstimator
+{
+public:
+  explicit ClockOffsetEstimator(double drift = 0.001);
+
+  void Reset();
+
+  // Both in seconds, returns when the sample was sent on the local clock
+  double ToLocal(double senderTime, double receiveTime);
+
+private:
+  double m_Drift; // Seconds per second
+  double m_Offset;
+  double m_LastReceiveTime;
+  bool m_Valid;
+};
@@ -0,0 +1,115 @@
+#include "TakeRecorder.h"
+
+TakeRecorder::TakeRecorder(size_t capacity) :
+  m_Capacity(capacity),
+  m_Time(0),
+  m_Recording(false),
+  m_Reducing(false),
+  m_HasResult(false)
+{
+  m_Samples.reserve(capacity);
+}
+
+TakeRecorder::~TakeRecorder()
+{
+  if (m_Worker.joinable())
+    m_Worker.join();
+}
+
+bool TakeRecorder::Start()
+{
+  if (m_Reducing)
+    return false;
+
+  // The worker is done with the samples by now
+  if (m_Worker.joinable())
+    m_Worker.join();
+
+  m_Samples.clear();
+  m_Time = 0;
+  m_Recording = true;
+  return true;
+}
+
+void TakeRecorder::AddFrame(float dt, float const* pValues)
+{
+  if (!m_Recording || IsFull())
+    return;
+
+  TakeSample sample;
+  for (int i = 0; i < TrackChannel_Count; ++i)
+    sample.Values[i] = pValues[i];
+
+  if (!m_Samples.empty())
+  {
+    // Nodes need increasing times
+    if (dt <= 0)
+      return;
+
+    m_Time += dt;
+
+    // q and -q are the same rotation, but interpolating
+    // between them would spin the camera around
+    float const* previous = &m_Samples.back().Values[TrackChannel_RotationX];
+    float* rotation = &sample.Values[TrackChannel_RotationX];
+
+    float dot = 0;
+    for (int i = 0; i < 4; ++i)
+      dot += previous[i] * rotation[i];
+
+    if (dot < 0)
+    {
+      for (int i = 0; i < 4; ++i)
+        rotation[i] = -rotation[i];
+    }
+  }
+
+  sample.Time = m_Time;
+  m_Samples.push_back(sample);
+}
+
+bool TakeRecorder::Stop(TakeTolerance const& tolerance)
+{
+  if (!m_Recording)
+    return false;
+
+  m_Recording = false;
+  if (m_Samples.size() < 2)
+    return false;
+
+  m_Reducing = true;
+  m_Worker = std::thread(&TakeRecorder::Reduce, this, tolerance);
+  return true;
+}
+
+bool TakeRecorder::TryGetResult(ReducedTake& take)
+{
+  std::lock_guard<std::mutex> lock(m_ResultMutex);
+  if (!m_HasResult)
+    return false;
+
+  take = std::move(m_Result);
+  m_HasResult = false;
+  return true;
+}
+
+void TakeRecorder::Reduce(TakeTolerance tolerance)
+{
+  ReducedTake take;
+  take.SampleCount = m_Samples.size();
+  take.Duration = m_Samples.back().Time;
+
+  std::vector<size_t> kept = ReduceTake(m_Samples.data(), m_Samples.size(), tolerance, &take.Error);
+
+  take.Nodes.reserve(kept.size());
+  for (size_t index : kept)
+    take.Nodes.push_back(m_Samples[index]);
+
+  {
+    std::lock_guard<std::mutex> lock(m_ResultMutex);
+    m_Result = std::move(take);
+    m_HasResult = true;
+  }
+
+  m_Reducing = false;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "TakeReducer.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct ReducedTake
+{
+  std::vector<TakeSample> Nodes;
+  size_t SampleCount{ 0 }; // Frames that were recorded
+  float Duration{ 0 };     // Seconds
+  TakeError Error;         // Largest difference between playback and recording
+};
+
+// Records the camera every frame into a buffer that's allocated up
+// front, so recording doesn't allocate or lock. A stopped take is handed
+// to a worker thread that reduces it to track nodes, and a new take can
+// only start once that's done.
+//
+// Start, AddFrame and Stop have to be called from the same thread.
+// Doesn't depend on Windows headers.
+class TakeRecorder
+{
+public:
+  explicit TakeRecorder(size_t capacity);
+  ~TakeRecorder();
+
+  // Returns false if the previous take is still being reduced
+  bool Start();
+
+  // Values holds TrackChannel_Count floats in TrackChannel order.
+  // Frames are dropped once the buffer is full.
+  void AddFrame(float dt, float const* pValues);
+
+  // Returns false if the take is too short to become a track
+  bool Stop(TakeTolerance const& tolerance);
+
+  bool IsRecording() const { return m_Recording; }
+  bool IsFull() const { return m_Samples.size() >= m_Capacity; }
+  size_t GetCapacity() const { return m_Capacity; }
+
+  // Any thread. Results are handed out once.
+  bool IsReducing() const { return m_Reducing; }
+  bool TryGetResult(ReducedTake& take);
+
+private:
+  void Reduce(TakeTolerance tolerance);
+
+private:
+  std::vector<TakeSample> m_Samples;
+  size_t m_Capacity;
+  float m_Time;
+  std::atomic<bool> m_Recording;
+
+  std::thread m_Worker;
+  std::atomic<bool> m_Reducing;
+
+  std::mutex m_ResultMutex;
+  ReducedTake m_Result;
+  bool m_HasResult;
+
+public:
+  TakeRecorder(TakeRecorder const&) = delete;
+  void operator=(TakeRecorder const&) = delete;
+};
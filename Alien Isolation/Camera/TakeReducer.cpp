@@ -0,0 +1,384 @@
+#include "TakeReducer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  const double g_RadiansToDegrees = 57.295779513082320876798;
+
+  // Eased time only runs forward while neighbouring segments are less
+  // than five times as long as each other, any longer and the curve
+  // through the node times overshoots
+  const float g_MaxDurationRatio = 4.f;
+
+  // Same curve as util::math::CatmullRomInterpolate and XMVectorCatmullRom
+  double CatmullRom(double y0, double y1, double y2, double y3, double mu)
+  {
+    double a0 = -0.5 * y0 + 1.5 * y1 - 1.5 * y2 + 0.5 * y3;
+    double a1 = y0 - 2.5 * y1 + 2 * y2 - 0.5 * y3;
+    double a2 = -0.5 * y0 + 0.5 * y2;
+    return ((a0 * mu + a1) * mu + a2) * mu + y1;
+  }
+
+  double CatmullRomSlope(double y0, double y1, double y2, double y3, double mu)
+  {
+    double a0 = -0.5 * y0 + 1.5 * y1 - 1.5 * y2 + 0.5 * y3;
+    double a1 = y0 - 2.5 * y1 + 2 * y2 - 0.5 * y3;
+    double a2 = -0.5 * y0 + 0.5 * y2;
+    return (3 * a0 * mu + 2 * a1) * mu + a2;
+  }
+
+  // Quaternions as x, y, z, w like XMFLOAT4
+  struct Quaternion
+  {
+    double x, y, z, w;
+  };
+
+  Quaternion LoadRotation(TakeSample const& sample)
+  {
+    float const* q = &sample.Values[TrackChannel_RotationX];
+    double length = std::sqrt(static_cast<double>(q[0]) * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+    if (length <= 0)
+      return Quaternion{ 0, 0, 0, 1 };
+
+    return Quaternion{ q[0] / length, q[1] / length, q[2] / length, q[3] / length };
+  }
+
+  // a * b, b applied first
+  Quaternion Multiply(Quaternion const& a, Quaternion const& b)
+  {
+    return Quaternion{
+      a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+      a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+      a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+      a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z };
+  }
+
+  Quaternion Conjugate(Quaternion const& q)
+  {
+    return Quaternion{ -q.x, -q.y, -q.z, q.w };
+  }
+
+  // Expects a unit quaternion with w >= 0
+  Quaternion Log(Quaternion const& q)
+  {
+    double sinHalfAngle = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z);
+    double scale = sinHalfAngle > 1e-12 ? std::atan2(sinHalfAngle, q.w) / sinHalfAngle : 1;
+    return Quaternion{ q.x * scale, q.y * scale, q.z * scale, 0 };
+  }
+
+  Quaternion Exp(Quaternion const& q)
+  {
+    double halfAngle = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z);
+    double scale = halfAngle > 1e-12 ? std::sin(halfAngle) / halfAngle : 1;
+    return Quaternion{ q.x * scale, q.y * scale, q.z * scale, std::cos(halfAngle) };
+  }
+
+  // Shortest path like XMQuaternionSlerp
+  Quaternion Slerp(Quaternion const& a, Quaternion b, double mu)
+  {
+    double cosAngle = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+    if (cosAngle < 0)
+    {
+      cosAngle = -cosAngle;
+      b = Quaternion{ -b.x, -b.y, -b.z, -b.w };
+    }
+
+    double wa = 1 - mu;
+    double wb = mu;
+    if (cosAngle < 1 - 1e-9)
+    {
+      double angle = std::acos(cosAngle);
+      double sinAngle = std::sin(angle);
+      wa = std::sin((1 - mu) * angle) / sinAngle;
+      wb = std::sin(mu * angle) / sinAngle;
+    }
+
+    return Quaternion{ wa * a.x + wb * b.x, wa * a.y + wb * b.y, wa * a.z + wb * b.z, wa * a.w + wb * b.w };
+  }
+
+  // SQUAD control point of q, same as TrackSnapshot
+  Quaternion Control(Quaternion const& previous, Quaternion const& q, Quaternion const& next)
+  {
+    Quaternion inverse = Conjugate(q);
+    Quaternion toNext = Log(Multiply(inverse, next));
+    Quaternion toPrevious = Log(Multiply(inverse, previous));
+
+    Quaternion tangent{ -(toNext.x + toPrevious.x) / 4, -(toNext.y + toPrevious.y) / 4,
+      -(toNext.z + toPrevious.z) / 4, 0 };
+    return Multiply(q, Exp(tangent));
+  }
+
+  // The four nodes a segment is interpolated from. The first and last
+  // node stand in for the missing ones at the ends, like TrackSnapshot.
+  // Rotations only need the control points of the middle two.
+  struct Segment
+  {
+    TakeSample const* Nodes[4];
+    Quaternion Rotations[4];
+    Quaternion Controls[2];
+
+    Segment(TakeSample const* pSamples, std::vector<size_t> const& kept, size_t index)
+    {
+      Nodes[0] = &pSamples[kept[index > 0 ? index - 1 : index]];
+      Nodes[1] = &pSamples[kept[index]];
+      Nodes[2] = &pSamples[kept[index + 1]];
+      Nodes[3] = &pSamples[kept[index + 2 < kept.size() ? index + 2 : index + 1]];
+
+      for (int i = 0; i < 4; ++i)
+        Rotations[i] = LoadRotation(*Nodes[i]);
+
+      Controls[0] = Control(Rotations[0], Rotations[1], Rotations[2]);
+      Controls[1] = Control(Rotations[1], Rotations[2], Rotations[3]);
+    }
+
+    double Time(double mu) const
+    {
+      return CatmullRom(Nodes[0]->Time, Nodes[1]->Time, Nodes[2]->Time, Nodes[3]->Time, mu);
+    }
+
+    double TimeSlope(double mu) const
+    {
+      return CatmullRomSlope(Nodes[0]->Time, Nodes[1]->Time, Nodes[2]->Time, Nodes[3]->Time, mu);
+    }
+  };
+
+  // Eased timing runs the node times through the same curve as the
+  // values, so the mu for a time has to be solved for. Newton converges
+  // in a few steps, bisection takes over where the curve isn't monotonic.
+  double SolveMu(Segment const& segment, double time, double low)
+  {
+    double high = 1;
+    double t1 = segment.Nodes[1]->Time;
+    double t2 = segment.Nodes[2]->Time;
+    if (t2 <= t1)
+      return low;
+
+    double mu = std::max(low, std::min(high, (time - t1) / (t2 - t1)));
+
+    for (int i = 0; i < 16; ++i)
+    {
+      double error = segment.Time(mu) - time;
+      if (std::fabs(error) < 1e-6)
+        break;
+
+      if (error > 0)
+        high = mu;
+      else
+        low = mu;
+
+      double slope = segment.TimeSlope(mu);
+      double next = slope > 0 ? mu - error / slope : -1;
+      mu = next > low && next < high ? next : (low + high) / 2;
+    }
+
+    return mu;
+  }
+
+  void Interpolate(Segment const& segment, double mu, float* pValues)
+  {
+    for (int i = 0; i < TrackChannel_Count; ++i)
+    {
+      pValues[i] = static_cast<float>(CatmullRom(segment.Nodes[0]->Values[i], segment.Nodes[1]->Values[i],
+        segment.Nodes[2]->Values[i], segment.Nodes[3]->Values[i], mu));
+    }
+
+    // Rotation is a SQUAD spline like TrackSnapshot plays it
+    Quaternion outer = Slerp(segment.Rotations[1], segment.Rotations[2], mu);
+    Quaternion inner = Slerp(segment.Controls[0], segment.Controls[1], mu);
+    Quaternion q = Slerp(outer, inner, 2 * mu * (1 - mu));
+
+    double length = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    if (length > 0)
+    {
+      pValues[TrackChannel_RotationX] = static_cast<float>(q.x / length);
+      pValues[TrackChannel_RotationY] = static_cast<float>(q.y / length);
+      pValues[TrackChannel_RotationZ] = static_cast<float>(q.z / length);
+      pValues[TrackChannel_RotationW] = static_cast<float>(q.w / length);
+    }
+  }
+
+  TakeError Measure(float const* pPlayed, float const* pRecorded)
+  {
+    TakeError error;
+
+    float dx = pPlayed[TrackChannel_PositionX] - pRecorded[TrackChannel_PositionX];
+    float dy = pPlayed[TrackChannel_PositionY] - pRecorded[TrackChannel_PositionY];
+    float dz = pPlayed[TrackChannel_PositionZ] - pRecorded[TrackChannel_PositionZ];
+    error.Position = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+    // The angle from the chord between the quaternions stays
+    // accurate for the small angles the tolerance is about
+    float const* a = &pPlayed[TrackChannel_RotationX];
+    float const* b = &pRecorded[TrackChannel_RotationX];
+    float sign = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3] < 0 ? -1.f : 1.f;
+
+    float chord = 0;
+    for (int i = 0; i < 4; ++i)
+      chord += (a[i] - sign * b[i]) * (a[i] - sign * b[i]);
+
+    double halfChord = std::min(1.0, std::sqrt(static_cast<double>(chord)) / 2);
+    error.Rotation = static_cast<float>(4 * std::asin(halfChord) * g_RadiansToDegrees);
+
+    error.FieldOfView = std::fabs(pPlayed[TrackChannel_FieldOfView] - pRecorded[TrackChannel_FieldOfView]);
+
+    for (int i = TrackChannel_FocusDistance; i <= TrackChannel_DofStrength; ++i)
+      error.DepthOfField = std::max(error.DepthOfField, std::fabs(pPlayed[i] - pRecorded[i]));
+
+    return error;
+  }
+
+  // Error of the worst sample in a segment relative to the tolerance,
+  // above 1 means the segment has to be split at that sample
+  double CheckSegment(TakeSample const* pSamples, std::vector<size_t> const& kept, size_t index,
+    TakeTolerance const& tolerance, size_t& worst, TakeError* pError)
+  {
+    Segment segment(pSamples, kept, index);
+
+    const float minTolerance = 1e-6f;
+    float position = std::max(tolerance.Position, minTolerance);
+    float rotation = std::max(tolerance.Rotation, minTolerance);
+    float fieldOfView = std::max(tolerance.FieldOfView, minTolerance);
+    float depthOfField = std::max(tolerance.DepthOfField, minTolerance);
+
+    double worstScore = 0;
+    double mu = 0;
+    float values[TrackChannel_Count];
+
+    for (size_t i = kept[index] + 1; i < kept[index + 1]; ++i)
+    {
+      // Samples are in time order, so mu only ever grows
+      mu = SolveMu(segment, pSamples[i].Time, mu);
+      Interpolate(segment, mu, values);
+
+      TakeError error = Measure(values, pSamples[i].Values);
+      double score = std::max(std::max(error.Position / position, error.Rotation / rotation),
+        std::max(error.FieldOfView / fieldOfView, error.DepthOfField / depthOfField));
+
+      if (score > worstScore)
+      {
+        worstScore = score;
+        worst = i;
+      }
+
+      if (pError)
+      {
+        pError->Position = std::max(pError->Position, error.Position);
+        pError->Rotation = std::max(pError->Rotation, error.Rotation);
+        pError->FieldOfView = std::max(pError->FieldOfView, error.FieldOfView);
+        pError->DepthOfField = std::max(pError->DepthOfField, error.DepthOfField);
+      }
+    }
+
+    return worstScore;
+  }
+
+  // Sample closest to the middle of a segment in time
+  size_t FindMiddleSample(TakeSample const* pSamples, size_t first, size_t last)
+  {
+    float middle = (pSamples[first].Time + pSamples[last].Time) / 2;
+    TakeSample const* pMiddle = std::lower_bound(pSamples + first + 1, pSamples + last, middle,
+      [](TakeSample const& sample, float time) { return sample.Time < time; });
+
+    size_t index = pMiddle - pSamples;
+    if (index > first + 1 && middle - pSamples[index - 1].Time < pSamples[index].Time - middle)
+      index--;
+
+    return index;
+  }
+
+  // True if the segment is so much longer than a neighbour that
+  // the eased time curve through it would run backwards
+  bool IsTooLong(TakeSample const* pSamples, std::vector<size_t> const& kept, size_t index)
+  {
+    if (kept[index + 1] - kept[index] < 2)
+      return false;
+
+    float duration = pSamples[kept[index + 1]].Time - pSamples[kept[index]].Time;
+    float limit = duration;
+
+    if (index > 0)
+      limit = std::min(limit, pSamples[kept[index]].Time - pSamples[kept[index - 1]].Time);
+    if (index + 2 < kept.size())
+      limit = std::min(limit, pSamples[kept[index + 2]].Time - pSamples[kept[index + 1]].Time);
+
+    return duration > limit * g_MaxDurationRatio;
+  }
+}
+
+std::vector<size_t> ReduceTake(TakeSample const* pSamples, size_t count,
+  TakeTolerance const& tolerance, TakeError* pError /* = nullptr */)
+{
+  std::vector<size_t> kept;
+  if (pError)
+    *pError = TakeError();
+
+  if (count == 0)
+    return kept;
+
+  kept.push_back(0);
+  if (count > 1)
+    kept.push_back(count - 1);
+
+  // Per segment between kept samples. Segments that passed stay
+  // untouched until a split next to them changes their curve.
+  std::vector<char> dirty(kept.size() - 1, 1);
+  std::vector<size_t> splits;
+
+  std::vector<size_t> nextKept;
+  std::vector<char> nextDirty;
+
+  for (;;)
+  {
+    // 0 is never inside a segment, so it means no split
+    splits.assign(dirty.size(), 0);
+    bool split = false;
+
+    for (size_t i = 0; i < dirty.size(); ++i)
+    {
+      size_t worst = 0;
+      if (dirty[i] && CheckSegment(pSamples, kept, i, tolerance, worst, nullptr) > 1)
+        splits[i] = worst;
+      else if (IsTooLong(pSamples, kept, i))
+        splits[i] = FindMiddleSample(pSamples, kept[i], kept[i + 1]);
+
+      split |= splits[i] != 0;
+    }
+
+    if (!split)
+      break;
+
+    nextKept.clear();
+    nextDirty.clear();
+
+    for (size_t i = 0; i < splits.size(); ++i)
+    {
+      nextKept.push_back(kept[i]);
+
+      if (splits[i])
+      {
+        nextKept.push_back(splits[i]);
+        nextDirty.push_back(1);
+        nextDirty.push_back(1);
+      }
+      else
+      {
+        bool neighbourSplit = (i > 0 && splits[i - 1]) || (i + 1 < splits.size() && splits[i + 1]);
+        nextDirty.push_back(neighbourSplit);
+      }
+    }
+
+    nextKept.push_back(kept.back());
+    kept.swap(nextKept);
+    dirty.swap(nextDirty);
+  }
+
+  if (pError)
+  {
+    size_t worst = 0;
+    for (size_t i = 0; i + 1 < kept.size(); ++i)
+      CheckSegment(pSamples, kept, i, tolerance, worst, pError);
+  }
+
+  return kept;
+}
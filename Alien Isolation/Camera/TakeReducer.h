@@ -0,0 +1,51 @@
+#pragma once
+#include "TrackEvaluator.h"
+#include <cstddef>
+#include <vector>
+
+// Turns a camera take recorded at frame rate into the few nodes a
+// camera track needs to play it back within given error bounds.
+//
+// Doesn't depend on Windows or DirectX headers.
+
+struct TakeSample
+{
+  float Time; // Seconds since the take started
+  float Values[TrackChannel_Count];
+};
+
+// How far playback may stray from the recording
+struct TakeTolerance
+{
+  float Position{ 0.01f };      // Distance
+  float Rotation{ 0.1f };       // Degrees
+  float FieldOfView{ 0.1f };    // Degrees
+  float DepthOfField{ 0.001f }; // Focus distance, scale and strength
+};
+
+// Largest difference between playback and recording per kind of channel
+struct TakeError
+{
+  float Position{ 0 };
+  float Rotation{ 0 };
+  float FieldOfView{ 0 };
+  float DepthOfField{ 0 };
+};
+
+// Ramer-Douglas-Peucker, except that a segment is measured against the
+// Catmull-Rom and SQUAD curves the track is played with instead of a
+// straight line.
+// Every pass splits each segment that's out of tolerance at its worst
+// sample. A segment's curve depends on the nodes on both sides of it,
+// so its neighbours are checked again after a split.
+//
+// The curve is evaluated at eased timing, the way TrackPlayer plays
+// tracks by default, and segments are kept from getting much longer
+// than their neighbours so eased time never runs backwards. Samples
+// need increasing times and rotations in the same hemisphere as the
+// sample before them.
+//
+// Returns the indices of the samples to keep, always including the
+// first and the last one.
+std::vector<size_t> ReduceTake(TakeSample const* pSamples, size_t count,
+  TakeTolerance const& tolerance, TakeError* pError = nullptr);
@@ -0,0 +1,165 @@
+#include "TrackEvaluator.h"
+
+#include <algorithm>
+#include <xmmintrin.h>
+
+void TrackSamples::Resize(size_t count)
+{
+  Count = count;
+  for (auto& channel : Channels)
+    channel.resize(count);
+}
+
+void TrackEvaluator::Clear()
+{
+  m_Times.clear();
+  for (auto& channel : m_Channels)
+    channel.clear();
+}
+
+void TrackEvaluator::Reserve(size_t nodeCount)
+{
+  m_Times.reserve(nodeCount);
+  for (auto& channel : m_Channels)
+    channel.reserve(nodeCount);
+}
+
+void TrackEvaluator::AddNode(float time, float const* pValues)
+{
+  m_Times.push_back(time);
+  for (int i = 0; i < TrackChannel_Count; ++i)
+    m_Channels[i].push_back(pValues[i]);
+}
+
+void TrackEvaluator::RemoveLastNode()
+{
+  if (m_Times.empty()) return;
+
+  m_Times.pop_back();
+  for (auto& channel : m_Channels)
+    channel.pop_back();
+}
+
+void TrackEvaluator::Evaluate(float const* pTimes, size_t count, TrackSamples& out) const
+{
+  out.Resize(count);
+  if (count == 0) return;
+
+  if (m_Times.empty())
+  {
+    for (auto& channel : out.Channels)
+      std::fill(channel.begin(), channel.end(), 0.f);
+    return;
+  }
+
+  const unsigned int lastNode = static_cast<unsigned int>(m_Times.size()) - 1;
+  unsigned int segment = 0;
+
+  for (size_t i = 0; i < count; i += 4)
+  {
+    // Lanes past the end repeat the last sample and are not stored
+    size_t lanes = std::min<size_t>(4, count - i);
+
+    alignas(16) float mu[4];
+    unsigned int ids[4][4];
+
+    for (size_t lane = 0; lane < 4; ++lane)
+    {
+      float time = pTimes[i + std::min(lane, lanes - 1)];
+
+      if (lastNode == 0)
+      {
+        mu[lane] = 0;
+        ids[0][lane] = ids[1][lane] = ids[2][lane] = ids[3][lane] = 0;
+        continue;
+      }
+
+      segment = FindSegment(time, segment);
+
+      float t1 = m_Times[segment];
+      float t2 = m_Times[segment + 1];
+      float m = t2 > t1 ? (time - t1) / (t2 - t1) : 0.f;
+      mu[lane] = std::max(0.f, std::min(1.f, m));
+
+      ids[1][lane] = segment;
+      ids[2][lane] = segment + 1;
+      ids[0][lane] = segment > 0 ? segment - 1 : segment;
+      ids[3][lane] = segment + 1 < lastNode ? segment + 2 : segment + 1;
+    }
+
+    __m128 vMu = _mm_load_ps(mu);
+    __m128 vHalf = _mm_set1_ps(0.5f);
+    __m128 vOneHalf = _mm_set1_ps(1.5f);
+    __m128 vTwo = _mm_set1_ps(2.f);
+    __m128 vTwoHalf = _mm_set1_ps(2.5f);
+
+    __m128 results[TrackChannel_Count];
+    for (int c = 0; c < TrackChannel_Count; ++c)
+    {
+      const float* y = m_Channels[c].data();
+      __m128 y0 = _mm_set_ps(y[ids[0][3]], y[ids[0][2]], y[ids[0][1]], y[ids[0][0]]);
+      __m128 y1 = _mm_set_ps(y[ids[1][3]], y[ids[1][2]], y[ids[1][1]], y[ids[1][0]]);
+      __m128 y2 = _mm_set_ps(y[ids[2][3]], y[ids[2][2]], y[ids[2][1]], y[ids[2][0]]);
+      __m128 y3 = _mm_set_ps(y[ids[3][3]], y[ids[3][2]], y[ids[3][1]], y[ids[3][0]]);
+
+      // Same coefficients as util::math::CatmullRomInterpolate
+      __m128 a0 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(vOneHalf, _mm_sub_ps(y1, y2)), _mm_mul_ps(vHalf, y0)), _mm_mul_ps(vHalf, y3));
+      __m128 a1 = _mm_sub_ps(_mm_add_ps(y0, _mm_mul_ps(vTwo, y2)), _mm_add_ps(_mm_mul_ps(vTwoHalf, y1), _mm_mul_ps(vHalf, y3)));
+      __m128 a2 = _mm_mul_ps(vHalf, _mm_sub_ps(y2, y0));
+
+      __m128 r = _mm_add_ps(_mm_mul_ps(a0, vMu), a1);
+      r = _mm_add_ps(_mm_mul_ps(r, vMu), a2);
+      results[c] = _mm_add_ps(_mm_mul_ps(r, vMu), y1);
+    }
+
+    // Normalize the interpolated quaternions, four at a time
+    __m128 lengthSq = _mm_mul_ps(results[TrackChannel_RotationX], results[TrackChannel_RotationX]);
+    lengthSq = _mm_add_ps(lengthSq, _mm_mul_ps(results[TrackChannel_RotationY], results[TrackChannel_RotationY]));
+    lengthSq = _mm_add_ps(lengthSq, _mm_mul_ps(results[TrackChannel_RotationZ], results[TrackChannel_RotationZ]));
+    lengthSq = _mm_add_ps(lengthSq, _mm_mul_ps(results[TrackChannel_RotationW], results[TrackChannel_RotationW]));
+
+    __m128 validMask = _mm_cmpgt_ps(lengthSq, _mm_setzero_ps());
+    __m128 invLength = _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(lengthSq));
+    invLength = _mm_or_ps(_mm_and_ps(validMask, invLength), _mm_andnot_ps(validMask, _mm_set1_ps(1.f)));
+
+    for (int c = TrackChannel_RotationX; c <= TrackChannel_RotationW; ++c)
+      results[c] = _mm_mul_ps(results[c], invLength);
+
+    for (int c = 0; c < TrackChannel_Count; ++c)
+    {
+      float* pOut = out.Channels[c].data() + i;
+      if (lanes == 4)
+        _mm_storeu_ps(pOut, results[c]);
+      else
+      {
+        alignas(16) float values[4];
+        _mm_store_ps(values, results[c]);
+        for (size_t lane = 0; lane < lanes; ++lane)
+          pOut[lane] = values[lane];
+      }
+    }
+  }
+}
+
+unsigned int TrackEvaluator::FindSegment(float time, unsigned int hint) const
+{
+  const unsigned int lastSegment = static_cast<unsigned int>(m_Times.size()) - 2;
+
+  // Baked timestamps are usually sorted, so the answer is
+  // almost always the previous segment or the one after it.
+  if (hint <= lastSegment)
+  {
+    if (time >= m_Times[hint] && (time < m_Times[hint + 1] || hint == lastSegment))
+      return hint;
+
+    if (hint + 1 <= lastSegment && time >= m_Times[hint + 1] && (time < m_Times[hint + 2] || hint + 1 == lastSegment))
+      return hint + 1;
+  }
+
+  auto upper = std::upper_bound(m_Times.begin(), m_Times.end(), time);
+  if (upper == m_Times.begin())
+    return 0;
+
+  unsigned int segment = static_cast<unsigned int>(upper - m_Times.begin()) - 1;
+  return std::min(segment, lastSegment);
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Channels of a camera track node. Rotation is a quaternion
+// and gets normalized after interpolation.
+enum TrackChannel
+{
+  TrackChannel_PositionX,
+  TrackChannel_PositionY,
+  TrackChannel_PositionZ,
+  TrackChannel_RotationX,
+  TrackChannel_RotationY,
+  TrackChannel_RotationZ,
+  TrackChannel_RotationW,
+  TrackChannel_FieldOfView,
+  TrackChannel_FocusDistance,
+  TrackChannel_DofScale,
+  TrackChannel_DofStrength,
+  TrackChannel_Count
+};
+
+// Results of a batch evaluation, one array per channel
+struct TrackSamples
+{
+  size_t Count{ 0 };
+  std::array<std::vector<float>, TrackChannel_Count> Channels;
+
+  void Resize(size_t count);
+};
+
+// Structure-of-arrays copy of a camera track for evaluating
+// many timestamps at once, for example when baking preview
+// geometry or exporting a track. Every channel is stored
+// contiguously so four samples are interpolated per SSE
+// instruction instead of one channel at a time.
+//
+// Doesn't depend on Windows or DirectX headers.
+class TrackEvaluator
+{
+public:
+  void Clear();
+  void Reserve(size_t nodeCount);
+
+  // Values holds TrackChannel_Count floats in TrackChannel order.
+  // Nodes have to be added in time order.
+  void AddNode(float time, float const* pValues);
+  void RemoveLastNode();
+
+  size_t GetNodeCount() const { return m_Times.size(); }
+  float GetNodeTime(size_t index) const { return m_Times[index]; }
+  float GetNodeValue(size_t index, TrackChannel channel) const { return m_Channels[channel][index]; }
+  float GetStartTime() const { return m_Times.empty() ? 0 : m_Times.front(); }
+  float GetEndTime() const { return m_Times.empty() ? 0 : m_Times.back(); }
+
+  // Evaluates Catmull-Rom interpolated values for count timestamps.
+  // Timestamps outside the track are clamped to the first/last node.
+  // Sorted timestamps take a fast path when looking up segments.
+  void Evaluate(float const* pTimes, size_t count, TrackSamples& out) const;
+
+private:
+  unsigned int FindSegment(float time, unsigned int hint) const;
+
+private:
+  std::vector<float> m_Times;
+  std::array<std::vector<float>, TrackChannel_Count> m_Channels;
+};
\ No newline at end of file
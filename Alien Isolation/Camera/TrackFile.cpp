@@ -0,0 +1,226 @@
+#include "TrackFile.h"
+
+#include <cstring>
+
+using namespace trackfile;
+
+namespace
+{
+  // Sanity limit, a file claiming more is treated as corrupted
+  const uint32_t g_MaxChannels = 1024;
+
+  template <typename T>
+  void Append(std::vector<uint8_t>& buffer, T const& value)
+  {
+    uint8_t const* pBytes = reinterpret_cast<uint8_t const*>(&value);
+    buffer.insert(buffer.end(), pBytes, pBytes + sizeof(T));
+  }
+
+  template <typename T>
+  T ReadAt(uint8_t const* pData, size_t offset)
+  {
+    T value;
+    memcpy(&value, pData + offset, sizeof(T));
+    return value;
+  }
+
+  // Offsets are 32 bits in the file but are checked in 64 bits,
+  // so huge counts can't wrap around on x86
+  bool IsInside(uint64_t offset, uint64_t length, size_t size)
+  {
+    return offset <= size && length <= size - offset;
+  }
+}
+
+void Writer::AddTrack(std::string const& name, std::vector<NodeRecord> const& nodes)
+{
+  m_Names.push_back(name);
+  m_Tracks.push_back(nodes);
+}
+
+std::vector<uint8_t> Writer::Finish() const
+{
+  uint32_t trackCount = static_cast<uint32_t>(m_Tracks.size());
+
+  size_t channelTableSize = TrackChannel_Count * sizeof(TrackFileChannel);
+  size_t trackTableSize = trackCount * sizeof(TrackFileTrack);
+  size_t nodeDataOffset = sizeof(TrackFileHeader) + channelTableSize + trackTableSize;
+  size_t recordSize = sizeof(float) * (TrackChannel_Count + 1);
+
+  TrackFileHeader header;
+  header.Magic = Magic;
+  header.Version = Version;
+  header.HeaderSize = sizeof(TrackFileHeader);
+  header.ChannelCount = TrackChannel_Count;
+  header.TrackCount = trackCount;
+
+  std::vector<uint8_t> buffer;
+  Append(buffer, header);
+
+  for (uint16_t i = 0; i < TrackChannel_Count; ++i)
+  {
+    TrackFileChannel channel;
+    channel.Id = i;
+    channel.Reserved = 0;
+    Append(buffer, channel);
+  }
+
+  // Node data comes first and names after it, so the offsets
+  // can be computed before anything is written
+  size_t nodeOffset = nodeDataOffset;
+  size_t nameOffset = nodeDataOffset;
+  for (auto const& nodes : m_Tracks)
+    nameOffset += nodes.size() * recordSize;
+
+  for (uint32_t i = 0; i < trackCount; ++i)
+  {
+    TrackFileTrack track;
+    track.NodeOffset = static_cast<uint32_t>(nodeOffset);
+    track.NodeCount = static_cast<uint32_t>(m_Tracks[i].size());
+    track.NameOffset = static_cast<uint32_t>(nameOffset);
+    track.NameLength = static_cast<uint32_t>(m_Names[i].size());
+    Append(buffer, track);
+
+    nodeOffset += m_Tracks[i].size() * recordSize;
+    nameOffset += m_Names[i].size();
+  }
+
+  buffer.reserve(nameOffset);
+  for (auto const& nodes : m_Tracks)
+  {
+    for (auto const& node : nodes)
+    {
+      Append(buffer, node.Time);
+      for (float value : node.Values)
+        Append(buffer, value);
+    }
+  }
+
+  for (auto const& name : m_Names)
+    buffer.insert(buffer.end(), name.begin(), name.end());
+
+  return buffer;
+}
+
+bool Reader::Open(void const* pData, size_t size, std::string& error)
+{
+  m_pData = nullptr;
+  m_Size = 0;
+  m_TrackCount = 0;
+  m_ChannelMap.clear();
+
+  uint8_t const* pBytes = static_cast<uint8_t const*>(pData);
+  if (!pBytes || size < sizeof(TrackFileHeader))
+  {
+    error = "File is too small";
+    return false;
+  }
+
+  TrackFileHeader header = ReadAt<TrackFileHeader>(pBytes, 0);
+  if (header.Magic != Magic)
+  {
+    error = "Not a camera track file";
+    return false;
+  }
+
+  // Newer minor additions go after the known header fields,
+  // anything that breaks the layout increases the version
+  if (header.Version == 0 || header.Version > Version)
+  {
+    error = "Unsupported version " + std::to_string(header.Version);
+    return false;
+  }
+
+  if (header.HeaderSize < sizeof(TrackFileHeader) || header.HeaderSize > size)
+  {
+    error = "Invalid header size";
+    return false;
+  }
+
+  if (header.ChannelCount > g_MaxChannels)
+  {
+    error = "Invalid channel count";
+    return false;
+  }
+
+  uint64_t channelTableOffset = header.HeaderSize;
+  uint64_t channelTableSize = static_cast<uint64_t>(header.ChannelCount) * sizeof(TrackFileChannel);
+  uint64_t trackTableOffset = channelTableOffset + channelTableSize;
+  uint64_t trackTableSize = static_cast<uint64_t>(header.TrackCount) * sizeof(TrackFileTrack);
+
+  if (!IsInside(channelTableOffset, channelTableSize, size) || !IsInside(trackTableOffset, trackTableSize, size))
+  {
+    error = "Tables extend past the end of the file";
+    return false;
+  }
+
+  m_ChannelMap.resize(header.ChannelCount, -1);
+  for (uint32_t i = 0; i < header.ChannelCount; ++i)
+  {
+    TrackFileChannel channel = ReadAt<TrackFileChannel>(pBytes, static_cast<size_t>(channelTableOffset) + i * sizeof(TrackFileChannel));
+    if (channel.Id < TrackChannel_Count)
+      m_ChannelMap[i] = channel.Id;
+  }
+
+  uint64_t recordSize = sizeof(float) * (static_cast<uint64_t>(header.ChannelCount) + 1);
+  for (uint32_t i = 0; i < header.TrackCount; ++i)
+  {
+    TrackFileTrack track = ReadAt<TrackFileTrack>(pBytes, static_cast<size_t>(trackTableOffset) + i * sizeof(TrackFileTrack));
+
+    if (!IsInside(track.NodeOffset, track.NodeCount * recordSize, size) ||
+      !IsInside(track.NameOffset, track.NameLength, size))
+    {
+      error = "Track " + std::to_string(i) + " extends past the end of the file";
+      m_ChannelMap.clear();
+      return false;
+    }
+  }
+
+  m_pData = pBytes;
+  m_Size = size;
+  m_TrackCount = header.TrackCount;
+  m_TrackTableOffset = static_cast<size_t>(trackTableOffset);
+  m_RecordSize = static_cast<size_t>(recordSize);
+  return true;
+}
+
+std::string Reader::GetTrackName(uint32_t track) const
+{
+  if (track >= m_TrackCount) return "";
+
+  TrackFileTrack entry = GetTrack(track);
+  return std::string(reinterpret_cast<char const*>(m_pData + entry.NameOffset), entry.NameLength);
+}
+
+uint32_t Reader::GetNodeCount(uint32_t track) const
+{
+  if (track >= m_TrackCount) return 0;
+  return GetTrack(track).NodeCount;
+}
+
+NodeRecord Reader::GetNode(uint32_t track, uint32_t node) const
+{
+  NodeRecord record;
+  memset(&record, 0, sizeof(record));
+
+  if (track >= m_TrackCount) return record;
+
+  TrackFileTrack entry = GetTrack(track);
+  if (node >= entry.NodeCount) return record;
+
+  size_t offset = entry.NodeOffset + node * m_RecordSize;
+  record.Time = ReadAt<float>(m_pData, offset);
+
+  for (size_t i = 0; i < m_ChannelMap.size(); ++i)
+  {
+    if (m_ChannelMap[i] >= 0)
+      record.Values[m_ChannelMap[i]] = ReadAt<float>(m_pData, offset + (i + 1) * sizeof(float));
+  }
+
+  return record;
+}
+
+TrackFileTrack Reader::GetTrack(uint32_t track) const
+{
+  return ReadAt<TrackFileTrack>(m_pData, m_TrackTableOffset + track * sizeof(TrackFileTrack));
+}
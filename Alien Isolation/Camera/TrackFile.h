@@ -0,0 +1,98 @@
+#pragma once
+#include "TrackEvaluator.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary container for camera tracks, all values little-endian:
+//
+//   Header         TrackFileHeader
+//   Channel table  ChannelCount x TrackFileChannel
+//   Track table    TrackCount x TrackFileTrack
+//   Node records   per node: float time, then one float per channel
+//   Names          UTF-8, not null terminated
+//
+// Channels are stored by TrackChannel id, so a newer version can add
+// channels without breaking older readers. Unknown channels are
+// skipped and missing ones read as zero.
+//
+// Doesn't depend on Windows or DirectX headers.
+namespace trackfile
+{
+  const uint32_t Magic = 0x4B525443; // "CTRK"
+  const uint16_t Version = 1;
+
+#pragma pack(push, 1)
+  struct TrackFileHeader
+  {
+    uint32_t Magic;
+    uint16_t Version;
+    uint16_t HeaderSize;
+    uint32_t ChannelCount;
+    uint32_t TrackCount;
+  };
+
+  struct TrackFileChannel
+  {
+    uint16_t Id;
+    uint16_t Reserved;
+  };
+
+  struct TrackFileTrack
+  {
+    uint32_t NameOffset;
+    uint32_t NameLength;
+    uint32_t NodeOffset;
+    uint32_t NodeCount;
+  };
+#pragma pack(pop)
+
+  // One node in TrackChannel order
+  struct NodeRecord
+  {
+    float Time;
+    float Values[TrackChannel_Count];
+  };
+
+  // Serializes tracks into memory, every track is written with all
+  // channels this build knows about
+  class Writer
+  {
+  public:
+    void AddTrack(std::string const& name, std::vector<NodeRecord> const& nodes);
+    std::vector<uint8_t> Finish() const;
+
+  private:
+    std::vector<std::string> m_Names;
+    std::vector<std::vector<NodeRecord>> m_Tracks;
+  };
+
+  // Reads tracks straight from a buffer, usually a mapped file. Open
+  // validates every table and offset, so the accessors never read
+  // out of bounds even on a corrupted file. The buffer has to stay
+  // alive for as long as the reader is used.
+  class Reader
+  {
+  public:
+    bool Open(void const* pData, size_t size, std::string& error);
+
+    uint32_t GetTrackCount() const { return m_TrackCount; }
+    std::string GetTrackName(uint32_t track) const;
+    uint32_t GetNodeCount(uint32_t track) const;
+    NodeRecord GetNode(uint32_t track, uint32_t node) const;
+
+  private:
+    TrackFileTrack GetTrack(uint32_t track) const;
+
+  private:
+    uint8_t const* m_pData{ nullptr };
+    size_t m_Size{ 0 };
+
+    uint32_t m_TrackCount{ 0 };
+    size_t m_TrackTableOffset{ 0 };
+    size_t m_RecordSize{ 0 };
+
+    // Where each file channel goes in NodeRecord::Values, -1 if unknown
+    std::vector<int> m_ChannelMap;
+  };
+}
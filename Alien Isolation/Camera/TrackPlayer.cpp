@@ -1,24 +1,86 @@
 #include "TrackPlayer.h"
+#include "TrackFile.h"
 #include "../Main.h"
+#include "../Util/ConfigWriter.h"
 #include "../Util/Util.h"
 #include "../Util/ImGuiEXT.h"
+#include "../Util/MappedFile.h"
 #include "../resource.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
 
 using namespace DirectX;
 
+static const char* g_trackDirectory = "./Cinematic Tools/Tracks/";
+
+// Ten minutes at 120 fps
+static const size_t g_takeCapacity = 10 * 60 * 120;
+
+static trackfile::NodeRecord NodeToRecord(CatmullRomNode const& node)
+{
+  trackfile::NodeRecord record;
+  record.Time = node.TimeStamp;
+  record.Values[TrackChannel_PositionX] = node.Position.x;
+  record.Values[TrackChannel_PositionY] = node.Position.y;
+  record.Values[TrackChannel_PositionZ] = node.Position.z;
+  record.Values[TrackChannel_RotationX] = node.Rotation.x;
+  record.Values[TrackChannel_RotationY] = node.Rotation.y;
+  record.Values[TrackChannel_RotationZ] = node.Rotation.z;
+  record.Values[TrackChannel_RotationW] = node.Rotation.w;
+  record.Values[TrackChannel_FieldOfView] = node.FieldOfView;
+  record.Values[TrackChannel_FocusDistance] = node.FocusDistance;
+  record.Values[TrackChannel_DofScale] = node.DofScale;
+  record.Values[TrackChannel_DofStrength] = node.DofStrength;
+  return record;
+}
+
+static CatmullRomNode RecordToNode(trackfile::NodeRecord const& record)
+{
+  CatmullRomNode node;
+  node.TimeStamp = record.Time;
+  node.Position = XMFLOAT3(record.Values[TrackChannel_PositionX],
+    record.Values[TrackChannel_PositionY],
+    record.Values[TrackChannel_PositionZ]);
+  node.Rotation = XMFLOAT4(record.Values[TrackChannel_RotationX],
+    record.Values[TrackChannel_RotationY],
+    record.Values[TrackChannel_RotationZ],
+    record.Values[TrackChannel_RotationW]);
+  node.FieldOfView = record.Values[TrackChannel_FieldOfView];
+  node.FocusDistance = record.Values[TrackChannel_FocusDistance];
+  node.DofScale = record.Values[TrackChannel_DofScale];
+  node.DofStrength = record.Values[TrackChannel_DofStrength];
+
+  node.Transform = XMMatrixRotationQuaternion(XMLoadFloat4(&node.Rotation));
+  node.Transform.r[3] = XMLoadFloat3(&node.Position);
+  node.Transform.r[3].m128_f32[3] = 1.0f;
+  return node;
+}
+
 TrackPlayer::TrackPlayer() :
   m_IsPlaying(false),
   m_LockRotation(true),
   m_LockFieldOfView(false),
   m_ManualPlay(false),
+  m_ConstantSpeed(false),
   m_NodeTimeSpan(3.0f),
-  m_CurrentNode(0),
-  m_CurrentTime(0),
-  m_RunningId(2)
+  m_RestartRequested(false),
+  m_SeekTime(0),
+  m_SeekRequested(false),
+  m_PlaybackTime(0),
+  m_ScrubTime(0),
+  m_SelectedTrack(0),
+  m_RunningId(2),
+  m_TrackFileName("Tracks\0"),
+  m_Recorder(g_takeCapacity),
+  m_RecordToggled(false),
+  m_TakeId(1)
 {
   m_Tracks.emplace_back("Track #1");
+  m_Tracks[0].Snapshot = std::make_shared<TrackSnapshot>();
   m_TrackNames.push_back(m_Tracks[0].Name.c_str());
+  PublishSelectedTrack();
 
   m_pCameraModel = g_mainHandle->GetRenderer()->CreateModelFromResource(IDR_OBJ_CAMERA);
 }
@@ -47,299 +109,309 @@ void TrackPlayer::CreateNode(Camera const& camera)
 
   newNode.TimeStamp = 0;
 
-  size_t nodes = m_Tracks[m_SelectedTrack].Nodes.size();
+  std::lock_guard<std::mutex> lock(m_TrackMutex);
+  CameraTrack& track = m_Tracks[m_SelectedTrack];
+  std::shared_ptr<TrackSnapshot const> pSnapshot = std::atomic_load(&track.Snapshot);
+
+  size_t nodes = pSnapshot->GetNodeCount();
   if (nodes > 0)
-    newNode.TimeStamp = m_Tracks[m_SelectedTrack].Nodes[nodes - 1].TimeStamp + m_NodeTimeSpan;
+    newNode.TimeStamp = pSnapshot->GetNodes()[nodes - 1].TimeStamp + m_NodeTimeSpan;
+
+  pSnapshot = pSnapshot->CopyWithNode(newNode);
+  std::atomic_store(&track.Snapshot, pSnapshot);
+  PublishSelectedTrack();
 
-  m_Tracks[m_SelectedTrack].Nodes.push_back(newNode);
-  SmoothTrack();
-  UpdateNodeBuffers();
-  util::log::Write("Node created, total nodes: %d", m_Tracks[m_SelectedTrack].Nodes.size());
+  track.Preview.OnNodeInserted(pSnapshot->GetNodeCount(), pSnapshot->GetNodeCount() - 1);
+  UpdateNodeBuffers(track, *pSnapshot);
+
+  util::log::Write("Node created, total nodes: %d", pSnapshot->GetNodeCount());
 }
 
 void TrackPlayer::DeleteNode()
 {
   if (m_IsPlaying) return;
 
-  std::vector<CatmullRomNode>& nodes = m_Tracks[m_SelectedTrack].Nodes;
-  if (nodes.size() == 0) return;
+  std::lock_guard<std::mutex> lock(m_TrackMutex);
+  CameraTrack& track = m_Tracks[m_SelectedTrack];
+  std::shared_ptr<TrackSnapshot const> pSnapshot = std::atomic_load(&track.Snapshot);
+  if (pSnapshot->GetNodeCount() == 0) return;
+
+  pSnapshot = pSnapshot->CopyWithoutLastNode();
+  std::atomic_store(&track.Snapshot, pSnapshot);
+  PublishSelectedTrack();
+
+  track.Preview.OnNodeErased(pSnapshot->GetNodeCount(), pSnapshot->GetNodeCount());
+  UpdateNodeBuffers(track, *pSnapshot);
 
-  nodes.erase(nodes.begin() + (nodes.size() - 1));
-  SmoothTrack();
-  UpdateNodeBuffers();
-  util::log::Write("Deleted node, remaining nodes %d", nodes.size());
+  util::log::Write("Deleted node, remaining nodes %d", pSnapshot->GetNodeCount());
 }
 
 void TrackPlayer::Toggle()
 {
-  if (m_Tracks[m_SelectedTrack].Nodes.size() <= 1)
+  if (GetSnapshot()->GetNodeCount() <= 1)
   {
     util::log::Warning("Can't play a camera track with less than 2 nodes");
     return;
   }
 
-  m_IsPlaying = !m_IsPlaying;
-  if (!m_IsPlaying) return;
+  // The cursor belongs to the camera thread, it restarts from the
+  // beginning on the first frame it plays
+  bool playing = !m_IsPlaying;
+  if (playing)
+    m_RestartRequested = true;
 
-  m_CurrentTime = 0;
-  m_CurrentNode = 0;
+  m_IsPlaying = playing;
 }
 
 CatmullRomNode TrackPlayer::PlayForwardSmooth(float dt, bool ignoreManual /*= false*/)
 {
-  std::vector<CatmullRomNode>& nodes = m_Tracks[m_SelectedTrack].Nodes;
-  std::vector<SmoothNode>& smoothNodes = m_Tracks[m_SelectedTrack].SmoothNodes;
-
-  CatmullRomNode resultNode;
+  ApplySeek();
 
   if (!m_ManualPlay || ignoreManual)
-    m_CurrentTime += dt;
+    m_Cursor.Time += dt;
   else
   {
     float controlMultiplier = g_mainHandle->GetInputSystem()->GetActionState(Action::Camera_Up);
     controlMultiplier -= g_mainHandle->GetInputSystem()->GetActionState(Action::Camera_Down);
-    m_CurrentTime += dt * controlMultiplier;
+    m_Cursor.Time += dt * controlMultiplier;
   }
 
-  std::vector<CatmullRomNode>::iterator n0, n1, n2, n3;
-
-  bool goForward = false; // Time is increasing, should we move on to the next nodes?
-  bool goBackward = false; // Time is decreasing, should we move on to the previous nodes?
+  CatmullRomNode node = GetSnapshot()->Sample(m_Cursor, m_ConstantSpeed ? TrackTiming_ConstantSpeed : TrackTiming_Eased);
+  m_PlaybackTime = m_Cursor.Time;
+  return node;
+}
 
-  // Detect if we should move onto the next/previous node. If we're at the
-  // start or the end, return those nodes.
-  while ((goForward = m_CurrentTime >= nodes[m_CurrentNode + 1].TimeStamp) ||
-    (goBackward = m_CurrentTime < nodes[m_CurrentNode].TimeStamp))
-  {
-    if (goForward)
-    {
-      if (m_CurrentNode + 1 < nodes.size() - 1)
-      {
-        m_CurrentNode++;
-      }
-      else
-      {
-        resultNode.Rotation = nodes[m_CurrentNode + 1].Rotation;
-        resultNode.Position = nodes[m_CurrentNode + 1].Position;
-        resultNode.FieldOfView = nodes[m_CurrentNode + 1].FieldOfView;
-        return resultNode;
-      }
-    }
-    else if (goBackward)
-    {
-      if (m_CurrentNode - 1 >= 0)
-      {
-        m_CurrentNode -= 1;
-      }
-      else
-      {
-        m_CurrentTime = 0;
-        resultNode.Rotation = nodes[0].Rotation;
-        resultNode.Position = nodes[0].Position;
-        resultNode.FieldOfView = nodes[0].FieldOfView;
-        return resultNode;
-      }
-    }
-  }
+CatmullRomNode TrackPlayer::PlayForward(float dt, bool ignoreManual /*= false*/)
+{
+  ApplySeek();
 
-  n1 = nodes.begin() + m_CurrentNode;
-  n2 = n1 + 1;
-  n0 = m_CurrentNode > 0 ? n1 - 1 : n1;
-  n3 = m_CurrentNode + 1 < nodes.size() - 1 ? n2 + 1 : n2;
+  // Default time from node to node is 1 second.
+  // NodeTimeSpan modifies this. 
+  float timeMultiplier = (1.f / m_NodeTimeSpan);
 
-  while (m_CurrentTime >= smoothNodes[m_CurrentSmoothNode + 1].Time)
+  // If manual play is enabled, time is multiplied
+  // by input.
+  if (!m_ManualPlay || ignoreManual)
+    m_Cursor.Time += dt * timeMultiplier;
+  else
   {
-    if (m_CurrentSmoothNode < smoothNodes.size() - 2)
-      m_CurrentSmoothNode++;
+    float controlMultiplier = g_mainHandle->GetInputSystem()->GetActionState(Action::Camera_Up);
+    controlMultiplier -= g_mainHandle->GetInputSystem()->GetActionState(Action::Camera_Down);
+    m_Cursor.Time += dt * timeMultiplier * controlMultiplier;
   }
 
-  while (m_CurrentTime < smoothNodes[m_CurrentSmoothNode].Time)
-    m_CurrentSmoothNode -= 1;
-
-  float smoothNodeTimeInterval = smoothNodes[m_CurrentSmoothNode + 1].Time - smoothNodes[m_CurrentSmoothNode].Time;
-  float smoothNodeValueInterval = smoothNodes[m_CurrentSmoothNode + 1].Value - smoothNodes[m_CurrentSmoothNode].Value;
-
-  float interpolation = (m_CurrentTime - smoothNodes[m_CurrentSmoothNode].Time) / smoothNodeTimeInterval;
-  float mu = (smoothNodes[m_CurrentSmoothNode].Value + smoothNodeValueInterval * interpolation) - m_CurrentNode;
-
-  XMVECTOR qRot0 = XMLoadFloat4(&n0->Rotation);
-  XMVECTOR qRot1 = XMLoadFloat4(&n1->Rotation);
-  XMVECTOR qRot2 = XMLoadFloat4(&n2->Rotation);
-  XMVECTOR qRot3 = XMLoadFloat4(&n3->Rotation);
-
-  XMVECTOR vPos0 = XMLoadFloat3(&n0->Position);
-  XMVECTOR vPos1 = XMLoadFloat3(&n1->Position);
-  XMVECTOR vPos2 = XMLoadFloat3(&n2->Position);
-  XMVECTOR vPos3 = XMLoadFloat3(&n3->Position);
-
-  resultNode.FieldOfView = util::math::CatmullRomInterpolate(n0->FieldOfView,
-    n1->FieldOfView,
-    n2->FieldOfView,
-    n3->FieldOfView, mu);
+  CatmullRomNode node = GetSnapshot()->Sample(m_Cursor, TrackTiming_Linear);
+  m_PlaybackTime = m_Cursor.Time;
+  return node;
+}
 
-  resultNode.FocusDistance = util::math::CatmullRomInterpolate(n0->FocusDistance,
-    n1->FocusDistance,
-    n2->FocusDistance,
-    n3->FocusDistance, mu);
+void TrackPlayer::Seek(float time)
+{
+  m_SeekTime = time;
+  m_SeekRequested = true;
+}
 
-  resultNode.DofStrength = util::math::CatmullRomInterpolate(n0->DofStrength,
-    n1->DofStrength,
-    n2->DofStrength,
-    n3->DofStrength, mu);
+bool TrackPlayer::TakeSeekedNode(CatmullRomNode& node)
+{
+  if (m_IsPlaying || !m_SeekRequested.exchange(false))
+    return false;
 
-  resultNode.DofScale = util::math::CatmullRomInterpolate(n0->DofScale,
-    n1->DofScale,
-    n2->DofScale,
-    n3->DofScale, mu);
+  std::shared_ptr<TrackSnapshot const> pSnapshot = GetSnapshot();
+  if (pSnapshot->GetNodeCount() == 0)
+    return false;
 
-  XMVECTOR resultRot = XMVectorCatmullRom(qRot0, qRot1, qRot2, qRot3, mu);
-  XMVECTOR resultPos = XMVectorCatmullRom(vPos0, vPos1, vPos2, vPos3, mu);
+  node = pSnapshot->Evaluate(m_SeekTime, m_ConstantSpeed ? TrackTiming_ConstantSpeed : TrackTiming_Eased);
+  return true;
+}
 
-  XMStoreFloat4(&resultNode.Rotation, XMQuaternionNormalize(resultRot));
-  XMStoreFloat3(&resultNode.Position, resultPos);
+void TrackPlayer::ApplySeek()
+{
+  if (m_RestartRequested.exchange(false))
+    m_Cursor = TrackCursor();
 
-  return resultNode;
+  // The cursor's segment is only a hint, so
+  // jumping anywhere just needs a new time
+  if (m_SeekRequested.exchange(false))
+    m_Cursor.Time = m_SeekTime;
 }
 
-CatmullRomNode TrackPlayer::PlayForward(float dt, bool ignoreManual /*= false*/)
+void TrackPlayer::ToggleRecording()
 {
-  std::vector<CatmullRomNode>& nodes = m_Tracks[m_SelectedTrack].Nodes;
-
-  // Default time from node to node is 1 second.
-  // NodeTimeSpan modifies this. 
-  float timeMultiplier = (1.f / m_NodeTimeSpan);
+  m_RecordToggled = true;
+}
 
-  CatmullRomNode resultNode;
-  // If manual play is enabled, time is multiplied
-  // by input. IgnoreManual is for generating display buffers.
-  if (!m_ManualPlay || ignoreManual)
-    m_CurrentTime += dt * timeMultiplier;
-  else
+void TrackPlayer::RecordFrame(CatmullRomNode const& frame, float dt)
+{
+  if (m_RecordToggled.exchange(false))
   {
-    float controlMultiplier = g_mainHandle->GetInputSystem()->GetActionState(Action::Camera_Up);
-    controlMultiplier -= g_mainHandle->GetInputSystem()->GetActionState(Action::Camera_Down);
-    m_CurrentTime += dt * timeMultiplier * controlMultiplier;
+    if (m_Recorder.IsRecording())
+      StopRecording();
+    else if (m_IsPlaying)
+      util::log::Warning("Can't record a take while a camera track is playing");
+    else if (!m_Recorder.Start())
+      util::log::Warning("Previous take is still being reduced");
+    else
+      util::log::Write("Recording a take");
   }
 
-  std::vector<CatmullRomNode>::iterator n0, n1, n2, n3;
+  if (!m_Recorder.IsRecording()) return;
 
-  bool goForward = false; // Time is increasing, should we move on to the next nodes?
-  bool goBackward = false; // Time is decreasing, should we move on to the previous nodes?
+  // Same channel layout as the records
+  trackfile::NodeRecord record = NodeToRecord(frame);
+  m_Recorder.AddFrame(dt, record.Values);
 
-  // Detect if we should move onto the next/previous node. If we're at the
-  // start or the end, return those nodes.
-  while ((goForward = m_CurrentTime >= nodes[m_CurrentNode + 1].TimeStamp) ||
-    (goBackward = m_CurrentTime < nodes[m_CurrentNode].TimeStamp))
+  if (m_Recorder.IsFull())
   {
-    if (goForward)
-    {
-      if (m_CurrentNode + 1 < nodes.size() - 1)
-      {
-        m_CurrentNode++;
-      }
-      else
-      {
-        resultNode.Rotation = nodes[m_CurrentNode + 1].Rotation;
-        resultNode.Position = nodes[m_CurrentNode + 1].Position;
-        resultNode.FieldOfView = nodes[m_CurrentNode + 1].FieldOfView;
-        return resultNode;
-      }
-    }
-    else if (goBackward)
-    {
-      if (m_CurrentNode - 1 >= 0)
-      {
-        m_CurrentNode -= 1;
-      }
-      else
-      {
-        m_CurrentTime = 0;
-        resultNode.Rotation = nodes[0].Rotation;
-        resultNode.Position = nodes[0].Position;
-        resultNode.FieldOfView = nodes[0].FieldOfView;
-        return resultNode;
-      }
-    }
+    util::log::Warning("Take is full after %d frames, stopping", m_Recorder.GetCapacity());
+    StopRecording();
   }
+}
 
-  n1 = nodes.begin() + m_CurrentNode;
-  n2 = n1 + 1;
-  n0 = m_CurrentNode > 0 ? n1 - 1 : n1;
-  n3 = m_CurrentNode + 1 < nodes.size() - 1 ? n2 + 1 : n2;
+void TrackPlayer::StopRecording()
+{
+  m_RecordToggled = false;
+  if (!m_Recorder.IsRecording()) return;
 
-  float mu = (m_CurrentTime - n1->TimeStamp) / (n2->TimeStamp - n1->TimeStamp);
+  if (m_Recorder.Stop(m_TakeTolerance))
+    util::log::Write("Take stopped, reducing it to nodes");
+  else
+    util::log::Warning("Take is too short to make a track");
+}
 
-  XMVECTOR qRot0 = XMLoadFloat4(&n0->Rotation);
-  XMVECTOR qRot1 = XMLoadFloat4(&n1->Rotation);
-  XMVECTOR qRot2 = XMLoadFloat4(&n2->Rotation);
-  XMVECTOR qRot3 = XMLoadFloat4(&n3->Rotation);
+void TrackPlayer::Update()
+{
+  ReducedTake take;
+  if (!m_Recorder.TryGetResult(take)) return;
 
-  XMVECTOR vPos0 = XMLoadFloat3(&n0->Position);
-  XMVECTOR vPos1 = XMLoadFloat3(&n1->Position);
-  XMVECTOR vPos2 = XMLoadFloat3(&n2->Position);
-  XMVECTOR vPos3 = XMLoadFloat3(&n3->Position);
+  std::vector<CatmullRomNode> nodes;
+  nodes.reserve(take.Nodes.size());
+  for (auto const& sample : take.Nodes)
+  {
+    trackfile::NodeRecord record;
+    record.Time = sample.Time;
+    std::copy(std::begin(sample.Values), std::end(sample.Values), record.Values);
+    nodes.push_back(RecordToNode(record));
+  }
 
-  resultNode.FieldOfView = util::math::CatmullRomInterpolate(n0->FieldOfView,
-    n1->FieldOfView,
-    n2->FieldOfView,
-    n3->FieldOfView, mu);
+  std::shared_ptr<TrackSnapshot> pSnapshot = TrackSnapshot::Create(nodes);
 
-  resultNode.FocusDistance = util::math::CatmullRomInterpolate(n0->FocusDistance,
-    n1->FocusDistance,
-    n2->FocusDistance,
-    n3->FocusDistance, mu);
+  {
+    std::lock_guard<std::mutex> lock(m_TrackMutex);
 
-  resultNode.DofStrength = util::math::CatmullRomInterpolate(n0->DofStrength,
-    n1->DofStrength,
-    n2->DofStrength,
-    n3->DofStrength, mu);
+    m_Tracks.emplace_back("Take #" + std::to_string(m_TakeId++));
+    m_Tracks.back().Snapshot = pSnapshot;
+    UpdateNodeBuffers(m_Tracks.back(), *pSnapshot);
+    UpdateNameList();
 
-  resultNode.DofScale = util::math::CatmullRomInterpolate(n0->DofScale,
-    n1->DofScale,
-    n2->DofScale,
-    n3->DofScale, mu);
+    // Don't switch tracks under a playing camera
+    if (!m_IsPlaying)
+      SelectTrack(m_Tracks.size() - 1);
+  }
+  util::log::Ok("Reduced a %.1f second take from %d frames to %d nodes", take.Duration, take.SampleCount, nodes.size());
+  util::log::Write("Largest error: position %.4f, rotation %.3f, fov %.3f, dof %.4f",
+    take.Error.Position, take.Error.Rotation, take.Error.FieldOfView, take.Error.DepthOfField);
+}
 
-  XMVECTOR resultRot = XMVectorCatmullRom(qRot0, qRot1, qRot2, qRot3, mu);
-  XMVECTOR resultPos = XMVectorCatmullRom(vPos0, vPos1, vPos2, vPos3, mu);
+std::shared_ptr<TrackSnapshot const> TrackPlayer::GetSnapshot() const
+{
+  return std::atomic_load(&m_SelectedSnapshot);
+}
 
-  XMStoreFloat4(&resultNode.Rotation, XMQuaternionNormalize(resultRot));
-  XMStoreFloat3(&resultNode.Position, resultPos);
+void TrackPlayer::SelectTrack(unsigned int index)
+{
+  m_SelectedTrack = index;
+  PublishSelectedTrack();
+}
 
-  return resultNode;
+void TrackPlayer::PublishSelectedTrack()
+{
+  std::atomic_store(&m_SelectedSnapshot, std::atomic_load(&m_Tracks[m_SelectedTrack].Snapshot));
 }
 
 void TrackPlayer::DrawUI()
 {
-  ImGui::Text("Camera tracks");
-  ImGui::Combo("##CameraTrackList", (int*)&m_SelectedTrack, &m_TrackNames[0], m_TrackNames.size());
-  if (ImGui::Button("Create", ImVec2(95, 25)))
-    CreateTrack();
+  {
+    std::lock_guard<std::mutex> lock(m_TrackMutex);
+
+    ImGui::Text("Camera tracks");
+    int selectedTrack = m_SelectedTrack;
+    if (ImGui::Combo("##CameraTrackList", &selectedTrack, &m_TrackNames[0], m_TrackNames.size()))
+      SelectTrack(selectedTrack);
+    if (ImGui::Button("Create", ImVec2(95, 25)))
+      CreateTrack();
+    ImGui::SameLine(0, 10);
+    if (ImGui::Button("Delete", ImVec2(95, 25)))
+      DeleteTrack();
+  }
+  ImGui::Dummy(ImVec2(0, 5));
+  ImGui::Text("Track file");
+  ImGui::InputText("##CameraTrackFile", m_TrackFileName, 50);
+  if (ImGui::Button("Save", ImVec2(95, 25)))
+    SaveTracks();
   ImGui::SameLine(0, 10);
-  if (ImGui::Button("Delete", ImVec2(95, 25)))
-    DeleteTrack();
+  if (ImGui::Button("Load", ImVec2(95, 25)))
+    LoadTracks();
   ImGui::Dummy(ImVec2(0, 5));
   ImGui::Dummy(ImVec2(0, 5));
   ImGui::Text("Time between previous node");
   ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 10));
-  ImGui::InputFloat("##CameraTrackNodeTime", &m_NodeTimeSpan, 0.1f, 0, 2);
+  if (ImGui::InputFloat("##CameraTrackNodeTime", &m_NodeTimeSpan, 0.1f, 0, 2))
+  {
+    // Node times have to keep increasing
+    m_NodeTimeSpan = std::max(m_NodeTimeSpan, 0.1f);
+  }
 
   ImGui::Checkbox("Lock field of view", &m_LockFieldOfView);
   ImGui::Checkbox("Lock depth of field", &m_LockDepthOfField);
   ImGui::Checkbox("Lock rotation", &m_LockRotation);
   ImGui::Checkbox("Play manually", &m_ManualPlay);
+  ImGui::Checkbox("Constant speed", &m_ConstantSpeed);
   ImGui::PopStyleVar();
+
+  // Seeks while playing, otherwise the camera previews the track
+  std::shared_ptr<TrackSnapshot const> pSnapshot = GetSnapshot();
+  if (pSnapshot->GetNodeCount() > 1)
+  {
+    std::vector<CatmullRomNode> const& nodes = pSnapshot->GetNodes();
+    if (m_IsPlaying)
+      m_ScrubTime = m_PlaybackTime;
+
+    ImGui::Dummy(ImVec2(0, 5));
+    ImGui::Text("Track time");
+    if (ImGui::SliderFloat("##CameraTrackTime", &m_ScrubTime, nodes.front().TimeStamp, nodes.back().TimeStamp, "%.2f s"))
+      Seek(m_ScrubTime);
+  }
+
+  ImGui::Dummy(ImVec2(0, 5));
+  ImGui::Text("Take tolerance, position / rotation");
+  ImGui::InputFloat("##TakePositionTolerance", &m_TakeTolerance.Position, 0.001f, 0, 3);
+  ImGui::InputFloat("##TakeRotationTolerance", &m_TakeTolerance.Rotation, 0.01f, 0, 2);
+  ImGui::Text("Take tolerance, fov / depth of field");
+  ImGui::InputFloat("##TakeFovTolerance", &m_TakeTolerance.FieldOfView, 0.01f, 0, 2);
+  ImGui::InputFloat("##TakeDofTolerance", &m_TakeTolerance.DepthOfField, 0.001f, 0, 3);
+
+  if (m_Recorder.IsReducing())
+    ImGui::Button("Reducing take...", ImVec2(200, 25));
+  else if (ImGui::Button(m_Recorder.IsRecording() ? "Stop take" : "Record take", ImVec2(200, 25)))
+    ToggleRecording();
 }
 
 void TrackPlayer::DrawNodes()
 {
   if (m_IsPlaying) return;
 
+  std::lock_guard<std::mutex> lock(m_TrackMutex);
   CameraTrack& track = m_Tracks[m_SelectedTrack];
-  for (auto& node : track.Nodes)
+  std::shared_ptr<TrackSnapshot const> pSnapshot = std::atomic_load(&track.Snapshot);
+  for (auto& node : pSnapshot->GetNodes())
     g_mainHandle->GetRenderer()->DrawModel(m_pCameraModel.get(), node.Transform, { 1,0,0 });
 
+  // The preview is built on whichever thread edited the track,
+  // but the context can only be used from the render thread
+  UploadNodeBuffers(track);
+
   if (track.IndexCount > 0)
-    g_mainHandle->GetRenderer()->DrawLines(track.Indices.Get(), track.Vertices.Get(), track.IndexCount);
+    g_mainHandle->GetRenderer()->DrawLines(track.Indices.pBuffer.Get(), track.Vertices.pBuffer.Get(), track.IndexCount);
 }
 
 void TrackPlayer::CreateTrack()
@@ -347,9 +419,9 @@ void TrackPlayer::CreateTrack()
   if (m_IsPlaying) return;
 
   m_Tracks.emplace_back("Track #" + std::to_string(m_RunningId++));
-  m_SelectedTrack = m_Tracks.size() - 1;
-
+  m_Tracks.back().Snapshot = std::make_shared<TrackSnapshot>();
   UpdateNameList();
+  SelectTrack(m_Tracks.size() - 1);
 }
 
 void TrackPlayer::DeleteTrack()
@@ -357,120 +429,149 @@ void TrackPlayer::DeleteTrack()
   if (m_IsPlaying || m_Tracks.size() <= 1) return;
 
   m_Tracks.erase(m_Tracks.begin() + m_SelectedTrack);
-  if (m_SelectedTrack >= m_Tracks.size())
-    m_SelectedTrack -= 1;
-
   UpdateNameList();
+  SelectTrack(m_SelectedTrack < m_Tracks.size() ? m_SelectedTrack : m_Tracks.size() - 1);
 }
 
-void TrackPlayer::UpdateNodeBuffers()
+void TrackPlayer::SaveTracks()
 {
-  CameraTrack& track = m_Tracks[m_SelectedTrack];
-  const std::vector<CatmullRomNode>& nodes = track.Nodes;
+  std::unique_lock<std::mutex> lock(m_TrackMutex);
+  size_t trackCount = m_Tracks.size();
 
-  track.Vertices.Reset();
-  track.Indices.Reset();
+  trackfile::Writer writer;
+  for (auto const& track : m_Tracks)
+  {
+    std::shared_ptr<TrackSnapshot const> pSnapshot = std::atomic_load(&track.Snapshot);
 
-  if (nodes.size() < 2)
-    return;
+    std::vector<trackfile::NodeRecord> records;
+    records.reserve(pSnapshot->GetNodeCount());
+    for (auto const& node : pSnapshot->GetNodes())
+      records.push_back(NodeToRecord(node));
 
-  std::vector<VertexPositionColor> verticesVector;
-  std::vector<unsigned int> indicesVector;
+    writer.AddTrack(track.Name, records);
+  }
 
-  VertexPositionColor v1, v2;
-  v1.position = nodes[0].Position;
-  v1.color = v2.color = XMFLOAT4(1, 0, 0, 1);
+  lock.unlock();
 
-  XMVECTOR forward = XMVector3Rotate(XMVectorSet(0, 0, 1, 0), XMLoadFloat4(&nodes[0].Rotation));
-  XMStoreFloat3(&v2.position, XMLoadFloat3(&nodes[0].Position) - 0.5f*forward);
+  std::vector<uint8_t> data = writer.Finish();
+  std::string path = g_trackDirectory + std::string(m_TrackFileName) + ".cttrack";
 
-  verticesVector.push_back(v2);
-  verticesVector.push_back(v1);
-  indicesVector.push_back(0);
-  indicesVector.push_back(1);
+  // Replaced in one step, so a crash while saving keeps the old tracks
+  std::string error;
+  if (!util::ConfigWriter::Write(path, std::string(data.begin(), data.end()), &error))
+  {
+    util::log::Error("Failed to save camera tracks: %s", error.c_str());
+    return;
+  }
 
-  m_CurrentTime = 0;
-  m_CurrentNode = 0;
-  int lastNodeVertexIndex = 0;
-  int stepCount = 0;
+  util::log::Ok("Saved %d camera tracks to %s", trackCount, path.c_str());
+}
 
-  // Play through the track, save nodes into vertices
-  while (m_CurrentTime < nodes[nodes.size() - 1].TimeStamp)
-  {
-    stepCount++;
+void TrackPlayer::LoadTracks()
+{
+  if (m_IsPlaying) return;
 
-    VertexPositionColor nodeVertex, forwardVertex;
-    nodeVertex.color = forwardVertex.color = XMFLOAT4(1, 0, 0, 1);
+  std::string path = g_trackDirectory + std::string(m_TrackFileName) + ".cttrack";
 
-    CatmullRomNode node = PlayForward(0.1f, true);
-    nodeVertex.position = node.Position;
+  util::MappedFile file;
+  if (!file.Open(path))
+    return;
 
-    verticesVector.push_back(nodeVertex);
-    indicesVector.push_back(verticesVector.size() - 1); // Current node vertex
+  trackfile::Reader reader;
+  std::string error;
+  if (!reader.Open(file.GetData(), file.GetSize(), error))
+  {
+    util::log::Error("Could not load camera tracks from %s: %s", path.c_str(), error.c_str());
+    return;
+  }
 
-    lastNodeVertexIndex = verticesVector.size() - 1;
+  std::vector<CameraTrack> tracks;
+  for (uint32_t i = 0; i < reader.GetTrackCount(); ++i)
+  {
+    std::vector<CatmullRomNode> nodes;
+    nodes.reserve(reader.GetNodeCount(i));
 
-    // Create forward line to indicate 0.5 second of track time
-    if (stepCount % 5 == 0)
+    bool valid = true;
+    float startTime = 0;
+    for (uint32_t j = 0; j < reader.GetNodeCount(i) && valid; ++j)
     {
-      XMVECTOR forward = XMVector3Rotate(XMVectorSet(0, 0, 1, 0), XMLoadFloat4(&node.Rotation));
-      XMStoreFloat3(&forwardVertex.position, XMLoadFloat3(&node.Position) - 0.5*forward);
+      nodes.push_back(RecordToNode(reader.GetNode(i, j)));
 
-      verticesVector.push_back(forwardVertex);
-      indicesVector.push_back(verticesVector.size() - 1);
-      indicesVector.push_back(verticesVector.size() - 2);
+      // Tracks start at 0 like the ones made in the tools, and sampling
+      // expects every node to come strictly after the one before it
+      CatmullRomNode& node = nodes.back();
+      if (j == 0)
+        startTime = node.TimeStamp;
+
+      node.TimeStamp -= startTime;
+      valid = std::isfinite(node.TimeStamp) && (j == 0 || node.TimeStamp > nodes[j - 1].TimeStamp);
     }
+
+    std::string name = reader.GetTrackName(i);
+    if (!valid)
+    {
+      util::log::Warning("Skipping camera track %s, its node times don't increase", name.c_str());
+      continue;
+    }
+
+    tracks.emplace_back(name);
+    tracks.back().Snapshot = TrackSnapshot::Create(nodes);
   }
 
-  track.IndexCount = indicesVector.size();
-  g_mainHandle->GetRenderer()->CreateVertexIndexBuffers(indicesVector, verticesVector, track.Vertices.GetAddressOf(), track.Indices.GetAddressOf());
+  if (tracks.empty())
+  {
+    util::log::Warning("No camera tracks in %s", path.c_str());
+    return;
+  }
+
+  size_t trackCount = tracks.size();
+  {
+    std::lock_guard<std::mutex> lock(m_TrackMutex);
+
+    m_Tracks = std::move(tracks);
+    m_RunningId = m_Tracks.size() + 1;
+
+    for (auto& track : m_Tracks)
+      UpdateNodeBuffers(track, *track.Snapshot);
+
+    UpdateNameList();
+    SelectTrack(0);
+  }
 
-  m_CurrentTime = 0;
-  m_CurrentNode = 0;
+  util::log::Ok("Loaded %d camera tracks from %s", trackCount, path.c_str());
 }
 
-void TrackPlayer::UpdateNameList()
+void TrackPlayer::UpdateNodeBuffers(CameraTrack& track, TrackSnapshot const& snapshot)
 {
-  m_TrackNames.clear();
-  for (auto& track : m_Tracks)
-    m_TrackNames.push_back(track.Name.c_str());
+  // Same spacing as playing the track with 0.1 second steps.
+  // Only the segments around edited nodes get re-tessellated.
+  track.Preview.SetTimeStep(0.1f / m_NodeTimeSpan);
+  track.Preview.Update(snapshot.GetEvaluator());
 }
 
-// Generates interpolation values for irregular time intervals
-void TrackPlayer::SmoothTrack()
+void TrackPlayer::UploadNodeBuffers(CameraTrack& track)
 {
-  const std::vector<CatmullRomNode>& nodes = m_Tracks[m_SelectedTrack].Nodes;
-  std::vector<SmoothNode>& smoothNodes = m_Tracks[m_SelectedTrack].SmoothNodes;
-
-  if (nodes.size() < 2) return;
-  smoothNodes.clear();
+  static_assert(sizeof(PreviewVertex) == sizeof(VertexPositionColor), "Preview vertices have to match the line shader input");
 
-  int n0, n1, n2, n3;
-  int currentNode = 0;
-  float currentStep = 0;
-
-  do
-  {
-    if (currentStep > currentNode + 1)
-    {
-      currentNode++;
-      if (currentNode >= static_cast<int>(nodes.size()) - 1)
-        break;
-    }
+  std::vector<PreviewVertex> const& vertices = track.Preview.GetVertices();
+  std::vector<unsigned int> const& indices = track.Preview.GetIndices();
 
-    n1 = currentNode;
-    n2 = currentNode + 1;
-
-    n0 = n1 > 0 ? n1 - 1 : n1;
-    n3 = n2 < static_cast<int>(nodes.size()) - 1 ? n2 + 1 : n2;
+  track.IndexCount = indices.size();
+  if (!track.Preview.HasChanges())
+    return;
 
-    SmoothNode smoothNode;
-    smoothNode.Time = util::math::CatmullRomInterpolate(nodes[n0].TimeStamp, nodes[n1].TimeStamp, nodes[n2].TimeStamp, nodes[n3].TimeStamp, currentStep - n1);
-    smoothNode.Value = currentStep;
+  CTRenderer* pRenderer = g_mainHandle->GetRenderer();
+  pRenderer->UpdateGrowableBuffer(track.Vertices, D3D11_BIND_VERTEX_BUFFER, vertices.data(),
+    vertices.size() * sizeof(PreviewVertex), track.Preview.GetFirstChangedVertex() * sizeof(PreviewVertex));
+  pRenderer->UpdateGrowableBuffer(track.Indices, D3D11_BIND_INDEX_BUFFER, indices.data(),
+    indices.size() * sizeof(unsigned int), track.Preview.GetFirstChangedIndex() * sizeof(unsigned int));
 
-    smoothNodes.push_back(smoothNode);
-    currentStep += 1 / 100.f;
-  } while (true);
+  track.Preview.ClearChanges();
+}
 
-  util::log::Write("Created %d smooth nodes", smoothNodes.size());
+void TrackPlayer::UpdateNameList()
+{
+  m_TrackNames.clear();
+  for (auto& track : m_Tracks)
+    m_TrackNames.push_back(track.Name.c_str());
 }
\ No newline at end of file
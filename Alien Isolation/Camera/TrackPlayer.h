@@ -1,7 +1,11 @@
 #pragma once
 #include "CameraStructs.h"
+#include "TakeRecorder.h"
+#include "TrackSnapshot.h"
 #include <Model.h>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 class TrackPlayer
@@ -17,44 +21,102 @@ public:
   CatmullRomNode PlayForward(float dt, bool ignoreManual = false);
   CatmullRomNode PlayForwardSmooth(float dt, bool ignoreManual = false);
 
+  // Any thread. Moves playback to the given track time, or when the
+  // track isn't playing, has the camera preview it there.
+  void Seek(float time);
+
+  // Camera thread, while the track isn't playing. Returns true with
+  // the node at the seeked time once per seek.
+  bool TakeSeekedNode(CatmullRomNode& node);
+
+  // Starts or stops a take on the next recorded frame, from any thread
+  void ToggleRecording();
+
+  // Camera hook, with the camera of every frame. A stopped take is
+  // reduced to nodes in the background.
+  void RecordFrame(CatmullRomNode const& frame, float dt);
+
+  // Camera hook, when the camera is off. Also drops a pending toggle.
+  void StopRecording();
+
+  // Tools thread. Adds reduced takes as new tracks.
+  void Update();
+
+  // Current state of the selected track, without taking any lock.
+  // Safe to keep and sample on any thread with its own TrackCursor,
+  // edits don't affect it.
+  std::shared_ptr<TrackSnapshot const> GetSnapshot() const;
+
   void DrawUI();
   void DrawNodes();
 
   bool IsPlaying() { return m_IsPlaying; }
+  bool IsRecording() { return m_Recorder.IsRecording(); }
   bool IsRotationLocked() { return m_LockRotation; }
   bool IsFovLocked() { return m_LockFieldOfView; }
   bool IsDofLocked() { return m_LockDepthOfField; }
 
 private:
+  // m_TrackMutex has to be held for these
   void CreateTrack();
   void DeleteTrack();
+  void SelectTrack(unsigned int index);
+  void PublishSelectedTrack();
+
+  void SaveTracks();
+  void LoadTracks();
 
-  void UpdateNodeBuffers();
+  // m_TrackMutex has to be held for these too
+  void UpdateNodeBuffers(CameraTrack& track, TrackSnapshot const& snapshot);
+  void UploadNodeBuffers(CameraTrack& track);
   void UpdateNameList();
 
-  void SmoothTrack();
+  // Camera thread, applies a pending restart or seek to the playback cursor
+  void ApplySeek();
 
 private:
-  bool m_IsPlaying;
+  // Toggled from the tools thread while the camera thread plays
+  std::atomic<bool> m_IsPlaying;
 
   bool m_LockDepthOfField;
   bool m_LockRotation;
   bool m_LockFieldOfView;
   bool m_ManualPlay;
+  bool m_ConstantSpeed;
   float m_NodeTimeSpan;
 
-  unsigned int m_CurrentNode;
-  unsigned int m_CurrentSmoothNode;
-  float m_CurrentTime;
+  TrackCursor m_Cursor; // Playback position, owned by the thread updating the camera
+
+  // Other threads ask the camera thread to move m_Cursor
+  std::atomic<bool> m_RestartRequested;
+  std::atomic<float> m_SeekTime;
+  std::atomic<bool> m_SeekRequested;
+  std::atomic<float> m_PlaybackTime; // Copy of m_Cursor.Time for the UI
+  float m_ScrubTime;
 
+  // Tracks are added by the tools thread and edited from the UI on the
+  // render thread, so both take m_TrackMutex. The camera hook only
+  // reads m_SelectedSnapshot.
   std::vector<CameraTrack> m_Tracks;
   unsigned int m_SelectedTrack;
+  std::shared_ptr<TrackSnapshot const> m_SelectedSnapshot;
 
   std::vector<const char*> m_TrackNames;
   int m_RunningId;
 
+  char m_TrackFileName[50];
+
   std::unique_ptr<DirectX::Model> m_pCameraModel;
 
+  TakeRecorder m_Recorder;
+  TakeTolerance m_TakeTolerance;
+  std::atomic<bool> m_RecordToggled;
+  int m_TakeId;
+
+  // Guards the tracks, their names and preview geometry,
+  // and which one is selected
+  std::mutex m_TrackMutex;
+
 public:
   TrackPlayer(TrackPlayer const&) = delete;
   void operator=(TrackPlayer const&) = delete;
@@ -0,0 +1,237 @@
+#include "TrackPreview.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  // A short line pointing backwards is drawn every this many points
+  // to show which way the camera is facing
+  const unsigned int g_ForwardLineInterval = 5;
+  const float g_ForwardLineLength = 0.5f;
+
+  const float g_LineColor[4] = { 1, 0, 0, 1 };
+
+  PreviewVertex MakeVertex(float x, float y, float z)
+  {
+    PreviewVertex vertex;
+    vertex.Position[0] = x;
+    vertex.Position[1] = y;
+    vertex.Position[2] = z;
+    std::copy(g_LineColor, g_LineColor + 4, vertex.Color);
+    return vertex;
+  }
+
+  // Point behind the camera, the quaternion rotates (0, 0, 1) to its forward vector
+  PreviewVertex MakeForwardVertex(PreviewVertex const& origin, float qx, float qy, float qz, float qw)
+  {
+    float forwardX = 2 * (qx * qz + qw * qy);
+    float forwardY = 2 * (qy * qz - qw * qx);
+    float forwardZ = 1 - 2 * (qx * qx + qy * qy);
+
+    return MakeVertex(origin.Position[0] - g_ForwardLineLength * forwardX,
+      origin.Position[1] - g_ForwardLineLength * forwardY,
+      origin.Position[2] - g_ForwardLineLength * forwardZ);
+  }
+}
+
+void TrackPreview::SetTimeStep(float timeStep)
+{
+  if (timeStep == m_TimeStep) return;
+
+  m_TimeStep = timeStep;
+  Invalidate();
+}
+
+void TrackPreview::OnNodeInserted(unsigned int nodeCount, unsigned int index)
+{
+  if (nodeCount < 2)
+  {
+    Clear();
+    return;
+  }
+
+  if (m_Segments.size() + 2 != nodeCount)
+  {
+    m_Segments.resize(nodeCount - 1);
+    Invalidate();
+    return;
+  }
+
+  // A segment's shape depends on two nodes on both sides of it
+  unsigned int position = std::min<unsigned int>(index, m_Segments.size());
+  m_Segments.insert(m_Segments.begin() + position, PreviewSegment());
+  MarkDirty(static_cast<int>(index) - 2, static_cast<int>(index) + 1);
+}
+
+void TrackPreview::OnNodeErased(unsigned int nodeCount, unsigned int index)
+{
+  if (nodeCount < 2)
+  {
+    Clear();
+    return;
+  }
+
+  if (m_Segments.size() != nodeCount)
+  {
+    m_Segments.resize(nodeCount - 1);
+    Invalidate();
+    return;
+  }
+
+  unsigned int position = std::min<unsigned int>(index, m_Segments.size() - 1);
+  m_Segments.erase(m_Segments.begin() + position);
+  MarkDirty(static_cast<int>(index) - 2, static_cast<int>(index));
+}
+
+void TrackPreview::Invalidate()
+{
+  for (auto& segment : m_Segments)
+    segment.Dirty = true;
+}
+
+void TrackPreview::Clear()
+{
+  m_Segments.clear();
+  m_Vertices.clear();
+  m_Indices.clear();
+  m_FirstChangedVertex = 0;
+  m_FirstChangedIndex = 0;
+}
+
+unsigned int TrackPreview::Update(TrackEvaluator const& evaluator)
+{
+  size_t nodeCount = evaluator.GetNodeCount();
+  if (nodeCount < 2)
+  {
+    Clear();
+    return 0;
+  }
+
+  if (m_Segments.size() != nodeCount - 1)
+  {
+    m_Segments.resize(nodeCount - 1);
+    Invalidate();
+  }
+
+  // Segments before the first dirty one keep their place in the combined arrays
+  auto firstDirty = std::find_if(m_Segments.begin(), m_Segments.end(),
+    [](PreviewSegment const& segment) { return segment.Dirty; });
+
+  unsigned int first = static_cast<unsigned int>(firstDirty - m_Segments.begin());
+  unsigned int keptVertices = 0;
+  unsigned int keptIndices = 0;
+  if (first > 0)
+  {
+    PreviewSegment const& previous = m_Segments[first - 1];
+    keptVertices = previous.BaseVertex + previous.Vertices.size();
+    keptIndices = previous.BaseIndex + previous.Indices.size();
+  }
+
+  m_FirstChangedVertex = std::min(m_FirstChangedVertex, keptVertices);
+  m_FirstChangedIndex = std::min(m_FirstChangedIndex, keptIndices);
+
+  m_Vertices.resize(keptVertices);
+  m_Indices.resize(keptIndices);
+
+  unsigned int rebuiltCount = 0;
+  for (unsigned int i = first; i < m_Segments.size(); ++i)
+  {
+    PreviewSegment& segment = m_Segments[i];
+    if (segment.Dirty)
+    {
+      BuildSegment(evaluator, i);
+      segment.Dirty = false;
+      rebuiltCount++;
+    }
+
+    segment.BaseVertex = m_Vertices.size();
+    segment.BaseIndex = m_Indices.size();
+
+    m_Vertices.insert(m_Vertices.end(), segment.Vertices.begin(), segment.Vertices.end());
+    for (unsigned int index : segment.Indices)
+      m_Indices.push_back(segment.BaseVertex + index);
+  }
+
+  return rebuiltCount;
+}
+
+void TrackPreview::ClearChanges()
+{
+  m_FirstChangedVertex = m_Vertices.size();
+  m_FirstChangedIndex = m_Indices.size();
+}
+
+void TrackPreview::BuildSegment(TrackEvaluator const& evaluator, unsigned int index)
+{
+  PreviewSegment& segment = m_Segments[index];
+  segment.Vertices.clear();
+  segment.Indices.clear();
+
+  // The track starts with a line pointing backwards from the first node
+  if (index == 0)
+  {
+    PreviewVertex start = MakeVertex(evaluator.GetNodeValue(0, TrackChannel_PositionX),
+      evaluator.GetNodeValue(0, TrackChannel_PositionY),
+      evaluator.GetNodeValue(0, TrackChannel_PositionZ));
+
+    segment.Vertices.push_back(MakeForwardVertex(start,
+      evaluator.GetNodeValue(0, TrackChannel_RotationX),
+      evaluator.GetNodeValue(0, TrackChannel_RotationY),
+      evaluator.GetNodeValue(0, TrackChannel_RotationZ),
+      evaluator.GetNodeValue(0, TrackChannel_RotationW)));
+    segment.Vertices.push_back(start);
+    segment.Indices.push_back(0);
+    segment.Indices.push_back(1);
+  }
+
+  // Points are spaced from the start of each segment so that
+  // moving one node doesn't shift the points of any other segment
+  float startTime = evaluator.GetNodeTime(index);
+  float endTime = evaluator.GetNodeTime(index + 1);
+  float duration = endTime - startTime;
+
+  unsigned int pointCount = 1;
+  if (m_TimeStep > 0 && duration > 0)
+    pointCount = std::max(1u, static_cast<unsigned int>(std::ceil(duration / m_TimeStep)));
+
+  m_SampleTimes.resize(pointCount);
+  for (unsigned int i = 0; i < pointCount; ++i)
+    m_SampleTimes[i] = std::min(startTime + (i + 1) * m_TimeStep, endTime);
+  m_SampleTimes.back() = endTime;
+
+  evaluator.Evaluate(m_SampleTimes.data(), m_SampleTimes.size(), m_Samples);
+
+  auto const& channels = m_Samples.Channels;
+  for (unsigned int i = 0; i < pointCount; ++i)
+  {
+    PreviewVertex point = MakeVertex(channels[TrackChannel_PositionX][i],
+      channels[TrackChannel_PositionY][i],
+      channels[TrackChannel_PositionZ][i]);
+
+    segment.Vertices.push_back(point);
+    segment.Indices.push_back(segment.Vertices.size() - 1);
+
+    if ((i + 1) % g_ForwardLineInterval == 0)
+    {
+      segment.Vertices.push_back(MakeForwardVertex(point,
+        channels[TrackChannel_RotationX][i],
+        channels[TrackChannel_RotationY][i],
+        channels[TrackChannel_RotationZ][i],
+        channels[TrackChannel_RotationW][i]));
+
+      // Out to the forward point and back, the whole track is one line strip
+      segment.Indices.push_back(segment.Vertices.size() - 1);
+      segment.Indices.push_back(segment.Vertices.size() - 2);
+    }
+  }
+}
+
+void TrackPreview::MarkDirty(int first, int last)
+{
+  first = std::max(first, 0);
+  last = std::min(last, static_cast<int>(m_Segments.size()) - 1);
+
+  for (int i = first; i <= last; ++i)
+    m_Segments[i].Dirty = true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "TrackEvaluator.h"
+#include <vector>
+
+// Same memory layout as DirectX::VertexPositionColor
+struct PreviewVertex
+{
+  float Position[3];
+  float Color[4];
+};
+
+struct PreviewSegment
+{
+  std::vector<PreviewVertex> Vertices;
+  std::vector<unsigned int> Indices; // Relative to the first vertex of the segment
+  unsigned int BaseVertex{ 0 };
+  unsigned int BaseIndex{ 0 };
+  bool Dirty{ true };
+};
+
+// Line strip geometry for drawing a camera track, cached per
+// segment between two nodes. Editing a node only re-tessellates
+// the segments it influences, and the combined vertex and index
+// arrays are only rewritten from the first changed segment on, so
+// the renderer can upload just that part.
+//
+// Doesn't depend on Windows or DirectX headers.
+class TrackPreview
+{
+public:
+  // Time between two line points. Changing it invalidates every segment.
+  void SetTimeStep(float timeStep);
+
+  void OnNodeInserted(unsigned int nodeCount, unsigned int index);
+  void OnNodeErased(unsigned int nodeCount, unsigned int index);
+  void Invalidate();
+  void Clear();
+
+  // Re-tessellates dirty segments and rebuilds the combined arrays.
+  // Returns the number of segments that were re-tessellated.
+  unsigned int Update(TrackEvaluator const& evaluator);
+
+  std::vector<PreviewVertex> const& GetVertices() const { return m_Vertices; }
+  std::vector<unsigned int> const& GetIndices() const { return m_Indices; }
+
+  // Everything before these was left untouched since the last call
+  // to ClearChanges, so only the rest has to be uploaded.
+  unsigned int GetFirstChangedVertex() const { return m_FirstChangedVertex; }
+  unsigned int GetFirstChangedIndex() const { return m_FirstChangedIndex; }
+  bool HasChanges() const { return m_FirstChangedIndex < m_Indices.size(); }
+  void ClearChanges();
+
+private:
+  void BuildSegment(TrackEvaluator const& evaluator, unsigned int index);
+  void MarkDirty(int first, int last);
+
+private:
+  std::vector<PreviewSegment> m_Segments;
+  std::vector<PreviewVertex> m_Vertices;
+  std::vector<unsigned int> m_Indices;
+
+  float m_TimeStep{ 0.1f };
+  unsigned int m_FirstChangedVertex{ 0 };
+  unsigned int m_FirstChangedIndex{ 0 };
+
+  // Reused between segments to avoid allocating for every rebuild
+  std::vector<float> m_SampleTimes;
+  TrackSamples m_Samples;
+};
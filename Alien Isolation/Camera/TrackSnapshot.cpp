@@ -0,0 +1,264 @@
+#define NOMINMAX
+#include "TrackSnapshot.h"
+#include "../Util/Util.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace
+{
+  // Interpolates every channel of the segment starting at the given node
+  // except the rotation, which TrackSnapshot::InterpolateRotation handles
+  CatmullRomNode InterpolateNodes(std::vector<CatmullRomNode> const& nodes, unsigned int segment, float mu)
+  {
+    CatmullRomNode resultNode;
+
+    std::vector<CatmullRomNode>::const_iterator n0, n1, n2, n3;
+    n1 = nodes.begin() + segment;
+    n2 = n1 + 1;
+    n0 = segment > 0 ? n1 - 1 : n1;
+    n3 = segment + 1 < nodes.size() - 1 ? n2 + 1 : n2;
+
+    XMVECTOR vPos0 = XMLoadFloat3(&n0->Position);
+    XMVECTOR vPos1 = XMLoadFloat3(&n1->Position);
+    XMVECTOR vPos2 = XMLoadFloat3(&n2->Position);
+    XMVECTOR vPos3 = XMLoadFloat3(&n3->Position);
+
+    resultNode.FieldOfView = util::math::CatmullRomInterpolate(n0->FieldOfView,
+      n1->FieldOfView,
+      n2->FieldOfView,
+      n3->FieldOfView, mu);
+
+    resultNode.FocusDistance = util::math::CatmullRomInterpolate(n0->FocusDistance,
+      n1->FocusDistance,
+      n2->FocusDistance,
+      n3->FocusDistance, mu);
+
+    resultNode.DofStrength = util::math::CatmullRomInterpolate(n0->DofStrength,
+      n1->DofStrength,
+      n2->DofStrength,
+      n3->DofStrength, mu);
+
+    resultNode.DofScale = util::math::CatmullRomInterpolate(n0->DofScale,
+      n1->DofScale,
+      n2->DofScale,
+      n3->DofScale, mu);
+
+    XMVECTOR resultPos = XMVectorCatmullRom(vPos0, vPos1, vPos2, vPos3, mu);
+    XMStoreFloat3(&resultNode.Position, resultPos);
+
+    return resultNode;
+  }
+
+  // Unlike XMQuaternionLn this stays accurate for the small
+  // rotations between neighbouring nodes. Expects w >= 0.
+  XMVECTOR QuaternionLog(XMVECTOR q)
+  {
+    XMFLOAT4 value;
+    XMStoreFloat4(&value, q);
+
+    float sinHalfAngle = std::sqrt(value.x * value.x + value.y * value.y + value.z * value.z);
+    if (sinHalfAngle < 1e-7f)
+      return XMVectorSet(value.x, value.y, value.z, 0);
+
+    float scale = std::atan2(sinHalfAngle, value.w) / sinHalfAngle;
+    return XMVectorSet(value.x * scale, value.y * scale, value.z * scale, 0);
+  }
+
+  // Copies the node into the channel layout of TrackEvaluator, with the
+  // rotation flipped into the hemisphere of the node before it
+  void AddEvaluatorNode(TrackEvaluator& evaluator, CatmullRomNode const& node, XMFLOAT4 const& rotation)
+  {
+    float values[TrackChannel_Count];
+    values[TrackChannel_PositionX] = node.Position.x;
+    values[TrackChannel_PositionY] = node.Position.y;
+    values[TrackChannel_PositionZ] = node.Position.z;
+    values[TrackChannel_RotationX] = rotation.x;
+    values[TrackChannel_RotationY] = rotation.y;
+    values[TrackChannel_RotationZ] = rotation.z;
+    values[TrackChannel_RotationW] = rotation.w;
+    values[TrackChannel_FieldOfView] = node.FieldOfView;
+    values[TrackChannel_FocusDistance] = node.FocusDistance;
+    values[TrackChannel_DofScale] = node.DofScale;
+    values[TrackChannel_DofStrength] = node.DofStrength;
+
+    evaluator.AddNode(node.TimeStamp, values);
+  }
+}
+
+std::shared_ptr<TrackSnapshot> TrackSnapshot::Create(std::vector<CatmullRomNode> const& nodes)
+{
+  std::shared_ptr<TrackSnapshot> pSnapshot = std::make_shared<TrackSnapshot>();
+
+  pSnapshot->m_Nodes = nodes;
+  pSnapshot->m_Spline.Rebuild(pSnapshot->m_Nodes);
+
+  pSnapshot->m_RotationKeys.reserve(nodes.size());
+  pSnapshot->m_Evaluator.Reserve(nodes.size());
+  for (auto const& node : nodes)
+  {
+    pSnapshot->AddRotationKey(node);
+    AddEvaluatorNode(pSnapshot->m_Evaluator, node, pSnapshot->m_RotationKeys.back().Rotation);
+  }
+
+  return pSnapshot;
+}
+
+std::shared_ptr<TrackSnapshot> TrackSnapshot::CopyWithNode(CatmullRomNode const& node) const
+{
+  // The spline segments are shared with this snapshot, only the
+  // ones next to the new node are rebuilt
+  std::shared_ptr<TrackSnapshot> pSnapshot = std::make_shared<TrackSnapshot>(*this);
+
+  pSnapshot->m_Nodes.push_back(node);
+  pSnapshot->m_Spline.OnNodeInserted(pSnapshot->m_Nodes, pSnapshot->m_Nodes.size() - 1);
+  pSnapshot->AddRotationKey(node);
+  AddEvaluatorNode(pSnapshot->m_Evaluator, node, pSnapshot->m_RotationKeys.back().Rotation);
+
+  return pSnapshot;
+}
+
+std::shared_ptr<TrackSnapshot> TrackSnapshot::CopyWithoutLastNode() const
+{
+  std::shared_ptr<TrackSnapshot> pSnapshot = std::make_shared<TrackSnapshot>(*this);
+  if (pSnapshot->m_Nodes.empty())
+    return pSnapshot;
+
+  pSnapshot->m_Nodes.pop_back();
+  pSnapshot->m_Spline.OnNodeErased(pSnapshot->m_Nodes, pSnapshot->m_Nodes.size());
+  pSnapshot->m_Evaluator.RemoveLastNode();
+
+  // The new last node's control point loses its next neighbour
+  pSnapshot->m_RotationKeys.pop_back();
+  if (!pSnapshot->m_RotationKeys.empty())
+    pSnapshot->UpdateRotationControl(pSnapshot->m_RotationKeys.size() - 1);
+
+  return pSnapshot;
+}
+
+CatmullRomNode TrackSnapshot::Sample(TrackCursor& cursor, TrackTiming timing) const
+{
+  if (m_Nodes.empty())
+    return CatmullRomNode();
+
+  // If we're at the start or the end, return those nodes
+  if (cursor.Time < m_Nodes[0].TimeStamp)
+  {
+    cursor.Time = m_Nodes[0].TimeStamp;
+    cursor.Segment = 0;
+    return m_Nodes[0];
+  }
+
+  CatmullRomNode const& lastNode = m_Nodes[m_Nodes.size() - 1];
+  float duration = lastNode.TimeStamp - m_Nodes[0].TimeStamp;
+  if (cursor.Time >= lastNode.TimeStamp || duration <= 0)
+    return lastNode;
+
+  TrackSpline::Location location;
+  if (timing == TrackTiming_ConstantSpeed)
+  {
+    float distance = (cursor.Time - m_Nodes[0].TimeStamp) / duration * m_Spline.GetLength();
+    location = m_Spline.LocateDistance(distance, cursor.Segment);
+  }
+  else if (timing == TrackTiming_Eased)
+    location = m_Spline.LocateTime(cursor.Time, cursor.Segment);
+  else
+  {
+    location.Segment = cursor.Segment = FindSegment(cursor.Time, cursor.Segment);
+
+    CatmullRomNode const& n1 = m_Nodes[location.Segment];
+    CatmullRomNode const& n2 = m_Nodes[location.Segment + 1];
+    location.Mu = (cursor.Time - n1.TimeStamp) / (n2.TimeStamp - n1.TimeStamp);
+  }
+
+  CatmullRomNode resultNode = InterpolateNodes(m_Nodes, location.Segment, location.Mu);
+  resultNode.Rotation = InterpolateRotation(location.Segment, location.Mu);
+  return resultNode;
+}
+
+CatmullRomNode TrackSnapshot::Evaluate(float time, TrackTiming timing) const
+{
+  TrackCursor cursor;
+  cursor.Time = time;
+  return Sample(cursor, timing);
+}
+
+unsigned int TrackSnapshot::FindSegment(float time, unsigned int hint) const
+{
+  const unsigned int lastSegment = static_cast<unsigned int>(m_Nodes.size()) - 2;
+
+  // Playback moves forward a little every frame
+  for (unsigned int segment = hint; segment <= std::min(hint + 1, lastSegment); ++segment)
+  {
+    if (time >= m_Nodes[segment].TimeStamp && time < m_Nodes[segment + 1].TimeStamp)
+      return segment;
+  }
+
+  auto upper = std::upper_bound(m_Nodes.begin(), m_Nodes.end(), time,
+    [](float t, CatmullRomNode const& node) { return t < node.TimeStamp; });
+
+  if (upper == m_Nodes.begin())
+    return 0;
+
+  return std::min(static_cast<unsigned int>(upper - m_Nodes.begin()) - 1, lastSegment);
+}
+
+void TrackSnapshot::AddRotationKey(CatmullRomNode const& node)
+{
+  RotationKey key;
+  key.Rotation = node.Rotation;
+
+  // q and -q are the same rotation, but interpolating between
+  // them spins the camera around the long way
+  if (!m_RotationKeys.empty())
+  {
+    XMVECTOR qPrevious = XMLoadFloat4(&m_RotationKeys.back().Rotation);
+    XMVECTOR qRotation = XMLoadFloat4(&key.Rotation);
+    if (XMVectorGetX(XMQuaternionDot(qPrevious, qRotation)) < 0)
+      XMStoreFloat4(&key.Rotation, XMVectorNegate(qRotation));
+  }
+
+  m_RotationKeys.push_back(key);
+
+  // A control point depends on both neighbours of its node
+  size_t last = m_RotationKeys.size() - 1;
+  if (last > 0)
+    UpdateRotationControl(last - 1);
+  UpdateRotationControl(last);
+}
+
+void TrackSnapshot::UpdateRotationControl(size_t index)
+{
+  // s = q * exp(-(log(q^-1 * next) + log(q^-1 * previous)) / 4)
+  // The end nodes stand in for their missing neighbours like they
+  // do for the other channels. XMQuaternionMultiply(a, b) is b * a.
+  size_t previous = index > 0 ? index - 1 : index;
+  size_t next = index + 1 < m_RotationKeys.size() ? index + 1 : index;
+
+  XMVECTOR q = XMLoadFloat4(&m_RotationKeys[index].Rotation);
+  XMVECTOR qInverse = XMQuaternionInverse(q);
+  XMVECTOR qPrevious = XMLoadFloat4(&m_RotationKeys[previous].Rotation);
+  XMVECTOR qNext = XMLoadFloat4(&m_RotationKeys[next].Rotation);
+
+  XMVECTOR toNext = QuaternionLog(XMQuaternionMultiply(qNext, qInverse));
+  XMVECTOR toPrevious = QuaternionLog(XMQuaternionMultiply(qPrevious, qInverse));
+  XMVECTOR tangent = XMVectorScale(XMVectorAdd(toNext, toPrevious), -0.25f);
+
+  XMStoreFloat4(&m_RotationKeys[index].Control, XMQuaternionMultiply(XMQuaternionExp(tangent), q));
+}
+
+XMFLOAT4 TrackSnapshot::InterpolateRotation(unsigned int segment, float mu) const
+{
+  RotationKey const& k1 = m_RotationKeys[segment];
+  RotationKey const& k2 = m_RotationKeys[segment + 1];
+
+  XMFLOAT4 result;
+  XMVECTOR qResult = XMQuaternionSquad(XMLoadFloat4(&k1.Rotation), XMLoadFloat4(&k1.Control),
+    XMLoadFloat4(&k2.Control), XMLoadFloat4(&k2.Rotation), mu);
+
+  XMStoreFloat4(&result, XMQuaternionNormalize(qResult));
+
+  return result;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "CameraStructs.h"
+#include "TrackEvaluator.h"
+#include "TrackSpline.h"
+#include <memory>
+#include <vector>
+
+enum TrackTiming
+{
+  TrackTiming_Linear,        // Time runs linearly between node timestamps
+  TrackTiming_Eased,         // Time is eased between irregularly timed nodes
+  TrackTiming_ConstantSpeed  // Track length is spread evenly over its duration
+};
+
+// Where a reader is on a track. Every reader keeps its own cursor, so
+// playback, preview baking and exports don't interfere with each other.
+struct TrackCursor
+{
+  float Time{ 0 };
+  unsigned int Segment{ 0 }; // Lookup hint, doesn't have to be valid
+};
+
+// Nodes of a camera track together with the tables used to sample
+// them. A snapshot is never modified after it has been published,
+// edits create a new one instead, so any thread holding a pointer
+// can keep sampling it without locking.
+class TrackSnapshot
+{
+public:
+  static std::shared_ptr<TrackSnapshot> Create(std::vector<CatmullRomNode> const& nodes);
+
+  std::shared_ptr<TrackSnapshot> CopyWithNode(CatmullRomNode const& node) const;
+  std::shared_ptr<TrackSnapshot> CopyWithoutLastNode() const;
+
+  // Samples the track at cursor.Time and updates the segment hint.
+  // Times before the track start clamp the cursor back to zero.
+  CatmullRomNode Sample(TrackCursor& cursor, TrackTiming timing) const;
+
+  // Samples the track at any time without a cursor, for seeking and
+  // scrubbing. Nodes are binary searched, so a jump costs O(log n).
+  CatmullRomNode Evaluate(float time, TrackTiming timing) const;
+
+  std::vector<CatmullRomNode> const& GetNodes() const { return m_Nodes; }
+  TrackEvaluator const& GetEvaluator() const { return m_Evaluator; }
+  size_t GetNodeCount() const { return m_Nodes.size(); }
+
+private:
+  // Rotation of a node flipped into the hemisphere of the node before
+  // it, and the SQUAD control point that gives the rotation spline the
+  // same tangent at the node as the Catmull-Rom spline of the position
+  struct RotationKey
+  {
+    DirectX::XMFLOAT4 Rotation;
+    DirectX::XMFLOAT4 Control;
+  };
+
+  unsigned int FindSegment(float time, unsigned int hint) const;
+
+  void AddRotationKey(CatmullRomNode const& node);
+  void UpdateRotationControl(size_t index);
+  DirectX::XMFLOAT4 InterpolateRotation(unsigned int segment, float mu) const;
+
+private:
+  std::vector<CatmullRomNode> m_Nodes;
+  std::vector<RotationKey> m_RotationKeys;
+  TrackSpline m_Spline;
+  TrackEvaluator m_Evaluator;
+};
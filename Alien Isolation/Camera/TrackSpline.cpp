@@ -0,0 +1,266 @@
+#define NOMINMAX
+#include "TrackSpline.h"
+#include "CameraStructs.h"
+#include "../Util/Util.h"
+
+#include <algorithm>
+
+using namespace DirectX;
+
+namespace
+{
+  // Segments are split in half until the midpoint of the curve is
+  // closer than this to the midpoint of the straight line
+  const float g_PositionTolerance = 0.01f;
+  const float g_TimeTolerance = 0.001f;
+
+  // Always split a few times so S-shaped segments whose midpoint happens
+  // to land on the chord don't collapse into a single line
+  const int g_MinDepth = 2;
+  const int g_MaxDepth = 8;
+
+  struct SegmentPoints
+  {
+    XMVECTOR Positions[4];
+    float Times[4];
+  };
+
+  XMVECTOR EvaluatePosition(SegmentPoints const& points, float mu)
+  {
+    return XMVectorCatmullRom(points.Positions[0], points.Positions[1], points.Positions[2], points.Positions[3], mu);
+  }
+
+  float EvaluateTime(SegmentPoints const& points, float mu)
+  {
+    return util::math::CatmullRomInterpolate(points.Times[0], points.Times[1], points.Times[2], points.Times[3], mu);
+  }
+
+  void Subdivide(SegmentPoints const& points, std::vector<SplineSample>& samples,
+    float mu0, float time0, XMFLOAT3 const& pos0,
+    float mu1, float time1, XMFLOAT3 const& pos1, int depth)
+  {
+    XMVECTOR vPos0 = XMLoadFloat3(&pos0);
+    XMVECTOR vPos1 = XMLoadFloat3(&pos1);
+
+    float muMid = (mu0 + mu1) * 0.5f;
+    float timeMid = EvaluateTime(points, muMid);
+    XMVECTOR vPosMid = EvaluatePosition(points, muMid);
+
+    float positionError = XMVectorGetX(XMVector3Length(vPosMid - (vPos0 + vPos1) * 0.5f));
+    float timeError = fabsf(timeMid - (time0 + time1) * 0.5f);
+
+    XMFLOAT3 posMid;
+    XMStoreFloat3(&posMid, vPosMid);
+
+    if (depth < g_MaxDepth &&
+      (depth < g_MinDepth || positionError > g_PositionTolerance || timeError > g_TimeTolerance))
+    {
+      Subdivide(points, samples, mu0, time0, pos0, muMid, timeMid, posMid, depth + 1);
+      Subdivide(points, samples, muMid, timeMid, posMid, mu1, time1, pos1, depth + 1);
+      return;
+    }
+
+    SplineSample midSample;
+    midSample.Mu = muMid;
+    midSample.Time = timeMid;
+    midSample.Distance = samples.back().Distance + XMVectorGetX(XMVector3Length(vPosMid - vPos0));
+    samples.push_back(midSample);
+
+    SplineSample endSample;
+    endSample.Mu = mu1;
+    endSample.Time = time1;
+    endSample.Distance = midSample.Distance + XMVectorGetX(XMVector3Length(vPos1 - vPosMid));
+    samples.push_back(endSample);
+  }
+
+  // Finds the pair of samples around value and interpolates Mu between them
+  template <typename T>
+  float FindMu(std::vector<SplineSample> const& samples, float value, T getter)
+  {
+    auto upper = std::upper_bound(samples.begin() + 1, samples.end() - 1, value,
+      [&](float v, SplineSample const& sample) { return v < getter(sample); });
+
+    SplineSample const& s1 = *upper;
+    SplineSample const& s0 = *(upper - 1);
+
+    float interval = getter(s1) - getter(s0);
+    if (interval <= 0)
+      return s0.Mu;
+
+    float t = (value - getter(s0)) / interval;
+    t = std::max(0.f, std::min(1.f, t));
+    return s0.Mu + (s1.Mu - s0.Mu) * t;
+  }
+}
+
+void TrackSpline::Rebuild(std::vector<CatmullRomNode> const& nodes)
+{
+  Clear();
+  if (nodes.size() < 2) return;
+
+  m_Segments.resize(nodes.size() - 1);
+  m_StartDistances.resize(nodes.size() - 1);
+  RebuildRange(nodes, 0, m_Segments.size() - 1);
+}
+
+void TrackSpline::OnNodeInserted(std::vector<CatmullRomNode> const& nodes, unsigned int index)
+{
+  if (nodes.size() < 2)
+  {
+    Clear();
+    return;
+  }
+
+  // Tables are out of sync with the nodes, start over
+  if (m_Segments.size() + 2 != nodes.size())
+  {
+    Rebuild(nodes);
+    return;
+  }
+
+  // The new node splits one segment in two, and since a Catmull-Rom
+  // segment depends on the two nodes on both sides of it, the
+  // neighbouring segments need to be rebuilt as well.
+  unsigned int position = std::min<unsigned int>(index, m_Segments.size());
+  m_Segments.insert(m_Segments.begin() + position, nullptr);
+  m_StartDistances.insert(m_StartDistances.begin() + position, 0.f);
+  RebuildRange(nodes, static_cast<int>(index) - 2, static_cast<int>(index) + 1);
+}
+
+void TrackSpline::OnNodeErased(std::vector<CatmullRomNode> const& nodes, unsigned int index)
+{
+  if (nodes.size() < 2)
+  {
+    Clear();
+    return;
+  }
+
+  if (m_Segments.size() != nodes.size())
+  {
+    Rebuild(nodes);
+    return;
+  }
+
+  // Two segments around the erased node merge into one
+  unsigned int position = std::min<unsigned int>(index, m_Segments.size() - 1);
+  m_Segments.erase(m_Segments.begin() + position);
+  m_StartDistances.erase(m_StartDistances.begin() + position);
+  RebuildRange(nodes, static_cast<int>(index) - 2, static_cast<int>(index));
+}
+
+TrackSpline::Location TrackSpline::LocateTime(float time, unsigned int& cursor) const
+{
+  Location location{ 0, 0 };
+  if (m_Segments.empty()) return location;
+
+  auto getTime = [](SplineSample const& sample) { return sample.Time; };
+  auto segmentEnd = [&](unsigned int i) { return m_Segments[i]->Samples.back().Time; };
+
+  unsigned int segment = cursor < m_Segments.size() ? cursor : 0;
+  if (time < m_Segments[segment]->StartTime || time >= segmentEnd(segment))
+  {
+    if (segment + 1 < m_Segments.size() && time >= m_Segments[segment + 1]->StartTime && time < segmentEnd(segment + 1))
+      segment += 1;
+    else
+    {
+      auto upper = std::upper_bound(m_Segments.begin(), m_Segments.end(), time,
+        [](float t, std::shared_ptr<SplineSegment const> const& s) { return t < s->StartTime; });
+
+      segment = upper == m_Segments.begin() ? 0 : static_cast<unsigned int>(upper - m_Segments.begin()) - 1;
+    }
+  }
+
+  cursor = segment;
+  location.Segment = segment;
+  location.Mu = FindMu(m_Segments[segment]->Samples, time, getTime);
+  return location;
+}
+
+TrackSpline::Location TrackSpline::LocateDistance(float distance, unsigned int& cursor) const
+{
+  Location location{ 0, 0 };
+  if (m_Segments.empty()) return location;
+
+  auto getDistance = [](SplineSample const& sample) { return sample.Distance; };
+  auto segmentEnd = [&](unsigned int i) { return m_StartDistances[i] + m_Segments[i]->Length; };
+
+  unsigned int segment = cursor < m_Segments.size() ? cursor : 0;
+  if (distance < m_StartDistances[segment] || distance >= segmentEnd(segment))
+  {
+    if (segment + 1 < m_Segments.size() && distance >= m_StartDistances[segment + 1] && distance < segmentEnd(segment + 1))
+      segment += 1;
+    else
+    {
+      auto upper = std::upper_bound(m_StartDistances.begin(), m_StartDistances.end(), distance);
+      segment = upper == m_StartDistances.begin() ? 0 : static_cast<unsigned int>(upper - m_StartDistances.begin()) - 1;
+    }
+  }
+
+  cursor = segment;
+  location.Segment = segment;
+  location.Mu = FindMu(m_Segments[segment]->Samples, distance - m_StartDistances[segment], getDistance);
+  return location;
+}
+
+float TrackSpline::GetLength() const
+{
+  if (m_Segments.empty()) return 0;
+  return m_StartDistances.back() + m_Segments.back()->Length;
+}
+
+void TrackSpline::Clear()
+{
+  m_Segments.clear();
+  m_StartDistances.clear();
+}
+
+void TrackSpline::BuildSegment(std::vector<CatmullRomNode> const& nodes, unsigned int index)
+{
+  unsigned int n1 = index;
+  unsigned int n2 = index + 1;
+  unsigned int n0 = n1 > 0 ? n1 - 1 : n1;
+  unsigned int n3 = n2 < nodes.size() - 1 ? n2 + 1 : n2;
+  unsigned int ids[4] = { n0, n1, n2, n3 };
+
+  SegmentPoints points;
+  for (int i = 0; i < 4; ++i)
+  {
+    points.Positions[i] = XMLoadFloat3(&nodes[ids[i]].Position);
+    points.Times[i] = nodes[ids[i]].TimeStamp;
+  }
+
+  // Copies of the spline may still use the old segment
+  std::shared_ptr<SplineSegment> pSegment = std::make_shared<SplineSegment>();
+  SplineSegment& segment = *pSegment;
+  segment.StartTime = nodes[n1].TimeStamp;
+
+  SplineSample first;
+  first.Mu = 0;
+  first.Time = nodes[n1].TimeStamp;
+  first.Distance = 0;
+  segment.Samples.push_back(first);
+
+  Subdivide(points, segment.Samples, 0.f, nodes[n1].TimeStamp, nodes[n1].Position,
+    1.f, nodes[n2].TimeStamp, nodes[n2].Position, 0);
+
+  segment.Length = segment.Samples.back().Distance;
+  m_Segments[index] = pSegment;
+}
+
+void TrackSpline::RebuildRange(std::vector<CatmullRomNode> const& nodes, int first, int last)
+{
+  first = std::max(first, 0);
+  last = std::min(last, static_cast<int>(m_Segments.size()) - 1);
+
+  for (int i = first; i <= last; ++i)
+    BuildSegment(nodes, i);
+
+  UpdateDistances(first);
+}
+
+void TrackSpline::UpdateDistances(unsigned int first)
+{
+  // Only a running sum, the expensive part is building the segments
+  for (unsigned int i = first; i < m_Segments.size(); ++i)
+    m_StartDistances[i] = i > 0 ? m_StartDistances[i - 1] + m_Segments[i - 1]->Length : 0;
+}
\ No newline at end of file
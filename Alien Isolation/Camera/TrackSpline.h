@@ -0,0 +1,66 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+struct CatmullRomNode;
+
+struct SplineSample
+{
+  float Mu;       // Segment local interpolation value, 0 - 1
+  float Time;     // Eased track time at Mu
+  float Distance; // Arc length from the start of the segment to Mu
+};
+
+// Only depends on the four nodes around it, so it never changes
+// once built and is shared between copies of the spline
+struct SplineSegment
+{
+  std::vector<SplineSample> Samples;
+  float StartTime{ 0 };
+  float Length{ 0 };
+};
+
+// Lookup tables for playing a camera track at eased time or at
+// constant speed. Every segment between two nodes is adaptively
+// subdivided once, so finding a sample is a binary search instead
+// of a walk through the whole track. Editing a node only rebuilds
+// the segments that node influences, a copy shares the rest with
+// the spline it was copied from.
+class TrackSpline
+{
+public:
+  // Where on the track a sample lies, Segment is also the index
+  // of the first node of that segment.
+  struct Location
+  {
+    unsigned int Segment;
+    float Mu;
+  };
+
+public:
+  void Rebuild(std::vector<CatmullRomNode> const& nodes);
+  void OnNodeInserted(std::vector<CatmullRomNode> const& nodes, unsigned int index);
+  void OnNodeErased(std::vector<CatmullRomNode> const& nodes, unsigned int index);
+  void Clear();
+
+  // Cursor is the segment of the previous lookup. Sequential playback
+  // usually stays within the same or the next segment, so those are
+  // checked before falling back to a binary search.
+  Location LocateTime(float time, unsigned int& cursor) const;
+  Location LocateDistance(float distance, unsigned int& cursor) const;
+
+  float GetLength() const;
+  bool IsEmpty() const { return m_Segments.empty(); }
+
+private:
+  void BuildSegment(std::vector<CatmullRomNode> const& nodes, unsigned int index);
+  void RebuildRange(std::vector<CatmullRomNode> const& nodes, int first, int last);
+  void UpdateDistances(unsigned int first);
+
+private:
+  std::vector<std::shared_ptr<SplineSegment const>> m_Segments;
+
+  // Arc length before each segment, the only part that changes
+  // along the whole track when a segment is rebuilt
+  std::vector<float> m_StartDistances;
+};
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Main.h"
+#include "Util/Util.h"
 #include <thread>
 
 DWORD WINAPI RunCT(LPVOID arg)
@@ -8,6 +9,7 @@ DWORD WINAPI RunCT(LPVOID arg)
     g_mainHandle->Run();
 
   delete g_mainHandle;
+  util::log::Shutdown();
 
   FreeLibraryAndExitThread(g_dllHandle, 0);
 }
@@ -38,6 +38,7 @@ enum Action
   Track_CreateNode,
   Track_DeleteNode,
   Track_Play,
+  Track_Record,
 
   Object_PickUp,
   Object_Rotate,
@@ -141,6 +142,7 @@ static const std::map<Action, std::string> ActionStringMap = boost::assign::map_
 (Track_CreateNode, "Track_CreateNode")
 (Track_DeleteNode, "Track_DeleteNode")
 (Track_Play, "Track_Play")
+(Track_Record, "Track_Record")
 (Object_PickUp, "Object_PickUp")
 (Object_Rotate, "Object_Rotate")
 (Object_Remove, "Object_Remove")
@@ -182,6 +184,7 @@ static const std::map<Action, std::string> ActionUIStringMap = boost::assign::ma
 (Track_CreateNode, "Create track node")
 (Track_DeleteNode, "Delete track node")
 (Track_Play, "Play track")
+(Track_Record, "Record track take")
 (Object_PickUp, "Pick up object")
 (Object_Rotate, "Rotate object")
 (Object_Remove, "Remove object")
@@ -223,6 +226,7 @@ static const std::map<Action, int> DefaultKeyboardMap = boost::assign::map_list_
 (Track_CreateNode, VK_F1)
 (Track_DeleteNode, VK_F2)
 (Track_Play, VK_F3)
+(Track_Record, VK_F4)
 (Object_PickUp, 'Q')
 (Object_Rotate, 'E')
 (Object_Remove, 'R')
@@ -263,6 +267,7 @@ static const std::map<Action, GamepadKey> DefaultGamepadMap = boost::assign::map
 (Track_CreateNode, GamepadKey::None)
 (Track_DeleteNode, GamepadKey::None)
 (Track_Play, GamepadKey::None)
+(Track_Record, GamepadKey::None)
 (Object_PickUp, GamepadKey::None)
 (Object_Rotate, GamepadKey::None)
 (Object_Remove, GamepadKey::None)
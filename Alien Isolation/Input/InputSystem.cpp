@@ -13,12 +13,23 @@
 static const float g_actionClearTime = 0.2f;
 static const float g_mouseSensitivity = 1.0f;
 
+// Timestamp for mouse deltas, seconds since the first call
+static double GetInputTime()
+{
+  static const auto startTime = boost::chrono::high_resolution_clock::now();
+  boost::chrono::duration<double> time = boost::chrono::high_resolution_clock::now() - startTime;
+  return time.count();
+}
+
 InputSystem::InputSystem() :
   m_DInputInterface(NULL),
   m_WantedActionStates(),
   m_SmoothActionStates(),
   m_GamepadKeyStates(),
-  m_MouseBuffer(),
+  m_ActionEdges(Action::ActionCount),
+  m_ActionEvents(Action::ActionCount),
+  m_RawInputData(),
+  m_MouseState(),
   m_KeyboardKeyNames(),
   m_ShowUI(false),
   m_SelectedID(0),
@@ -31,6 +42,7 @@ InputSystem::InputSystem() :
 InputSystem::~InputSystem()
 {
   // Wait for threads to exit before destructing
+  m_ActionEvents.Wake();
   m_ActionThread.join();
   m_ControllerThread.join();
   m_HotkeyThread.join();
@@ -57,6 +69,8 @@ void InputSystem::Initialize()
   if (RegisterRawInputDevices(&Rid, 1, sizeof(Rid)) == FALSE)
     util::log::Error("RegisterRawInputDevices failed");
 
+  SubscribeAction(ToggleUI, [](ActionEvent const&) { g_mainHandle->GetUI()->Toggle(); });
+
   m_ActionThread = std::thread(&InputSystem::ActionUpdate, this);
   m_ControllerThread = std::thread(&InputSystem::ControllerUpdate, this);
   m_HotkeyThread = std::thread(&InputSystem::HotkeyUpdate, this);
@@ -64,19 +78,23 @@ void InputSystem::Initialize()
 
 void InputSystem::HandleRawInput(LPARAM lParam)
 {
-  UINT dwSize = 0;
-  GetRawInputData((HRAWINPUT)lParam, RID_INPUT, NULL, &dwSize, sizeof(RAWINPUTHEADER));
-  //printf("WM_INPUT 0x%X\n", dwSize);
-
-  BYTE* lpb = new BYTE[dwSize];
-  GetRawInputData((HRAWINPUT)lParam, RID_INPUT, lpb, &dwSize, sizeof(RAWINPUTHEADER));
+  // Runs on the window thread for every WM_INPUT, which can be a thousand
+  // times a second. Only the mouse is registered so its data always fits
+  // in the preallocated RAWINPUT, and no size query is needed.
+  UINT dwSize = sizeof(m_RawInputData);
+  if (GetRawInputData((HRAWINPUT)lParam, RID_INPUT, &m_RawInputData, &dwSize, sizeof(RAWINPUTHEADER)) == (UINT)-1)
+    return;
 
-  RAWINPUT* raw = (RAWINPUT*)lpb;
+  RAWINPUT* raw = &m_RawInputData;
   if (raw->header.dwType == RIM_TYPEMOUSE)
   {
-    m_MouseBuffer.x += raw->data.mouse.lLastX;
-    m_MouseBuffer.y += raw->data.mouse.lLastY;
-    m_MouseBuffer.z += static_cast<short>(raw->data.mouse.usButtonData);
+    MouseDelta delta;
+    delta.Time = GetInputTime();
+    delta.X = static_cast<float>(raw->data.mouse.lLastX);
+    delta.Y = static_cast<float>(raw->data.mouse.lLastY);
+    delta.Wheel = static_cast<short>(raw->data.mouse.usButtonData);
+
+    m_MouseDeltas.Push(delta);
   }
 }
 
@@ -110,7 +128,10 @@ bool InputSystem::HandleKeyMsg(WPARAM wParam, LPARAM lParam)
     m_CaptureState.CapturedKbKey |= wParam;
     m_CaptureState.CapturedKbName += util::KeyLparamToString(lParam);
 
-    m_KeyboardKeyNames[m_CaptureState.ActionIndex] = m_CaptureState.CapturedKbName;
+    {
+      std::lock_guard<std::mutex> lock(m_KeyNameMutex);
+      m_KeyboardKeyNames[m_CaptureState.ActionIndex] = m_CaptureState.CapturedKbName;
+    }
     m_KeyboardBindings[m_CaptureState.ActionIndex] = m_CaptureState.CapturedKbKey;
     m_CaptureState.CaptureKb = false;
 
@@ -122,9 +143,11 @@ bool InputSystem::HandleKeyMsg(WPARAM wParam, LPARAM lParam)
 
 void InputSystem::Update()
 {
-  // Copy buffer to mouse state, set buffer to zero
-  m_MouseState = m_MouseBuffer;
-  m_MouseBuffer = DirectX::XMFLOAT3(0, 0, 0);
+  // Sum up the mouse deltas since the last update. Each delta ends up
+  // in exactly one update, even if it arrives while this runs.
+  MouseDelta sum;
+  m_MouseDeltas.Consume(GetInputTime(), sum);
+  m_MouseState = DirectX::XMFLOAT3(sum.X, sum.Y, sum.Wheel);
 }
 
 void InputSystem::ShowUI()
@@ -175,7 +198,11 @@ void InputSystem::DrawUI()
       std::string name = ActionUIStringMap.at(action);
       GamepadKey padKey = m_GamepadBindings[i];
 
-      std::string kbString = m_KeyboardKeyNames[i];
+      std::string kbString;
+      {
+        std::lock_guard<std::mutex> lock(m_KeyNameMutex);
+        kbString = m_KeyboardKeyNames[i];
+      }
       if (m_CaptureState.CaptureKb && m_CaptureState.ActionIndex == i)
       {
         kbString = m_CaptureState.CapturedKbName;
@@ -215,6 +242,11 @@ void InputSystem::DrawUI()
 
 }
 
+void InputSystem::SubscribeAction(Action action, ActionHandler handler, ActionEventType type /* = ActionEvent_Press */)
+{
+  m_ActionEvents.Subscribe(action, type, handler);
+}
+
 bool InputSystem::IsActionDown(Action action)
 {
   return m_WantedActionStates[action] != 0.f;
@@ -259,6 +291,7 @@ void InputSystem::ReadConfig(INIReader* pReader)
     m_GamepadBindings[action] = padKey;
   }
 
+  std::array<std::string, Action::ActionCount> keyNames;
   for (int i = 0; i < Action::ActionCount; ++i)
   {
     std::string sHotkey = "";
@@ -270,8 +303,11 @@ void InputSystem::ReadConfig(INIReader* pReader)
       sHotkey += util::VkToString(modifier) + " + ";
     sHotkey += util::VkToString(hotkey);
 
-    m_KeyboardKeyNames[i] = sHotkey;
+    keyNames[i] = sHotkey;
   }
+
+  std::lock_guard<std::mutex> lock(m_KeyNameMutex);
+  m_KeyboardKeyNames.swap(keyNames);
 }
 
 const std::string InputSystem::GetConfig()
@@ -297,7 +333,11 @@ void InputSystem::ActionUpdate()
   // Processes keyboard + gamepad input and updates
   // action states based on bindings.
 
-  auto lastUpdate = boost::chrono::high_resolution_clock::now();
+  auto startTime = boost::chrono::high_resolution_clock::now();
+  auto lastUpdate = startTime;
+
+  std::array<bool, Action::ActionCount> actionsDown;
+  std::vector<ActionEvent> events;
 
   while (!g_shutdown)
   {
@@ -361,8 +401,18 @@ void InputSystem::ActionUpdate()
       }
     }
 
-    // Copy new values and perform smoothing
+    // Copy new values, queue press/release events for the hotkey thread
+    // and perform smoothing
     m_WantedActionStates = newWantedStates;
+
+    for (int i = 0; i < Action::ActionCount; ++i)
+      actionsDown[i] = newWantedStates[i] != 0.f;
+
+    boost::chrono::duration<double> time = lastUpdate - startTime;
+    events.clear();
+    m_ActionEdges.Update(actionsDown.data(), time.count(), events);
+    m_ActionEvents.Post(events);
+
     for (int i = 0; i < Action::ActionCount; ++i)
     {
       float& currentState = m_SmoothActionStates[i];
@@ -453,27 +503,16 @@ void InputSystem::ControllerUpdate()
 void InputSystem::HotkeyUpdate()
 {
   // Hotkey thread
-  // This is in its own thread so when you press and hold
-  // for example HUD Toggle, you can still move the camera
-  // and it doesn't block other updates until you lift the
-  // key up again.
+  // Runs the handlers subscribed to action events. ActionUpdate
+  // sends each press once, so holding a key down doesn't block
+  // other hotkeys, and a slow handler (HUD Toggle walks the
+  // Scaleform movies) doesn't hold up camera input.
+  //
+  // Actions are all up while the game is out of focus,
+  // so no events arrive then.
 
   while (!g_shutdown)
-  {
-    if (g_hasFocus)
-    {
-      if (IsActionDown(ToggleUI))
-      {
-        g_mainHandle->GetUI()->Toggle();
-        while (IsActionDown(ToggleUI))
-          Sleep(10);
-      }
-
-      g_mainHandle->GetCameraManager()->HotkeyUpdate();
-      g_mainHandle->GetCharacterController()->OnHotkeyUpdate();
-    }
-    Sleep(10);
-  }
+    m_ActionEvents.Dispatch(100);
 }
 
 void InputSystem::UpdateXInput()
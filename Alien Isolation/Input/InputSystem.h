@@ -1,10 +1,13 @@
 #pragma once
 #include "ActionDefs.h"
+#include "ActionEvents.h"
+#include "MouseDeltaRing.h"
 #include "../inih/cpp/INIReader.h"
 
 #include <array>
 #include <dinput.h>
 #include <DirectXMath.h>
+#include <mutex>
 #include <thread>
 #include <Xinput.h>
 
@@ -52,6 +55,9 @@ public:
   void ShowUI();
   void DrawUI();
 
+  // Handlers run on the hotkey thread, one event at a time
+  void SubscribeAction(Action action, ActionHandler handler, ActionEventType type = ActionEvent_Press);
+
   bool IsActionDown(Action action);
   bool IsPadKeyDown(GamepadKey key);
   float GetActionState(Action action);
@@ -90,13 +96,19 @@ private:
   std::array<int, Action::ActionCount>              m_KeyboardBindings;
   std::array<GamepadKey, Action::ActionCount>       m_GamepadBindings;
   std::array<std::string, Action::ActionCount>      m_KeyboardKeyNames;
+  // The config can be reloaded while the UI shows the names
+  std::mutex m_KeyNameMutex;
 
   std::array<float, Action::ActionCount>            m_WantedActionStates;
   std::array<float, Action::ActionCount>            m_SmoothActionStates;
   std::array<float, GamepadKey::GamepadKey_Count>   m_GamepadKeyStates;
 
+  ActionEdgeDetector m_ActionEdges;
+  ActionDispatcher m_ActionEvents;
+
   DirectX::XMFLOAT2 m_PrevMousePos;
-  DirectX::XMFLOAT3 m_MouseBuffer;
+  RAWINPUT m_RawInputData;
+  MouseDeltaRing m_MouseDeltas;
   DirectX::XMFLOAT3 m_MouseState;
   LPDIRECTINPUTDEVICE8 m_DIMouse;
 
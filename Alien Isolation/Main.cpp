@@ -3,9 +3,9 @@
 #include "AlienIsolation.h"
 
 #include <algorithm>
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/chrono.hpp>
-#include <fstream>
 #include <string>
 
 static const char* g_gameName = "Alien: Isolation";
@@ -42,6 +42,7 @@ Main::~Main()
   // Save config and disable hooks before exit
   if (m_ConfigChanged)
     SaveConfig();
+  m_ConfigWriter.Stop();
 
   util::hooks::SetHookState(false);
   SetWindowLongPtr(g_gameHwnd, -4, (LONG_PTR)g_origWndProc);
@@ -51,6 +52,7 @@ bool Main::Initialize()
 {
   boost::filesystem::path mainDir("./Cinematic Tools/");
   boost::filesystem::path profileDir("./Cinematic Tools/Profiles");
+  boost::filesystem::path trackDir("./Cinematic Tools/Tracks");
 
   if (!boost::filesystem::exists(mainDir))
     boost::filesystem::create_directory(mainDir);
@@ -58,6 +60,9 @@ bool Main::Initialize()
   if (!boost::filesystem::exists(profileDir))
     boost::filesystem::create_directory(profileDir);
 
+  if (!boost::filesystem::exists(trackDir))
+    boost::filesystem::create_directory(trackDir);
+
   util::log::Init();
   util::log::Write("Cinematic Tools for %s\n", g_gameName);
 
@@ -77,6 +82,8 @@ bool Main::Initialize()
     return false;
   }
 
+  util::offsets::Resolve();
+
   g_dxgiSwapChain = CATHODE::D3D::Singleton()->m_pSwapChain;//fb::DxRenderer::Singleton()->m_pScreen->m_pSwapChain; // Fetch SwapChain
   g_d3d11Device = CATHODE::D3D::Singleton()->m_pDevice;// fb::DxRenderer::Singleton()->m_pDevice; // Fetch ID3D11Device
   if (g_d3d11Device)
@@ -95,7 +102,7 @@ bool Main::Initialize()
 
   // Make timescale writable
   DWORD dwOld = 0;
-  if (!VirtualProtect(reinterpret_cast<LPVOID>(util::offsets::GetOffset("OFFSET_TIMESCALE")), sizeof(double), PAGE_READWRITE, &dwOld))
+  if (!VirtualProtect(reinterpret_cast<LPVOID>(util::offsets::GetOffset(OFFSET_TIMESCALE)), sizeof(double), PAGE_READWRITE, &dwOld))
     util::log::Warning("Could not get write permissions to timescale");
 
   // Retrieve game version and make a const variable for whatever version
@@ -112,6 +119,8 @@ bool Main::Initialize()
   m_pVisualsController = std::make_unique<VisualsController>();
   m_pUI = std::make_unique<UI>();
 
+  m_pCameraManager->SubscribeHotkeys(m_pInputSystem.get());
+  m_pCharacterController->SubscribeHotkeys(m_pInputSystem.get());
   m_pInputSystem->Initialize();
   if (!m_pUI->Initialize())
     return false;
@@ -126,7 +135,16 @@ bool Main::Initialize()
     return false;
   }
 
+  m_ConfigWriter.Start(g_configFile, [](const char* error)
+  {
+    util::log::Error("Could not save config. %s", error);
+  });
+
   LoadConfig();
+
+  if (!m_ConfigWatcher.Watch("./Cinematic Tools/") || !m_ProfileWatcher.Watch("./Cinematic Tools/Profiles/"))
+    util::log::Warning("Config files can't be watched, edits made outside the tools need a restart");
+
   m_Initialized = true;
   return true;
 }
@@ -146,9 +164,12 @@ void Main::Run()
     m_pVisualsController->Update();
     m_pUI->Update(dt.count());
 
-    // Check if config has been affected, if so, save it
+    CheckConfigFiles();
+
+    // Check if config has been affected, if so, save it.
+    // The file is written on the config writer's thread.
     m_dtConfigCheck += dt.count();
-    if (m_dtConfigCheck > 10.f)
+    if (m_dtConfigCheck > 1.f)
     {
       m_dtConfigCheck = 0;
       if (m_ConfigChanged)
@@ -191,21 +212,53 @@ void Main::LoadConfig()
 
 void Main::SaveConfig()
 {
-  util::log::Write("Saving current config...");
+  // Nothing is written if the content is the same as before
+  m_ConfigWriter.Submit(m_pCameraManager->GetConfig() + m_pInputSystem->GetConfig());
+}
+
+void Main::CheckConfigFiles()
+{
+  std::vector<std::string> changed;
+
+  // Lost changes could have been to anything
+  bool configChanged = !m_ConfigWatcher.Poll(changed);
+  for (auto& fileName : changed)
+  {
+    if (boost::iequals(fileName, "config.ini"))
+      configChanged = true;
+  }
+
+  if (configChanged)
+    ReloadConfig();
 
-  std::fstream file;
-  file.open(g_configFile, std::ios_base::out | std::ios_base::trunc);
+  // Missed profile files are imported the next time they're saved
+  changed.clear();
+  m_ProfileWatcher.Poll(changed);
 
-  if (!file.is_open())
+  for (auto& fileName : changed)
+    m_pCameraManager->ReloadProfile(fileName);
+}
+
+void Main::ReloadConfig()
+{
+  // Our own saves come back as changes too
+  std::string content;
+  if (!util::ConfigWriter::Read(g_configFile, content) || m_ConfigWriter.IsOwnContent(content))
+    return;
+
+  std::unique_ptr<INIReader> pConfig = std::make_unique<INIReader>(g_configFile);
+  if (pConfig->ParseError() != 0)
   {
-    util::log::Error("Could not save config, failed to open file for writing. GetLastError 0x%X", GetLastError());
+    util::log::Warning("config.ini has an error on line %d, keeping current settings", pConfig->ParseError());
     return;
   }
 
-  file << m_pCameraManager->GetConfig();
-  file << m_pInputSystem->GetConfig();
-  
-  file.close();
+  m_pConfig = std::move(pConfig);
+  m_pCameraManager->ReadConfig(m_pConfig.get());
+  m_pInputSystem->ReadConfig(m_pConfig.get());
+
+  m_ConfigWriter.SetCurrent(content);
+  util::log::Ok("Reloaded config.ini");
 }
 
 void Main::OnMapChange()
@@ -5,6 +5,8 @@
 #include "Tools/CharacterController.h"
 #include "Tools/VisualsController.h"
 #include "UI.h"
+#include "Util/ConfigWriter.h"
+#include "Util/FileWatcher.h"
 
 #include "inih/cpp/INIReader.h"
 #include <memory>
@@ -32,12 +34,19 @@ private:
   void LoadConfig();
   void SaveConfig();
 
+  // Picks up config and profile files edited outside the tools
+  void CheckConfigFiles();
+  void ReloadConfig();
+
   void OnMapChange();
 
   static LRESULT CALLBACK WndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 
 private:
   std::unique_ptr<INIReader> m_pConfig;
+  util::ConfigWriter m_ConfigWriter;
+  util::FileWatcher m_ConfigWatcher;
+  util::FileWatcher m_ProfileWatcher;
 
   std::unique_ptr<CameraManager> m_pCameraManager;
   std::unique_ptr<CharacterController> m_pCharacterController;
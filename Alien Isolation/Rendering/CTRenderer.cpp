@@ -1,8 +1,10 @@
+#define NOMINMAX
 #include "CTRenderer.h"
 #include "../Main.h"
 #include "../Util/Util.h"
 
 #include "../resource.h"
+#include <algorithm>
 #include <WICTextureLoader.h>
 
 CTRenderer::CTRenderer()
@@ -90,16 +92,19 @@ bool CTRenderer::Initialize()
 
 void CTRenderer::UpdateMatrices()
 {
-  Camera const& camera = g_mainHandle->GetCameraManager()->GetCamera();
+  // Keep the previous matrices if the camera is being written
+  CameraView camera;
+  if (!g_mainHandle->GetCameraManager()->GetCameraView(camera))
+    return;
 
-  XMVECTOR qRotation = XMLoadFloat4(&camera.AbsoluteRotation);
-  XMVECTOR vEyePos = XMLoadFloat3(&camera.AbsolutePosition);
+  XMVECTOR qRotation = XMLoadFloat4(&camera.Rotation);
+  XMVECTOR vEyePos = XMLoadFloat3(&camera.Position);
 
   XMMATRIX rotMatrix = XMMatrixRotationQuaternion(qRotation);
   XMMATRIX viewMatrix = XMMatrixLookToRH(vEyePos, rotMatrix.r[2], XMVectorSet(0, 1, 0, 0));
-  XMMATRIX projMatrix = XMMatrixPerspectiveFovRH(camera.Profile.FieldOfView, 1920 / 1080.f, 0.01f, 1000.f);
+  XMMATRIX projMatrix = XMMatrixPerspectiveFovRH(camera.FieldOfView, 1920 / 1080.f, 0.01f, 1000.f);
 
-  m_Matrices.EyePosition = XMFLOAT4(camera.AbsolutePosition.x, camera.AbsolutePosition.y, camera.AbsolutePosition.z, 1);
+  m_Matrices.EyePosition = XMFLOAT4(camera.Position.x, camera.Position.y, camera.Position.z, 1);
   XMStoreFloat4x4(&m_Matrices.View, viewMatrix);
   XMStoreFloat4x4(&m_Matrices.Projection, projMatrix);
 
@@ -159,30 +164,43 @@ ImgRsc CTRenderer::CreateImageFromResource(int id)
   return newImg;
 }
 
-void CTRenderer::CreateVertexIndexBuffers(std::vector<unsigned int> const& indices, std::vector<DirectX::VertexPositionColor> const& vertices, ID3D11Buffer** ppVertexBuffer, ID3D11Buffer** ppIndexBuffer)
+// pData holds the full contents, of which the bytes before firstChanged
+// are the same as in the previous update and don't need to be uploaded.
+void CTRenderer::UpdateGrowableBuffer(GrowableBuffer& buffer, UINT bindFlags, void const* pData, unsigned int size, unsigned int firstChanged)
 {
-  D3D11_BUFFER_DESC indexDesc{ 0 }, vertexDesc{ 0 };
-  indexDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-  indexDesc.ByteWidth = indices.size() * sizeof(unsigned int);
-  indexDesc.Usage = D3D11_USAGE_DEFAULT;
-  indexDesc.StructureByteStride = sizeof(unsigned int);
-
-  vertexDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-  vertexDesc.ByteWidth = vertices.size() * sizeof(DirectX::VertexPositionColor);
-  vertexDesc.Usage = D3D11_USAGE_DEFAULT;
-  vertexDesc.StructureByteStride = sizeof(DirectX::VertexPositionColor);
-
-  D3D11_SUBRESOURCE_DATA indexData{ 0 }, vertexData{ 0 };
-  indexData.pSysMem = &indices[0];
-  vertexData.pSysMem = &vertices[0];
-
-  HRESULT hr = g_d3d11Device->CreateBuffer(&indexDesc, &indexData, ppIndexBuffer);
-  if (FAILED(hr))
-    util::log::Error("Failed to create index buffer, HRESULT 0x%X", hr);
+  if (size == 0) return;
 
-  hr = g_d3d11Device->CreateBuffer(&vertexDesc, &vertexData, ppVertexBuffer);
-  if (FAILED(hr))
-    util::log::Error("Failed to create index buffer, HRESULT 0x%X", hr);
+  if (!buffer.pBuffer || size > buffer.Capacity)
+  {
+    // Leave room so adding nodes to a track doesn't reallocate every time
+    D3D11_BUFFER_DESC desc{ 0 };
+    desc.BindFlags = bindFlags;
+    desc.ByteWidth = std::max(size + size / 2, 4096u);
+    desc.Usage = D3D11_USAGE_DEFAULT;
+
+    buffer.pBuffer.Reset();
+    buffer.Capacity = 0;
+
+    HRESULT hr = g_d3d11Device->CreateBuffer(&desc, nullptr, buffer.pBuffer.GetAddressOf());
+    if (FAILED(hr))
+    {
+      util::log::Error("Failed to create buffer, HRESULT 0x%X", hr);
+      return;
+    }
+
+    buffer.Capacity = desc.ByteWidth;
+    firstChanged = 0;
+  }
+
+  if (firstChanged >= size) return;
+
+  D3D11_BOX box{ 0 };
+  box.left = firstChanged;
+  box.right = size;
+  box.bottom = 1;
+  box.back = 1;
+
+  g_d3d11Context->UpdateSubresource(buffer.pBuffer.Get(), 0, &box, (const BYTE*)pData + firstChanged, 0, 0);
 }
 
 std::unique_ptr<Model> CTRenderer::CreateModelFromResource(int id)
@@ -20,6 +20,14 @@ struct ImgRsc
   ComPtr<ID3D11ShaderResourceView> pSRV;
 };
 
+// Buffer that is kept alive and grown as needed instead of
+// being recreated every time its contents change
+struct GrowableBuffer
+{
+  ComPtr<ID3D11Buffer> pBuffer;
+  unsigned int Capacity{ 0 }; // Bytes
+};
+
 struct MatrixBuffer
 {
   DirectX::XMFLOAT4X4 World;
@@ -45,7 +53,7 @@ public:
   bool Initialize();
 
   ImgRsc CreateImageFromResource(int id);
-  void CreateVertexIndexBuffers(std::vector<unsigned int> const& indices, std::vector<DirectX::VertexPositionColor> const& vertices, ID3D11Buffer** ppVertexBuffer, ID3D11Buffer** ppIndexBuffer);
+  void UpdateGrowableBuffer(GrowableBuffer& buffer, UINT bindFlags, void const* pData, unsigned int size, unsigned int firstChanged);
 
   std::unique_ptr<DirectX::Model> CreateModelFromResource(int id);
 
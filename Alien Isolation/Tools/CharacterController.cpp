@@ -65,19 +65,11 @@ void CharacterController::Update()
   }
 }
 
-void CharacterController::OnHotkeyUpdate()
+void CharacterController::SubscribeHotkeys(InputSystem* pInput)
 {
-  InputSystem* pInput = g_mainHandle->GetInputSystem();
+  pInput->SubscribeAction(Action::ToggleInvisibility, [this](ActionEvent const&) { ToggleInvisibility(); });
 
-  if (pInput->IsActionDown(Action::ToggleInvisibility))
-  {
-    ToggleInvisibility();
-
-    while (pInput->IsActionDown(Action::ToggleInvisibility))
-      Sleep(100);
-  }
-
-  if (pInput->IsActionDown(FreezeCharacters))
+  pInput->SubscribeAction(Action::FreezeCharacters, [this](ActionEvent const&)
   {
     m_FreezeCharacters = !m_FreezeCharacters;
     util::log::Write("Freeze characters: %s", m_FreezeCharacters ? "On" : "Off");
@@ -90,11 +82,7 @@ void CharacterController::OnHotkeyUpdate()
       pChr->m_Active = !m_FreezeCharacters;
       pChr->m_Animate = !m_FreezeCharacters;
     }
-
-    while (pInput->IsActionDown(FreezeCharacters))
-      Sleep(100);
-  }
-
+  });
 }
 
 void CharacterController::DrawUI()
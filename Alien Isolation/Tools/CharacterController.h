@@ -1,6 +1,8 @@
 #pragma once
 #include "../AlienIsolation.h"
 
+class InputSystem;
+
 struct CharacterList
 {
   unsigned int Count{ 0 };
@@ -15,7 +17,7 @@ public:
   ~CharacterController();
 
   void Update();
-  void OnHotkeyUpdate();
+  void SubscribeHotkeys(InputSystem* pInput);
 
   void ShowUI() { m_ShowUI = true; }
   void DrawUI();
@@ -0,0 +1,300 @@
+#include "ConfigWriter.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <io.h>
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace util;
+
+namespace
+{
+  // Edits this close together are written once
+  const std::chrono::milliseconds g_CoalesceDelay(250);
+
+  // How many written versions are remembered
+  const size_t g_HistorySize = 8;
+
+  FILE* OpenFile(std::string const& path, const char* mode)
+  {
+#ifdef _WIN32
+    FILE* pFile = nullptr;
+    fopen_s(&pFile, path.c_str(), mode);
+    return pFile;
+#else
+    return fopen(path.c_str(), mode);
+#endif
+  }
+
+  // Makes sure the data is on disk before the file is renamed
+  bool SyncFile(FILE* pFile)
+  {
+    if (fflush(pFile) != 0)
+      return false;
+#ifdef _WIN32
+    return _commit(_fileno(pFile)) == 0;
+#else
+    return fsync(fileno(pFile)) == 0;
+#endif
+  }
+
+  bool RenameOver(std::string const& from, std::string const& to)
+  {
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE;
+#else
+    if (rename(from.c_str(), to.c_str()) != 0)
+      return false;
+
+    // The rename itself only sticks once the directory is synced
+    size_t separator = to.find_last_of('/');
+    std::string directory = separator == std::string::npos ? "." : to.substr(0, separator + 1);
+    int fd = open(directory.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+      fsync(fd);
+      close(fd);
+    }
+    return true;
+#endif
+  }
+
+  int GetError()
+  {
+#ifdef _WIN32
+    return static_cast<int>(GetLastError());
+#else
+    return errno;
+#endif
+  }
+}
+
+ConfigWriter::ConfigWriter() :
+  m_Submitted(0),
+  m_Completed(0),
+  m_WriteCount(0),
+  m_Waiting(0),
+  m_Failed(false),
+  m_Running(false),
+  m_Stopping(false)
+{
+
+}
+
+ConfigWriter::~ConfigWriter()
+{
+  Stop();
+}
+
+void ConfigWriter::Start(std::string const& path, ErrorHandler onError)
+{
+  if (m_Running)
+    return;
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Path = path;
+  m_OnError = std::move(onError);
+
+  // A temporary file means the last write never finished,
+  // the config itself is still the one before it
+  remove((m_Path + ".tmp").c_str());
+
+  m_Content.clear();
+  m_History.clear();
+  if (Read(m_Path, m_Content))
+    Remember(m_Content);
+
+  m_Submitted = 0;
+  m_Completed = 0;
+  m_Failed = false;
+  m_Stopping = false;
+  m_Running = true;
+  m_Thread = std::thread(&ConfigWriter::Run, this);
+}
+
+void ConfigWriter::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (!m_Running)
+      return;
+
+    m_Stopping = true;
+  }
+  m_Wake.notify_all();
+
+  if (m_Thread.joinable())
+    m_Thread.join();
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Running = false;
+}
+
+void ConfigWriter::Submit(std::string content)
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  if (content == m_Content && !m_Failed)
+    return;
+
+  if (m_Path.empty())
+    return;
+
+  // Already stopped, write on the calling thread
+  if (!m_Running || m_Stopping)
+  {
+    std::string error;
+    m_Failed = !Write(m_Path, content, &error);
+    if (m_Failed && m_OnError)
+      m_OnError(error.c_str());
+    else if (!m_Failed)
+      Remember(content);
+
+    m_Content.swap(content);
+    return;
+  }
+
+  m_Content.swap(content);
+  m_Submitted++;
+  lock.unlock();
+
+  m_Wake.notify_all();
+}
+
+void ConfigWriter::Flush()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  if (!m_Running)
+    return;
+
+  uint64_t target = m_Submitted;
+  m_Waiting++;
+  m_Wake.notify_all();
+  m_Written.wait(lock, [&] { return m_Completed >= target; });
+  m_Waiting--;
+}
+
+void ConfigWriter::Run()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  for (;;)
+  {
+    m_Wake.wait(lock, [this] { return m_Stopping || m_Submitted != m_Completed; });
+    if (m_Submitted == m_Completed)
+      break;
+
+    // Give a burst of edits time to settle, unless
+    // someone is waiting on the file
+    m_Wake.wait_for(lock, g_CoalesceDelay, [this] { return m_Stopping || m_Waiting > 0; });
+
+    uint64_t submitted = m_Submitted;
+    std::string content = m_Content;
+    lock.unlock();
+
+    std::string error;
+    bool written = Write(m_Path, content, &error);
+    if (!written && m_OnError)
+      m_OnError(error.c_str());
+
+    lock.lock();
+    if (written)
+    {
+      m_WriteCount++;
+      Remember(content);
+    }
+
+    // Saving the same content again should retry
+    if (submitted == m_Submitted)
+      m_Failed = !written;
+
+    m_Completed = submitted;
+    m_Written.notify_all();
+  }
+}
+
+bool ConfigWriter::IsOwnContent(std::string const& content)
+{
+  size_t hash = std::hash<std::string>()(content);
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  for (size_t remembered : m_History)
+  {
+    if (remembered == hash)
+      return true;
+  }
+  return false;
+}
+
+void ConfigWriter::SetCurrent(std::string content)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  // Older versions coming back would be someone else's edit too
+  m_History.clear();
+  Remember(content);
+  m_Content.swap(content);
+  m_Failed = false;
+}
+
+void ConfigWriter::Remember(std::string const& content)
+{
+  m_History.push_back(std::hash<std::string>()(content));
+  if (m_History.size() > g_HistorySize)
+    m_History.pop_front();
+}
+
+bool ConfigWriter::Read(std::string const& path, std::string& content)
+{
+  FILE* pFile = OpenFile(path, "rb");
+  if (!pFile)
+    return false;
+
+  char buffer[4096];
+  size_t read = 0;
+  while ((read = fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+    content.append(buffer, read);
+
+  fclose(pFile);
+  return true;
+}
+
+bool ConfigWriter::Write(std::string const& path, std::string const& content, std::string* pError /* = nullptr */)
+{
+  std::string tempPath = path + ".tmp";
+
+  FILE* pFile = OpenFile(tempPath, "wb");
+  if (!pFile)
+  {
+    if (pError)
+      *pError = "Could not open " + tempPath + " for writing, error " + std::to_string(GetError());
+    return false;
+  }
+
+  bool written = fwrite(content.data(), 1, content.size(), pFile) == content.size();
+  written = SyncFile(pFile) && written;
+  written = fclose(pFile) == 0 && written;
+
+  if (!written)
+  {
+    if (pError)
+      *pError = "Could not write " + tempPath + ", error " + std::to_string(GetError());
+    remove(tempPath.c_str());
+    return false;
+  }
+
+  if (!RenameOver(tempPath, path))
+  {
+    if (pError)
+      *pError = "Could not replace " + path + ", error " + std::to_string(GetError());
+    remove(tempPath.c_str());
+    return false;
+  }
+
+  return true;
+}
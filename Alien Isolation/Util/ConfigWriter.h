@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace util
+{
+  // Saves a config file on a background thread.
+  //
+  // Submitting is cheap: content that matches what's already on disk or
+  // queued is ignored, and only the latest content is kept while the
+  // file waits to be written. Edits that come in quick succession, like
+  // dragging a slider, end up as a single write.
+  //
+  // The file is written next to the target and renamed over it, so a
+  // crash leaves either the old or the new file, never a truncated one.
+  // Files are read and written as they are, without newline translation.
+  //
+  // Doesn't depend on Windows headers.
+  class ConfigWriter
+  {
+  public:
+    // Called on the background thread when the file couldn't be written
+    typedef std::function<void(const char* error)> ErrorHandler;
+
+    ConfigWriter();
+    ~ConfigWriter();
+
+    // Reads the file as it is now, so saving the same content is free
+    void Start(std::string const& path, ErrorHandler onError);
+
+    // Writes whatever is still queued and stops the background thread
+    void Stop();
+
+    void Submit(std::string content);
+
+    // Returns once the latest submitted content has been written
+    void Flush();
+
+    uint64_t GetWriteCount() const { return m_WriteCount; }
+
+    // True if the content is one of the last few versions this writer
+    // wrote or read, so a change to the file isn't someone else's edit
+    bool IsOwnContent(std::string const& content);
+
+    // Takes content someone else wrote to the file as the current version
+    void SetCurrent(std::string content);
+
+    static bool Read(std::string const& path, std::string& content);
+
+    // Replaces the file in one step, returns false if it was left as it was
+    static bool Write(std::string const& path, std::string const& content, std::string* pError = nullptr);
+
+  private:
+    void Run();
+    void Remember(std::string const& content);
+
+  private:
+    std::string m_Path;
+    ErrorHandler m_OnError;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Wake;
+    std::condition_variable m_Written;
+
+    // Latest content, submitted or on disk
+    std::string m_Content;
+    std::deque<size_t> m_History;
+    uint64_t m_Submitted;
+    uint64_t m_Completed;
+    std::atomic<uint64_t> m_WriteCount;
+    unsigned m_Waiting;
+    bool m_Failed;
+    bool m_Running;
+    bool m_Stopping;
+
+    std::thread m_Thread;
+
+  public:
+    ConfigWriter(ConfigWriter const&) = delete;
+    void operator=(ConfigWriter const&) = delete;
+  };
+}
@@ -0,0 +1,226 @@
+#include "FileWatcher.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace util;
+
+namespace
+{
+  // How long a file has to be left alone before it's reported
+  const std::chrono::milliseconds g_SettleTime(200);
+}
+
+#ifdef _WIN32
+
+struct FileWatcher::Backend
+{
+  HANDLE Directory;
+  OVERLAPPED Overlapped;
+  DWORD Buffer[4096];
+
+  Backend() :
+    Directory(INVALID_HANDLE_VALUE),
+    Overlapped()
+  {
+
+  }
+
+  ~Backend()
+  {
+    if (Directory != INVALID_HANDLE_VALUE)
+    {
+      // The buffer has to stay around until the read is really cancelled
+      DWORD bytes = 0;
+      CancelIoEx(Directory, &Overlapped);
+      GetOverlappedResult(Directory, &Overlapped, &bytes, TRUE);
+      CloseHandle(Directory);
+    }
+
+    if (Overlapped.hEvent)
+      CloseHandle(Overlapped.hEvent);
+  }
+
+  bool Open(std::string const& directory)
+  {
+    Directory = CreateFileA(directory.c_str(), FILE_LIST_DIRECTORY,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+      OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+
+    if (Directory == INVALID_HANDLE_VALUE)
+      return false;
+
+    Overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    return Overlapped.hEvent && Request();
+  }
+
+  bool Request()
+  {
+    ResetEvent(Overlapped.hEvent);
+    return ReadDirectoryChangesW(Directory, Buffer, sizeof(Buffer), FALSE,
+      FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+      nullptr, &Overlapped, nullptr) != FALSE;
+  }
+
+  void Read(FileWatcher& watcher, std::chrono::steady_clock::time_point time)
+  {
+    DWORD bytes = 0;
+    if (!GetOverlappedResult(Directory, &Overlapped, &bytes, FALSE))
+    {
+      if (GetLastError() == ERROR_IO_INCOMPLETE)
+        return;
+
+      watcher.m_Overflowed = true;
+      Request();
+      return;
+    }
+
+    // Nothing returned means the buffer overflowed
+    if (bytes == 0)
+      watcher.m_Overflowed = true;
+
+    const BYTE* pEntry = reinterpret_cast<const BYTE*>(Buffer);
+    while (bytes > 0)
+    {
+      const FILE_NOTIFY_INFORMATION* pInfo = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(pEntry);
+
+      int wideLength = static_cast<int>(pInfo->FileNameLength / sizeof(WCHAR));
+      int length = WideCharToMultiByte(CP_ACP, 0, pInfo->FileName, wideLength, nullptr, 0, nullptr, nullptr);
+
+      std::string name(length, '\0');
+      WideCharToMultiByte(CP_ACP, 0, pInfo->FileName, wideLength, &name[0], length, nullptr, nullptr);
+      watcher.OnChange(name, time);
+
+      if (pInfo->NextEntryOffset == 0)
+        break;
+      pEntry += pInfo->NextEntryOffset;
+    }
+
+    if (!Request())
+      watcher.m_Overflowed = true;
+  }
+};
+
+#else
+
+struct FileWatcher::Backend
+{
+  int Fd;
+
+  Backend() :
+    Fd(-1)
+  {
+
+  }
+
+  ~Backend()
+  {
+    if (Fd >= 0)
+      close(Fd);
+  }
+
+  bool Open(std::string const& directory)
+  {
+    Fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (Fd < 0)
+      return false;
+
+    uint32_t mask = IN_CREATE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE;
+    return inotify_add_watch(Fd, directory.c_str(), mask) >= 0;
+  }
+
+  void Read(FileWatcher& watcher, std::chrono::steady_clock::time_point time)
+  {
+    alignas(inotify_event) char buffer[16384];
+    for (;;)
+    {
+      ssize_t bytes = read(Fd, buffer, sizeof(buffer));
+      if (bytes <= 0)
+        return;
+
+      for (char* pEntry = buffer; pEntry < buffer + bytes; )
+      {
+        const inotify_event* pEvent = reinterpret_cast<const inotify_event*>(pEntry);
+        pEntry += sizeof(inotify_event) + pEvent->len;
+
+        if (pEvent->mask & IN_Q_OVERFLOW)
+          watcher.m_Overflowed = true;
+        else if (pEvent->len > 0 && !(pEvent->mask & IN_ISDIR))
+          watcher.OnChange(pEvent->name, time);
+      }
+    }
+  }
+};
+
+#endif
+
+FileWatcher::FileWatcher() :
+  m_Overflowed(false)
+{
+
+}
+
+FileWatcher::~FileWatcher()
+{
+  Stop();
+}
+
+bool FileWatcher::Watch(std::string const& directory)
+{
+  Stop();
+
+  std::unique_ptr<Backend> pBackend(new Backend());
+  if (!pBackend->Open(directory))
+    return false;
+
+  m_pBackend = std::move(pBackend);
+  return true;
+}
+
+void FileWatcher::Stop()
+{
+  m_pBackend.reset();
+  m_Pending.clear();
+  m_Overflowed = false;
+}
+
+bool FileWatcher::Poll(std::vector<std::string>& changed)
+{
+  if (!m_pBackend)
+    return true;
+
+  auto time = std::chrono::steady_clock::now();
+  m_pBackend->Read(*this, time);
+
+  if (m_Overflowed)
+  {
+    m_Overflowed = false;
+    m_Pending.clear();
+    return false;
+  }
+
+  for (auto itr = m_Pending.begin(); itr != m_Pending.end(); )
+  {
+    if (time - itr->second < g_SettleTime)
+    {
+      ++itr;
+      continue;
+    }
+
+    changed.push_back(itr->first);
+    itr = m_Pending.erase(itr);
+  }
+
+  return true;
+}
+
+void FileWatcher::OnChange(std::string const& name, std::chrono::steady_clock::time_point time)
+{
+  m_Pending[name] = time;
+}
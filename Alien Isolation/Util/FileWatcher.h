@@ -0,0 +1,49 @@
+#pragma once
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace util
+{
+  // Reports files that changed in a directory.
+  //
+  // Uses ReadDirectoryChangesW on Windows and inotify elsewhere, both
+  // without a thread of their own: Poll is meant to be called every
+  // update and doesn't block. Editors tend to save in several steps, so
+  // a file is only reported once it's been left alone for a moment.
+  // Subdirectories aren't watched.
+  class FileWatcher
+  {
+  public:
+    FileWatcher();
+    ~FileWatcher();
+
+    bool Watch(std::string const& directory);
+    void Stop();
+
+    bool IsWatching() const { return m_pBackend != nullptr; }
+
+    // Adds the names of files that changed, relative to the directory.
+    // Returns false if changes were lost and everything has to be
+    // assumed changed.
+    bool Poll(std::vector<std::string>& changed);
+
+  private:
+    struct Backend;
+
+    void OnChange(std::string const& name, std::chrono::steady_clock::time_point time);
+
+  private:
+    std::unique_ptr<Backend> m_pBackend;
+
+    // Files that changed but might not be done changing
+    std::map<std::string, std::chrono::steady_clock::time_point> m_Pending;
+    bool m_Overflowed;
+
+  public:
+    FileWatcher(FileWatcher const&) = delete;
+    void operator=(FileWatcher const&) = delete;
+  };
+}
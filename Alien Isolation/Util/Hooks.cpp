@@ -223,12 +223,12 @@ void util::hooks::Init()
   if (status != MH_OK)
     util::log::Error("Failed to initialize MinHook, MH_STATUS 0x%X", status);
 
-  CreateHook("CameraUpdate", util::offsets::GetOffset("OFFSET_CAMERAUPDATE"), hCameraUpdate, &oCameraUpdate);
-  //CreateHook("InputUpdate", util::offsets::GetOffset("OFFSET_INPUTUPDATE"), hInputUpdate, &oInputUpdate);
-  CreateHook("GamepadUpdate", util::offsets::GetOffset("OFFSET_GAMEPADUPDATE"), hGamepadUpdate, &oGamepadUpdate);
-  CreateHook("PostProcessUpdate", util::offsets::GetOffset("OFFSET_POSTPROCESSUPDATE"), hPostProcessUpdate, &oPostProcessUpdate);
-  CreateHook("TonemapUpdate", util::offsets::GetOffset("OFFSET_TONEMAPUPDATE"), hTonemapSettings, &oTonemapUpdate);
-  //CreateHook("AICombatManagerUpdate", util::offsets::GetOffset("OFFSET_COMBATMANAGERUPDATE"), hCombatManagerUpdate, &oCombatManagerUpdate);
+  CreateHook("CameraUpdate", util::offsets::GetOffset(OFFSET_CAMERAUPDATE), hCameraUpdate, &oCameraUpdate);
+  //CreateHook("InputUpdate", util::offsets::GetOffset(OFFSET_INPUTUPDATE), hInputUpdate, &oInputUpdate);
+  CreateHook("GamepadUpdate", util::offsets::GetOffset(OFFSET_GAMEPADUPDATE), hGamepadUpdate, &oGamepadUpdate);
+  CreateHook("PostProcessUpdate", util::offsets::GetOffset(OFFSET_POSTPROCESSUPDATE), hPostProcessUpdate, &oPostProcessUpdate);
+  CreateHook("TonemapUpdate", util::offsets::GetOffset(OFFSET_TONEMAPUPDATE), hTonemapSettings, &oTonemapUpdate);
+  //CreateHook("AICombatManagerUpdate", util::offsets::GetOffset(OFFSET_COMBATMANAGERUPDATE), hCombatManagerUpdate, &oCombatManagerUpdate);
   
   CreateHook("SetCursorPos", (int)GetProcAddress(GetModuleHandleA("user32.dll"), "SetCursorPos"), hSetCursorPos, &oSetCursorPos);
 
@@ -0,0 +1,128 @@
+#pragma once
+#include "LogThrottle.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace util
+{
+  // A formatted message handed to the log sink
+  struct LogMessage
+  {
+    int Level;
+    int64_t Time;      // Seconds since the epoch, when the message was logged
+    const char* pText; // Not null terminated
+    size_t Length;
+  };
+
+  // Moves log formatting and file I/O off the threads that log.
+  //
+  // Every logging thread gets its own ring of fixed size records, so
+  // logging never takes a lock or allocates. A record holds the format
+  // pointer and the raw arguments, strings are copied into it. A
+  // background thread formats the records in the order they were
+  // logged and hands them to the sink in batches.
+  //
+  // Format strings have to outlive the queue, which string literals do.
+  // When a thread's ring is full its messages are dropped and counted
+  // instead of blocking the thread. Call sites that log too often are
+  // throttled, how many of their messages were suppressed is written
+  // every report interval.
+  //
+  // Doesn't depend on Windows headers.
+  class LogQueue
+  {
+  public:
+    // Called on the background thread with every batch, dropped is
+    // the number of messages lost since the last batch
+    typedef std::function<void(LogMessage const* pMessages, size_t count, uint64_t dropped)> Sink;
+
+    static const size_t RecordSize = 512;
+
+    // Capacity is rounded up to a power of two. Each call site can log
+    // siteBurst messages at once and then one per siteInterval.
+    explicit LogQueue(size_t recordsPerThread = 512,
+      unsigned siteBurst = 20,
+      std::chrono::milliseconds siteInterval = std::chrono::milliseconds(500),
+      std::chrono::milliseconds reportInterval = std::chrono::seconds(10));
+    ~LogQueue();
+
+    void Start(Sink sink);
+
+    // Writes everything that's been logged and stops the background thread
+    void Stop();
+
+    bool IsRunning() const { return m_Running; }
+
+    // Returns false if the queue isn't running, the message
+    // has to be written some other way then
+    bool Push(int level, const char* format, va_list args);
+
+    // Returns once everything this thread logged before has been written
+    void Flush();
+
+  private:
+    struct Record;
+    struct Ring;
+    struct ThreadRing;
+
+    static size_t RoundUpCapacity(size_t capacity);
+
+    Ring* GetThreadRing();
+    void Run();
+    bool Drain();
+    bool ReportSuppressed();
+
+  private:
+    const uint64_t m_Id;
+    const size_t m_RingCapacity;
+    const std::chrono::milliseconds m_ReportInterval;
+
+    std::atomic<bool> m_Running;
+    std::atomic<bool> m_Stopping;
+
+    // Threads inside Push that saw the queue running. Stop waits
+    // for them before the background thread makes its last pass.
+    std::atomic<unsigned> m_Pushing;
+    std::atomic<uint64_t> m_Sequence;
+    LogThrottle m_Throttle;
+
+    std::mutex m_RingMutex;
+    std::vector<std::shared_ptr<Ring>> m_Rings;
+    std::atomic<bool> m_RingsChanged;
+
+    // The background thread sleeps for a few milliseconds at a time
+    // unless a ring is filling up or someone is waiting on a flush
+    std::mutex m_WakeMutex;
+    std::condition_variable m_Wake;
+    std::atomic<bool> m_Pending;
+
+    std::condition_variable m_Flushed;
+    uint64_t m_FlushRequested;
+    uint64_t m_FlushCompleted;
+
+    Sink m_Sink;
+    std::thread m_Thread;
+
+    // Only used on the background thread
+    std::vector<std::shared_ptr<Ring>> m_DrainRings;
+    std::vector<size_t> m_Heads;
+    std::vector<char> m_Abandoned;
+    std::vector<Record const*> m_Batch;
+    std::vector<LogMessage> m_Messages;
+    std::string m_Text;
+    std::chrono::steady_clock::time_point m_NextReport;
+
+  public:
+    LogQueue(LogQueue const&) = delete;
+    void operator=(LogQueue const&) = delete;
+  };
+}
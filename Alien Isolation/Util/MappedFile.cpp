@@ -0,0 +1,78 @@
+#include "MappedFile.h"
+#include "Util.h"
+
+using namespace util;
+
+MappedFile::MappedFile() :
+  m_hFile(INVALID_HANDLE_VALUE),
+  m_hMapping(NULL),
+  m_pView(nullptr),
+  m_Size(0)
+{
+
+}
+
+MappedFile::~MappedFile()
+{
+  Close();
+}
+
+bool MappedFile::Open(std::string const& path)
+{
+  Close();
+
+  m_hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (m_hFile == INVALID_HANDLE_VALUE)
+  {
+    util::log::Error("Could not open %s, GetLastError 0x%X", path.c_str(), GetLastError());
+    return false;
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(m_hFile, &fileSize) || fileSize.HighPart != 0)
+  {
+    util::log::Error("Could not get the size of %s or it's too large", path.c_str());
+    Close();
+    return false;
+  }
+
+  // Empty files can't be mapped, leave the view empty instead
+  m_Size = fileSize.LowPart;
+  if (m_Size == 0)
+    return true;
+
+  m_hMapping = CreateFileMappingA(m_hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (m_hMapping == NULL)
+  {
+    util::log::Error("CreateFileMapping failed for %s, GetLastError 0x%X", path.c_str(), GetLastError());
+    Close();
+    return false;
+  }
+
+  m_pView = MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+  if (m_pView == nullptr)
+  {
+    util::log::Error("MapViewOfFile failed for %s, GetLastError 0x%X", path.c_str(), GetLastError());
+    Close();
+    return false;
+  }
+
+  return true;
+}
+
+void MappedFile::Close()
+{
+  if (m_pView)
+    UnmapViewOfFile(m_pView);
+
+  if (m_hMapping)
+    CloseHandle(m_hMapping);
+
+  if (m_hFile != INVALID_HANDLE_VALUE)
+    CloseHandle(m_hFile);
+
+  m_hFile = INVALID_HANDLE_VALUE;
+  m_hMapping = NULL;
+  m_pView = nullptr;
+  m_Size = 0;
+}
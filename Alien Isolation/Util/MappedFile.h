@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <Windows.h>
+
+namespace util
+{
+  // Read-only view of a whole file. Pages are only read from disk
+  // when they are touched, so opening a large file is instant.
+  class MappedFile
+  {
+  public:
+    MappedFile();
+    ~MappedFile();
+
+    bool Open(std::string const& path);
+    void Close();
+
+    void const* GetData() const { return m_pView; }
+    size_t GetSize() const { return m_Size; }
+
+  private:
+    HANDLE m_hFile;
+    HANDLE m_hMapping;
+    void const* m_pView;
+    size_t m_Size;
+
+  public:
+    MappedFile(MappedFile const&) = delete;
+    void operator=(MappedFile const&) = delete;
+  };
+}
@@ -0,0 +1,184 @@
+#include "OffsetCache.h"
+#include "ConfigWriter.h"
+#include "PatternScanner.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using namespace util::offsets;
+
+namespace
+{
+  const char* g_CacheMagic = "CTOFFSETS";
+  const int g_CacheVersion = 1;
+
+  const uint64_t g_FnvOffsetBasis = 0xCBF29CE484222325ull;
+  const uint64_t g_FnvPrime = 0x100000001B3ull;
+}
+
+OffsetCache::OffsetCache() :
+  m_ModuleHash(0),
+  m_Dirty(false)
+{
+
+}
+
+bool OffsetCache::Load(std::string const& path)
+{
+  m_ModuleHash = 0;
+  m_Entries.clear();
+  m_Dirty = false;
+
+  std::ifstream file(path);
+  if (!file.is_open())
+    return false;
+
+  std::string magic;
+  int version = 0;
+  uint64_t moduleHash = 0;
+  if (!(file >> magic >> version >> std::hex >> moduleHash) || magic != g_CacheMagic || version != g_CacheVersion)
+    return false;
+
+  std::unordered_map<std::string, Entry> entries;
+  std::string name;
+  Entry entry;
+  while (file >> name >> entry.PatternHash >> entry.Offset)
+    entries[name] = entry;
+
+  // Anything left over means the file was cut short or edited
+  if (!file.eof())
+    return false;
+
+  m_ModuleHash = moduleHash;
+  m_Entries.swap(entries);
+  return true;
+}
+
+bool OffsetCache::Save(std::string const& path) const
+{
+  std::ostringstream content;
+  content << g_CacheMagic << " " << g_CacheVersion << " " << std::hex << m_ModuleHash << "\n";
+  for (auto const& entry : m_Entries)
+    content << entry.first << " " << entry.second.PatternHash << " " << entry.second.Offset << "\n";
+
+  // A game that's closed while saving keeps the previous cache
+  return util::ConfigWriter::Write(path, content.str());
+}
+
+std::vector<size_t> OffsetCache::FindPatterns(uint8_t const* pData, size_t size,
+  std::vector<CachedPattern> const& patterns, size_t* pScannedCount /* = nullptr */)
+{
+  std::vector<size_t> results(patterns.size(), PatternScanner::NotFound);
+  std::vector<uint64_t> hashes(patterns.size());
+
+  PatternScanner scanner;
+  std::vector<size_t> scanned;
+
+  for (size_t i = 0; i < patterns.size(); ++i)
+  {
+    CachedPattern const& pattern = patterns[i];
+    hashes[i] = HashPattern(pattern.Bytes, pattern.Mask);
+
+    auto cached = m_Entries.find(pattern.Name);
+    if (cached != m_Entries.end()
+      && cached->second.PatternHash == hashes[i]
+      && Matches(pData, size, cached->second.Offset, pattern.Bytes, pattern.Mask))
+    {
+      results[i] = cached->second.Offset;
+      continue;
+    }
+
+    scanner.AddPattern(pattern.Bytes, pattern.Mask);
+    scanned.push_back(i);
+  }
+
+  if (pScannedCount)
+    *pScannedCount = scanned.size();
+
+  if (scanned.empty())
+    return results;
+
+  std::vector<size_t> scanResults = scanner.Scan(pData, size);
+  for (size_t i = 0; i < scanned.size(); ++i)
+  {
+    size_t index = scanned[i];
+    results[index] = scanResults[i];
+
+    // Patterns that can't be found aren't cached, so they're
+    // scanned for again next time
+    if (scanResults[i] == PatternScanner::NotFound)
+    {
+      if (m_Entries.erase(patterns[index].Name))
+        m_Dirty = true;
+      continue;
+    }
+
+    Entry entry;
+    entry.PatternHash = hashes[index];
+    entry.Offset = scanResults[i];
+    m_Entries[patterns[index].Name] = entry;
+    m_Dirty = true;
+  }
+
+  return results;
+}
+
+void OffsetCache::SetModuleHash(uint64_t hash)
+{
+  if (m_ModuleHash == hash)
+    return;
+
+  m_ModuleHash = hash;
+  m_Dirty = true;
+}
+
+uint64_t OffsetCache::Hash(void const* pData, size_t size, uint64_t seed /* = 0 */)
+{
+  // FNV-1a, but mixing in 8 bytes at a time since code sections
+  // are tens of megabytes
+  uint8_t const* pBytes = static_cast<uint8_t const*>(pData);
+  uint64_t hash = g_FnvOffsetBasis ^ seed;
+
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+  {
+    uint64_t word;
+    memcpy(&word, pBytes + i, sizeof(word));
+    hash = (hash ^ word) * g_FnvPrime;
+  }
+
+  for (; i < size; ++i)
+    hash = (hash ^ pBytes[i]) * g_FnvPrime;
+
+  return (hash ^ size) * g_FnvPrime;
+}
+
+uint64_t OffsetCache::HashPattern(std::vector<uint8_t> const& bytes, std::string const& mask)
+{
+  // Wildcard bytes don't count, only where they are
+  std::vector<uint8_t> masked(bytes.size(), 0);
+  for (size_t i = 0; i < bytes.size(); ++i)
+  {
+    if (i < mask.size() && mask[i] == 'x')
+      masked[i] = bytes[i];
+  }
+
+  uint64_t hash = Hash(masked.data(), masked.size());
+  return Hash(mask.data(), mask.size(), hash);
+}
+
+bool OffsetCache::Matches(uint8_t const* pData, size_t size, size_t offset,
+  std::vector<uint8_t> const& bytes, std::string const& mask)
+{
+  if (bytes.empty() || offset > size || bytes.size() > size - offset)
+    return false;
+
+  for (size_t i = 0; i < bytes.size(); ++i)
+  {
+    if (i < mask.size() && mask[i] == 'x' && pData[offset + i] != bytes[i])
+      return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace util
+{
+  namespace offsets
+  {
+    struct CachedPattern
+    {
+      std::string Name;
+      std::vector<uint8_t> Bytes;
+      std::string Mask; // x = evaluate, anything else is a wildcard
+    };
+
+    // Remembers where each pattern was found in the game module, so
+    // the module doesn't have to be scanned on every launch.
+    //
+    // Cached offsets are only trusted if the pattern hasn't changed and
+    // its bytes still match at the cached offset. Anything else is
+    // scanned for again, so the cache heals itself after a game patch.
+    //
+    // Doesn't depend on Windows headers.
+    class OffsetCache
+    {
+    public:
+      OffsetCache();
+
+      // Discards the cache if the file is missing or malformed
+      bool Load(std::string const& path);
+      bool Save(std::string const& path) const;
+
+      // Returns the offset of every pattern from the module start, or
+      // PatternScanner::NotFound. Only patterns without a valid cached
+      // offset are scanned for.
+      std::vector<size_t> FindPatterns(uint8_t const* pData, size_t size,
+        std::vector<CachedPattern> const& patterns, size_t* pScannedCount = nullptr);
+
+      // Hash of the module's code, only used to tell when the game was updated
+      uint64_t GetModuleHash() const { return m_ModuleHash; }
+      void SetModuleHash(uint64_t hash);
+
+      // True when the cache differs from what was loaded
+      bool IsDirty() const { return m_Dirty; }
+
+      static uint64_t Hash(void const* pData, size_t size, uint64_t seed = 0);
+      static uint64_t HashPattern(std::vector<uint8_t> const& bytes, std::string const& mask);
+      static bool Matches(uint8_t const* pData, size_t size, size_t offset,
+        std::vector<uint8_t> const& bytes, std::string const& mask);
+
+    private:
+      struct Entry
+      {
+        uint64_t PatternHash;
+        size_t Offset;
+      };
+
+      uint64_t m_ModuleHash;
+      std::unordered_map<std::string, Entry> m_Entries;
+      bool m_Dirty;
+    };
+  }
+}
@@ -1,4 +1,6 @@
 #include "Util.h"
+#include "OffsetCache.h"
+#include "PatternScanner.h"
 #include "../Main.h"
 
 #include <boost/assign.hpp>
@@ -11,75 +13,84 @@ using namespace boost::assign;
 namespace
 {
   bool m_UseScannedResults = false;
-  std::unordered_map<std::string, util::offsets::Signature> m_Signatures;
+  std::vector<std::pair<OffsetId, util::offsets::Signature>> m_Signatures;
 
   // Fill with hardcoded offsets if you don't want to use scanning
   // These should be relative to the module base.
-  std::unordered_map<std::string, int> m_HardcodedOffsets = map_list_of
-  ("OFFSET_D3D", 0x17DF5CC)
-  ("OFFSET_MAIN", 0x12F0C88)
-
-  ("OFFSET_CAMERAUPDATE", 0x32300)
-  ("OFFSET_GETCAMERAMATRIX", 0x5B0B40)
-  ("OFFSET_POSTPROCESSUPDATE", 0x608C50)
-  ("OFFSET_TONEMAPUPDATE", 0x208490)
-
-  ("OFFSET_INPUTUPDATE", 0x57D6C0)
-  ("OFFSET_GAMEPADUPDATE", 0x60EE30)
-  ("OFFSET_COMBATMANAGERUPDATE", 0x37A800)
-
-  ("OFFSET_SHOWMOUSE", 0x1359B44)
-  ("OFFSET_DRAWUI", 0x1240F27)
-  ("OFFSET_FREEZETIME", 0x12F194C)
-  ("OFFSET_SCALEFORM", 0x134A78C)
-  ("OFFSET_TIMESCALE", 0xDC6EA0)
-  ("OFFSET_POSTPROCESS", 0x15D0970);
-
-  bool DataCompare(BYTE* pData, BYTE* bSig, const char* szMask)
-  {
-    for (; *szMask; ++szMask, ++pData, ++bSig)
-    {
-      if (*szMask == 'x' && *pData != *bSig)
-        return false;
-    }
-    return (*szMask) == 0;
-  }
+  std::unordered_map<OffsetId, int> m_HardcodedOffsets = map_list_of
+  (OFFSET_D3D, 0x17DF5CC)
+  (OFFSET_MAIN, 0x12F0C88)
+
+  (OFFSET_CAMERAUPDATE, 0x32300)
+  (OFFSET_GETCAMERAMATRIX, 0x5B0B40)
+  (OFFSET_POSTPROCESSUPDATE, 0x608C50)
+  (OFFSET_TONEMAPUPDATE, 0x208490)
+
+  (OFFSET_INPUTUPDATE, 0x57D6C0)
+  (OFFSET_GAMEPADUPDATE, 0x60EE30)
+  (OFFSET_COMBATMANAGERUPDATE, 0x37A800)
 
-  BYTE* FindPattern(BYTE* dwAddress, __int64 dwSize, BYTE* pbSig, const char* szMask)
+  (OFFSET_SHOWMOUSE, 0x1359B44)
+  (OFFSET_DRAWUI, 0x1240F27)
+  (OFFSET_FREEZETIME, 0x12F194C)
+  (OFFSET_SCALEFORM, 0x134A78C)
+  (OFFSET_TIMESCALE, 0xDC6EA0)
+  (OFFSET_POSTPROCESS, 0x15D0970);
+
+  // Same order as OffsetId, used for logging and the offset cache
+  const char* g_offsetNames[] =
   {
-    register BYTE bFirstByte = *(BYTE*)pbSig;
+    "OFFSET_D3D",
+    "OFFSET_MAIN",
 
-    __int64 length = (__int64)dwAddress + dwSize - strlen(szMask);
+    "OFFSET_CAMERAUPDATE",
+    "OFFSET_GETCAMERAMATRIX",
+    "OFFSET_POSTPROCESSUPDATE",
+    "OFFSET_TONEMAPUPDATE",
 
-    for (register __int64 i = (__int64)dwAddress; i < length; i += 4) // might run faster with 8 bytes but I am too lazy
-    {
-      unsigned x = *(unsigned*)(i);
+    "OFFSET_INPUTUPDATE",
+    "OFFSET_GAMEPADUPDATE",
+    "OFFSET_COMBATMANAGERUPDATE",
 
-      if ((x & 0xFF) == bFirstByte)
-        if (DataCompare(reinterpret_cast<BYTE*>(i), pbSig, szMask))
-          return reinterpret_cast<BYTE*>(i);
+    "OFFSET_SHOWMOUSE",
+    "OFFSET_DRAWUI",
+    "OFFSET_FREEZETIME",
+    "OFFSET_SCALEFORM",
+    "OFFSET_TIMESCALE",
+    "OFFSET_POSTPROCESS"
+  };
 
-      if ((x & 0xFF00) >> 8 == bFirstByte)
-        if (DataCompare(reinterpret_cast<BYTE*>(i + 1), pbSig, szMask))
-          return reinterpret_cast<BYTE*>(i + 1);
+  static_assert(sizeof(g_offsetNames) / sizeof(g_offsetNames[0]) == OffsetCount, "Every OffsetId needs a name");
 
-      if ((x & 0xFF0000) >> 16 == bFirstByte)
-        if (DataCompare(reinterpret_cast<BYTE*>(i + 2), pbSig, szMask))
-          return reinterpret_cast<BYTE*>(i + 2);
+  const char* g_offsetCacheFile = "./Cinematic Tools/offsets.cache";
 
-      if ((x & 0xFF000000) >> 24 == bFirstByte)
-        if (DataCompare(reinterpret_cast<BYTE*>(i + 3), pbSig, szMask))
-          return reinterpret_cast<BYTE*>(i + 3);
+  // Hashes the executable sections of the module. Data sections
+  // change while the game runs so they're left out.
+  uint64_t HashCodeSections(BYTE* pBase)
+  {
+    IMAGE_DOS_HEADER* pDosHeader = reinterpret_cast<IMAGE_DOS_HEADER*>(pBase);
+    IMAGE_NT_HEADERS* pNtHeaders = reinterpret_cast<IMAGE_NT_HEADERS*>(pBase + pDosHeader->e_lfanew);
+    IMAGE_SECTION_HEADER* pSection = IMAGE_FIRST_SECTION(pNtHeaders);
+
+    uint64_t hash = 0;
+    for (WORD i = 0; i < pNtHeaders->FileHeader.NumberOfSections; ++i, ++pSection)
+    {
+      if (pSection->Characteristics & IMAGE_SCN_MEM_EXECUTE)
+        hash = util::offsets::OffsetCache::Hash(pBase + pSection->VirtualAddress, pSection->Misc.VirtualSize, hash);
     }
-    return 0;
+
+    return hash;
   }
 }
 
+int util::offsets::g_resolvedOffsets[OffsetCount] = { 0 };
+
 util::offsets::Signature::Signature(std::string const& sig, int offset /* = 0 */)
 {
-  Pattern = new BYTE[sig.size()]();
   AddOffset = offset;
 
+  // Reference offset and size are counted in bytes of the pattern,
+  // not in characters of the signature string
   for (size_t i = 0; i < sig.size(); ++i)
   {
     switch (sig[i])
@@ -91,26 +102,31 @@ util::offsets::Signature::Signature(std::string const& sig, int offset /* = 0 */
       case '[':
       {
         HasReference = true;
-        ReferenceOffset = i;
+        ReferenceOffset = static_cast<int>(Pattern.size());
         break;
       }
       case ']':
       {
-        ReferenceSize = i - ReferenceOffset;
+        ReferenceSize = static_cast<int>(Pattern.size()) - ReferenceOffset;
         break;
       }
       case '?':
       {
         Mask += '?';
+        Pattern.push_back(0);
         // In signature it's clearer to mark one wildcard byte as ??
         // so skip the next character.
         i += 1;
+        break;
       }
       default:
       {
+        if (i + 1 >= sig.size())
+          break;
+
         Mask += 'x';
         // Process 2 characters into a single byte
-        Pattern[i] = (util::CharToByte(sig[i]) << 4) + util::CharToByte(sig[i+1]);
+        Pattern.push_back((util::CharToByte(sig[i]) << 4) + util::CharToByte(sig[i+1]));
         i += 1;
       }
     }
@@ -129,8 +145,10 @@ void util::offsets::Scan()
   //
   // The last argument is the offset to be added to the result, useful when
   // you need a code offset for byte patches.
+  //
+  // m_Signatures.emplace_back(OFFSET_EXAMPLE, Signature("12 34 56 78 [ ?? ?? ?? ?? ] AA BB ?? DF", 0x20));
 
-  m_Signatures.emplace("OFFSET_EXAMPLE", Signature("12 34 56 78 [ ?? ?? ?? ?? ] AA BB ?? DF", 0x20));
+  m_Signatures.clear();
 
   util::log::Write("Scanning for offsets...");
 
@@ -139,31 +157,66 @@ void util::offsets::Scan()
   {
     util::log::Error("GetModuleInformation failed, GetLastError 0x%X", GetLastError());
     util::log::Error("Offset scanning unavailable");
+    Resolve();
     return;
   }
 
+  BYTE* pBase = reinterpret_cast<BYTE*>(info.lpBaseOfDll);
+
+  std::vector<CachedPattern> patterns;
+  for (auto& entry : m_Signatures)
+  {
+    CachedPattern pattern;
+    pattern.Name = GetOffsetName(entry.first);
+    pattern.Bytes = entry.second.Pattern;
+    pattern.Mask = entry.second.Mask;
+    patterns.push_back(pattern);
+  }
+
+  // Offsets from the last launch are used if their patterns still
+  // match, everything else is searched for in a single pass
+  OffsetCache cache;
+  cache.Load(g_offsetCacheFile);
+
+  uint64_t moduleHash = HashCodeSections(pBase);
+  if (cache.GetModuleHash() != 0 && cache.GetModuleHash() != moduleHash)
+    util::log::Write("Game has been updated since the offsets were cached");
+
+  size_t scannedCount = 0;
+  std::vector<size_t> results = cache.FindPatterns(pBase, info.SizeOfImage, patterns, &scannedCount);
+  util::log::Write("%d/%d offsets from cache", patterns.size() - scannedCount, patterns.size());
+
+  cache.SetModuleHash(moduleHash);
+  if (cache.IsDirty() && !cache.Save(g_offsetCacheFile))
+    util::log::Warning("Could not write offset cache %s", g_offsetCacheFile);
+
   bool allFound = true;
+  size_t index = 0;
 
   for (auto& entry : m_Signatures)
   {
     Signature& sig = entry.second;
-    int result = reinterpret_cast<int>(FindPattern((BYTE*)info.lpBaseOfDll, info.SizeOfImage, sig.Pattern, sig.Mask.c_str()));
-    if (!result)
+    size_t result = results[index++];
+    if (result == PatternScanner::NotFound)
     {
-      util::log::Error("Could not find pattern for %s", entry.first.c_str());
+      util::log::Error("Could not find pattern for %s", GetOffsetName(entry.first));
+      sig.Result = 0;
       allFound = false;
+      continue;
     }
 
+    int address = reinterpret_cast<int>(pBase + result);
+
     if (sig.HasReference)
     {
       // Get the assembly reference
-      int* pReference = (int*)(result + sig.ReferenceOffset);
+      int* pReference = (int*)(address + sig.ReferenceOffset);
       // Assembly reference is relative to the address after the reference
       sig.Result = ((int)pReference + sig.ReferenceSize) + *pReference;
       sig.Result += sig.AddOffset;
     }
     else
-      sig.Result = result + sig.AddOffset;
+      sig.Result = address + sig.AddOffset;
   }
 
   if (allFound)
@@ -172,32 +225,40 @@ void util::offsets::Scan()
     util::log::Warning("All offsets could not be found, this might result in a crash");
 
   m_UseScannedResults = true;
+  Resolve();
 }
 
-int util::offsets::GetOffset(std::string const& name)
+void util::offsets::Resolve()
 {
-  // If a scan was done, prefer those results.
-  // If something couldn't be found or there was no scan,
-  // use the hardcoded offsets.
+  // If the offsets were scanned, their absolute position is known.
+  // With hardcoded offsets, use relative offset because it's not
+  // 100% guaranteed the game module will load at the same address space.
+
+  for (int i = 0; i < OffsetCount; ++i)
+    g_resolvedOffsets[i] = 0;
 
+  for (auto& entry : m_HardcodedOffsets)
+    g_resolvedOffsets[entry.first] = entry.second + (int)g_gameHandle;
+
+  // If a scan was done, prefer those results.
+  // If something couldn't be found, keep the hardcoded offset.
   if (m_UseScannedResults)
   {
-    auto result = m_Signatures.find(name);
-    if (result != m_Signatures.end())
+    for (auto& entry : m_Signatures)
     {
-      if (result->second.Result)
-        return result->second.Result;
+      if (entry.second.Result)
+        g_resolvedOffsets[entry.first] = entry.second.Result;
     }
   }
 
-  // If the offsets were scanned, their absolute position is known.
-  // With hardcoded offsets, use relative offset because it's not
-  // 100% guaranteed the game module will load at the same address space.
-
-  auto hardcodedResult = m_HardcodedOffsets.find(name);
-  if (hardcodedResult != m_HardcodedOffsets.end())
-    return hardcodedResult->second + (int)g_gameHandle;
+  for (int i = 0; i < OffsetCount; ++i)
+  {
+    if (!g_resolvedOffsets[i])
+      util::log::Error("Offset %s does not exist", g_offsetNames[i]);
+  }
+}
 
-  util::log::Error("Offset %s does not exist", name.c_str());
-  return 0;
+const char* util::offsets::GetOffsetName(OffsetId id)
+{
+  return g_offsetNames[id];
 }
\ No newline at end of file
@@ -0,0 +1,221 @@
+#include "PatternScanner.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define PATTERNSCANNER_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace util::offsets;
+
+const size_t PatternScanner::NotFound;
+
+namespace
+{
+  // Only every this many bytes are counted when looking for rare bytes
+  const size_t g_HistogramStride = 61;
+
+  // Splitting small images between threads costs more than it saves
+  const size_t g_MinChunkSize = 1024 * 1024;
+
+  // Above this many distinct anchor bytes a lookup table is faster
+  // than comparing every block against each of them
+  const size_t g_MaxSimdAnchors = 16;
+
+  unsigned int LowestBit(unsigned int mask)
+  {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+  }
+}
+
+size_t PatternScanner::AddPattern(std::vector<uint8_t> const& bytes, std::string const& mask)
+{
+  Pattern pattern;
+  pattern.Bytes = bytes;
+  pattern.Mask.resize(bytes.size(), 0);
+  pattern.Anchor = 0;
+
+  for (size_t i = 0; i < bytes.size() && i < mask.size(); ++i)
+  {
+    if (mask[i] == 'x')
+      pattern.Mask[i] = 0xFF;
+  }
+
+  m_Patterns.push_back(pattern);
+  return m_Patterns.size() - 1;
+}
+
+std::vector<size_t> PatternScanner::Scan(uint8_t const* pData, size_t size, unsigned int threadCount) const
+{
+  std::vector<size_t> results(m_Patterns.size(), NotFound);
+  if (m_Patterns.empty() || !pData || size == 0)
+    return results;
+
+  std::vector<Pattern> patterns = m_Patterns;
+  ChooseAnchors(pData, size, patterns);
+
+  // Patterns listed by their anchor byte
+  std::vector<std::vector<Candidate>> candidates(256);
+  for (size_t i = 0; i < patterns.size(); ++i)
+  {
+    Pattern const& pattern = patterns[i];
+    if (pattern.Bytes.empty() || pattern.Bytes.size() > size)
+      continue;
+
+    // Nothing to compare, matches right at the start
+    if (pattern.Mask[pattern.Anchor] == 0)
+    {
+      results[i] = 0;
+      continue;
+    }
+
+    Candidate candidate;
+    candidate.Pattern = i;
+    candidate.Anchor = pattern.Anchor;
+    candidates[pattern.Bytes[pattern.Anchor]].push_back(candidate);
+  }
+
+  if (threadCount == 0)
+    threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+  size_t chunkSize = std::max(g_MinChunkSize, (size + threadCount - 1) / threadCount);
+  size_t chunkCount = (size + chunkSize - 1) / chunkSize;
+
+  std::vector<std::vector<size_t>> chunkResults(chunkCount, results);
+  std::vector<std::thread> threads;
+
+  // Chunks split the positions of the anchor bytes. Patterns may
+  // still extend into the neighbouring chunks.
+  for (size_t i = 1; i < chunkCount; ++i)
+  {
+    size_t begin = i * chunkSize;
+    size_t end = std::min(size, begin + chunkSize);
+    threads.emplace_back([&, i, begin, end]
+    {
+      ScanChunk(pData, size, begin, end, patterns, candidates, chunkResults[i]);
+    });
+  }
+
+  ScanChunk(pData, size, 0, std::min(size, chunkSize), patterns, candidates, chunkResults[0]);
+
+  for (auto& thread : threads)
+    thread.join();
+
+  for (auto const& chunk : chunkResults)
+  {
+    for (size_t i = 0; i < results.size(); ++i)
+      results[i] = std::min(results[i], chunk[i]);
+  }
+
+  return results;
+}
+
+void PatternScanner::ChooseAnchors(uint8_t const* pData, size_t size, std::vector<Pattern>& patterns) const
+{
+  size_t histogram[256] = { 0 };
+  for (size_t i = 0; i < size; i += g_HistogramStride)
+    histogram[pData[i]]++;
+
+  for (auto& pattern : patterns)
+  {
+    size_t rarest = static_cast<size_t>(-1);
+    for (size_t i = 0; i < pattern.Bytes.size(); ++i)
+    {
+      if (pattern.Mask[i] && histogram[pattern.Bytes[i]] < rarest)
+      {
+        rarest = histogram[pattern.Bytes[i]];
+        pattern.Anchor = i;
+      }
+    }
+  }
+}
+
+void PatternScanner::ScanChunk(uint8_t const* pData, size_t size, size_t begin, size_t end,
+  std::vector<Pattern> const& patterns, std::vector<std::vector<Candidate>> const& candidates,
+  std::vector<size_t>& results) const
+{
+  size_t remaining = 0;
+  uint8_t anchorBytes[256];
+  size_t anchorCount = 0;
+  bool isAnchor[256] = { false };
+
+  for (size_t i = 0; i < 256; ++i)
+  {
+    if (candidates[i].empty()) continue;
+
+    anchorBytes[anchorCount++] = static_cast<uint8_t>(i);
+    isAnchor[i] = true;
+    remaining += candidates[i].size();
+  }
+
+  // Chunks are scanned from the start, so the first match found
+  // for a pattern is also the lowest one in this chunk
+  auto checkPosition = [&](size_t position)
+  {
+    for (auto const& candidate : candidates[pData[position]])
+    {
+      if (results[candidate.Pattern] != NotFound || position < candidate.Anchor)
+        continue;
+
+      Pattern const& pattern = patterns[candidate.Pattern];
+      size_t start = position - candidate.Anchor;
+      if (pattern.Bytes.size() > size - start)
+        continue;
+
+      uint8_t const* pStart = pData + start;
+      size_t i = 0;
+      while (i < pattern.Bytes.size() && ((pStart[i] ^ pattern.Bytes[i]) & pattern.Mask[i]) == 0)
+        ++i;
+
+      if (i == pattern.Bytes.size())
+      {
+        results[candidate.Pattern] = start;
+        remaining--;
+      }
+    }
+  };
+
+  size_t position = begin;
+
+#ifdef PATTERNSCANNER_SSE2
+  if (anchorCount <= g_MaxSimdAnchors)
+  {
+    __m128i anchors[g_MaxSimdAnchors];
+    for (size_t i = 0; i < anchorCount; ++i)
+      anchors[i] = _mm_set1_epi8(static_cast<char>(anchorBytes[i]));
+
+    for (; position + 16 <= end && remaining > 0; position += 16)
+    {
+      __m128i block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(pData + position));
+      __m128i hits = _mm_setzero_si128();
+      for (size_t i = 0; i < anchorCount; ++i)
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, anchors[i]));
+
+      unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(hits));
+      while (mask)
+      {
+        checkPosition(position + LowestBit(mask));
+        mask &= mask - 1;
+      }
+    }
+  }
+#endif
+
+  for (; position < end && remaining > 0; ++position)
+  {
+    if (isAnchor[pData[position]])
+      checkPosition(position);
+  }
+}
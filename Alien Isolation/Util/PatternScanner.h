@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace util
+{
+  namespace offsets
+  {
+    // Finds the first match of many byte patterns in a single pass.
+    //
+    // Every pattern is anchored on the byte that is rarest in the
+    // scanned image, so most positions are rejected after comparing
+    // against just the set of anchor bytes. With SSE2 that comparison
+    // is done 16 bytes at a time. The image is split into chunks that
+    // are scanned in parallel.
+    //
+    // Doesn't depend on Windows headers.
+    class PatternScanner
+    {
+    public:
+      static const size_t NotFound = static_cast<size_t>(-1);
+
+      // Mask has one character per byte, 'x' compares the byte and
+      // anything else is a wildcard. Returns the index of the pattern.
+      size_t AddPattern(std::vector<uint8_t> const& bytes, std::string const& mask);
+
+      // Returns the offset of the first match of every pattern in
+      // the order they were added, or NotFound. Zero threads uses
+      // one per core.
+      std::vector<size_t> Scan(uint8_t const* pData, size_t size, unsigned int threadCount = 0) const;
+
+    private:
+      struct Pattern
+      {
+        std::vector<uint8_t> Bytes;
+        std::vector<uint8_t> Mask; // 0xFF or 0 per byte, so comparing is a single AND
+        size_t Anchor;             // Index of the byte used to find candidates
+      };
+
+      struct Candidate
+      {
+        size_t Pattern;
+        size_t Anchor;
+      };
+
+      void ChooseAnchors(uint8_t const* pData, size_t size, std::vector<Pattern>& patterns) const;
+      void ScanChunk(uint8_t const* pData, size_t size, size_t begin, size_t end,
+        std::vector<Pattern> const& patterns, std::vector<std::vector<Candidate>> const& candidates,
+        std::vector<size_t>& results) const;
+
+    private:
+      std::vector<Pattern> m_Patterns;
+    };
+  }
+}
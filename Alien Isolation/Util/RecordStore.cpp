@@ -0,0 +1,398 @@
+#include "RecordStore.h"
+#include "ConfigWriter.h"
+#include <array>
+#include <cstring>
+#include <limits>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace util;
+
+namespace
+{
+  const char g_FileMagic[8] = { 'C', 'T', 'S', 'T', 'O', 'R', 'E', '1' };
+  const uint32_t g_RecordMagic = 0x43525443; // "CTRC"
+
+  // Outdated copies are compacted away on open once they take
+  // up more than this and more than the records themselves
+  const uint64_t g_CompactThreshold = 64 * 1024;
+
+  struct RecordHeader
+  {
+    uint32_t Magic;
+    uint16_t NameSize;
+    uint16_t Flags;
+    uint32_t DataSize;
+    uint32_t Checksum; // Of the sizes, the name and the data
+  };
+  static_assert(sizeof(RecordHeader) == 16, "Record header has to be packed");
+
+  FILE* OpenFile(std::string const& path, const char* mode)
+  {
+#ifdef _WIN32
+    FILE* pFile = nullptr;
+    fopen_s(&pFile, path.c_str(), mode);
+    return pFile;
+#else
+    return fopen(path.c_str(), mode);
+#endif
+  }
+
+  bool Seek(FILE* pFile, uint64_t offset)
+  {
+#ifdef _WIN32
+    return _fseeki64(pFile, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(pFile, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+  }
+
+  uint64_t RecordSize(size_t nameSize, size_t dataSize)
+  {
+    return sizeof(RecordHeader) + nameSize + dataSize;
+  }
+
+  uint32_t RecordChecksum(std::string const& name, std::string const& data)
+  {
+    uint32_t sizes[2] = { static_cast<uint32_t>(name.size()), static_cast<uint32_t>(data.size()) };
+    uint32_t crc = RecordStore::Checksum(sizes, sizeof(sizes));
+    crc = RecordStore::Checksum(name.data(), name.size(), crc);
+    return RecordStore::Checksum(data.data(), data.size(), crc);
+  }
+}
+
+RecordStore::RecordStore() :
+  m_pFile(nullptr),
+  m_End(0),
+  m_LiveBytes(0),
+  m_DamagedBytes(0)
+{
+
+}
+
+RecordStore::~RecordStore()
+{
+  Close();
+}
+
+bool RecordStore::Open(std::string const& path, std::string* pError /* = nullptr */)
+{
+  Close();
+  m_Path = path;
+
+  std::string content;
+  if (!ConfigWriter::Read(path, content))
+  {
+    content.assign(g_FileMagic, sizeof(g_FileMagic));
+    if (!ConfigWriter::Write(path, content, pError))
+      return false;
+  }
+
+  // Reading the whole file in one go is the fastest way to check it,
+  // only the index is kept
+  bool hasHeader = content.compare(0, sizeof(g_FileMagic), g_FileMagic, sizeof(g_FileMagic)) == 0;
+  m_End = Scan(content, hasHeader ? sizeof(g_FileMagic) : 0);
+
+  m_pFile = OpenFile(path, "r+b");
+  if (!m_pFile)
+  {
+    if (pError)
+      *pError = "Could not open " + path;
+    Close();
+    return false;
+  }
+
+  if (m_DamagedBytes > 0 || !hasHeader)
+  {
+    // Keep what was there, in case the damage can be fixed by hand
+    if (!content.empty())
+      ConfigWriter::Write(path + ".damaged", content);
+
+    if (!Compact(pError))
+    {
+      Close();
+      return false;
+    }
+    return true;
+  }
+
+  if (GetDeadBytes() > g_CompactThreshold && GetDeadBytes() > m_LiveBytes)
+    Compact(pError);
+
+  return true;
+}
+
+void RecordStore::Close()
+{
+  if (m_pFile)
+  {
+    fclose(m_pFile);
+    m_pFile = nullptr;
+  }
+
+  m_Names.clear();
+  m_Entries.clear();
+  m_Index.clear();
+  m_End = 0;
+  m_LiveBytes = 0;
+  m_DamagedBytes = 0;
+}
+
+int RecordStore::Find(std::string const& name) const
+{
+  auto itr = m_Index.find(name);
+  return itr == m_Index.end() ? -1 : static_cast<int>(itr->second);
+}
+
+bool RecordStore::Get(std::string const& name, std::string& data)
+{
+  auto itr = m_Index.find(name);
+  if (itr == m_Index.end() || !m_pFile)
+    return false;
+
+  Entry const& entry = m_Entries[itr->second];
+  return ReadData(entry, data) && RecordChecksum(name, data) == entry.Checksum;
+}
+
+bool RecordStore::Put(std::string const& name, std::string const& data, bool* pChanged /* = nullptr */, std::string* pError /* = nullptr */)
+{
+  if (pChanged)
+    *pChanged = false;
+
+  if (!m_pFile)
+  {
+    if (pError)
+      *pError = "The store isn't open";
+    return false;
+  }
+
+  if (name.empty() || name.size() > std::numeric_limits<uint16_t>::max()
+    || data.size() > std::numeric_limits<uint32_t>::max())
+  {
+    if (pError)
+      *pError = "Record name or data has an invalid size";
+    return false;
+  }
+
+  uint32_t checksum = RecordChecksum(name, data);
+
+  // Only read the saved copy back if it could be the same
+  auto itr = m_Index.find(name);
+  if (itr != m_Index.end())
+  {
+    Entry const& saved = m_Entries[itr->second];
+    std::string savedData;
+    if (saved.Size == data.size() && saved.Checksum == checksum && ReadData(saved, savedData) && savedData == data)
+      return true;
+  }
+
+  std::string record;
+  AppendRecord(record, name, data, checksum);
+
+  // Anything past the end is a torn write and gets written over
+  bool written = Seek(m_pFile, m_End)
+    && fwrite(record.data(), 1, record.size(), m_pFile) == record.size()
+    && fflush(m_pFile) == 0;
+
+  if (!written)
+  {
+    if (pError)
+      *pError = "Could not write to " + m_Path;
+    return false;
+  }
+
+  Entry entry;
+  entry.Offset = m_End + sizeof(RecordHeader) + name.size();
+  entry.Size = static_cast<uint32_t>(data.size());
+  entry.Checksum = checksum;
+
+  m_End += record.size();
+  AddEntry(name, entry);
+
+  if (pChanged)
+    *pChanged = true;
+  return true;
+}
+
+bool RecordStore::Sync()
+{
+  if (!m_pFile || fflush(m_pFile) != 0)
+    return false;
+#ifdef _WIN32
+  return _commit(_fileno(m_pFile)) == 0;
+#else
+  return fsync(fileno(m_pFile)) == 0;
+#endif
+}
+
+bool RecordStore::Compact(std::string* pError /* = nullptr */)
+{
+  if (!m_pFile)
+  {
+    if (pError)
+      *pError = "The store isn't open";
+    return false;
+  }
+
+  std::string content(g_FileMagic, sizeof(g_FileMagic));
+  content.reserve(static_cast<size_t>(m_LiveBytes));
+
+  std::vector<Entry> entries;
+  entries.reserve(m_Entries.size());
+
+  std::string data;
+  for (size_t i = 0; i < m_Names.size(); ++i)
+  {
+    Entry entry = m_Entries[i];
+    if (!ReadData(entry, data) || RecordChecksum(m_Names[i], data) != entry.Checksum)
+    {
+      if (pError)
+        *pError = "Could not read " + m_Names[i] + " from " + m_Path;
+      return false;
+    }
+
+    entry.Offset = content.size() + sizeof(RecordHeader) + m_Names[i].size();
+    AppendRecord(content, m_Names[i], data, entry.Checksum);
+    entries.push_back(entry);
+  }
+
+  // The file can't be replaced while it's open on Windows
+  fclose(m_pFile);
+  bool written = ConfigWriter::Write(m_Path, content, pError);
+
+  m_pFile = OpenFile(m_Path, "r+b");
+  if (!m_pFile)
+  {
+    if (pError)
+      *pError = "Could not open " + m_Path;
+    return false;
+  }
+
+  if (!written)
+    return false;
+
+  m_Entries.swap(entries);
+  m_End = content.size();
+  m_LiveBytes = content.size();
+  return true;
+}
+
+uint32_t RecordStore::Checksum(void const* pData, size_t size, uint32_t crc /* = 0 */)
+{
+  // CRC-32, same as zlib
+  static const std::array<uint32_t, 256> table = []
+  {
+    std::array<uint32_t, 256> values;
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+      uint32_t value = i;
+      for (int bit = 0; bit < 8; ++bit)
+        value = (value & 1) ? 0xEDB88320 ^ (value >> 1) : value >> 1;
+      values[i] = value;
+    }
+    return values;
+  }();
+
+  uint8_t const* pBytes = static_cast<uint8_t const*>(pData);
+  crc = ~crc;
+  for (size_t i = 0; i < size; ++i)
+    crc = table[(crc ^ pBytes[i]) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+uint64_t RecordStore::Scan(std::string const& content, size_t start)
+{
+  m_LiveBytes = sizeof(g_FileMagic);
+  m_DamagedBytes = 0;
+
+  size_t pos = start;
+  uint64_t end = start;
+  while (pos < content.size())
+  {
+    RecordHeader header;
+    bool valid = content.size() - pos >= sizeof(header);
+    if (valid)
+    {
+      memcpy(&header, content.data() + pos, sizeof(header));
+      valid = header.Magic == g_RecordMagic && header.NameSize > 0 && header.Flags == 0
+        && content.size() - pos - sizeof(header) >= static_cast<uint64_t>(header.NameSize) + header.DataSize;
+    }
+
+    if (valid)
+    {
+      size_t namePos = pos + sizeof(header);
+      std::string name(content, namePos, header.NameSize);
+      std::string data(content, namePos + header.NameSize, header.DataSize);
+      valid = RecordChecksum(name, data) == header.Checksum;
+
+      if (valid)
+      {
+        Entry entry;
+        entry.Offset = namePos + header.NameSize;
+        entry.Size = header.DataSize;
+        entry.Checksum = header.Checksum;
+        AddEntry(name, entry);
+
+        pos = static_cast<size_t>(entry.Offset + entry.Size);
+        end = pos;
+        continue;
+      }
+    }
+
+    // Skip ahead to the next thing that looks like a record
+    uint32_t magic = g_RecordMagic;
+    size_t next = content.find(std::string(reinterpret_cast<const char*>(&magic), sizeof(magic)), pos + 1);
+    if (next == std::string::npos)
+      next = content.size();
+
+    m_DamagedBytes += next - pos;
+    pos = next;
+  }
+
+  return end;
+}
+
+void RecordStore::AddEntry(std::string const& name, Entry const& entry)
+{
+  auto itr = m_Index.find(name);
+  if (itr == m_Index.end())
+  {
+    m_Index.emplace(name, m_Names.size());
+    m_Names.push_back(name);
+    m_Entries.push_back(entry);
+  }
+  else
+  {
+    m_LiveBytes -= RecordSize(name.size(), m_Entries[itr->second].Size);
+    m_Entries[itr->second] = entry;
+  }
+
+  m_LiveBytes += RecordSize(name.size(), entry.Size);
+}
+
+bool RecordStore::ReadData(Entry const& entry, std::string& data)
+{
+  data.resize(entry.Size);
+  if (!Seek(m_pFile, entry.Offset))
+    return false;
+
+  return entry.Size == 0 || fread(&data[0], 1, entry.Size, m_pFile) == entry.Size;
+}
+
+void RecordStore::AppendRecord(std::string& out, std::string const& name, std::string const& data, uint32_t checksum)
+{
+  RecordHeader header;
+  header.Magic = g_RecordMagic;
+  header.NameSize = static_cast<uint16_t>(name.size());
+  header.Flags = 0;
+  header.DataSize = static_cast<uint32_t>(data.size());
+  header.Checksum = checksum;
+
+  out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  out += name;
+  out += data;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace util
+{
+  // Named blobs kept in a single file.
+  //
+  // The file is an append-only log: saving a record adds a new copy to
+  // the end and the index points at the newest one. Only the index is
+  // kept in memory, data is read from the file when it's asked for.
+  // Every record carries a checksum, so a torn write or a damaged file
+  // loses the affected records instead of the whole store. Damaged and
+  // outdated copies are dropped by compacting, which rewrites the file
+  // in one step.
+  //
+  // Doesn't depend on Windows headers.
+  class RecordStore
+  {
+  public:
+    RecordStore();
+    ~RecordStore();
+
+    // Creates the file if it doesn't exist. Damage found while opening
+    // is skipped and compacted away right after.
+    bool Open(std::string const& path, std::string* pError = nullptr);
+    void Close();
+
+    bool IsOpen() const { return m_pFile != nullptr; }
+
+    // Names in the order they were first saved
+    std::vector<std::string> const& GetNames() const { return m_Names; }
+    size_t GetCount() const { return m_Names.size(); }
+
+    // Index into GetNames, or -1
+    int Find(std::string const& name) const;
+
+    bool Get(std::string const& name, std::string& data);
+
+    // Appends a new copy unless the data is the same as the saved one.
+    // Changed is set if a copy was appended.
+    bool Put(std::string const& name, std::string const& data, bool* pChanged = nullptr, std::string* pError = nullptr);
+
+    // Makes sure everything that was put is on disk
+    bool Sync();
+
+    // Rewrites the file with only the newest copy of each record
+    bool Compact(std::string* pError = nullptr);
+
+    // Bytes that were unreadable on open
+    uint64_t GetDamagedBytes() const { return m_DamagedBytes; }
+    // Bytes taken up by copies that were saved over
+    uint64_t GetDeadBytes() const { return m_End - m_LiveBytes; }
+
+    static uint32_t Checksum(void const* pData, size_t size, uint32_t crc = 0);
+
+  private:
+    struct Entry
+    {
+      uint64_t Offset; // Of the data, after the header and name
+      uint32_t Size;
+      uint32_t Checksum;
+    };
+
+    // Builds the index from the records in a whole file,
+    // returns where the last valid one ends
+    uint64_t Scan(std::string const& content, size_t start);
+    void AddEntry(std::string const& name, Entry const& entry);
+    bool ReadData(Entry const& entry, std::string& data);
+
+    // Record as it's laid out in the file
+    static void AppendRecord(std::string& out, std::string const& name, std::string const& data, uint32_t checksum);
+
+  private:
+    std::string m_Path;
+    FILE* m_pFile;
+
+    std::vector<std::string> m_Names;
+    std::vector<Entry> m_Entries;
+    std::unordered_map<std::string, size_t> m_Index;
+
+    uint64_t m_End;
+    uint64_t m_LiveBytes;
+    uint64_t m_DamagedBytes;
+
+  public:
+    RecordStore(RecordStore const&) = delete;
+    void operator=(RecordStore const&) = delete;
+  };
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace util
+{
+  // Hands a value from one writer thread to any number of reader
+  // threads without locking. Readers never see a half written value,
+  // and the writer is never held up by readers.
+  //
+  // If a read overlaps a write it fails instead of waiting, so a game
+  // thread hook can't stall if the writer gets preempted mid-write.
+  // Readers should keep using the last value they got in that case.
+  //
+  // The value is stored as atomic words so that the racing reads are
+  // well defined.
+  template<typename T>
+  class SeqLock
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock values are copied bytewise");
+
+  public:
+    SeqLock() :
+      m_Sequence(0)
+    {
+      for (auto& word : m_Words)
+        word.store(0, std::memory_order_relaxed);
+    }
+
+    SeqLock(T const& value) :
+      SeqLock()
+    {
+      Store(value);
+    }
+
+    // Only one thread may store
+    void Store(T const& value)
+    {
+      uint32_t words[WordCount] = { 0 };
+      memcpy(words, &value, sizeof(T));
+
+      // Odd sequence marks a write in progress
+      uint32_t sequence = m_Sequence.load(std::memory_order_relaxed);
+      m_Sequence.store(sequence + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+
+      for (size_t i = 0; i < WordCount; ++i)
+        m_Words[i].store(words[i], std::memory_order_relaxed);
+
+      m_Sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Leaves value untouched and returns false if every attempt
+    // overlapped a write
+    bool TryLoad(T& value, unsigned int attempts = 4) const
+    {
+      uint32_t words[WordCount];
+
+      for (unsigned int attempt = 0; attempt < attempts; ++attempt)
+      {
+        uint32_t before = m_Sequence.load(std::memory_order_acquire);
+        if (before & 1)
+          continue;
+
+        for (size_t i = 0; i < WordCount; ++i)
+          words[i] = m_Words[i].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_Sequence.load(std::memory_order_relaxed) != before)
+          continue;
+
+        memcpy(&value, words, sizeof(T));
+        return true;
+      }
+
+      return false;
+    }
+
+    // Incremented twice by every store
+    uint32_t GetSequence() const { return m_Sequence.load(std::memory_order_acquire); }
+
+  private:
+    static const size_t WordCount = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    std::atomic<uint32_t> m_Sequence;
+    std::atomic<uint32_t> m_Words[WordCount];
+
+  public:
+    SeqLock(SeqLock const&) = delete;
+    void operator=(SeqLock const&) = delete;
+  };
+}
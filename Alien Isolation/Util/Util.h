@@ -5,6 +5,32 @@
 #include <vector>
 #include <Windows.h>
 
+// Every offset the tools use. Names are checked at compile time
+// and the addresses are looked up by index.
+enum OffsetId
+{
+  OFFSET_D3D,
+  OFFSET_MAIN,
+
+  OFFSET_CAMERAUPDATE,
+  OFFSET_GETCAMERAMATRIX,
+  OFFSET_POSTPROCESSUPDATE,
+  OFFSET_TONEMAPUPDATE,
+
+  OFFSET_INPUTUPDATE,
+  OFFSET_GAMEPADUPDATE,
+  OFFSET_COMBATMANAGERUPDATE,
+
+  OFFSET_SHOWMOUSE,
+  OFFSET_DRAWUI,
+  OFFSET_FREEZETIME,
+  OFFSET_SCALEFORM,
+  OFFSET_TIMESCALE,
+  OFFSET_POSTPROCESS,
+
+  OffsetCount
+};
+
 namespace util
 {
   namespace hooks
@@ -32,7 +58,10 @@ namespace util
 
   namespace log
   {
+    // Messages are formatted and written on a background thread
     void Init();
+    // Writes what's left and stops the background thread
+    void Shutdown();
 
     void Write(const char* format, ...);
     void Warning(const char* format, ...);
@@ -44,7 +73,7 @@ namespace util
   {
     struct Signature
     {
-      BYTE* Pattern{ nullptr }; // The pattern to search
+      std::vector<BYTE> Pattern; // The pattern to search
       std::string Mask;  // Which bytes should be evaluated (x = evaluate, ? = skip)
       
       bool HasReference{ false }; // Interpret the offset from the assembly reference
@@ -52,13 +81,24 @@ namespace util
       int ReferenceSize{ 0 }; // How many bytes is the assembly reference (usually 4, obsolete?)
       int AddOffset{ 0 }; // How much bytes should be added to the final result
 
-      int Result;
+      int Result{ 0 };
 
       Signature(std::string const& sig, int offset = 0);
     };
 
     void Scan();
-    int GetOffset(std::string const& name);
+
+    // Fills the address table from the scan results, or from the
+    // hardcoded offsets if there was no scan. Needs to be called
+    // before any GetOffset, and again after a Scan.
+    void Resolve();
+    const char* GetOffsetName(OffsetId id);
+
+    extern int g_resolvedOffsets[OffsetCount];
+
+    // Called every frame by the engine accessors and hooks,
+    // so it's only an array read
+    inline int GetOffset(OffsetId id) { return g_resolvedOffsets[id]; }
   }
 
   bool GetResource(int, void*&, DWORD&);
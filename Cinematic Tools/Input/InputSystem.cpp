@@ -19,6 +19,7 @@ InputSystem::InputSystem() :
   m_WantedActionStates(),
   m_SmoothActionStates(),
   m_GamepadKeyStates(),
+  m_RawInputData(),
   m_MouseState(),
   m_KeyboardKeyNames(),
   m_ShowUI(false)
@@ -70,22 +71,19 @@ void InputSystem::Update()
 
 void InputSystem::HandleMouseMsg(LPARAM lParam)
 {
-  // Handle raw mouse messages
-
-  UINT dwSize = 0;
-  GetRawInputData((HRAWINPUT)lParam, RID_INPUT, NULL, &dwSize, sizeof(RAWINPUTHEADER));
-
-  BYTE* lpb = new BYTE[dwSize];
-  GetRawInputData((HRAWINPUT)lParam, RID_INPUT, lpb, &dwSize, sizeof(RAWINPUTHEADER));
+  // Handle raw mouse messages. Runs for every WM_INPUT, which can be a
+  // thousand times a second. Mouse data always fits in the preallocated
+  // RAWINPUT, bigger HID reports fail to read and are skipped.
+  UINT dwSize = sizeof(m_RawInputData);
+  if (GetRawInputData((HRAWINPUT)lParam, RID_INPUT, &m_RawInputData, &dwSize, sizeof(RAWINPUTHEADER)) == (UINT)-1)
+    return;
 
-  RAWINPUT* raw = (RAWINPUT*)lpb;
+  RAWINPUT* raw = &m_RawInputData;
   if (raw->header.dwType == RIM_TYPEMOUSE)
   {
     m_MouseState.x += raw->data.mouse.lLastX;
     m_MouseState.y += raw->data.mouse.lLastY;
   }
-
-  delete[] lpb;
 }
 
 bool InputSystem::HandleKeyMsg(WPARAM wParam, LPARAM lParam)
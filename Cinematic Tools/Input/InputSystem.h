@@ -91,6 +91,7 @@ private:
   std::array<float, GamepadKey::GamepadKey_Count>   m_GamepadKeyStates;
 
   DirectX::XMFLOAT2 m_PrevMousePos;
+  RAWINPUT m_RawInputData;
   DirectX::XMFLOAT2 m_MouseState;
   LPDIRECTINPUTDEVICE8 m_DIMouse;
 
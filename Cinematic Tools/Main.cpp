@@ -2,7 +2,6 @@
 #include "Util/Util.h"
 #include <boost/filesystem.hpp>
 #include <boost/chrono.hpp>
-#include <fstream>
 
 static const char* g_gameName = "theHunter: CoTW";
 static const char* g_moduleName = "theHunterCoTW_F";
@@ -86,6 +85,11 @@ bool Main::Initialize()
 
   util::hooks::Init();
 
+  m_ConfigWriter.Start(g_configFile, [](const char* error)
+  {
+    util::log::Error("Could not save config. %s", error);
+  });
+
   LoadConfig();
   return true;
 }
@@ -102,9 +106,10 @@ void Main::Run()
     m_pCameraManager->Update(dt.count());
     m_pUI->Update(dt.count());
 
-    // Check if config has been affected, if so, save it
+    // Check if config has been affected, if so, save it.
+    // The file is written on the config writer's thread.
     m_dtConfigCheck += dt.count();
-    if (m_dtConfigCheck > 10.f)
+    if (m_dtConfigCheck > 1.f)
     {
       m_dtConfigCheck = 0;
       if (m_ConfigChanged)
@@ -119,6 +124,7 @@ void Main::Run()
 
   // Save config and disable hooks before exit
   SaveConfig();
+  m_ConfigWriter.Stop();
   util::hooks::SetHookState(false);
 }
 
@@ -143,19 +149,8 @@ void Main::LoadConfig()
 
 void Main::SaveConfig()
 {
-  std::fstream file;
-  file.open(g_configFile, std::ios_base::out | std::ios_base::trunc);
-
-  if (!file.is_open())
-  {
-    util::log::Error("Could not save config, failed to open file for writing. GetLastError 0x%X", GetLastError());
-    return;
-  }
-
-  file << m_pCameraManager->GetConfig();
-  file << m_pInputSystem->GetConfig();
-  
-  file.close();
+  // Nothing is written if the content is the same as before
+  m_ConfigWriter.Submit(m_pCameraManager->GetConfig() + m_pInputSystem->GetConfig());
 }
 
 extern LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
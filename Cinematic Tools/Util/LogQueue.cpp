@@ -0,0 +1,852 @@
+#include "LogQueue.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+
+using namespace util;
+
+namespace
+{
+  std::atomic<uint64_t> g_NextQueueId(1);
+
+  const std::chrono::milliseconds g_WakeInterval(5);
+
+  // Longest string argument a record will hold
+  const size_t g_MaxStringLength = 0xFFFF;
+
+  enum ArgType
+  {
+    Arg_None,       // Literal text, like "%%"
+    Arg_Int,
+    Arg_Long,
+    Arg_LongLong,
+    Arg_Size,
+    Arg_PtrDiff,
+    Arg_Double,
+    Arg_LongDouble,
+    Arg_WideChar,
+    Arg_String,
+    Arg_WideString,
+    Arg_Pointer,
+    Arg_Count       // %n, read but never written through
+  };
+
+  // One conversion of a printf format. Length modifiers are stored in
+  // their standard form, so MSVC's %I64X is formatted as %llX.
+  struct FormatSpec
+  {
+    const char* pFlags;
+    size_t FlagsLength;
+    bool WidthArg;
+    const char* pWidth;
+    size_t WidthLength;
+    bool HasPrecision;
+    bool PrecisionArg;
+    const char* pPrecision;
+    size_t PrecisionLength;
+    const char* Length;
+    char Conversion;
+    ArgType Type;
+  };
+
+  size_t CountDigits(const char* p)
+  {
+    size_t count = 0;
+    while (p[count] >= '0' && p[count] <= '9')
+      count++;
+    return count;
+  }
+
+  // Parses the conversion following a '%' and returns the text after it
+  const char* ParseSpec(const char* p, FormatSpec& spec)
+  {
+    spec = FormatSpec();
+    spec.Length = "";
+
+    spec.pFlags = p;
+    while (*p && strchr("-+ #0", *p))
+      ++p;
+    spec.FlagsLength = p - spec.pFlags;
+
+    if (*p == '*')
+    {
+      spec.WidthArg = true;
+      ++p;
+    }
+    else
+    {
+      spec.pWidth = p;
+      spec.WidthLength = CountDigits(p);
+      p += spec.WidthLength;
+    }
+
+    if (*p == '.')
+    {
+      spec.HasPrecision = true;
+      ++p;
+
+      if (*p == '*')
+      {
+        spec.PrecisionArg = true;
+        ++p;
+      }
+      else
+      {
+        spec.pPrecision = p;
+        spec.PrecisionLength = CountDigits(p);
+        p += spec.PrecisionLength;
+      }
+    }
+
+    enum { Length_None, Length_Char, Length_Short, Length_Long, Length_LongLong,
+      Length_Size, Length_PtrDiff, Length_LongDouble } length = Length_None;
+
+    switch (*p)
+    {
+    case 'h':
+      ++p;
+      length = Length_Short;
+      if (*p == 'h')
+      {
+        ++p;
+        length = Length_Char;
+      }
+      break;
+    case 'l':
+      ++p;
+      length = Length_Long;
+      if (*p == 'l')
+      {
+        ++p;
+        length = Length_LongLong;
+      }
+      break;
+    case 'w':
+      ++p;
+      length = Length_Long;
+      break;
+    case 'L':
+      ++p;
+      length = Length_LongDouble;
+      break;
+    case 'j':
+      ++p;
+      length = Length_LongLong;
+      break;
+    case 'z':
+      ++p;
+      length = Length_Size;
+      break;
+    case 't':
+      ++p;
+      length = Length_PtrDiff;
+      break;
+    case 'I':
+      ++p;
+      if (p[0] == '6' && p[1] == '4')
+      {
+        p += 2;
+        length = Length_LongLong;
+      }
+      else if (p[0] == '3' && p[1] == '2')
+        p += 2;
+      else
+        length = Length_Size;
+      break;
+    }
+
+    spec.Conversion = *p;
+    if (*p)
+      ++p;
+
+    switch (spec.Conversion)
+    {
+    case 'd': case 'i': case 'u': case 'o': case 'x': case 'X':
+      switch (length)
+      {
+      case Length_Char: spec.Type = Arg_Int; spec.Length = "hh"; break;
+      case Length_Short: spec.Type = Arg_Int; spec.Length = "h"; break;
+      case Length_Long: spec.Type = Arg_Long; spec.Length = "l"; break;
+      case Length_LongLong: spec.Type = Arg_LongLong; spec.Length = "ll"; break;
+      case Length_Size: spec.Type = Arg_Size; spec.Length = "z"; break;
+      case Length_PtrDiff: spec.Type = Arg_PtrDiff; spec.Length = "t"; break;
+      default: spec.Type = Arg_Int; break;
+      }
+      break;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+      spec.Type = length == Length_LongDouble ? Arg_LongDouble : Arg_Double;
+      spec.Length = length == Length_LongDouble ? "L" : "";
+      break;
+    case 'c':
+      spec.Type = length == Length_Long ? Arg_WideChar : Arg_Int;
+      spec.Length = length == Length_Long ? "l" : "";
+      break;
+    case 'C':
+      spec.Type = Arg_WideChar;
+      spec.Conversion = 'c';
+      spec.Length = "l";
+      break;
+    case 's':
+      spec.Type = length == Length_Long ? Arg_WideString : Arg_String;
+      spec.Length = length == Length_Long ? "l" : "";
+      break;
+    case 'S':
+      // MSVC reads %S as the other width's string, %hS is narrow
+      spec.Type = length == Length_Short ? Arg_String : Arg_WideString;
+      spec.Conversion = 's';
+      spec.Length = length == Length_Short ? "" : "l";
+      break;
+    case 'p':
+      spec.Type = Arg_Pointer;
+      break;
+    case 'n':
+      spec.Type = Arg_Count;
+      break;
+    default:
+      spec.Type = Arg_None;
+      break;
+    }
+
+    return p;
+  }
+
+  class ArgWriter
+  {
+  public:
+    ArgWriter(unsigned char* pData, size_t size) :
+      m_pData(pData),
+      m_Size(size),
+      m_Used(0)
+    {
+    }
+
+    template<typename T>
+    bool Write(T value)
+    {
+      if (m_Size - m_Used < sizeof(T))
+        return false;
+
+      memcpy(m_pData + m_Used, &value, sizeof(T));
+      m_Used += sizeof(T);
+      return true;
+    }
+
+    // Strings are cut short to whatever space is left
+    template<typename Char>
+    bool WriteString(Char const* pString)
+    {
+      if (!pString)
+        return WriteString("(null)");
+
+      if (m_Size - m_Used < sizeof(uint16_t))
+        return false;
+
+      size_t space = (m_Size - m_Used - sizeof(uint16_t)) / sizeof(Char);
+      size_t length = 0;
+      while (length < space && length < g_MaxStringLength && pString[length])
+        length++;
+
+      Write(static_cast<uint16_t>(length));
+      memcpy(m_pData + m_Used, pString, length * sizeof(Char));
+      m_Used += length * sizeof(Char);
+      return true;
+    }
+
+    size_t GetUsed() const { return m_Used; }
+
+  private:
+    unsigned char* m_pData;
+    size_t m_Size;
+    size_t m_Used;
+  };
+
+  class ArgReader
+  {
+  public:
+    ArgReader(unsigned char const* pData, size_t size) :
+      m_pData(pData),
+      m_Size(size),
+      m_Used(0)
+    {
+    }
+
+    template<typename T>
+    bool Read(T& value)
+    {
+      if (m_Size - m_Used < sizeof(T))
+        return false;
+
+      memcpy(&value, m_pData + m_Used, sizeof(T));
+      m_Used += sizeof(T);
+      return true;
+    }
+
+    template<typename Char>
+    bool ReadString(std::basic_string<Char>& value)
+    {
+      uint16_t length = 0;
+      if (!Read(length) || (m_Size - m_Used) / sizeof(Char) < length)
+        return false;
+
+      value.resize(length);
+      if (length > 0)
+        memcpy(&value[0], m_pData + m_Used, length * sizeof(Char));
+      m_Used += length * sizeof(Char);
+      return true;
+    }
+
+  private:
+    unsigned char const* m_pData;
+    size_t m_Size;
+    size_t m_Used;
+  };
+
+  // Copies the arguments the format refers to, returns the bytes used
+  size_t EncodeArgs(const char* format, va_list args, unsigned char* pData, size_t size)
+  {
+    ArgWriter writer(pData, size);
+
+    for (const char* p = format; *p; )
+    {
+      if (*p++ != '%')
+        continue;
+
+      FormatSpec spec;
+      p = ParseSpec(p, spec);
+
+      if (spec.WidthArg && !writer.Write(va_arg(args, int)))
+        break;
+      if (spec.PrecisionArg && !writer.Write(va_arg(args, int)))
+        break;
+
+      bool written = true;
+      switch (spec.Type)
+      {
+      case Arg_Int: written = writer.Write(va_arg(args, int)); break;
+      case Arg_Long: written = writer.Write(va_arg(args, long)); break;
+      case Arg_LongLong: written = writer.Write(va_arg(args, long long)); break;
+      case Arg_Size: written = writer.Write(va_arg(args, size_t)); break;
+      case Arg_PtrDiff: written = writer.Write(va_arg(args, ptrdiff_t)); break;
+      case Arg_Double: written = writer.Write(va_arg(args, double)); break;
+      case Arg_LongDouble: written = writer.Write(va_arg(args, long double)); break;
+      case Arg_WideChar: written = writer.Write(static_cast<uint32_t>(va_arg(args, int))); break;
+      case Arg_String: written = writer.WriteString(va_arg(args, const char*)); break;
+      case Arg_WideString: written = writer.WriteString(va_arg(args, const wchar_t*)); break;
+      case Arg_Pointer: written = writer.Write(va_arg(args, void*)); break;
+      case Arg_Count: va_arg(args, void*); break;
+      default: break;
+      }
+
+      if (!written)
+        break;
+    }
+
+    return writer.GetUsed();
+  }
+
+  // Counts a thread in Push for as long as it's in there
+  class PushScope
+  {
+  public:
+    explicit PushScope(std::atomic<unsigned>& pushing) :
+      m_Pushing(pushing)
+    {
+      m_Pushing.fetch_add(1);
+    }
+
+    ~PushScope()
+    {
+      m_Pushing.fetch_sub(1);
+    }
+
+    PushScope(PushScope const&) = delete;
+    void operator=(PushScope const&) = delete;
+
+  private:
+    std::atomic<unsigned>& m_Pushing;
+  };
+
+  template<typename T>
+  void AppendFormatted(std::string& text, const char* spec, T value)
+  {
+    char buffer[256];
+    int length = snprintf(buffer, sizeof(buffer), spec, value);
+    if (length < 0)
+      return;
+
+    if (static_cast<size_t>(length) < sizeof(buffer))
+    {
+      text.append(buffer, length);
+      return;
+    }
+
+    size_t offset = text.size();
+    text.resize(offset + length + 1);
+    snprintf(&text[offset], length + 1, spec, value);
+    text.resize(offset + length);
+  }
+
+  // Rebuilds the conversion with star arguments filled in
+  void BuildSpec(FormatSpec const& spec, int width, int precision, char* pOut, size_t size)
+  {
+    char* p = pOut;
+    char* pEnd = pOut + size - 1;
+    auto append = [&](const char* pText, size_t length)
+    {
+      length = std::min(length, static_cast<size_t>(pEnd - p));
+      memcpy(p, pText, length);
+      p += length;
+    };
+
+    char number[16];
+    append("%", 1);
+    append(spec.pFlags, spec.FlagsLength);
+
+    if (spec.WidthArg)
+      append(number, snprintf(number, sizeof(number), "%d", width));
+    else
+      append(spec.pWidth, spec.WidthLength);
+
+    if (spec.HasPrecision)
+    {
+      append(".", 1);
+      if (spec.PrecisionArg)
+        append(number, snprintf(number, sizeof(number), "%d", precision));
+      else
+        append(spec.pPrecision, spec.PrecisionLength);
+    }
+
+    append(spec.Length, strlen(spec.Length));
+    append(&spec.Conversion, 1);
+    *p = 0;
+  }
+
+  // Formats the record's arguments with its format. A record that ran
+  // out of space for arguments ends in "..." where they stop.
+  void FormatArgs(const char* format, unsigned char const* pData, size_t size, std::string& text)
+  {
+    ArgReader reader(pData, size);
+    std::string narrow;
+    std::wstring wide;
+    char specText[64];
+
+    const char* p = format;
+    while (*p)
+    {
+      const char* pPercent = strchr(p, '%');
+      if (!pPercent)
+      {
+        text.append(p);
+        break;
+      }
+
+      text.append(p, pPercent - p);
+
+      FormatSpec spec;
+      const char* pNext = ParseSpec(pPercent + 1, spec);
+
+      if (spec.Type == Arg_None)
+      {
+        if (spec.Conversion == '%')
+          text.push_back('%');
+        else
+          text.append(pPercent, pNext - pPercent);
+
+        p = pNext;
+        continue;
+      }
+
+      int width = 0;
+      int precision = 0;
+      if ((spec.WidthArg && !reader.Read(width)) || (spec.PrecisionArg && !reader.Read(precision)))
+      {
+        text.append("...");
+        break;
+      }
+
+      BuildSpec(spec, width, precision, specText, sizeof(specText));
+
+      bool read = true;
+      switch (spec.Type)
+      {
+      case Arg_Int: { int value; if ((read = reader.Read(value))) AppendFormatted(text, specText, value); } break;
+      case Arg_Long: { long value; if ((read = reader.Read(value))) AppendFormatted(text, specText, value); } break;
+      case Arg_LongLong: { long long value; if ((read = reader.Read(value))) AppendFormatted(text, specText, value); } break;
+      case Arg_Size: { size_t value; if ((read = reader.Read(value))) AppendFormatted(text, specText, value); } break;
+      case Arg_PtrDiff: { ptrdiff_t value; if ((read = reader.Read(value))) AppendFormatted(text, specText, value); } break;
+      case Arg_Double: { double value; if ((read = reader.Read(value))) AppendFormatted(text, specText, value); } break;
+      case Arg_LongDouble: { long double value; if ((read = reader.Read(value))) AppendFormatted(text, specText, value); } break;
+      case Arg_WideChar: { uint32_t value; if ((read = reader.Read(value))) AppendFormatted(text, specText, static_cast<wint_t>(value)); } break;
+      case Arg_String: if ((read = reader.ReadString(narrow))) AppendFormatted(text, specText, narrow.c_str()); break;
+      case Arg_WideString: if ((read = reader.ReadString(wide))) AppendFormatted(text, specText, wide.c_str()); break;
+      case Arg_Pointer: { void* value; if ((read = reader.Read(value))) AppendFormatted(text, specText, value); } break;
+      default: break;
+      }
+
+      if (!read)
+      {
+        text.append("...");
+        break;
+      }
+
+      p = pNext;
+    }
+  }
+}
+
+struct LogQueue::Record
+{
+  uint64_t Sequence;
+  int64_t Time;
+  const char* Format;
+  int Level;
+  uint32_t Size;
+  unsigned char Args[RecordSize - 32];
+};
+
+// Single producer, single consumer. Head and tail are kept on
+// separate cache lines so the two threads don't fight over them.
+struct LogQueue::Ring
+{
+  explicit Ring(size_t capacity) :
+    Records(new Record[capacity]),
+    Mask(capacity - 1),
+    Head(0),
+    Dropped(0),
+    Tail(0),
+    Abandoned(false)
+  {
+  }
+
+  std::unique_ptr<Record[]> Records;
+  const size_t Mask;
+
+  char Padding0[64];
+  std::atomic<size_t> Head; // Written by the logging thread
+  std::atomic<uint64_t> Dropped;
+  char Padding1[64];
+  std::atomic<size_t> Tail; // Written by the background thread
+  std::atomic<bool> Abandoned;
+};
+
+// Ties a thread to its ring. When the thread exits the background
+// thread frees the ring once it has been drained.
+struct LogQueue::ThreadRing
+{
+  uint64_t QueueId{ 0 };
+  std::shared_ptr<Ring> pRing;
+
+  ~ThreadRing()
+  {
+    if (pRing)
+      pRing->Abandoned = true;
+  }
+};
+
+LogQueue::LogQueue(size_t recordsPerThread /* = 512 */,
+  unsigned siteBurst /* = 20 */,
+  std::chrono::milliseconds siteInterval /* = 500 ms */,
+  std::chrono::milliseconds reportInterval /* = 10 s */) :
+  m_Id(g_NextQueueId++),
+  m_RingCapacity(RoundUpCapacity(recordsPerThread)),
+  m_ReportInterval(reportInterval),
+  m_Running(false),
+  m_Stopping(false),
+  m_Pushing(0),
+  m_Sequence(0),
+  m_Throttle(siteBurst, std::chrono::duration_cast<std::chrono::nanoseconds>(siteInterval).count()),
+  m_RingsChanged(false),
+  m_Pending(false),
+  m_FlushRequested(0),
+  m_FlushCompleted(0)
+{
+  static_assert(sizeof(Record) == RecordSize, "Log records should fill whole cache lines");
+}
+
+LogQueue::~LogQueue()
+{
+  Stop();
+}
+
+size_t LogQueue::RoundUpCapacity(size_t capacity)
+{
+  size_t rounded = 2;
+  while (rounded < capacity)
+    rounded *= 2;
+  return rounded;
+}
+
+void LogQueue::Start(Sink sink)
+{
+  if (m_Running)
+    return;
+
+  m_Sink = std::move(sink);
+  m_NextReport = std::chrono::steady_clock::now() + m_ReportInterval;
+  m_Stopping = false;
+  m_Running = true;
+  m_Thread = std::thread(&LogQueue::Run, this);
+}
+
+void LogQueue::Stop()
+{
+  if (!m_Running)
+    return;
+
+  // Messages logged after this point are written by the caller,
+  // the ones already being pushed are written by the background thread
+  m_Running = false;
+  while (m_Pushing != 0)
+    std::this_thread::yield();
+
+  {
+    std::lock_guard<std::mutex> lock(m_WakeMutex);
+    m_Stopping = true;
+  }
+  m_Wake.notify_one();
+
+  if (m_Thread.joinable())
+    m_Thread.join();
+}
+
+bool LogQueue::Push(int level, const char* format, va_list args)
+{
+  // Counted before m_Running is checked, so Stop either sees this
+  // push or this push sees the queue stopped
+  PushScope scope(m_Pushing);
+  if (!m_Running)
+    return false;
+
+  int64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+  if (!m_Throttle.Allow(format, level, time))
+    return true;
+
+  Ring* pRing = GetThreadRing();
+  size_t head = pRing->Head.load(std::memory_order_relaxed);
+
+  if (head - pRing->Tail.load(std::memory_order_acquire) > pRing->Mask)
+  {
+    pRing->Dropped.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  Record& record = pRing->Records[head & pRing->Mask];
+  record.Sequence = m_Sequence.fetch_add(1, std::memory_order_relaxed);
+  record.Time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  record.Format = format;
+  record.Level = level;
+  record.Size = static_cast<uint32_t>(EncodeArgs(format, args, record.Args, sizeof(record.Args)));
+
+  pRing->Head.store(head + 1, std::memory_order_release);
+
+  // The background thread wakes up on its own every few milliseconds,
+  // it's only woken early when a ring is filling up
+  if (head - pRing->Tail.load(std::memory_order_relaxed) == pRing->Mask / 2
+    && !m_Pending.exchange(true))
+  {
+    m_Wake.notify_one();
+  }
+
+  return true;
+}
+
+void LogQueue::Flush()
+{
+  std::unique_lock<std::mutex> lock(m_WakeMutex);
+  if (!m_Running)
+    return;
+
+  uint64_t request = ++m_FlushRequested;
+  m_Wake.notify_one();
+  m_Flushed.wait(lock, [&] { return m_FlushCompleted >= request; });
+}
+
+LogQueue::Ring* LogQueue::GetThreadRing()
+{
+  static thread_local ThreadRing threadRing;
+  if (threadRing.QueueId == m_Id)
+    return threadRing.pRing.get();
+
+  if (threadRing.pRing)
+    threadRing.pRing->Abandoned = true;
+
+  std::shared_ptr<Ring> pRing = std::make_shared<Ring>(m_RingCapacity);
+  {
+    std::lock_guard<std::mutex> lock(m_RingMutex);
+    m_Rings.push_back(pRing);
+    m_RingsChanged = true;
+  }
+
+  threadRing.QueueId = m_Id;
+  threadRing.pRing = pRing;
+  return pRing.get();
+}
+
+void LogQueue::Run()
+{
+  for (;;)
+  {
+    uint64_t flushRequest = 0;
+    bool stopping = false;
+    {
+      std::unique_lock<std::mutex> lock(m_WakeMutex);
+      m_Wake.wait_for(lock, g_WakeInterval,
+        [this] { return m_Pending || m_Stopping || m_FlushRequested != m_FlushCompleted; });
+
+      flushRequest = m_FlushRequested;
+      stopping = m_Stopping;
+    }
+
+    m_Pending = false;
+    bool wrote = Drain();
+
+    // Suppressed counts are written once more when stopping
+    auto now = std::chrono::steady_clock::now();
+    if (stopping || now >= m_NextReport)
+    {
+      wrote |= ReportSuppressed();
+      m_NextReport = now + m_ReportInterval;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(m_WakeMutex);
+      m_FlushCompleted = flushRequest;
+    }
+    m_Flushed.notify_all();
+
+    if (stopping && !wrote)
+      break;
+  }
+
+  // Anyone still waiting on a flush got everything there is
+  {
+    std::lock_guard<std::mutex> lock(m_WakeMutex);
+    m_FlushCompleted = m_FlushRequested;
+  }
+  m_Flushed.notify_all();
+}
+
+bool LogQueue::Drain()
+{
+  if (m_RingsChanged.exchange(false))
+  {
+    std::lock_guard<std::mutex> lock(m_RingMutex);
+    m_DrainRings = m_Rings;
+  }
+
+  // Heads are read once, so threads that keep logging
+  // can't keep the batch growing
+  m_Heads.resize(m_DrainRings.size());
+  m_Abandoned.resize(m_DrainRings.size());
+  m_Batch.clear();
+  uint64_t dropped = 0;
+
+  bool abandoned = false;
+  for (size_t i = 0; i < m_DrainRings.size(); ++i)
+  {
+    Ring& ring = *m_DrainRings[i];
+
+    // A ring whose thread has exited gets nothing after this pass
+    m_Abandoned[i] = ring.Abandoned.load(std::memory_order_acquire);
+    abandoned |= m_Abandoned[i] != 0;
+
+    size_t tail = ring.Tail.load(std::memory_order_relaxed);
+    size_t head = ring.Head.load(std::memory_order_acquire);
+
+    for (size_t index = tail; index != head; ++index)
+      m_Batch.push_back(&ring.Records[index & ring.Mask]);
+
+    m_Heads[i] = head;
+    dropped += ring.Dropped.exchange(0, std::memory_order_relaxed);
+  }
+
+  bool wrote = !m_Batch.empty() || dropped > 0;
+  if (wrote)
+  {
+    // Each ring is in order already, this interleaves the threads
+    std::sort(m_Batch.begin(), m_Batch.end(),
+      [](Record const* pA, Record const* pB) { return pA->Sequence < pB->Sequence; });
+
+    m_Text.clear();
+    m_Messages.clear();
+
+    for (Record const* pRecord : m_Batch)
+    {
+      size_t offset = m_Text.size();
+      FormatArgs(pRecord->Format, pRecord->Args, pRecord->Size, m_Text);
+
+      LogMessage message;
+      message.Level = pRecord->Level;
+      message.Time = pRecord->Time;
+      message.pText = nullptr;
+      message.Length = m_Text.size() - offset;
+      m_Messages.push_back(message);
+    }
+
+    // The text is only done growing now
+    const char* pText = m_Text.data();
+    for (LogMessage& message : m_Messages)
+    {
+      message.pText = pText;
+      pText += message.Length;
+    }
+
+    m_Sink(m_Messages.data(), m_Messages.size(), dropped);
+
+    for (size_t i = 0; i < m_DrainRings.size(); ++i)
+      m_DrainRings[i]->Tail.store(m_Heads[i], std::memory_order_release);
+  }
+
+  if (abandoned)
+  {
+    std::lock_guard<std::mutex> lock(m_RingMutex);
+    for (size_t i = 0; i < m_DrainRings.size(); ++i)
+    {
+      if (m_Abandoned[i])
+        m_Rings.erase(std::remove(m_Rings.begin(), m_Rings.end(), m_DrainRings[i]), m_Rings.end());
+    }
+    m_RingsChanged = true;
+  }
+
+  return wrote;
+}
+
+bool LogQueue::ReportSuppressed()
+{
+  m_Text.clear();
+  m_Messages.clear();
+
+  int64_t time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+  m_Throttle.TakeSuppressed([&](const char* format, int level, uint64_t suppressed)
+  {
+    size_t offset = m_Text.size();
+    m_Text += "Suppressed ";
+    m_Text += std::to_string(suppressed);
+    m_Text += suppressed == 1 ? " message like \"" : " messages like \"";
+    m_Text += format;
+    m_Text += "\"";
+
+    LogMessage message;
+    message.Level = level;
+    message.Time = time;
+    message.pText = nullptr;
+    message.Length = m_Text.size() - offset;
+    m_Messages.push_back(message);
+  });
+
+  if (m_Messages.empty())
+    return false;
+
+  const char* pText = m_Text.data();
+  for (LogMessage& message : m_Messages)
+  {
+    message.pText = pText;
+    pText += message.Length;
+  }
+
+  m_Sink(m_Messages.data(), m_Messages.size(), 0);
+  return true;
+}
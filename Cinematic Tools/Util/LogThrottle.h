@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace util
+{
+  // Limits how often a single call site can log.
+  //
+  // Call sites are told apart by their format string, which is a
+  // literal at every log call. Each site can log a burst of messages at
+  // once and then one message per interval, anything more is counted
+  // instead. The table has a fixed size and is lock free, sites that
+  // don't fit in it are never throttled.
+  class LogThrottle
+  {
+  public:
+    // Called for every site that had messages suppressed
+    typedef std::function<void(const char* format, int level, uint64_t suppressed)> Report;
+
+    static const size_t SiteCount = 1024;
+
+    LogThrottle(unsigned burst, int64_t intervalNs);
+
+    // Time is in nanoseconds from a steady clock
+    bool Allow(const char* format, int level, int64_t time);
+
+    // Hands out the suppressed counts and resets them
+    void TakeSuppressed(Report const& report);
+
+  private:
+    struct Site
+    {
+      std::atomic<const char*> Format;
+      std::atomic<int> Level;
+      std::atomic<int64_t> NextTime;   // When the next message fits in the rate
+      std::atomic<uint64_t> Suppressed;
+    };
+
+    Site* FindSite(const char* format);
+
+  private:
+    const int64_t m_Interval;
+    const int64_t m_Tolerance;
+    std::unique_ptr<Site[]> m_Sites;
+
+  public:
+    LogThrottle(LogThrottle const&) = delete;
+    void operator=(LogThrottle const&) = delete;
+  };
+}
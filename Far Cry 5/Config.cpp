@@ -3,11 +3,10 @@
 #include "Main.h"
 #include "resource.h"
 
-#include <fstream>
-
 Config::Config(std::string const& fileName /* = "./Cinematic Tools/config.ini" */)
 {
   m_isDirty = false;
+  m_dtCheck = 0;
   m_sFileName = fileName;
 
   util::log::Write("Loading config.ini");
@@ -30,26 +29,36 @@ Config::Config(std::string const& fileName /* = "./Cinematic Tools/config.ini" *
     {
       util::log::Write("Creating config.ini");
       std::string defaultConfig((char*)pData);
-      std::fstream file;
-      file.open(fileName, std::fstream::in | std::fstream::out | std::fstream::trunc);
 
-      file << defaultConfig;
-      file.close();
+      std::string error;
+      if (!util::ConfigWriter::Write(fileName, defaultConfig, &error))
+        util::log::Error("Could not create config.ini. %s", error.c_str());
     }
     else
       util::log::Error("Could not load default config from resources");
   }
+
+  m_Writer.Start(fileName, [](const char* error)
+  {
+    util::log::Error("Could not save config.ini. %s", error);
+  });
 }
 
 Config::~Config()
 {
+  Close();
+}
 
+void Config::Close()
+{
+  m_Writer.Stop();
 }
 
 void Config::Update(double dt)
 {
+  // Saving only hands the config to the writer thread
   m_dtCheck += dt;
-  if (m_dtCheck < 10.f) return;
+  if (m_dtCheck < 1.f) return;
   m_dtCheck = 0;
 
   if (m_isDirty)
@@ -61,13 +70,7 @@ void Config::Update(double dt)
 
 void Config::Save()
 {
-  std::fstream file;
-  file.open(m_sFileName, std::fstream::in | std::fstream::out | std::fstream::trunc);
-
-  std::vector<std::string> hotkeyConfig = g_mainHandle->GetInputManager()->GetSettings();
-  for (auto line : hotkeyConfig)
-    file << line << std::endl;
-
-  file << g_mainHandle->GetCameraManager()->GetConfig() << std::endl;
-  file.close();
+  // Nothing is written if the content is the same as before
+  m_Writer.Submit(g_mainHandle->GetInputManager()->GetConfig() +
+    g_mainHandle->GetCameraManager()->GetConfig() + "\n");
 }
\ No newline at end of file
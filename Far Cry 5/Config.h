@@ -1,6 +1,7 @@
 #pragma once
 #include <memory>
 #include "inih/cpp/INIReader.h"
+#include "Util/ConfigWriter.h"
 
 class Config
 {
@@ -12,11 +13,15 @@ public:
   void Save();
   void Update(double);
 
+  // Writes the last saved config and stops the writer thread
+  void Close();
+
   INIReader* GetReader() { return m_pReader.get(); }
 
 private:
   std::string m_sFileName;
   std::unique_ptr<INIReader> m_pReader;
+  util::ConfigWriter m_Writer;
 
   float m_dtCheck;
   bool m_isDirty;
@@ -1,4 +1,5 @@
 #include "Main.h"
+#include "Util/Util.h"
 
 Main* g_mainHandle = nullptr;
 HINSTANCE g_dllHandle = NULL;
@@ -14,6 +15,7 @@ DWORD WINAPI Initialize(LPVOID lpArg)
     g_mainHandle->Run();
 
   g_mainHandle->Release();
+  util::log::Shutdown();
   FreeLibraryAndExitThread(g_dllHandle, 0);
 
   delete pDllInstance;
@@ -52,6 +52,7 @@ bool Main::Initialize()
   m_pInputManager = std::make_unique<InputManager>();
   m_pUI = std::make_unique<UI>();
 
+  m_pCameraManager->SubscribeHotkeys(m_pInputManager.get());
   m_pInputManager->Initialize(m_pConfig->GetReader());
   if (!m_pUI->Initialize(FC::FCHwnd))
   {
@@ -67,6 +68,7 @@ void Main::Release()
 {
   util::log::Write("Main::Release()");
   m_pConfig->Save();
+  m_pConfig->Close();
 
   util::hooks::Uninitialize();
 
@@ -94,4 +96,5 @@ void Main::Update()
   m_pCameraManager->Update(dt.count());
   m_pEnvironmentManager->Update();
   m_pUI->Update(dt.count());
+  m_pConfig->Update(dt.count());
 }
\ No newline at end of file
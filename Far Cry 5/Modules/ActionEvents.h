@@ -0,0 +1,89 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+enum ActionEventType
+{
+  ActionEvent_Press,
+  ActionEvent_Release,
+  ActionEvent_Repeat, // Sent while an action is held down, after the repeat delay
+  ActionEvent_TypeCount
+};
+
+struct ActionEvent
+{
+  int Action;
+  ActionEventType Type;
+  double Time; // Seconds, on the clock passed to ActionEdgeDetector::Update
+};
+
+typedef std::function<void(ActionEvent const&)> ActionHandler;
+
+// Turns sampled up/down action states into press, release
+// and repeat events. Each change produces exactly one event.
+//
+// Doesn't depend on Windows headers.
+class ActionEdgeDetector
+{
+public:
+  ActionEdgeDetector(size_t actionCount, double repeatDelay = 0.5, double repeatInterval = 0.1);
+
+  // pDown has one entry per action. Events for every change since
+  // the previous update are appended to events.
+  void Update(bool const* pDown, double time, std::vector<ActionEvent>& events);
+
+  // Releases every held action, for example when focus is lost
+  void ReleaseAll(double time, std::vector<ActionEvent>& events);
+
+  bool IsDown(int action) const { return m_States[action].Down; }
+
+private:
+  struct State
+  {
+    bool Down;
+    double NextRepeat;
+  };
+
+  std::vector<State> m_States;
+  double m_RepeatDelay;
+  double m_RepeatInterval;
+};
+
+// Queue of action events. The input thread posts events and
+// another thread runs the handlers subscribed to them, so a slow
+// handler or a held key never holds up input processing or
+// other hotkeys.
+class ActionDispatcher
+{
+public:
+  ActionDispatcher(size_t actionCount);
+
+  // Can be called from any thread, also from inside a handler
+  void Subscribe(int action, ActionEventType type, ActionHandler handler);
+
+  // Only holds the lock long enough to append the events
+  void Post(std::vector<ActionEvent> const& events);
+
+  // Waits until events are posted or the timeout passes, then runs
+  // the handlers of every queued event in order. Returns the number
+  // of events handled.
+  size_t Dispatch(unsigned int timeoutMs);
+
+  // Wakes up a waiting Dispatch, used when shutting down
+  void Wake();
+
+private:
+  std::vector<std::vector<ActionHandler>> m_Handlers; // action * ActionEvent_TypeCount + type
+  std::vector<ActionEvent> m_Queue;
+  bool m_Woken;
+
+  std::mutex m_Mutex;
+  std::condition_variable m_Posted;
+
+public:
+  ActionDispatcher(ActionDispatcher const&) = delete;
+  void operator=(ActionDispatcher const&) = delete;
+};
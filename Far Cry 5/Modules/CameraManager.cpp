@@ -15,6 +15,8 @@ CameraManager::CameraManager() :
   m_GamepadDisabled(true),
   m_Camera(Camera()),
   m_pActivator(nullptr),
+  m_StateChannel(CameraState()),
+  m_StartSequence(0),
   m_uiRequestReset(false),
   m_uiRequestToggle(false),
   m_GameUIDisabled(false),
@@ -47,27 +49,31 @@ void CameraManager::CameraHook(FC::CMarketingCamera* pGameCamera)
     util::log::Write("CMarketingCamera 0x%I64X", pGameCamera);
   }
 
-  if (!m_CameraEnabled) return;
+  m_StateChannel.TryLoad(m_CameraHookState);
+  CameraState const& state = m_CameraHookState;
+
+  if (!state.enabled) return;
 
   XMFLOAT4X4& gameMatrix = pGameCamera->GetTransform();
   XMFLOAT3* position = (XMFLOAT3*)&gameMatrix.m[3][0];
 
-  if (m_FirstEnable)
-  {
-    m_FirstEnable = false;
-    m_Camera.position = *position;
-  }
-
-  *position = m_Camera.position;
-  pGameCamera->m_FieldofView = XMConvertToRadians(m_Camera.fov);
-  pGameCamera->m_NearPlane = m_Camera.nearPlane;
-  pGameCamera->m_FarPlane = m_Camera.farPlane;
-  pGameCamera->m_DofEnable = m_Dof.enabled;
-  pGameCamera->m_DofOverride = m_Dof.enabled;
-  pGameCamera->m_DofFocusDistance = m_Dof.focusDistance;
-  pGameCamera->m_DofNear = m_Dof.nearDistance;
-  pGameCamera->m_DofFar = m_Dof.farDistance;
-  pGameCamera->m_DofCoC = m_Dof.cocSize;
+  if (m_FirstEnable.exchange(false))
+    m_StartPosition.Store(*position);
+
+  // Leave the game camera where it is until Update has moved
+  // our camera to the start position
+  if (state.startSequence == m_StartPosition.GetSequence())
+    *position = state.position;
+
+  pGameCamera->m_FieldofView = XMConvertToRadians(state.fov);
+  pGameCamera->m_NearPlane = state.nearPlane;
+  pGameCamera->m_FarPlane = state.farPlane;
+  pGameCamera->m_DofEnable = state.dof.enabled;
+  pGameCamera->m_DofOverride = state.dof.enabled;
+  pGameCamera->m_DofFocusDistance = state.dof.focusDistance;
+  pGameCamera->m_DofNear = state.dof.nearDistance;
+  pGameCamera->m_DofFar = state.dof.farDistance;
+  pGameCamera->m_DofCoC = state.dof.cocSize;
 }
 
 void __fastcall CameraManager::ComponentHook(FC::ComponentCollection<__int64>* pCollection)
@@ -113,69 +119,76 @@ void __fastcall CameraManager::ComponentHook(FC::ComponentCollection<__int64>* p
 
 void CameraManager::AngleHook(__int64 pMatrix)
 {
-  if (!m_CameraEnabled) return;
+  m_StateChannel.TryLoad(m_AngleHookState);
+  if (!m_AngleHookState.enabled) return;
+
   XMFLOAT4X4* rotMatrix = reinterpret_cast<XMFLOAT4X4*>(pMatrix);
-  *rotMatrix = m_Camera.rotMatrix;
+  *rotMatrix = m_AngleHookState.rotMatrix;
 }
 
-void CameraManager::HotkeyUpdate()
+void CameraManager::SubscribeHotkeys(InputManager* pInput)
 {
-  InputManager* pInput = g_mainHandle->GetInputManager();
-  if (pInput->IsActionDown(Camera_Toggle))
-  {
-    m_uiRequestToggle = true;
-
-    while (pInput->IsActionDown(Camera_Toggle))
-      Sleep(10);
-  }
+  // Handlers run once per key press on the hotkey thread
+  pInput->SubscribeAction(Camera_Toggle, [this](ActionEvent const&) { m_uiRequestToggle = true; });
+  pInput->SubscribeAction(Camera_HideHUD, [this](ActionEvent const&) { m_GameUIDisabled = !m_GameUIDisabled; });
 
-  if (pInput->IsActionDown(Camera_HideHUD))
-  {
-    m_GameUIDisabled = !m_GameUIDisabled;
-    while (pInput->IsActionDown(Camera_HideHUD))
-      Sleep(10);
-  }
-
-  if (pInput->IsActionDown(Camera_FreezeTime))
+  pInput->SubscribeAction(Camera_FreezeTime, [](ActionEvent const&)
   {
     FC::CTimer* pTimer = FC::CTimer::Singleton();
     pTimer->m_FreezeTime = !pTimer->m_FreezeTime;
+  });
 
-    while (pInput->IsActionDown(Camera_FreezeTime))
-      Sleep(10);
-  }
-
-  if (m_CameraEnabled)
+  pInput->SubscribeAction(Track_CreateKey, [this](ActionEvent const&)
   {
-    if (pInput->IsActionDown(Track_CreateKey))
-    {
+    if (m_CameraEnabled)
       m_TrackManager.CreateNode(m_Camera);
+  });
 
-      while (pInput->IsActionDown(Track_CreateKey))
-        Sleep(10);
-    }
-    if (pInput->IsActionDown(Track_DeleteKey))
-    {
+  pInput->SubscribeAction(Track_DeleteKey, [this](ActionEvent const&)
+  {
+    if (m_CameraEnabled)
       m_TrackManager.DeleteNode();
+  });
 
-      while (pInput->IsActionDown(Track_DeleteKey))
-        Sleep(10);
-    }
-    if (pInput->IsActionDown(Track_Play))
-    {
+  pInput->SubscribeAction(Track_Play, [this](ActionEvent const&)
+  {
+    if (m_CameraEnabled)
       m_TrackManager.Play();
+  });
+}
 
-      while (pInput->IsActionDown(Track_Play))
-        Sleep(10);
-    }
+void CameraManager::Update(double dt)
+{
+  // Move to where the game camera was when it was enabled
+  unsigned startSequence = m_StartPosition.GetSequence();
+  if (startSequence != m_StartSequence && m_StartPosition.TryLoad(m_Camera.position))
+  {
+    m_Camera.rotation = XMFLOAT4(0, 0, 0, 1);
+    m_StartSequence = startSequence;
+  }
+
+  if (m_CameraEnabled)
+  {
+    UpdateInput(dt);
+    UpdateCamera(dt);
   }
+
+  PublishState();
 }
 
-void CameraManager::Update(double dt)
+void CameraManager::PublishState()
 {
-  if (!m_CameraEnabled) return;
-  UpdateInput(dt);
-  UpdateCamera(dt);
+  CameraState state;
+  state.enabled = m_CameraEnabled;
+  state.position = m_Camera.position;
+  state.rotMatrix = m_Camera.rotMatrix;
+  state.fov = m_Camera.fov;
+  state.nearPlane = m_Camera.nearPlane;
+  state.farPlane = m_Camera.farPlane;
+  state.dof = m_Dof;
+  state.startSequence = m_StartSequence;
+
+  m_StateChannel.Store(state);
 }
 
 void CameraManager::UpdateCamera(double dt)
@@ -291,7 +304,6 @@ void CameraManager::ToggleCamera()
 void CameraManager::ResetCamera()
 {
   if (!m_CameraEnabled) return;
-  m_Camera.rotation = XMFLOAT4(0, 0, 0, 1);
   m_FirstEnable = true;
   ToggleCamera();
   Sleep(100);
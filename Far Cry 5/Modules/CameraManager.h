@@ -1,7 +1,32 @@
 #pragma once
 #include "../Dunya.h"
+#include "../Util/SeqLock.h"
 #include "TrackManager.h"
 
+#include <atomic>
+
+class InputManager;
+
+// Everything the game thread hooks need to place the camera. A complete
+// copy is published after every update so hooks never see a camera that
+// is halfway through being updated.
+struct CameraState
+{
+  bool enabled{ false };
+  DirectX::XMFLOAT3 position{ 0,0,0 };
+  DirectX::XMFLOAT4X4 rotMatrix{ 1,0,0,0,
+                                 0,1,0,0,
+                                 0,0,1,0,
+                                 0,0,0,1 };
+  float fov{ 60.f };
+  float nearPlane{ 0.25f };
+  float farPlane{ 10000.f };
+  DepthOfField dof;
+
+  // Sequence of the start position the camera was last moved to
+  unsigned startSequence{ 0 };
+};
+
 class CameraManager
 {
 public:
@@ -12,7 +37,7 @@ public:
   void AngleHook(__int64 pMatrix);
   void __fastcall ComponentHook(FC::ComponentCollection<__int64>* pCollection);
 
-  void HotkeyUpdate();
+  void SubscribeHotkeys(InputManager* pInput);
   void Update(double dt);
   void DrawUI();
 
@@ -27,12 +52,15 @@ private:
   void UpdateCamera(double dt);
   void UpdateInput(double dt);
 
+  // Copies the camera for the game thread hooks
+  void PublishState();
+
   void ToggleCamera();
   void ResetCamera();
 
 private:
   bool m_CameraEnabled;
-  bool m_FirstEnable;
+  std::atomic<bool> m_FirstEnable;
   bool m_GamepadDisabled;
 
   bool m_GameUIDisabled;
@@ -45,6 +73,17 @@ private:
   bool m_uiRequestToggle;
   bool m_uiRequestReset;
 
+  // Written by Update on the tools thread. Each hook keeps the last
+  // state it read, in case a read overlaps a write.
+  util::SeqLock<CameraState> m_StateChannel;
+  CameraState m_CameraHookState;
+  CameraState m_AngleHookState;
+
+  // Game camera position captured by CameraHook when the camera is
+  // enabled for the first time, picked up by Update
+  util::SeqLock<DirectX::XMFLOAT3> m_StartPosition;
+  unsigned m_StartSequence;
+
   TrackManager m_TrackManager;
   float m_mousePitchBuffer[50];
   float m_mouseYawBuffer[50];
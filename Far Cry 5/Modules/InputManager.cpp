@@ -6,7 +6,9 @@
 
 BOOL DIEnumDevicesCallback(LPCDIDEVICEINSTANCE lpddi, LPVOID pvRef);
 
-InputManager::InputManager()
+InputManager::InputManager() :
+  m_actionEdges(Action::Action_Count),
+  m_actionEvents(Action::Action_Count)
 {
   lpdi = nullptr;
   lpdiGamepad = nullptr;
@@ -47,6 +49,8 @@ void InputManager::Initialize(INIReader* pConfigReader)
 
   ReadConfig(pConfigReader);
 
+  SubscribeAction(UI_Toggle, [](ActionEvent const&) { g_mainHandle->GetUI()->Toggle(); });
+
   CreateThread(NULL, NULL, HotkeyThread, this, NULL, NULL);
   CreateThread(NULL, NULL, ControllerThread, this, NULL, NULL);
   CreateThread(NULL, NULL, UpdateThread, this, NULL, NULL);
@@ -385,7 +389,12 @@ void InputManager::ParseXInputData(XINPUT_STATE& state)
 DWORD WINAPI InputManager::UpdateThread(LPVOID lpArg)
 {
   InputManager* pInputMgr = reinterpret_cast<InputManager*>(lpArg);
-  boost::chrono::high_resolution_clock::time_point lastUpdate = boost::chrono::high_resolution_clock::now();
+  boost::chrono::high_resolution_clock::time_point startTime = boost::chrono::high_resolution_clock::now();
+  boost::chrono::high_resolution_clock::time_point lastUpdate = startTime;
+
+  bool actionsDown[Action::Action_Count];
+  std::vector<ActionEvent> events;
+
   while (!g_shutdown)
   {
     boost::chrono::duration<double> dt = boost::chrono::high_resolution_clock::now() - lastUpdate;
@@ -483,6 +492,15 @@ DWORD WINAPI InputManager::UpdateThread(LPVOID lpArg)
 
     memcpy(pInputMgr->m_wantedActionStates, newWantedStates, sizeof(newWantedStates));
 
+    // Queue press/release events for the hotkey thread
+    for (int i = 0; i < Action::Action_Count; ++i)
+      actionsDown[i] = newWantedStates[i] != 0;
+
+    boost::chrono::duration<double> time = lastUpdate - startTime;
+    events.clear();
+    pInputMgr->m_actionEdges.Update(actionsDown, time.count(), events);
+    pInputMgr->m_actionEvents.Post(events);
+
     for (int i = 0; i < Action::Action_Count; ++i)
     {
       float& currentState = pInputMgr->m_smoothActionStates[i];
@@ -515,22 +533,12 @@ DWORD WINAPI InputManager::HotkeyThread(LPVOID lpArg)
 {
   InputManager* pInputMgr = reinterpret_cast<InputManager*>(lpArg);
 
+  // Runs the handlers subscribed to action events. UpdateThread
+  // sends each press once, so holding a key down doesn't block
+  // other hotkeys. Actions are all up while the game is out of
+  // focus, so no events arrive then.
   while (!g_shutdown)
-  {
-    if (FC::IsFocused())
-    {
-      if (pInputMgr->IsActionDown(UI_Toggle))
-      {
-        g_mainHandle->GetUI()->Toggle();
-        while (pInputMgr->IsActionDown(UI_Toggle))
-          Sleep(1);
-      }
-
-      g_mainHandle->GetCameraManager()->HotkeyUpdate();
-    }
-
-    Sleep(1);
-  }
+    pInputMgr->m_actionEvents.Dispatch(100);
 
   util::log::Write("HotkeyThread exit");
   return 0;
@@ -579,29 +587,19 @@ HRESULT InputManager::CreateDevice(LPCDIDEVICEINSTANCE lpddi)
   return lpdi->CreateDevice(lpddi->guidInstance, &lpdiGamepad, NULL);
 }
 
-std::vector<std::string> InputManager::GetSettings()
+const std::string InputManager::GetConfig()
 {
-  std::vector<std::string> settings;
+  std::string config;
 
-  settings.push_back("[KeyboardMap]");
+  config += "[KeyboardMap]\n";
   for (auto itr = ActionStringMap.begin(); itr != ActionStringMap.end(); ++itr)
-  {
-    Action action = itr->first;
-    std::string name = itr->second;
-
-    settings.push_back(name + " = " + std::to_string(m_keyboardMap[action]));
-  }
+    config += itr->second + " = " + std::to_string(m_keyboardMap[itr->first]) + "\n";
 
-  settings.push_back("\n[GamepadMap]");
+  config += "\n[GamepadMap]\n";
   for (auto itr = ActionStringMap.begin(); itr != ActionStringMap.end(); ++itr)
-  {
-    Action action = itr->first;
-    std::string name = itr->second;
-
-    settings.push_back(name + " = " + std::to_string(m_gamepadMap[action]));
-  }
+    config += itr->second + " = " + std::to_string(m_gamepadMap[itr->first]) + "\n";
 
-  return settings;
+  return config;
 }
 
 void InputManager::DrawConfigUI()
@@ -727,6 +725,11 @@ bool InputManager::IsActionDown(Action action)
   return m_wantedActionStates[action] != 0;
 }
 
+void InputManager::SubscribeAction(Action action, ActionHandler handler, ActionEventType type /* = ActionEvent_Press */)
+{
+  m_actionEvents.Subscribe(action, type, handler);
+}
+
 void InputManager::HandleInputMessage(LPARAM lParam)
 {
   RECT windowRect;
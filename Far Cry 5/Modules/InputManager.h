@@ -1,4 +1,5 @@
 #pragma once
+#include "ActionEvents.h"
 #include "../Util/ActionHelpers.h"
 #include "../Inih/cpp/INIReader.h"
 #include <map>
@@ -29,12 +30,15 @@ public:
 
   float GetActionState(Action actionId);
   bool IsActionDown(Action actionId);
+
+  // Handlers run on the hotkey thread, one event at a time
+  void SubscribeAction(Action actionId, ActionHandler handler, ActionEventType type = ActionEvent_Press);
   std::tuple<int, int> GetMouseState() { return m_mouseState; }
 
   HRESULT CreateDevice(LPCDIDEVICEINSTANCE);
 
   void DrawConfigUI();
-  std::vector<std::string> GetSettings();
+  const std::string GetConfig();
 
   bool KeyDown(LPARAM lparam, WPARAM wparam);
   bool IsCapturingKey() { return m_captureGamepadKey || m_captureKeyboardKey; }
@@ -72,6 +76,9 @@ private:
   float m_smoothActionStates[Action::Action_Count];
   float m_gamepadKeyStates[GamepadKey::GamepadKey_Count];
 
+  ActionEdgeDetector m_actionEdges;
+  ActionDispatcher m_actionEvents;
+
   std::tuple<int, int> m_mouseState;
 
   std::map<int, int> m_hotkeyMap;
@@ -4,6 +4,8 @@
 #include "../../Util/Util.h"
 #include "../../Util/ImGuiHelpers.h"
 
+#include <algorithm>
+
 using namespace DirectX;
 
 TrackManager::TrackManager()
@@ -52,9 +54,6 @@ void TrackManager::HotkeyUpdate()
 
 CatmullRomNode TrackManager::PlayForward(double dt, bool ignoreManual /*= false*/)
 {
-  std::vector<CatmullRomNode>& nodes = m_tracks[m_selectedTrack].nodes;
-
-  CatmullRomNode resultNode;
   if (!m_manualPlay || ignoreManual)
     m_state.time += dt * m_speedMultiplier;
   else
@@ -64,49 +63,45 @@ CatmullRomNode TrackManager::PlayForward(double dt, bool ignoreManual /*= false*
     m_state.time += dt * timeMultiplier * m_speedMultiplier;
   }
 
-  std::vector<CatmullRomNode>::iterator n0, n1, n2, n3;
+  return Evaluate(m_tracks[m_selectedTrack].nodes, m_state);
+}
 
-  bool goForward = false; // Time is increasing, should we move on to the next nodes?
-  bool goBackward = false; // Time is decreasing, should we move on to the previous nodes?
+// Only touches the given state, so display nodes can be generated
+// with their own state without disturbing playback
+CatmullRomNode TrackManager::Evaluate(const std::vector<CatmullRomNode>& nodes, PlayState& state) const
+{
+  CatmullRomNode resultNode;
+  std::vector<CatmullRomNode>::const_iterator n0, n1, n2, n3;
 
-  while ((goForward = m_state.time >= nodes[m_state.node + 1].time) ||
-    (goBackward = m_state.time < nodes[m_state.node].time))
+  // If we're at the start or the end, return those nodes
+  if (state.time < nodes[0].time)
   {
-    if (goForward)
-    {
-      if (m_state.node + 1 < nodes.size() - 1)
-        m_state.node++;
-      else
-      {
-        resultNode.qRotation = nodes[m_state.node + 1].qRotation;
-        resultNode.vPosition = nodes[m_state.node + 1].vPosition;
-        resultNode.fov = nodes[m_state.node + 1].fov;
-        return resultNode;
-      }
-    }
-    else if (goBackward)
-    {
-      if (m_state.node - 1 >= 0)
-      {
-        m_state.node -= 1;
-      }
-      else
-      {
-        m_state.time = 0;
-        resultNode.qRotation = nodes[0].qRotation;
-        resultNode.vPosition = nodes[0].vPosition;
-        resultNode.fov = nodes[0].fov;
-        return resultNode;
-      }
-    }
+    state.time = 0;
+    state.node = 0;
+    resultNode.qRotation = nodes[0].qRotation;
+    resultNode.vPosition = nodes[0].vPosition;
+    resultNode.fov = nodes[0].fov;
+    return resultNode;
   }
 
-  n1 = nodes.begin() + m_state.node;
+  const CatmullRomNode& lastNode = nodes[nodes.size() - 1];
+  if (state.time >= lastNode.time)
+  {
+    state.node = nodes.size() - 2;
+    resultNode.qRotation = lastNode.qRotation;
+    resultNode.vPosition = lastNode.vPosition;
+    resultNode.fov = lastNode.fov;
+    return resultNode;
+  }
+
+  state.node = FindSegment(nodes, state.time, state.node);
+
+  n1 = nodes.begin() + state.node;
   n2 = n1 + 1;
-  n0 = m_state.node > 0 ? n1 - 1 : n1;
-  n3 = m_state.node + 1 < nodes.size() - 1 ? n2 + 1 : n2;
+  n0 = state.node > 0 ? n1 - 1 : n1;
+  n3 = state.node + 1 < nodes.size() - 1 ? n2 + 1 : n2;
 
-  double mu = (m_state.time - n1->time) / (n2->time - n1->time);
+  double mu = (state.time - n1->time) / (n2->time - n1->time);
 
   XMVECTOR qRot0 = XMLoadFloat4(&n0->qRotation);
   XMVECTOR qRot1 = XMLoadFloat4(&n1->qRotation);
@@ -127,6 +122,29 @@ CatmullRomNode TrackManager::PlayForward(double dt, bool ignoreManual /*= false*
   return resultNode;
 }
 
+unsigned int TrackManager::FindSegment(const std::vector<CatmullRomNode>& nodes, double time, unsigned int hint) const
+{
+  const unsigned int lastSegment = nodes.size() - 2;
+
+  // Playback moves forward a little every frame
+  for (unsigned int segment = hint; segment <= hint + 1 && segment <= lastSegment; ++segment)
+  {
+    if (time >= nodes[segment].time && time < nodes[segment + 1].time)
+      return segment;
+  }
+
+  // Anywhere else is a binary search, so seeking doesn't
+  // walk the track one node at a time
+  auto upper = std::upper_bound(nodes.begin(), nodes.end(), time,
+    [](double t, const CatmullRomNode& node) { return t < node.time; });
+
+  if (upper == nodes.begin())
+    return 0;
+
+  unsigned int segment = (upper - nodes.begin()) - 1;
+  return segment < lastSegment ? segment : lastSegment;
+}
+
 void TrackManager::Play()
 {
   if (m_tracks[m_selectedTrack].nodes.size() < 2)
@@ -298,7 +316,10 @@ TrackManager::~TrackManager()
 
 void TrackManager::GenerateDisplayNodes()
 {
-  const std::vector<CatmullRomNode>& nodes = m_tracks[m_selectedTrack].nodes;
+  // Work on a copy so nodes can be added while the buffers are generated
+  m_nodeMutex.lock();
+  const std::vector<CatmullRomNode> nodes = m_tracks[m_selectedTrack].nodes;
+  m_nodeMutex.unlock();
 
   m_displayMutex.lock();
   m_displayNodes.clear();
@@ -338,19 +359,21 @@ void TrackManager::GenerateDisplayNodes()
   indicesVector.push_back(0);
   indicesVector.push_back(1);
 
-  m_state.time = 0;
-  m_state.node = 0;
+  PlayState state;
+  state.time = 0;
+  state.node = 0;
   int lastNodeVertexIndex = 0;
   int stepCount = 0;
 
-  while (m_state.time < nodes[nodes.size() - 1].time)
+  while (state.time < nodes[nodes.size() - 1].time)
   {
     stepCount++;
 
     VertexPositionColor nodeVertex, forwardVertex;
     nodeVertex.color = forwardVertex.color = XMFLOAT4(1, 0, 0, 1);
 
-    CatmullRomNode node = PlayForward(0.1f, true);
+    state.time += 0.1 * m_speedMultiplier;
+    CatmullRomNode node = Evaluate(nodes, state);
     nodeVertex.position = node.vPosition;
 
     verticesVector.push_back(nodeVertex);
@@ -383,7 +406,5 @@ void TrackManager::GenerateDisplayNodes()
   m_vertexCount = verticesVector.size();
   m_indexCount = indicesVector.size();
 
-  m_state.time = 0;
-  m_state.node = 0;
   m_displayMutex.unlock();
 }
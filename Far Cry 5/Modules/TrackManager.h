@@ -58,6 +58,9 @@ private:
   size_t m_indexCount;
 
   //void SmoothTrack();
+  CatmullRomNode Evaluate(const std::vector<CatmullRomNode>& nodes, PlayState& state) const;
+  // state.node is tried first, it's usually still right or one behind
+  unsigned int FindSegment(const std::vector<CatmullRomNode>& nodes, double time, unsigned int hint) const;
   void GenerateDisplayNodes();
   boost::mutex m_nodeMutex; // So we don't try to draw a node that's being deleted for example.
   boost::mutex m_displayMutex; // Also don't draw while generating display nodes
@@ -25,63 +25,42 @@ CameraManager::~CameraManager()
 
 }
 
-void CameraManager::HotkeyUpdate()
+void CameraManager::SubscribeHotkeys(InputSystem* pInput)
 {
-  InputSystem* pInput = g_mainHandle->GetInputSystem();
-
-  if (pInput->IsActionDown(Action::ToggleCamera))
-  {
-    ToggleCamera();
-    while (pInput->IsActionDown(Action::ToggleCamera))
-      Sleep(1);
-  }
+  // Handlers run once per key press on the hotkey thread
+  pInput->SubscribeAction(Action::ToggleCamera, [this](ActionEvent const&) { ToggleCamera(); });
 
-  if (pInput->IsActionDown(Action::ToggleHUD))
+  pInput->SubscribeAction(Action::ToggleHUD, [](ActionEvent const&)
   {
     float* HUDVisibility = (float*)((__int64)g_gameHandle + 0x1174118);
     *HUDVisibility = (*HUDVisibility == 1.0f) ? 0 : 1.0f;
+  });
 
-    while (pInput->IsActionDown(Action::ToggleHUD))
-      Sleep(1);
-  }
-
-  if (pInput->IsActionDown(Action::ToggleFreezeTime))
+  pInput->SubscribeAction(Action::ToggleFreezeTime, [this](ActionEvent const&)
   {
     m_TimeFreezeEnabled = !m_TimeFreezeEnabled;
     util::log::Write("Timefreeze %s", m_TimeFreezeEnabled ? "Enabled" : "Disabled");
 
     Northlight::SetGameFreezed(m_TimeFreezeEnabled);
+  });
 
-    while (pInput->IsActionDown(Action::ToggleFreezeTime))
-      Sleep(1);
-  }
-
-  if (m_CameraEnabled)
+  pInput->SubscribeAction(Action::Track_CreateNode, [this](ActionEvent const&)
   {
-    if (pInput->IsActionDown(Action::Track_CreateNode))
-    {
+    if (m_CameraEnabled)
       m_TrackPlayer.CreateNode(m_Camera);
+  });
 
-      while (pInput->IsActionDown(Action::Track_CreateNode))
-        Sleep(1);
-    }
-
-    if (pInput->IsActionDown(Action::Track_DeleteNode))
-    {
+  pInput->SubscribeAction(Action::Track_DeleteNode, [this](ActionEvent const&)
+  {
+    if (m_CameraEnabled)
       m_TrackPlayer.DeleteNode();
+  });
 
-      while (pInput->IsActionDown(Action::Track_DeleteNode))
-        Sleep(1);
-    }
-
-    if (pInput->IsActionDown(Action::Track_Play))
-    {
+  pInput->SubscribeAction(Action::Track_Play, [this](ActionEvent const&)
+  {
+    if (m_CameraEnabled)
       m_TrackPlayer.Toggle();
-
-      while (pInput->IsActionDown(Action::Track_Play))
-        Sleep(1);
-    }
-  }
+  });
 }
 
 void CameraManager::Update(double dt)
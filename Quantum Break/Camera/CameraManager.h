@@ -2,13 +2,15 @@
 #include "TrackPlayer.h"
 #include "../inih/cpp/INIReader.h"
 
+class InputSystem;
+
 class CameraManager
 {
 public:
   CameraManager();
   ~CameraManager();
 
-  void HotkeyUpdate();
+  void SubscribeHotkeys(InputSystem* pInput);
   void Update(double dt);
   void DrawUI();
 
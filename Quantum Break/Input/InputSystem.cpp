@@ -13,12 +13,22 @@
 static const float g_actionClearTime = 0.2f;
 static const float g_mouseSensitivity = 1.0f;
 
+// Timestamp for mouse deltas, seconds since the first call
+static double GetInputTime()
+{
+  static const auto startTime = boost::chrono::high_resolution_clock::now();
+  boost::chrono::duration<double> time = boost::chrono::high_resolution_clock::now() - startTime;
+  return time.count();
+}
+
 InputSystem::InputSystem() :
   m_DInputInterface(NULL),
   m_WantedActionStates(),
   m_SmoothActionStates(),
   m_GamepadKeyStates(),
-  m_MouseState(),
+  m_ActionEdges(Action::ActionCount),
+  m_ActionEvents(Action::ActionCount),
+  m_RawInputData(),
   m_KeyboardKeyNames(),
   m_ShowUI(false)
 {
@@ -28,6 +38,7 @@ InputSystem::InputSystem() :
 InputSystem::~InputSystem()
 {
   // Wait for threads to exit before destructing
+  m_ActionEvents.Wake();
   m_ActionThread.join();
   m_ControllerThread.join();
   m_HotkeyThread.join();
@@ -51,6 +62,8 @@ void InputSystem::Initialize()
   if (RegisterRawInputDevices(&Rid, 1, sizeof(Rid)) == FALSE)
     util::log::Error("RegisterRawInputDevices failed");
 
+  SubscribeAction(ToggleUI, [](ActionEvent const&) { g_mainHandle->GetUI()->Toggle(); });
+
   m_ActionThread = std::thread(&InputSystem::ActionUpdate, this);
   m_ControllerThread = std::thread(&InputSystem::ControllerUpdate, this);
   m_HotkeyThread = std::thread(&InputSystem::HotkeyUpdate, this);
@@ -61,29 +74,37 @@ void InputSystem::HandleMouseMsg(UINT uMsg, WPARAM wParam, LPARAM lParam)
   switch (uMsg)
   {
   case WM_MOUSEWHEEL:
-    m_MouseState.z += GET_WHEEL_DELTA_WPARAM(wParam);
+  {
+    // Same thread as raw input, so it can share the ring
+    MouseDelta delta;
+    delta.Time = GetInputTime();
+    delta.Wheel = GET_WHEEL_DELTA_WPARAM(wParam);
+    m_MouseDeltas.Push(delta);
     break;
   }
+  }
 }
 
 void InputSystem::HandleRawInput(LPARAM lParam)
 {
-  UINT dwSize = 0;
-  GetRawInputData((HRAWINPUT)lParam, RID_INPUT, NULL, &dwSize, sizeof(RAWINPUTHEADER));
-  //printf("WM_INPUT 0x%X\n", dwSize);
-
-  BYTE* lpb = new BYTE[dwSize];
-  GetRawInputData((HRAWINPUT)lParam, RID_INPUT, lpb, &dwSize, sizeof(RAWINPUTHEADER));
+  // Runs on the window thread for every WM_INPUT, which can be a thousand
+  // times a second. Only the mouse is registered so its data always fits
+  // in the preallocated RAWINPUT, and no size query is needed.
+  UINT dwSize = sizeof(m_RawInputData);
+  if (GetRawInputData((HRAWINPUT)lParam, RID_INPUT, &m_RawInputData, &dwSize, sizeof(RAWINPUTHEADER)) == (UINT)-1)
+    return;
 
-  RAWINPUT* raw = (RAWINPUT*)lpb;
+  RAWINPUT* raw = &m_RawInputData;
   if (raw->header.dwType == RIM_TYPEMOUSE)
   {
-    m_MouseState.x += raw->data.mouse.lLastX;
-    m_MouseState.y += raw->data.mouse.lLastY;
-    m_MouseState.z += static_cast<short>(raw->data.mouse.usButtonData);
-  }
+    MouseDelta delta;
+    delta.Time = GetInputTime();
+    delta.X = static_cast<float>(raw->data.mouse.lLastX);
+    delta.Y = static_cast<float>(raw->data.mouse.lLastY);
+    delta.Wheel = static_cast<short>(raw->data.mouse.usButtonData);
 
-  delete[] lpb;
+    m_MouseDeltas.Push(delta);
+  }
 }
 
 bool InputSystem::HandleKeyMsg(WPARAM wParam, LPARAM lParam)
@@ -198,6 +219,11 @@ void InputSystem::DrawUI()
 
 }
 
+void InputSystem::SubscribeAction(Action action, ActionHandler handler, ActionEventType type /* = ActionEvent_Press */)
+{
+  m_ActionEvents.Subscribe(action, type, handler);
+}
+
 bool InputSystem::IsActionDown(Action action)
 {
   return m_WantedActionStates[action] != 0.f;
@@ -210,9 +236,11 @@ float InputSystem::GetActionState(Action action)
 
 DirectX::XMFLOAT3 InputSystem::GetMouseState()
 {
-  DirectX::XMFLOAT3 stateCopy = m_MouseState;
-  m_MouseState = DirectX::XMFLOAT3(0, 0, 0);
-  return stateCopy;
+  // Sums up the mouse deltas since the last call, only
+  // the camera update may take them
+  MouseDelta sum;
+  m_MouseDeltas.Consume(GetInputTime(), sum);
+  return DirectX::XMFLOAT3(sum.X, sum.Y, sum.Wheel);
 }
 
 void InputSystem::ReadConfig(INIReader* pReader)
@@ -267,7 +295,11 @@ void InputSystem::ActionUpdate()
   // Processes keyboard + gamepad input and updates
   // action states based on bindings.
 
-  auto lastUpdate = boost::chrono::high_resolution_clock::now();
+  auto startTime = boost::chrono::high_resolution_clock::now();
+  auto lastUpdate = startTime;
+
+  std::array<bool, Action::ActionCount> actionsDown;
+  std::vector<ActionEvent> events;
 
   while (!g_shutdown)
   {
@@ -332,8 +364,17 @@ void InputSystem::ActionUpdate()
       }
     }
 
-    // Copy new values and perform smoothing
+    // Copy new values, queue press/release events for the hotkey thread
+    // and perform smoothing
     m_WantedActionStates = newWantedStates;
+
+    for (int i = 0; i < Action::ActionCount; ++i)
+      actionsDown[i] = newWantedStates[i] != 0.f;
+
+    boost::chrono::duration<double> time = lastUpdate - startTime;
+    events.clear();
+    m_ActionEdges.Update(actionsDown.data(), time.count(), events);
+    m_ActionEvents.Post(events);
     for (int i = 0; i < Action::ActionCount; ++i)
     {
       float& currentState = m_SmoothActionStates[i];
@@ -410,26 +451,15 @@ void InputSystem::ControllerUpdate()
 void InputSystem::HotkeyUpdate()
 {
   // Hotkey thread
-  // This is in its own thread so when you press and hold
-  // for example HUD Toggle, you can still move the camera
-  // and it doesn't block other updates until you lift the
-  // key up again.
+  // Runs the handlers subscribed to action events. ActionUpdate
+  // sends each press once, so holding a key down doesn't block
+  // other hotkeys.
+  //
+  // Actions are all up while the game is out of focus,
+  // so no events arrive then.
 
   while (!g_shutdown)
-  {
-    if (g_hasFocus)
-    {
-      if (IsActionDown(ToggleUI))
-      {
-        g_mainHandle->GetUI()->Toggle();
-        while (IsActionDown(ToggleUI))
-          Sleep(10);
-      }
-
-      g_mainHandle->GetCameraManager()->HotkeyUpdate();
-    }
-    Sleep(10);
-  }
+    m_ActionEvents.Dispatch(100);
 }
 
 void InputSystem::UpdateXInput()
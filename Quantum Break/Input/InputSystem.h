@@ -1,5 +1,7 @@
 #pragma once
 #include "ActionDefs.h"
+#include "ActionEvents.h"
+#include "MouseDeltaRing.h"
 #include "../inih/cpp/INIReader.h"
 
 #include <array>
@@ -50,6 +52,9 @@ public:
   void ShowUI();
   void DrawUI();
 
+  // Handlers run on the hotkey thread, one event at a time
+  void SubscribeAction(Action action, ActionHandler handler, ActionEventType type = ActionEvent_Press);
+
   bool IsActionDown(Action action);
   float GetActionState(Action action);
   DirectX::XMFLOAT3 GetMouseState();
@@ -85,7 +90,11 @@ private:
   std::array<float, Action::ActionCount>            m_SmoothActionStates;
   std::array<float, GamepadKey::GamepadKey_Count>   m_GamepadKeyStates;
 
-  DirectX::XMFLOAT3 m_MouseState;
+  ActionEdgeDetector m_ActionEdges;
+  ActionDispatcher m_ActionEvents;
+
+  RAWINPUT m_RawInputData;
+  MouseDeltaRing m_MouseDeltas;
   LPDIRECTINPUTDEVICE8 m_DIMouse;
 
   CaptureInfo m_CaptureState;
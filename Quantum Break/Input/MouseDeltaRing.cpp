@@ -0,0 +1,67 @@
+#include "MouseDeltaRing.h"
+
+const size_t MouseDeltaRing::Capacity;
+
+MouseDeltaRing::MouseDeltaRing() :
+  m_Head(0),
+  m_Tail(0),
+  m_HasCarry(false)
+{
+  static_assert((Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two");
+}
+
+void MouseDeltaRing::Push(MouseDelta const& delta)
+{
+  MouseDelta next = delta;
+
+  // Whatever didn't fit last time goes out first, merged into this one.
+  // The sum keeps the newest timestamp so it's never consumed early.
+  if (m_HasCarry)
+  {
+    next.X += m_Carry.X;
+    next.Y += m_Carry.Y;
+    next.Wheel += m_Carry.Wheel;
+    m_HasCarry = false;
+  }
+
+  if (!TryPush(next))
+  {
+    m_Carry = next;
+    m_HasCarry = true;
+  }
+}
+
+bool MouseDeltaRing::TryPush(MouseDelta const& delta)
+{
+  size_t head = m_Head.load(std::memory_order_relaxed);
+  size_t tail = m_Tail.load(std::memory_order_acquire);
+  if (head - tail == Capacity)
+    return false;
+
+  m_Deltas[head & (Capacity - 1)] = delta;
+  m_Head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+size_t MouseDeltaRing::Consume(double time, MouseDelta& sum)
+{
+  size_t tail = m_Tail.load(std::memory_order_relaxed);
+  size_t head = m_Head.load(std::memory_order_acquire);
+
+  size_t count = 0;
+  for (; tail != head; ++tail)
+  {
+    MouseDelta const& delta = m_Deltas[tail & (Capacity - 1)];
+    if (delta.Time > time)
+      break;
+
+    sum.Time = delta.Time;
+    sum.X += delta.X;
+    sum.Y += delta.Y;
+    sum.Wheel += delta.Wheel;
+    count++;
+  }
+
+  m_Tail.store(tail, std::memory_order_release);
+  return count;
+}
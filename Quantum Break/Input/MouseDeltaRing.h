@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// Mouse movement reported by one raw input message
+struct MouseDelta
+{
+  double Time{ 0 }; // Seconds, same clock for producer and consumer
+  float X{ 0 };
+  float Y{ 0 };
+  float Wheel{ 0 };
+};
+
+// Passes mouse deltas from the window thread to the update thread
+// without locks or allocations. Only one thread may push and only
+// one thread may consume.
+//
+// Deltas are never dropped. If the ring is full the producer holds
+// on to the sum and pushes it together with the next delta.
+//
+// Doesn't depend on Windows headers.
+class MouseDeltaRing
+{
+public:
+  static const size_t Capacity = 1024; // Power of two
+
+  MouseDeltaRing();
+
+  // Producer side
+  void Push(MouseDelta const& delta);
+
+  // Consumer side. Adds up every delta stamped at or before time and
+  // leaves the later ones for the next call. sum.Time is set to the
+  // time of the last delta added. Returns how many deltas were added.
+  size_t Consume(double time, MouseDelta& sum);
+
+private:
+  bool TryPush(MouseDelta const& delta);
+
+private:
+  MouseDelta m_Deltas[Capacity];
+
+  std::atomic<size_t> m_Head; // Written by the producer
+  std::atomic<size_t> m_Tail; // Written by the consumer
+
+  MouseDelta m_Carry; // Only touched by the producer
+  bool m_HasCarry;
+
+public:
+  MouseDeltaRing(MouseDeltaRing const&) = delete;
+  void operator=(MouseDeltaRing const&) = delete;
+};
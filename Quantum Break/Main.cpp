@@ -4,7 +4,6 @@
 
 #include <boost/filesystem.hpp>
 #include <boost/chrono.hpp>
-#include <fstream>
 
 static const char* g_gameName = "Quantum Break";
 static const char* g_moduleName = "QuantumBreak.exe";
@@ -74,6 +73,12 @@ bool Main::Initialize()
   g_rendererModule = GetModuleHandleA("renderer_x64_f");
   g_rlModule = GetModuleHandleA("rl_x64_f");
 
+  if (!Northlight::BindExports())
+  {
+    util::log::Error("Game modules are missing exports the tools need");
+    return false;
+  }
+
   g_d3d11Device = Northlight::d3d::Device::GetDevice(); // Fetch ID3D11Device
   g_d3d11Context = Northlight::d3d::Device::GetContext(); // Fetch context
   g_dxgiSwapChain = Northlight::d3d::Device::Singleton()->m_pSwapchain; // Fetch SwapChain
@@ -93,11 +98,17 @@ bool Main::Initialize()
   m_pInputSystem = std::make_unique<InputSystem>();
   m_pUI = std::make_unique<UI>();
 
+  m_pCameraManager->SubscribeHotkeys(m_pInputSystem.get());
   m_pInputSystem->Initialize();
   if (!m_pUI->Initialize())
     return false;
 
   util::hooks::Init();
+  m_ConfigWriter.Start(g_configFile, [](const char* error)
+  {
+    util::log::Error("Could not save config. %s", error);
+  });
+
   LoadConfig();
 
   // Subclass the window with a new WndProc to catch messages
@@ -123,9 +134,10 @@ void Main::Run()
     m_pCameraManager->Update(dt.count());
     m_pUI->Update(dt.count());
 
-    // Check if config has been affected, if so, save it
+    // Check if config has been affected, if so, save it.
+    // The file is written on the config writer's thread.
     m_dtConfigCheck += dt.count();
-    if (m_dtConfigCheck > 10.f)
+    if (m_dtConfigCheck > 1.f)
     {
       m_dtConfigCheck = 0;
       if (m_ConfigChanged)
@@ -140,6 +152,7 @@ void Main::Run()
 
   // Save config and disable hooks before exit
   SaveConfig();
+  m_ConfigWriter.Stop();
   util::hooks::SetHookState(false);
 }
 
@@ -164,19 +177,8 @@ void Main::LoadConfig()
 
 void Main::SaveConfig()
 {
-  std::fstream file;
-  file.open(g_configFile, std::ios_base::out | std::ios_base::trunc);
-
-  if (!file.is_open())
-  {
-    util::log::Error("Could not save config, failed to open file for writing. GetLastError 0x%X", GetLastError());
-    return;
-  }
-
-  file << m_pCameraManager->GetConfig();
-  file << m_pInputSystem->GetConfig();
-  
-  file.close();
+  // Nothing is written if the content is the same as before
+  m_ConfigWriter.Submit(m_pCameraManager->GetConfig() + m_pInputSystem->GetConfig());
 }
 
 extern LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
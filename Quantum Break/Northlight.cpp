@@ -0,0 +1,51 @@
+#include "Main.h"
+#include "Util/Util.h"
+#include "Util/Symbols.h"
+#include "Northlight.h"
+
+Northlight::Exports Northlight::g_exports = {};
+
+namespace
+{
+  class ModuleExportResolver : public util::symbols::ExportResolver
+  {
+  public:
+    void* Find(const char* moduleName, const char* symbolName) override
+    {
+      HMODULE hModule = GetModuleHandleA(moduleName);
+      if (!hModule)
+        return nullptr;
+
+      return reinterpret_cast<void*>(GetProcAddress(hModule, symbolName));
+    }
+  };
+}
+
+bool Northlight::BindExports()
+{
+  using util::symbols::Bind;
+
+  std::vector<util::symbols::SymbolBinding> bindings =
+  {
+    Bind(g_exports.AIManagerGetInstance, "ai_x64_f", "?getInstance@AIManager@ai@@SAPEAV12@XZ"),
+    Bind(g_exports.CharacterSetSuspended, "ai_x64_f", "?setSuspended@Character@ai@@QEAAX_N@Z"),
+
+    Bind(g_exports.DeviceGetDevice, "d3d_x64_f", "?getDevice@Device@d3d@@QEAAPEAXXZ"),
+    Bind(g_exports.DeviceGetContext, "d3d_x64_f", "?getDeviceContext@Device@d3d@@QEAAPEAXXZ"),
+    Bind(g_exports.DeviceGetInstance, "d3d_x64_f", "?getInstanceUnchecked@Device@d3d@@SAPEAV12@XZ"),
+
+    Bind(g_exports.ppTimeInstance, "rl_x64_f", "?sm_pInstance@Time@r@@0PEAV12@EA"),
+    Bind(g_exports.PerspectiveViewSetFov, "rl_x64_f", "?setFov@PerspectiveView@m@@QEAAXM@Z"),
+    Bind(g_exports.XInputGetState, "rl_x64_f", "?rmdXInputGetState@@YAKKPEAU_rmd_XINPUT_STATE@@@Z"),
+
+    Bind(g_exports.SpotLightConstructor, "renderer_x64_f", "??0SpotLight@rend@@QEAA@XZ"),
+  };
+
+  ModuleExportResolver resolver;
+  std::vector<std::string> missing = util::symbols::BindAll(resolver, bindings);
+
+  for (auto const& name : missing)
+    util::log::Error("Could not find export %s", name.c_str());
+
+  return missing.empty();
+}
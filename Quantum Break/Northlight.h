@@ -12,7 +12,51 @@ namespace Northlight
 {
   namespace ai
   {
+    class AIManager;
     class Character;
+  }
+
+  namespace d3d
+  {
+    class Device;
+  }
+
+  namespace r
+  {
+    class Time;
+  }
+
+  namespace rend
+  {
+    class Spotlight;
+  }
+
+  // Functions and variables exported by the engine modules. They're
+  // looked up once by BindExports() in Main::Initialize, instead of
+  // going through GetProcAddress on every call.
+  struct Exports
+  {
+    ai::AIManager*(__stdcall* AIManagerGetInstance)();
+    void(__fastcall* CharacterSetSuspended)(ai::Character*, bool);
+
+    ID3D11Device*(__fastcall* DeviceGetDevice)();
+    ID3D11DeviceContext*(__fastcall* DeviceGetContext)();
+    d3d::Device*(__fastcall* DeviceGetInstance)();
+
+    r::Time** ppTimeInstance;
+    void(__fastcall* PerspectiveViewSetFov)(__int64, float);
+    __int64(__fastcall* XInputGetState)(int, __int64);
+
+    __int64(__fastcall* SpotLightConstructor)(rend::Spotlight*);
+  };
+
+  extern Exports g_exports;
+
+  // Logs every export that couldn't be found and returns false
+  bool BindExports();
+
+  namespace ai
+  {
     class WorldConception;
 
     class AIManager
@@ -24,10 +68,7 @@ namespace Northlight
     public:
       static AIManager* Singleton()
       {
-        typedef AIManager*(__stdcall* tGetInstance)();
-
-        tGetInstance AIManagerGetInstance = (tGetInstance)GetProcAddress(g_aiModule, "?getInstance@AIManager@ai@@SAPEAV12@XZ");
-        return AIManagerGetInstance();
+        return g_exports.AIManagerGetInstance();
       }
 
       static int GetCharacters(Character** pCharacters)
@@ -67,10 +108,7 @@ namespace Northlight
     public:
       void SetSuspended(bool val)
       {
-        typedef void(__fastcall* tCharacterSetSuspended)(Character*, bool);
-
-        tCharacterSetSuspended CharacterSetSuspended = (tCharacterSetSuspended)GetProcAddress(g_aiModule, "?setSuspended@Character@ai@@QEAAX_N@Z");
-        CharacterSetSuspended(this, val);
+        g_exports.CharacterSetSuspended(this, val);
       }
     };
 
@@ -94,26 +132,17 @@ namespace Northlight
 
       static ID3D11Device* GetDevice()
       {
-        typedef ID3D11Device*(__fastcall* tGetDevice)();
-
-        tGetDevice oGetDevice = (tGetDevice)GetProcAddress(g_d3dModule, "?getDevice@Device@d3d@@QEAAPEAXXZ");
-        return oGetDevice();
+        return g_exports.DeviceGetDevice();
       }
 
       static ID3D11DeviceContext* GetContext()
       {
-        typedef ID3D11DeviceContext*(__fastcall* tGetContext)();
-
-        tGetContext oGetContext = (tGetContext)GetProcAddress(g_d3dModule, "?getDeviceContext@Device@d3d@@QEAAPEAXXZ");
-        return oGetContext();
+        return g_exports.DeviceGetContext();
       }
 
       static Device* Singleton()
       {
-        typedef Device*(__fastcall* tGetInstance)();
-
-        tGetInstance GetInstance = (tGetInstance)GetProcAddress(g_d3dModule, "?getInstanceUnchecked@Device@d3d@@SAPEAV12@XZ");
-        return GetInstance();
+        return g_exports.DeviceGetInstance();
       }
     };
   }
@@ -152,7 +181,7 @@ namespace Northlight
     public:
       static Time* Singleton()
       {
-        return *(Time**)(GetProcAddress(g_rlModule, "?sm_pInstance@Time@r@@0PEAV12@EA"));
+        return *g_exports.ppTimeInstance;
       }
     };
 
@@ -173,10 +202,7 @@ namespace Northlight
     public:
       Spotlight()
       {
-        typedef __int64(__fastcall* tCreateSpotLight)(rend::Spotlight* pThis);
-        tCreateSpotLight CreateSpotLight = (tCreateSpotLight)GetProcAddress(g_rendererModule, "??0SpotLight@rend@@QEAA@XZ");
-
-        CreateSpotLight(this);
+        g_exports.SpotLightConstructor(this);
       }
 
 
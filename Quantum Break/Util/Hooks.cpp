@@ -205,8 +205,8 @@ void util::hooks::Init()
     util::log::Error("Failed to initialize MinHook, MH_STATUS 0x%X", status);
 
   __int64 CameraUpdate = (__int64)g_gameHandle + 0x3A1FC0;
-  __int64 SetFov = (__int64)GetProcAddress(g_rlModule, "?setFov@PerspectiveView@m@@QEAAXM@Z");
-  __int64 GetXinputState = (__int64)GetProcAddress(g_rlModule, "?rmdXInputGetState@@YAKKPEAU_rmd_XINPUT_STATE@@@Z");
+  __int64 SetFov = (__int64)Northlight::g_exports.PerspectiveViewSetFov;
+  __int64 GetXinputState = (__int64)Northlight::g_exports.XInputGetState;
   __int64 AspectRatioHook = (__int64)g_rlModule + 0xA4D20;
   __int64 FreezeHook = (__int64)g_gameHandle + 0x357610;
 
@@ -1,5 +1,10 @@
+#define NOMINMAX
 #include "Util.h"
+#include "LogFile.h"
+#include "LogQueue.h"
+#include <boost/date_time/c_local_time_adjustor.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <algorithm>
 #include <mutex>
 #include <stdio.h>
 
@@ -13,28 +18,114 @@ namespace
   HANDLE hstdin, hstdout;
   FILE* pfstdin;
   FILE* pfstdout;
-  FILE* pfileout;
 
-  static void PrintTimeStamp()
+  // Keeps a flood of messages from filling up the disk
+  const uint64_t g_logFileSize = 16 * 1024 * 1024;
+  const unsigned g_logFileBackups = 2;
+  LogFile g_logFile;
+
+  enum LogLevel
+  {
+    LogLevel_Write,
+    LogLevel_Warning,
+    LogLevel_Error,
+    LogLevel_Ok
+  };
+
+  struct LogStyle
+  {
+    WORD Color;
+    const char* Type;
+  };
+
+  const LogStyle g_logStyles[] =
+  {
+    { FOREGROUND_BLUE | FOREGROUND_GREEN | FOREGROUND_RED | FOREGROUND_INTENSITY, "" },
+    { FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY, "[WARNING] " },
+    { FOREGROUND_RED | FOREGROUND_INTENSITY, "[ERROR] " },
+    { FOREGROUND_GREEN | FOREGROUND_INTENSITY, "[OK] " }
+  };
+
+  // Never deleted, hooks may still log while the DLL unloads
+  LogQueue* g_pLogQueue = nullptr;
+
+  std::string MakeTimeStamp(ptime const& time)
   {
-    ptime now = second_clock::local_time();
-    std::string sTimeStamp = "[" + to_simple_string(now) + "] ";
+    return "[" + to_simple_string(time) + "] ";
+  }
+
+  // The caller holds g_logMutex
+  void WriteMessage(std::string const& timeStamp, int level, const char* pText, size_t length)
+  {
+    LogStyle const& style = g_logStyles[level];
+
     SetConsoleTextAttribute(hstdout, FOREGROUND_RED | FOREGROUND_INTENSITY);
-    printf(sTimeStamp.c_str());
-    fprintf(pfileout, sTimeStamp.c_str());
+    fputs(timeStamp.c_str(), stdout);
+    g_logFile.Write(timeStamp.c_str(), timeStamp.size());
+
+    SetConsoleTextAttribute(hstdout, style.Color);
+    fputs(style.Type, stdout);
+    g_logFile.Write(style.Type);
+    fwrite(pText, 1, length, stdout);
+    g_logFile.Write(pText, length);
+    fputc('\n', stdout);
+    g_logFile.Write("\n", 1);
+  }
+
+  // Runs on the log queue's thread, the file is flushed once per batch
+  void WriteBatch(LogMessage const* pMessages, size_t count, uint64_t dropped)
+  {
+    std::lock_guard<std::mutex> lock(g_logMutex);
+
+    int64_t lastTime = -1;
+    std::string timeStamp;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      LogMessage const& message = pMessages[i];
+      if (message.Time != lastTime)
+      {
+        ptime utcTime = from_time_t(static_cast<time_t>(message.Time));
+        timeStamp = MakeTimeStamp(boost::date_time::c_local_adjustor<ptime>::utc_to_local(utcTime));
+        lastTime = message.Time;
+      }
+
+      WriteMessage(timeStamp, message.Level, message.pText, message.Length);
+    }
+
+    if (dropped > 0)
+    {
+      char text[64];
+      int length = sprintf_s(text, "%llu log messages were dropped", static_cast<unsigned long long>(dropped));
+      WriteMessage(MakeTimeStamp(second_clock::local_time()), LogLevel_Warning, text, length);
+    }
+
+    fflush(stdout);
+    g_logFile.Flush();
   }
 
-  static void PrintMessage(WORD color, const char* type, const char* format, va_list args)
+  // Formats and writes on the calling thread, for
+  // messages logged before Init or after Shutdown
+  void PrintMessage(int level, const char* format, va_list args)
   {
     // Block other threads from writing at the same time
     std::lock_guard<std::mutex> lock(g_logMutex);
+    if (!g_logFile.IsOpen())
+      return;
+
+    char text[1024];
+    int length = vsnprintf(text, sizeof(text), format, args);
+    if (length < 0)
+      return;
+
+    WriteMessage(MakeTimeStamp(second_clock::local_time()), level, text, std::min<size_t>(length, sizeof(text) - 1));
+    g_logFile.Flush();
+  }
 
-    PrintTimeStamp();
-    SetConsoleTextAttribute(hstdout, color);
-    std::string finalFormat = std::string(type) + format + "\n";
-    vfprintf(stdout, finalFormat.c_str(), args);
-    vfprintf(pfileout, finalFormat.c_str(), args);
-    fflush(pfileout);
+  void QueueMessage(int level, const char* format, va_list args)
+  {
+    if (!g_pLogQueue || !g_pLogQueue->Push(level, format, args))
+      PrintMessage(level, format, args);
   }
 }
 
@@ -45,14 +136,25 @@ void log::Init()
   freopen_s(&pfstdin, "CONIN$", "r", stdin);
   hstdin = GetStdHandle(STD_INPUT_HANDLE);
   hstdout = GetStdHandle(STD_OUTPUT_HANDLE);
-  fopen_s(&pfileout, ".\\Cinematic Tools\\CT.log", "w");
+  g_logFile.Open(".\\Cinematic Tools\\CT.log", g_logFileSize, g_logFileBackups);
+
+  if (!g_pLogQueue)
+    g_pLogQueue = new LogQueue();
+
+  g_pLogQueue->Start(WriteBatch);
+}
+
+void log::Shutdown()
+{
+  if (g_pLogQueue)
+    g_pLogQueue->Stop();
 }
 
 void log::Write(const char* format, ...)
 {
   va_list args;
   va_start(args, format);
-  PrintMessage(FOREGROUND_BLUE | FOREGROUND_GREEN | FOREGROUND_RED | FOREGROUND_INTENSITY, "", format, args);
+  QueueMessage(LogLevel_Write, format, args);
   va_end(args);
 }
 
@@ -60,7 +162,7 @@ void log::Warning(const char* format, ...)
 {
   va_list args;
   va_start(args, format);
-  PrintMessage(FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_INTENSITY, "[WARNING] ", format, args);
+  QueueMessage(LogLevel_Warning, format, args);
   va_end(args);
 }
 
@@ -68,7 +170,7 @@ void log::Error(const char* format, ...)
 {
   va_list args;
   va_start(args, format);
-  PrintMessage(FOREGROUND_RED | FOREGROUND_INTENSITY, "[ERROR] ", format, args);
+  QueueMessage(LogLevel_Error, format, args);
   va_end(args);
 }
 
@@ -76,6 +178,6 @@ void log::Ok(const char* format, ...)
 {
   va_list args;
   va_start(args, format);
-  PrintMessage(FOREGROUND_GREEN | FOREGROUND_INTENSITY, "[OK] ", format, args);
+  QueueMessage(LogLevel_Ok, format, args);
   va_end(args);
-}
\ No newline at end of file
+}
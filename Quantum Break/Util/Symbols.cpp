@@ -0,0 +1,21 @@
+#include "Symbols.h"
+
+#include <cstring>
+
+std::vector<std::string> util::symbols::BindAll(ExportResolver& resolver, std::vector<SymbolBinding> const& bindings)
+{
+  std::vector<std::string> missing;
+
+  for (auto const& binding : bindings)
+  {
+    void* pAddress = resolver.Find(binding.Module, binding.Symbol);
+    if (!pAddress)
+      missing.push_back(std::string(binding.Module) + "!" + binding.Symbol);
+
+    // Function pointers can't be assigned from void* directly,
+    // they're the same size so copy the bytes instead
+    memcpy(binding.pTarget, &pAddress, sizeof(void*));
+  }
+
+  return missing;
+}
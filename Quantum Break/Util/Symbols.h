@@ -0,0 +1,39 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace util
+{
+  namespace symbols
+  {
+    // Looks up an exported symbol of a loaded module. The game uses
+    // GetProcAddress, tests can use a table of fake exports.
+    class ExportResolver
+    {
+    public:
+      virtual ~ExportResolver() {}
+
+      // nullptr if the module isn't loaded or doesn't export the symbol
+      virtual void* Find(const char* moduleName, const char* symbolName) = 0;
+    };
+
+    // Pointer variable that receives the address of an export
+    struct SymbolBinding
+    {
+      const char* Module;
+      const char* Symbol;
+      void* pTarget;
+    };
+
+    template<typename T>
+    SymbolBinding Bind(T& target, const char* moduleName, const char* symbolName)
+    {
+      static_assert(sizeof(T) == sizeof(void*), "Exports can only be bound to pointers");
+      return SymbolBinding{ moduleName, symbolName, &target };
+    }
+
+    // Resolves every binding once. Returns "module!symbol" for each export
+    // that couldn't be found, those targets are set to null.
+    std::vector<std::string> BindAll(ExportResolver& resolver, std::vector<SymbolBinding> const& bindings);
+  }
+}
@@ -5,6 +5,9 @@
 
 using namespace DirectX;
 
+// Mouse sensitivity is per count at this many updates per second
+static const float g_mouseReferenceRate = 60.f;
+
 CameraManager::CameraManager() :
   m_CameraEnabled(false),
   m_AutoReset(false),
@@ -12,9 +15,13 @@ CameraManager::CameraManager() :
   m_UIRequestReset(false),
   m_GamepadDisabled(true),
   m_KbmDisabled(true),
-  m_SmoothMouse(true),
   m_Camera(),
   m_TrackPlayer(),
+  m_WheelAverage(25.f / 60),
+  m_MouseFilter(MouseFilter_Average),
+  m_MouseSmoothTime(0.2f),
+  m_MouseMinCutoff(1.f),
+  m_MouseBeta(0.005f),
   m_HudDisabled(false),
   m_TimeFreezeEnabled(false)
 {
@@ -45,13 +52,13 @@ void CameraManager::HotkeyUpdate()
     if (m_TimeFreezeEnabled)
     {
       typedef void(__fastcall* tFreezeGame)(int a1);
-      tFreezeGame FreezeGame = (tFreezeGame)util::offsets::GetOffset("OFFSET_FREEZEGAME");
+      tFreezeGame FreezeGame = (tFreezeGame)util::offsets::GetOffset(OFFSET_FREEZEGAME);
       FreezeGame(8);
     }
     else
     {
       typedef void(__fastcall* tUnfreezeGame)(int a1);
-      tUnfreezeGame UnfreezeGame = (tUnfreezeGame)util::offsets::GetOffset("OFFSET_UNFREEZEGAME");
+      tUnfreezeGame UnfreezeGame = (tUnfreezeGame)util::offsets::GetOffset(OFFSET_UNFREEZEGAME);
       UnfreezeGame(8);
     }
   }
@@ -154,11 +161,35 @@ void CameraManager::DrawUI()
   ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 10));
   ImGui::InputFloat("##CameraFoV", &m_Camera.FieldOfView, 1.f, 1.f, 2);
   ImGui::Checkbox("Reset camera automatically", &m_AutoReset);
-  ImGui::Checkbox("Smooth mouse", &m_SmoothMouse);
   ImGui::Checkbox("Disable player KBM input", &m_KbmDisabled);
   ImGui::Checkbox("Disable player gamepad input", &m_GamepadDisabled);
   ImGui::PopStyleVar();
 
+  bool filterChanged = false;
+  ImGui::Text("Mouse filter");
+  filterChanged |= ImGui::Combo("##MouseFilter", &m_MouseFilter, "None\0Average\0One Euro\0");
+  if (m_MouseFilter == MouseFilter_Average)
+  {
+    ImGui::Text("Smoothing time");
+    filterChanged |= ImGui::InputFloat("##MouseSmoothTime", &m_MouseSmoothTime, 0.05f, 0.1f, 2);
+    if (m_MouseSmoothTime < 0.01f)
+      m_MouseSmoothTime = 0.01f;
+  }
+  else if (m_MouseFilter == MouseFilter_OneEuro)
+  {
+    ImGui::Text("Minimum cutoff");
+    filterChanged |= ImGui::InputFloat("##MouseMinCutoff", &m_MouseMinCutoff, 0.1f, 1.f, 2);
+    ImGui::Text("Speed coefficient");
+    filterChanged |= ImGui::InputFloat("##MouseBeta", &m_MouseBeta, 0.001f, 0.01f, 4);
+    if (m_MouseMinCutoff < 0.01f)
+      m_MouseMinCutoff = 0.01f;
+    if (m_MouseBeta < 0)
+      m_MouseBeta = 0;
+  }
+
+  if (filterChanged)
+    g_mainHandle->OnConfigChanged();
+
   ImGui::NextColumn();
   ImGui::SetColumnOffset(-1, 552);
   ImGui::PushItemWidth(200);
@@ -174,6 +205,13 @@ void CameraManager::ReadConfig(INIReader* pReader)
   m_Camera.RollSpeed = pReader->GetReal("Camera", "RollSpeed", XM_PI / 8);
   m_Camera.FovSpeed = pReader->GetReal("Camera", "FovSpeed", 5.0f);
   m_AutoReset = pReader->GetBoolean("Camera", "AutoReset", false);
+  m_MouseFilter = pReader->GetInteger("Camera", "MouseFilter", MouseFilter_Average);
+  m_MouseSmoothTime = pReader->GetReal("Camera", "MouseSmoothTime", 0.2f);
+  m_MouseMinCutoff = pReader->GetReal("Camera", "MouseMinCutoff", 1.0f);
+  m_MouseBeta = pReader->GetReal("Camera", "MouseBeta", 0.005f);
+
+  if (m_MouseFilter < 0 || m_MouseFilter >= MouseFilter_Count)
+    m_MouseFilter = MouseFilter_Average;
 }
 
 const std::string CameraManager::GetConfig() const
@@ -184,6 +222,10 @@ const std::string CameraManager::GetConfig() const
   config += "RollSpeed = " + std::to_string(m_Camera.RollSpeed) + "\n";
   config += "FovSpeed = " + std::to_string(m_Camera.FovSpeed) + "\n";
   config += "AutoReset = " + std::to_string(m_AutoReset) + "\n";
+  config += "MouseFilter = " + std::to_string(m_MouseFilter) + "\n";
+  config += "MouseSmoothTime = " + std::to_string(m_MouseSmoothTime) + "\n";
+  config += "MouseMinCutoff = " + std::to_string(m_MouseMinCutoff) + "\n";
+  config += "MouseBeta = " + std::to_string(m_MouseBeta) + "\n";
 
   return config;
 }
@@ -269,20 +311,44 @@ void CameraManager::UpdateInput(double dt)
   m_CameraInput.dYaw = pInput->GetActionState(Camera_YawRight) - pInput->GetActionState(Camera_YawLeft);
   m_CameraInput.dRoll = pInput->GetActionState(Camera_RollLeft) - pInput->GetActionState(Camera_RollRight);
   m_CameraInput.dFocalLength = pInput->GetActionState(Camera_IncFieldOfView) - pInput->GetActionState(Camera_DecFieldOfView);
-  if (m_KbmDisabled && !g_mainHandle->GetUI()->IsEnabled())
+  if (m_KbmDisabled && !g_mainHandle->GetUI()->IsEnabled() && dt > 0)
   {
     XMFLOAT3 state = pInput->GetMouseState();
     float sensitivity = pInput->GetMouseSensitivity();
+    float fdt = static_cast<float>(dt);
 
-    m_MouseBuffer.AddValue(state);
-    XMFLOAT3 smoothState = m_MouseBuffer.CalcAverage();
+    // Filters take x, y and wheel counts as arrays and give counts
+    // per second
+    float delta[3] = { state.x, state.y, state.z };
+    float velocity[3] = { state.x / fdt, state.y / fdt, state.z / fdt };
+    float wheelVelocity[3];
 
-    if (m_SmoothMouse)
-      state = smoothState;
+    if (m_MouseFilter == MouseFilter_Average)
+    {
+      m_MouseAverage.SetWindow(m_MouseSmoothTime);
+      m_MouseAverage.Update(delta, fdt, velocity);
+    }
+    else if (m_MouseFilter == MouseFilter_OneEuro)
+    {
+      m_MouseOneEuro.SetParameters(m_MouseMinCutoff, m_MouseBeta);
+      m_MouseOneEuro.Update(delta, fdt, velocity);
+    }
 
-    m_CameraInput.dPitch += state.y * sensitivity;
-    m_CameraInput.dYaw += state.x * sensitivity;
-    m_CameraInput.dFocalLength += smoothState.z;
+    // The wheel is always smoothed, single notches would jump the FoV
+    m_WheelAverage.Update(delta, fdt, wheelVelocity);
+
+    // Sensitivity was tuned for counts per frame at 60 fps, UpdateCamera
+    // scales these by dt again like the key and gamepad input
+    m_CameraInput.dPitch += velocity[1] * sensitivity / g_mouseReferenceRate;
+    m_CameraInput.dYaw += velocity[0] * sensitivity / g_mouseReferenceRate;
+    m_CameraInput.dFocalLength += wheelVelocity[2] / g_mouseReferenceRate;
+  }
+  else
+  {
+    // Start over instead of releasing old movement later
+    m_MouseAverage.Reset();
+    m_MouseOneEuro.Reset();
+    m_WheelAverage.Reset();
   }
 }
 
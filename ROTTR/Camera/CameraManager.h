@@ -1,37 +1,11 @@
 #pragma once
 #include "TrackPlayer.h"
 #include "../inih/cpp/INIReader.h"
+#include "MouseFilter.h"
 #include "../Foundation.h"
 
-#include <array>
 #include <boost/chrono/chrono.hpp>
 
-struct MouseBuffer
-{
-  std::array<DirectX::XMFLOAT3, 25> Values{ DirectX::XMFLOAT3(0,0,0) };
-
-  void AddValue(DirectX::XMFLOAT3 const& val)
-  {
-    for (int i = 24; i > 0; i -= 1)
-      Values[i] = Values[i - 1];
-
-    Values[0] = val;
-  }
-
-  DirectX::XMFLOAT3 CalcAverage()
-  {
-    DirectX::XMFLOAT3 avg{ 0,0,0 };
-    for (int i = 0; i < 25; ++i)
-    {
-      avg.x += Values[i].x / 25;
-      avg.y += Values[i].y / 25;
-      avg.z += Values[i].z / 25;
-    }
-
-    return avg;
-  }
-};
-
 class CameraManager
 {
 public:
@@ -77,8 +51,13 @@ private:
   TrackPlayer m_TrackPlayer;
 
   boost::chrono::high_resolution_clock::time_point m_dtCameraUpdate;
-  MouseBuffer m_MouseBuffer;
-  bool m_SmoothMouse;
+  WindowedAverage m_MouseAverage;
+  OneEuroFilter m_MouseOneEuro;
+  WindowedAverage m_WheelAverage;
+  int m_MouseFilter;
+  float m_MouseSmoothTime; // Seconds
+  float m_MouseMinCutoff;
+  float m_MouseBeta;
 
   bool m_HudDisabled;
   bool m_TimeFreezeEnabled;
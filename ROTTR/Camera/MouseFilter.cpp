@@ -0,0 +1,138 @@
+#include "MouseFilter.h"
+
+#include <cmath>
+
+const int WindowedAverage::MaxSamples;
+
+WindowedAverage::WindowedAverage(float window /* = 0.2f */) :
+  m_Window(window)
+{
+  Reset();
+}
+
+void WindowedAverage::Reset()
+{
+  m_First = 0;
+  m_Count = 0;
+  m_SumTime = 0;
+
+  for (int i = 0; i < 3; ++i)
+    m_SumDelta[i] = 0;
+}
+
+void WindowedAverage::RemoveOldest()
+{
+  Sample const& oldest = m_Samples[m_First];
+  for (int i = 0; i < 3; ++i)
+    m_SumDelta[i] -= oldest.Delta[i];
+
+  m_SumTime -= oldest.dt;
+  m_First = (m_First + 1) % MaxSamples;
+  m_Count--;
+
+  // Start from exact zeros so rounding errors can't pile up
+  if (m_Count == 0)
+    Reset();
+}
+
+void WindowedAverage::Update(float const* pDelta, float dt, float* pVelocity)
+{
+  if (dt < 0)
+    dt = 0;
+
+  if (m_Count == MaxSamples)
+    RemoveOldest();
+
+  Sample& sample = m_Samples[(m_First + m_Count) % MaxSamples];
+  for (int i = 0; i < 3; ++i)
+  {
+    sample.Delta[i] = pDelta[i];
+    m_SumDelta[i] += pDelta[i];
+  }
+
+  sample.dt = dt;
+  m_SumTime += dt;
+  m_Count++;
+
+  // Drop samples as long as the rest still cover the whole window
+  while (m_Count > 1 && m_SumTime - m_Samples[m_First].dt >= m_Window)
+    RemoveOldest();
+
+  // Dividing by the whole window even before it has filled up means
+  // the time before a reset counts as no movement. Otherwise the start
+  // of a movement would come through at full speed and the camera would
+  // turn further than the mouse moved. A full ring covers less than
+  // the window, then the average is over the samples there are.
+  double time = m_SumTime > m_Window || m_Count == MaxSamples ? m_SumTime : m_Window;
+  for (int i = 0; i < 3; ++i)
+    pVelocity[i] = time > 0 ? static_cast<float>(m_SumDelta[i] / time) : 0.f;
+}
+
+OneEuroFilter::OneEuroFilter(float minCutoff /* = 1.f */, float beta /* = 0.005f */, float derivativeCutoff /* = 1.f */) :
+  m_MinCutoff(minCutoff),
+  m_Beta(beta),
+  m_DerivativeCutoff(derivativeCutoff)
+{
+  Reset();
+}
+
+void OneEuroFilter::SetParameters(float minCutoff, float beta)
+{
+  m_MinCutoff = minCutoff;
+  m_Beta = beta;
+}
+
+void OneEuroFilter::Reset()
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    m_Lag[i] = 0;
+    m_Velocity[i] = 0;
+  }
+
+  m_First = true;
+}
+
+float OneEuroFilter::Alpha(float cutoff, float dt)
+{
+  const float pi = 3.14159265f;
+  float tau = 1.f / (2 * pi * cutoff);
+  return 1.f / (1.f + tau / dt);
+}
+
+void OneEuroFilter::Update(float const* pDelta, float dt, float* pVelocity)
+{
+  if (dt <= 0)
+  {
+    // No time passed, hold on to the movement until it does
+    for (int i = 0; i < 3; ++i)
+    {
+      m_Lag[i] += pDelta[i];
+      pVelocity[i] = 0;
+    }
+    return;
+  }
+
+  float derivativeAlpha = Alpha(m_DerivativeCutoff, dt);
+
+  for (int i = 0; i < 3; ++i)
+  {
+    // How far the raw position is ahead of the filtered one
+    float distance = m_Lag[i] + pDelta[i];
+
+    float alpha = 1.f;
+    if (!m_First)
+    {
+      // Speed of the raw input, the lag would make it depend on dt
+      m_Velocity[i] += derivativeAlpha * (pDelta[i] / dt - m_Velocity[i]);
+      float cutoff = m_MinCutoff + m_Beta * std::fabs(m_Velocity[i]);
+      alpha = Alpha(cutoff, dt);
+    }
+
+    float moved = alpha * distance;
+    m_Lag[i] = distance - moved;
+    pVelocity[i] = moved / dt;
+  }
+
+  m_First = false;
+}
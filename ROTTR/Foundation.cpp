@@ -0,0 +1,40 @@
+#include "Globals.h"
+#include "Util/Util.h"
+#include "Util/Symbols.h"
+#include "Foundation.h"
+
+Nx::Exports Nx::g_exports = {};
+
+namespace
+{
+  class ModuleExportResolver : public util::symbols::ExportResolver
+  {
+  public:
+    void* Find(const char* moduleName, const char* symbolName) override
+    {
+      HMODULE hModule = GetModuleHandleA(moduleName);
+      if (!hModule)
+        return nullptr;
+
+      return reinterpret_cast<void*>(GetProcAddress(hModule, symbolName));
+    }
+  };
+}
+
+bool Nx::BindExports()
+{
+  using util::symbols::Bind;
+
+  std::vector<util::symbols::SymbolBinding> bindings =
+  {
+    Bind(g_exports.GetGameState, "NxApp_GoldMaster.dll", "NxApp_GetGameState"),
+  };
+
+  ModuleExportResolver resolver;
+  std::vector<std::string> missing = util::symbols::BindAll(resolver, bindings);
+
+  for (auto const& name : missing)
+    util::log::Error("Could not find export %s", name.c_str());
+
+  return missing.empty();
+}
@@ -4,6 +4,21 @@
 
 namespace Nx
 {
+  class NxGameStateImpl;
+
+  // Functions exported by NxApp. They're looked up once by
+  // BindExports() in Main::Initialize, instead of going through
+  // GetModuleHandle and GetProcAddress on every call.
+  struct Exports
+  {
+    NxGameStateImpl*(__fastcall* GetGameState)();
+  };
+
+  extern Exports g_exports;
+
+  // Logs every export that couldn't be found and returns false
+  bool BindExports();
+
   class NxGameStateImpl
   {
   public:
@@ -28,11 +43,7 @@ namespace Nx
   public:
     static NxGameStateImpl* Singleton()
     {
-      HMODULE hModule = GetModuleHandleA("NxApp_GoldMaster.dll");
-      typedef NxGameStateImpl*(__fastcall* tGetGameState)();
-      tGetGameState GetGameState = (tGetGameState)GetProcAddress(hModule, "NxApp_GetGameState");
-
-      return GetGameState();
+      return g_exports.GetGameState();
     }
   };
 }
@@ -62,7 +73,7 @@ namespace Foundation
   public:
     static GameRender* Singleton()
     {
-      return *(GameRender**)(util::offsets::GetOffset("OFFSET_GAMERENDER"));
+      return *(GameRender**)(util::offsets::GetOffset(OFFSET_GAMERENDER));
     }
   }; // Size = 0xCB60
 
@@ -249,7 +260,7 @@ namespace Foundation
   public:
     static Scene* Singleton()
     {
-      return *(Scene**)(util::offsets::GetOffset("OFFSET_SCENE"));
+      return *(Scene**)(util::offsets::GetOffset(OFFSET_SCENE));
     }
   }; // Size = 0x3D60
 
@@ -314,7 +325,7 @@ namespace Foundation
   public:
     static PCDX11DeviceManager* Singleton()
     {
-      return *(PCDX11DeviceManager**)(util::offsets::GetOffset("OFFSET_DX11DEVICEMANAGER"));
+      return *(PCDX11DeviceManager**)(util::offsets::GetOffset(OFFSET_DX11DEVICEMANAGER));
     }
   };
 
@@ -327,7 +338,7 @@ namespace Foundation
   public:
     static PCDX11RenderDevice* Singleton()
     {
-      return *(PCDX11RenderDevice**)(util::offsets::GetOffset("OFFSET_DX11RENDERDEVICE"));
+      return *(PCDX11RenderDevice**)(util::offsets::GetOffset(OFFSET_DX11RENDERDEVICE));
     }
   };
 
@@ -350,7 +361,7 @@ namespace Foundation
 
     static UiMenuStateManager* Singleton()
     {
-      return *(UiMenuStateManager**)(util::offsets::GetOffset("OFFSET_UIMENUSTATEMANAGER"));
+      return *(UiMenuStateManager**)(util::offsets::GetOffset(OFFSET_UIMENUSTATEMANAGER));
     }
 
     void ShowMouse(bool show)
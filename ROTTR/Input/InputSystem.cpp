@@ -14,12 +14,21 @@ static const float g_actionClearTime = 0.2f;
 static const float g_mouseSensitivity = 1.0f;
 static const float g_controllerBindThreshold = 0.5f;
 
+// Timestamp for mouse deltas, seconds since the first call
+static double GetInputTime()
+{
+  static const auto startTime = boost::chrono::high_resolution_clock::now();
+  boost::chrono::duration<double> time = boost::chrono::high_resolution_clock::now() - startTime;
+  return time.count();
+}
+
 InputSystem::InputSystem() :
   m_DInputInterface(NULL),
   m_WantedActionStates(),
   m_SmoothActionStates(),
   m_GamepadKeyStates(),
-  m_MouseBuffer(),
+  m_RawInputData(),
+  m_MouseState(),
   m_KeyboardKeyNames(),
   m_ShowUI(false)
 {
@@ -58,22 +67,24 @@ void InputSystem::Initialize()
 
 void InputSystem::HandleRawInput(LPARAM lParam)
 {
-  UINT dwSize = 0;
-  GetRawInputData((HRAWINPUT)lParam, RID_INPUT, NULL, &dwSize, sizeof(RAWINPUTHEADER));
-  //printf("WM_INPUT 0x%X\n", dwSize);
-
-  BYTE* lpb = new BYTE[dwSize];
-  GetRawInputData((HRAWINPUT)lParam, RID_INPUT, lpb, &dwSize, sizeof(RAWINPUTHEADER));
+  // Runs on the window thread for every WM_INPUT, which can be a thousand
+  // times a second. Only the mouse is registered so its data always fits
+  // in the preallocated RAWINPUT, and no size query is needed.
+  UINT dwSize = sizeof(m_RawInputData);
+  if (GetRawInputData((HRAWINPUT)lParam, RID_INPUT, &m_RawInputData, &dwSize, sizeof(RAWINPUTHEADER)) == (UINT)-1)
+    return;
 
-  RAWINPUT* raw = (RAWINPUT*)lpb;
+  RAWINPUT* raw = &m_RawInputData;
   if (raw->header.dwType == RIM_TYPEMOUSE)
   {
-    m_MouseBuffer.x += raw->data.mouse.lLastX;
-    m_MouseBuffer.y += raw->data.mouse.lLastY;
-    m_MouseBuffer.z += static_cast<short>(raw->data.mouse.usButtonData);
-  }
+    MouseDelta delta;
+    delta.Time = GetInputTime();
+    delta.X = static_cast<float>(raw->data.mouse.lLastX);
+    delta.Y = static_cast<float>(raw->data.mouse.lLastY);
+    delta.Wheel = static_cast<short>(raw->data.mouse.usButtonData);
 
-  delete[] lpb;
+    m_MouseDeltas.Push(delta);
+  }
 }
 
 bool InputSystem::HandleKeyMsg(WPARAM wParam, LPARAM lParam)
@@ -116,9 +127,11 @@ void InputSystem::Update()
   ActionUpdate();
   HotkeyUpdate();
 
-  // Copy buffer to mouse state, set buffer to zero
-  m_MouseState = m_MouseBuffer;
-  m_MouseBuffer = DirectX::XMFLOAT3(0, 0, 0);
+  // Sum up the mouse deltas since the last update. Each delta ends up
+  // in exactly one update, even if it arrives while this runs.
+  MouseDelta sum;
+  m_MouseDeltas.Consume(GetInputTime(), sum);
+  m_MouseState = DirectX::XMFLOAT3(sum.X, sum.Y, sum.Wheel);
 }
 
 void InputSystem::ShowUI()
@@ -1,5 +1,6 @@
 #pragma once
 #include "ActionDefs.h"
+#include "MouseDeltaRing.h"
 #include "../inih/cpp/INIReader.h"
 
 #include <array>
@@ -92,7 +93,8 @@ private:
   std::array<float, GamepadKey::GamepadKey_Count>   m_GamepadKeyStates;
 
   DirectX::XMFLOAT2 m_PrevMousePos;
-  DirectX::XMFLOAT3 m_MouseBuffer;
+  RAWINPUT m_RawInputData;
+  MouseDeltaRing m_MouseDeltas;
   DirectX::XMFLOAT3 m_MouseState;
   LPDIRECTINPUTDEVICE8 m_DIMouse;
 
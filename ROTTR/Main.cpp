@@ -64,6 +64,14 @@ bool Main::Initialize()
     return false;
   }
 
+  util::offsets::Resolve();
+
+  if (!Nx::BindExports())
+  {
+    util::log::Error("Game modules are missing exports the tools need");
+    return false;
+  }
+
   g_d3d11Device = Foundation::PCDX11DeviceManager::Singleton()->m_pD3D11Device; // Fetch ID3D11Device
   if (g_d3d11Device)
     g_d3d11Device->GetImmediateContext(&g_d3d11Context);
@@ -90,6 +98,12 @@ bool Main::Initialize()
     return false;
 
   util::hooks::Init();
+
+  m_ConfigWriter.Start(g_configFile, [](const char* error)
+  {
+    util::log::Error("Could not save config. %s", error);
+  });
+
   LoadConfig();
 
   // Subclass the window with a new WndProc to catch messages
@@ -153,9 +167,10 @@ void Main::Run()
     m_CameraManager->Update(dt.count());
     m_UI->Update(dt.count());
 
-    // Check if config has been affected, if so, save it
+    // Check if config has been affected, if so, save it.
+    // The file is written on the config writer's thread.
     m_dtConfigCheck += dt.count();
-    if (m_dtConfigCheck > 10.f)
+    if (m_dtConfigCheck > 1.f)
     {
       m_dtConfigCheck = 0;
       if (m_ConfigChanged)
@@ -190,19 +205,8 @@ void Main::LoadConfig()
 
 void Main::SaveConfig()
 {
-  std::fstream file;
-  file.open(g_configFile, std::ios_base::out | std::ios_base::trunc);
-
-  if (!file.is_open())
-  {
-    util::log::Error("Could not save config, failed to open file for writing. GetLastError 0x%X", GetLastError());
-    return;
-  }
-
-  file << m_CameraManager->GetConfig();
-  file << m_InputSystem->GetConfig();
-
-  file.close();
+  // Nothing is written if the content is the same as before
+  m_ConfigWriter.Submit(m_CameraManager->GetConfig() + m_InputSystem->GetConfig());
 }
 
 extern LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam); 
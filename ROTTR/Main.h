@@ -3,6 +3,7 @@
 #include "Input/InputSystem.h"
 #include "Rendering/CTRenderer.h"
 #include "UI.h"
+#include "Util/ConfigWriter.h"
 
 #include "inih/cpp/INIReader.h"
 #include <memory.h>
@@ -32,6 +33,7 @@ private:
 private:
 
   std::unique_ptr<INIReader>      m_Config;
+  util::ConfigWriter              m_ConfigWriter;
   std::unique_ptr<CameraManager>  m_CameraManager;
   std::unique_ptr<InputSystem>    m_InputSystem;
   std::unique_ptr<CTRenderer>     m_Renderer;
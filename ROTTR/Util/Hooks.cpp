@@ -173,12 +173,12 @@ void util::hooks::Init()
   if (status != MH_OK)
     util::log::Error("Failed to initialize MinHook, MH_STATUS 0x%X", status);
 
-  CreateHook("CameraUpdate", util::offsets::GetOffset("OFFSET_CAMERAUPDATE"), hCameraUpdate, &oCameraUpdate);
+  CreateHook("CameraUpdate", util::offsets::GetOffset(OFFSET_CAMERAUPDATE), hCameraUpdate, &oCameraUpdate);
 
-  CreateHook("KeyboardMouseUpdate", util::offsets::GetOffset("OFFSET_KEYBOARDMOUSEUPDATE"), hKeyboardMouseUpdate, &oKeyboardMouseUpdate);
-  CreateHook("GamepadUpdate", util::offsets::GetOffset("OFFSET_GAMEPADUPDATE"), hGamepadUpdate, &oGamepadUpdate);
+  CreateHook("KeyboardMouseUpdate", util::offsets::GetOffset(OFFSET_KEYBOARDMOUSEUPDATE), hKeyboardMouseUpdate, &oKeyboardMouseUpdate);
+  CreateHook("GamepadUpdate", util::offsets::GetOffset(OFFSET_GAMEPADUPDATE), hGamepadUpdate, &oGamepadUpdate);
   //CreateHook("SceneLightRender", 0x1439D50B0, hSceneRenderLights, &oSceneRenderLights);
-  CreateHook("ScaleformRender", util::offsets::GetOffset("OFFSET_SCALEFORMRENDER"), hScaleformRenderer_Render, &oScaleformRenderer_Render);
+  CreateHook("ScaleformRender", util::offsets::GetOffset(OFFSET_SCALEFORMRENDER), hScaleformRenderer_Render, &oScaleformRenderer_Render);
 
   CreateVTableHook("SwapChainPresent", (PDWORD64*)g_dxgiSwapChain, hIDXGISwapChain_Present, 8, &oIDXGISwapChain_Present);
 }
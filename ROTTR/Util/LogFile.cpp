@@ -0,0 +1,114 @@
+#include "LogFile.h"
+#include <cstring>
+
+using namespace util;
+
+namespace
+{
+  FILE* OpenFile(std::string const& path)
+  {
+#ifdef _WIN32
+    FILE* pFile = nullptr;
+    fopen_s(&pFile, path.c_str(), "w");
+    return pFile;
+#else
+    return fopen(path.c_str(), "w");
+#endif
+  }
+}
+
+LogFile::LogFile() :
+  m_pFile(nullptr),
+  m_MaxSize(0),
+  m_Backups(0),
+  m_Size(0)
+{
+
+}
+
+LogFile::~LogFile()
+{
+  Close();
+}
+
+bool LogFile::Open(std::string const& path, uint64_t maxSize, unsigned backups)
+{
+  Close();
+
+  m_Path = path;
+  m_MaxSize = maxSize;
+  m_Backups = backups;
+  m_Size = 0;
+
+  // Backups left from the last session would only be confusing
+  for (unsigned i = 1; i <= m_Backups; ++i)
+    remove(GetBackupPath(i).c_str());
+
+  m_pFile = OpenFile(m_Path);
+  return m_pFile != nullptr;
+}
+
+void LogFile::Close()
+{
+  if (m_pFile)
+  {
+    fclose(m_pFile);
+    m_pFile = nullptr;
+  }
+}
+
+void LogFile::Write(const char* pData, size_t length)
+{
+  if (!m_pFile)
+    return;
+
+  fwrite(pData, 1, length, m_pFile);
+  m_Size += length;
+}
+
+void LogFile::Write(const char* pText)
+{
+  Write(pText, strlen(pText));
+}
+
+void LogFile::Flush()
+{
+  if (!m_pFile)
+    return;
+
+  fflush(m_pFile);
+
+  if (m_MaxSize > 0 && m_Size >= m_MaxSize)
+    Rotate();
+}
+
+std::string LogFile::GetBackupPath(unsigned index) const
+{
+  // CT.log -> CT.1.log
+  std::string suffix = "." + std::to_string(index);
+
+  size_t extension = m_Path.find_last_of('.');
+  size_t directory = m_Path.find_last_of("/\\");
+  if (extension == std::string::npos || (directory != std::string::npos && extension < directory))
+    return m_Path + suffix;
+
+  return m_Path.substr(0, extension) + suffix + m_Path.substr(extension);
+}
+
+void LogFile::Rotate()
+{
+  fclose(m_pFile);
+  m_pFile = nullptr;
+
+  // rename doesn't replace existing files on Windows
+  if (m_Backups > 0)
+  {
+    remove(GetBackupPath(m_Backups).c_str());
+    for (unsigned i = m_Backups - 1; i > 0; --i)
+      rename(GetBackupPath(i).c_str(), GetBackupPath(i + 1).c_str());
+    rename(m_Path.c_str(), GetBackupPath(1).c_str());
+  }
+
+  m_Size = 0;
+  m_pFile = OpenFile(m_Path);
+}
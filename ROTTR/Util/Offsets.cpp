@@ -11,26 +11,48 @@ using namespace boost::assign;
 namespace
 {
   bool m_UseScannedResults = false;
-  std::unordered_map<std::string, util::offsets::Signature> m_Signatures;
+  std::vector<std::pair<OffsetId, util::offsets::Signature>> m_Signatures;
 
   // Fill with hardcoded offsets if you don't want to use scanning
   // These should be relative to the module base.
-  std::unordered_map<std::string, __int64> m_HardcodedOffsets = map_list_of
-  ("OFFSET_GAMERENDER", 0x2DB71B0)
-  ("OFFSET_DX11DEVICEMANAGER", 0x1A12288)
-  ("OFFSET_DX11RENDERDEVICE", 0x19EFAA0)
-  ("OFFSET_UIMENUSTATEMANAGER", 0x2DB9B70)
+  std::unordered_map<OffsetId, __int64> m_HardcodedOffsets = map_list_of
+  (OFFSET_GAMERENDER, 0x2DB71B0)
+  (OFFSET_DX11DEVICEMANAGER, 0x1A12288)
+  (OFFSET_DX11RENDERDEVICE, 0x19EFAA0)
+  (OFFSET_UIMENUSTATEMANAGER, 0x2DB9B70)
 
-  ("OFFSET_SCENE", 0x2CCC8D0)
+  (OFFSET_SCENE, 0x2CCC8D0)
     
-  ("OFFSET_CAMERAUPDATE", 0x3F9F9D0)
+  (OFFSET_CAMERAUPDATE, 0x3F9F9D0)
 
-  ("OFFSET_KEYBOARDMOUSEUPDATE", 0x3732AF0)
-  ("OFFSET_GAMEPADUPDATE", 0x3732790)
+  (OFFSET_KEYBOARDMOUSEUPDATE, 0x3732AF0)
+  (OFFSET_GAMEPADUPDATE, 0x3732790)
     
-  ("OFFSET_FREEZEGAME", 0x3FEAB30)
-  ("OFFSET_UNFREEZEGAME", 0x3FD8910)
-  ("OFFSET_SCALEFORMRENDER", 0x42AB3F0);
+  (OFFSET_FREEZEGAME, 0x3FEAB30)
+  (OFFSET_UNFREEZEGAME, 0x3FD8910)
+  (OFFSET_SCALEFORMRENDER, 0x42AB3F0);
+
+  // Same order as OffsetId, used for logging
+  const char* g_offsetNames[] =
+  {
+    "OFFSET_GAMERENDER",
+    "OFFSET_DX11DEVICEMANAGER",
+    "OFFSET_DX11RENDERDEVICE",
+    "OFFSET_UIMENUSTATEMANAGER",
+
+    "OFFSET_SCENE",
+
+    "OFFSET_CAMERAUPDATE",
+
+    "OFFSET_KEYBOARDMOUSEUPDATE",
+    "OFFSET_GAMEPADUPDATE",
+
+    "OFFSET_FREEZEGAME",
+    "OFFSET_UNFREEZEGAME",
+    "OFFSET_SCALEFORMRENDER"
+  };
+
+  static_assert(sizeof(g_offsetNames) / sizeof(g_offsetNames[0]) == OffsetCount, "Every OffsetId needs a name");
   
 
   bool DataCompare(BYTE* pData, BYTE* bSig, const char* szMask)
@@ -73,6 +95,8 @@ namespace
   }
 }
 
+__int64 util::offsets::g_resolvedOffsets[OffsetCount] = { 0 };
+
 util::offsets::Signature::Signature(std::string const& sig, int offset /* = 0 */)
 {
   Pattern = new BYTE[sig.size()]();
@@ -117,7 +141,10 @@ util::offsets::Signature::Signature(std::string const& sig, int offset /* = 0 */
 
 void util::offsets::Scan()
 {
-  m_Signatures.emplace("OFFSET_DXRENDERER", Signature("75 87 48 8B 05 [ ?? ?? ?? ?? ] 48 8B B0"));
+  // Signatures are added with an OffsetId, for example
+  // m_Signatures.emplace_back(OFFSET_EXAMPLE, Signature("12 34 56 78 [ ?? ?? ?? ?? ] AA BB ?? DF", 0x20));
+
+  m_Signatures.clear();
 
   util::log::Write("Scanning for offsets...");
 
@@ -126,6 +153,7 @@ void util::offsets::Scan()
   {
     util::log::Error("GetModuleInformation failed, GetLastError 0x%X", GetLastError());
     util::log::Error("Offset scanning unavailable");
+    Resolve();
     return;
   }
 
@@ -137,7 +165,7 @@ void util::offsets::Scan()
     __int64 result = (__int64)FindPattern((BYTE*)info.lpBaseOfDll, info.SizeOfImage, sig.Pattern, sig.Mask.c_str());
     if (!result)
     {
-      util::log::Error("Could not find pattern for %s", entry.first.c_str());
+      util::log::Error("Could not find pattern for %s", GetOffsetName(entry.first));
       allFound = false;
     }
 
@@ -159,32 +187,40 @@ void util::offsets::Scan()
     util::log::Warning("All offsets could not be found, this might result in a crash");
 
   m_UseScannedResults = true;
+  Resolve();
 }
 
-__int64 util::offsets::GetOffset(std::string const& name)
+void util::offsets::Resolve()
 {
-  // If a scan was done, prefer those results.
-  // If something couldn't be found or there was no scan,
-  // use the hardcoded offsets.
+  // If the offsets were scanned, their absolute position is known.
+  // With hardcoded offsets, use relative offset because it's not
+  // 100% guaranteed the game module will load at the same address space.
+
+  for (int i = 0; i < OffsetCount; ++i)
+    g_resolvedOffsets[i] = 0;
+
+  for (auto& entry : m_HardcodedOffsets)
+    g_resolvedOffsets[entry.first] = entry.second + (__int64)g_gameHandle;
 
+  // If a scan was done, prefer those results.
+  // If something couldn't be found, keep the hardcoded offset.
   if (m_UseScannedResults)
   {
-    auto result = m_Signatures.find(name);
-    if (result != m_Signatures.end())
+    for (auto& entry : m_Signatures)
     {
-      if (result->second.Result)
-        return result->second.Result;
+      if (entry.second.Result)
+        g_resolvedOffsets[entry.first] = entry.second.Result;
     }
   }
 
-  // If the offsets were scanned, their absolute position is known.
-  // With hardcoded offsets, use relative offset because it's not
-  // 100% guaranteed the game module will load at the same address space.
-
-  auto hardcodedResult = m_HardcodedOffsets.find(name);
-  if (hardcodedResult != m_HardcodedOffsets.end())
-    return hardcodedResult->second + (__int64)g_gameHandle;
+  for (int i = 0; i < OffsetCount; ++i)
+  {
+    if (!g_resolvedOffsets[i])
+      util::log::Error("Offset %s does not exist", g_offsetNames[i]);
+  }
+}
 
-  util::log::Error("Offset %s does not exist", name.c_str());
-  return 0;
+const char* util::offsets::GetOffsetName(OffsetId id)
+{
+  return g_offsetNames[id];
 }
\ No newline at end of file
@@ -5,6 +5,29 @@
 #include <vector>
 #include <Windows.h>
 
+// Every offset the tools use. Names are checked at compile time
+// and the addresses are looked up by index.
+enum OffsetId
+{
+  OFFSET_GAMERENDER,
+  OFFSET_DX11DEVICEMANAGER,
+  OFFSET_DX11RENDERDEVICE,
+  OFFSET_UIMENUSTATEMANAGER,
+
+  OFFSET_SCENE,
+
+  OFFSET_CAMERAUPDATE,
+
+  OFFSET_KEYBOARDMOUSEUPDATE,
+  OFFSET_GAMEPADUPDATE,
+
+  OFFSET_FREEZEGAME,
+  OFFSET_UNFREEZEGAME,
+  OFFSET_SCALEFORMRENDER,
+
+  OffsetCount
+};
+
 namespace util
 {
   namespace hooks
@@ -32,7 +55,10 @@ namespace util
 
   namespace log
   {
+    // Messages are formatted and written on a background thread
     void Init();
+    // Writes what's left and stops the background thread
+    void Shutdown();
 
     void Write(const char* format, ...);
     void Warning(const char* format, ...);
@@ -58,7 +84,18 @@ namespace util
     };
 
     void Scan();
-    __int64 GetOffset(std::string const& name);
+
+    // Fills the address table from the scan results, or from the
+    // hardcoded offsets if there was no scan. Needs to be called
+    // before any GetOffset, and again after a Scan.
+    void Resolve();
+    const char* GetOffsetName(OffsetId id);
+
+    extern __int64 g_resolvedOffsets[OffsetCount];
+
+    // Called every frame by the engine accessors and hooks,
+    // so it's only an array read
+    inline __int64 GetOffset(OffsetId id) { return g_resolvedOffsets[id]; }
   }
 
   bool GetResource(int, void*&, DWORD&);
@@ -1,4 +1,5 @@
 #include "Globals.h"
+#include "Util/Util.h"
 #include <Windows.h>
 
 DWORD WINAPI RunCT(LPVOID lpArg)
@@ -9,6 +10,7 @@ DWORD WINAPI RunCT(LPVOID lpArg)
     g_mainHandle->Run();
 
   delete g_mainHandle;
+  util::log::Shutdown();
   FreeLibraryAndExitThread(g_dllHandle, 0);
   return 0;
 }
@@ -2,6 +2,7 @@
 #include <Windows.h>
 
 #include "Main.h"
+#include "Util/Util.h"
 
 Main* g_mainHandle = nullptr;
 HINSTANCE g_dllHandle = NULL;
@@ -17,6 +18,7 @@ DWORD WINAPI Initialize(LPVOID arg)
 
   g_mainHandle->Release();
   delete g_mainHandle;
+  util::log::Shutdown();
 
   return 1;
 }
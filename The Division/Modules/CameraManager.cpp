@@ -4,6 +4,7 @@
 #include "../Util/Util.h"
 #include "../imgui/imgui.h"
 #include "../Util/ImGuiHelpers.h"
+#include <algorithm>
 #include <stdio.h>
 
 CameraManager::CameraManager()
@@ -47,7 +48,12 @@ CameraManager::~CameraManager()
 void CameraManager::Update(double dt)
 {
   UpdatePlayerList();
-  if (!m_cameraEnabled) return;
+  if (!m_cameraEnabled)
+  {
+    PublishState();
+    return;
+  }
+
   if (m_shakeInfo.shakeEnabled) GenerateShake(dt);
 
   if (m_trackState.playing) PlayTrackForward(dt);
@@ -108,44 +114,66 @@ void CameraManager::Update(double dt)
     m_camera.fov += dt * m_settings.zoomSpeed * pInputManager->GetActionState(InputManager::Action::Camera_IncFov);
     m_camera.fov -= dt * m_settings.zoomSpeed * pInputManager->GetActionState(InputManager::Action::Camera_DecFov);
   }
+
+  PublishState();
 }
 
 void CameraManager::CameraHook(__int64 pCamera)
 {
-  if (!m_cameraEnabled)
+  m_stateChannel.TryLoad(m_hookState);
+  CameraState const& state = m_hookState;
+
+  if (!state.enabled)
     return;
 
   TD::GameCamera* pGameCamera = (TD::GameCamera*)pCamera;
 
   XMMATRIX targetMatrix = XMMatrixIdentity();
-  if (m_lockToPlayer)
-    targetMatrix = m_pAgents[m_selectedPlayerIndex]->m_Transform;
+  if (state.pTarget)
+    targetMatrix = state.pTarget->m_Transform;
 
-  XMMATRIX rotationMatrix = XMMatrixRotationRollPitchYaw(XMConvertToRadians(m_camera.pitch), XMConvertToRadians(m_camera.yaw), 0);
-  XMMATRIX rollMatrix = XMMatrixRotationRollPitchYaw(0, 0, XMConvertToRadians(m_camera.roll));
+  XMMATRIX rotationMatrix = XMMatrixRotationRollPitchYaw(XMConvertToRadians(state.camera.pitch), XMConvertToRadians(state.camera.yaw), 0);
+  XMMATRIX rollMatrix = XMMatrixRotationRollPitchYaw(0, 0, XMConvertToRadians(state.camera.roll));
   rotationMatrix = XMMatrixMultiply(rollMatrix, rotationMatrix);
 
   XMVECTOR cameraPos = targetMatrix.r[3];
-  cameraPos += m_camera.position.m128_f32[0] * targetMatrix.r[0];
-  cameraPos += m_camera.position.m128_f32[1] * targetMatrix.r[1];
-  cameraPos += m_camera.position.m128_f32[2] * targetMatrix.r[2];
+  cameraPos += state.camera.position.m128_f32[0] * targetMatrix.r[0];
+  cameraPos += state.camera.position.m128_f32[1] * targetMatrix.r[1];
+  cameraPos += state.camera.position.m128_f32[2] * targetMatrix.r[2];
 
   targetMatrix = XMMatrixMultiply(rotationMatrix, targetMatrix);
-  if (m_shakeInfo.shakeEnabled)
-    targetMatrix = XMMatrixMultiply(m_shakeInfo.shakeMatrix, targetMatrix);
+  if (state.shakeEnabled)
+    targetMatrix = XMMatrixMultiply(state.shakeMatrix, targetMatrix);
 
   targetMatrix.r[3] = cameraPos;
 
-  if (m_trackState.playing && m_trackState.rotationLocked)
-    targetMatrix = m_trackState.transform;
-  else if (m_trackState.playing)
-    targetMatrix.r[3] = m_trackState.transform.r[3];
+  if (state.track.playing && state.track.rotationLocked)
+    targetMatrix = state.track.transform;
+  else if (state.track.playing)
+    targetMatrix.r[3] = state.track.transform.r[3];
 
   pGameCamera->m_Transform = targetMatrix;
-  if (!m_trackState.playing || !m_trackState.fovLocked)
-    pGameCamera->m_FieldOfView = XMConvertToRadians(m_camera.fov);
+  if (!state.track.playing || !state.track.fovLocked)
+    pGameCamera->m_FieldOfView = XMConvertToRadians(state.camera.fov);
   else
-    pGameCamera->m_FieldOfView = XMConvertToRadians(m_trackState.fov);
+    pGameCamera->m_FieldOfView = XMConvertToRadians(state.track.fov);
+}
+
+void CameraManager::PublishState()
+{
+  CameraState state;
+  state.enabled = m_cameraEnabled;
+  state.camera = m_camera;
+  state.shakeEnabled = m_shakeInfo.shakeEnabled;
+  state.shakeMatrix = m_shakeInfo.shakeMatrix;
+  state.track = m_trackState;
+
+  // The agent list is rebuilt on every update, so hand the hook
+  // the agent itself instead of an index into the list
+  if (m_lockToPlayer && m_selectedPlayerIndex < (int)m_pAgents.size())
+    state.pTarget = m_pAgents[m_selectedPlayerIndex];
+
+  m_stateChannel.Store(state);
 }
 
 void CameraManager::ToggleCamera()
@@ -284,6 +312,29 @@ void CameraManager::ToggleTrackPlay()
   m_trackState.playing = true;
 }
 
+// Playback usually stays in the hinted segment or moves on to the next
+// one. Anything else is a binary search, so a big jump in time doesn't
+// take a frame per node to catch up.
+static int FindTrackSegment(std::vector<CameraNode> const& nodes, double time, int hint)
+{
+  const int lastSegment = static_cast<int>(nodes.size()) - 2;
+
+  for (int segment = hint; segment <= hint + 1 && segment <= lastSegment; ++segment)
+  {
+    if (segment >= 0 && time >= nodes[segment].time && time < nodes[segment + 1].time)
+      return segment;
+  }
+
+  auto upper = std::upper_bound(nodes.begin(), nodes.end(), time,
+    [](double t, CameraNode const& node) { return t < node.time; });
+
+  if (upper == nodes.begin())
+    return 0;
+
+  int segment = static_cast<int>(upper - nodes.begin()) - 1;
+  return segment < lastSegment ? segment : lastSegment;
+}
+
 void CameraManager::PlayTrackForward(double dt)
 {
   std::vector<CameraNode>& rNodes = m_tracks[m_selectedTrackIndex].nodes;
@@ -296,36 +347,16 @@ void CameraManager::PlayTrackForward(double dt)
   }
   m_trackState.time += finalDt;
 
+  // Stop at either end of the track
+  if (m_trackState.time < rNodes.front().time)
+    m_trackState.time = rNodes.front().time;
+  else if (m_trackState.time > rNodes.back().time)
+    m_trackState.time = rNodes.back().time;
+
+  m_trackState.node = FindTrackSegment(rNodes, m_trackState.time, m_trackState.node);
   CameraNode* r2 = &rNodes[m_trackState.node];
   CameraNode* r3 = &rNodes[m_trackState.node + 1];
 
-  if (m_trackState.time > r3->time)
-  {
-    if (m_trackState.node + 1 < rNodes.size() - 1)
-    {
-      m_trackState.node += 1;
-      r2 = &rNodes[m_trackState.node];
-      r3 = &rNodes[m_trackState.node + 1];
-    }
-    else
-    {
-      m_trackState.time = r3->time;
-    }
-  }
-  else if (m_trackState.time < r2->time)
-  {
-    if (m_trackState.node > 0)
-    {
-      m_trackState.node -= 1;
-      r2 = &rNodes[m_trackState.node];
-      r3 = &rNodes[m_trackState.node + 1];
-    }
-    else
-    {
-      m_trackState.time = 0;
-    }
-  }
-
   CameraNode* r1 = (m_trackState.node > 0)                     ? &rNodes[m_trackState.node - 1] : r2;
   CameraNode* r4 = (m_trackState.node + 1 < rNodes.size() - 1) ? &rNodes[m_trackState.node + 2] : r3;
 
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "Snowdrop.h"
+#include "../Util/SeqLock.h"
 
 using namespace DirectX;
 
@@ -65,6 +66,19 @@ struct CameraShake
   float dtShake{ 0.f };
 };
 
+// Everything CameraHook needs to place the camera. A complete copy is
+// published after every update so the hook never sees a camera that is
+// halfway through being updated.
+struct CameraState
+{
+  bool enabled{ false };
+  TD::Agent* pTarget{ nullptr }; // Only set when locked to a player
+  Camera camera;
+  bool shakeEnabled{ false };
+  XMMATRIX shakeMatrix{ XMMatrixIdentity() };
+  TrackState track;
+};
+
 class CameraManager
 {
 public:
@@ -92,6 +106,9 @@ private:
 
   void UpdatePlayerList();
 
+  // Copies the camera for CameraHook
+  void PublishState();
+
 private:
   bool m_cameraEnabled;
   bool m_firstEnable;
@@ -108,6 +125,11 @@ private:
   TrackState m_trackState;
   int m_runningId;
 
+  // Written by Update, CameraHook keeps the last state it read in
+  // case a read overlaps a write
+  util::SeqLock<CameraState> m_stateChannel;
+  CameraState m_hookState;
+
   const char** m_playerList;
   std::vector<TD::Agent*> m_pAgents;
   int m_playerCount;
@@ -0,0 +1,87 @@
+#include "LogThrottle.h"
+
+using namespace util;
+
+namespace
+{
+  // Sites are only ever added, a full table is searched this far
+  const size_t g_MaxProbes = 16;
+}
+
+LogThrottle::LogThrottle(unsigned burst, int64_t intervalNs) :
+  m_Interval(intervalNs),
+  m_Tolerance(intervalNs * (burst > 0 ? burst - 1 : 0)),
+  m_Sites(new Site[SiteCount])
+{
+  for (size_t i = 0; i < SiteCount; ++i)
+  {
+    m_Sites[i].Format = nullptr;
+    m_Sites[i].Level = 0;
+    m_Sites[i].NextTime = INT64_MIN;
+    m_Sites[i].Suppressed = 0;
+  }
+}
+
+LogThrottle::Site* LogThrottle::FindSite(const char* format)
+{
+  uint64_t hash = reinterpret_cast<uintptr_t>(format) * 0x9E3779B97F4A7C15ull;
+  size_t index = static_cast<size_t>(hash >> 54) & (SiteCount - 1);
+
+  for (size_t probe = 0; probe < g_MaxProbes; ++probe)
+  {
+    Site& site = m_Sites[(index + probe) & (SiteCount - 1)];
+
+    const char* current = site.Format.load(std::memory_order_acquire);
+    if (current == format)
+      return &site;
+
+    if (!current && site.Format.compare_exchange_strong(current, format, std::memory_order_acq_rel))
+      return &site;
+
+    // Another thread may have claimed it for the same site
+    if (current == format)
+      return &site;
+  }
+
+  return nullptr;
+}
+
+bool LogThrottle::Allow(const char* format, int level, int64_t time)
+{
+  Site* pSite = FindSite(format);
+  if (!pSite)
+    return true;
+
+  // Generic cell rate: a message is allowed if the site isn't more than
+  // burst - 1 intervals ahead of the rate, and then moves it one ahead
+  int64_t next = pSite->NextTime.load(std::memory_order_relaxed);
+  for (;;)
+  {
+    int64_t start = next > time ? next : time;
+    if (start - time > m_Tolerance)
+    {
+      pSite->Level.store(level, std::memory_order_relaxed);
+      pSite->Suppressed.fetch_add(1, std::memory_order_release);
+      return false;
+    }
+
+    if (pSite->NextTime.compare_exchange_weak(next, start + m_Interval, std::memory_order_relaxed))
+      return true;
+  }
+}
+
+void LogThrottle::TakeSuppressed(Report const& report)
+{
+  for (size_t i = 0; i < SiteCount; ++i)
+  {
+    Site& site = m_Sites[i];
+
+    const char* format = site.Format.load(std::memory_order_acquire);
+    if (!format || site.Suppressed.load(std::memory_order_relaxed) == 0)
+      continue;
+
+    uint64_t suppressed = site.Suppressed.exchange(0, std::memory_order_acquire);
+    if (suppressed > 0)
+      report(format, site.Level.load(std::memory_order_relaxed), suppressed);
+  }
+}
@@ -14,7 +14,10 @@ namespace util
 
   namespace log
   {
+    // Messages are formatted and written on a background thread
     void Init();
+    // Writes what's left and stops the background thread
+    void Shutdown();
 
     void Write(const char* format, ...);
     void Warning(const char* format, ...);
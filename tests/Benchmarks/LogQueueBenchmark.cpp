@@ -0,0 +1,161 @@
+#include "../../Alien Isolation/Util/LogQueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace util;
+
+namespace
+{
+  typedef std::chrono::steady_clock Clock;
+
+  FILE* g_Console;
+  FILE* g_File;
+
+  // The logger the queue replaced: a lock, a time stamp string, two
+  // vfprintf calls and a flush per message
+  std::mutex g_LogMutex;
+  void LockedLog(const char* format, ...)
+  {
+    std::lock_guard<std::mutex> lock(g_LogMutex);
+    char stamp[64];
+    time_t now = time(nullptr);
+    strftime(stamp, sizeof(stamp), "[%Y-%b-%d %H:%M:%S] ", localtime(&now));
+    fputs(stamp, g_Console);
+    fputs(stamp, g_File);
+
+    std::string finalFormat = std::string("[WARNING] ") + format + "\n";
+    va_list args;
+    va_start(args, format);
+    vfprintf(g_Console, finalFormat.c_str(), args);
+    va_end(args);
+    va_start(args, format);
+    vfprintf(g_File, finalFormat.c_str(), args);
+    va_end(args);
+    fflush(g_File);
+  }
+
+  LogQueue* g_pQueue;
+  void QueuedLog(const char* format, ...)
+  {
+    va_list args;
+    va_start(args, format);
+    g_pQueue->Push(1, format, args);
+    va_end(args);
+  }
+
+  // What the Windows sink does, without the console colours
+  size_t g_Written, g_Dropped;
+  void WriteBatch(LogMessage const* pMessages, size_t count, uint64_t dropped)
+  {
+    g_Written += count;
+    g_Dropped += dropped;
+
+    char stamp[64];
+    int64_t lastTime = -1;
+    for (size_t i = 0; i < count; ++i)
+    {
+      if (pMessages[i].Time != lastTime)
+      {
+        time_t t = static_cast<time_t>(pMessages[i].Time);
+        strftime(stamp, sizeof(stamp), "[%Y-%b-%d %H:%M:%S] ", localtime(&t));
+        lastTime = pMessages[i].Time;
+      }
+
+      for (FILE* pFile : { g_Console, g_File })
+      {
+        fputs(stamp, pFile);
+        fputs("[WARNING] ", pFile);
+        fwrite(pMessages[i].pText, 1, pMessages[i].Length, pFile);
+        fputc('\n', pFile);
+      }
+    }
+
+    fflush(g_Console);
+    fflush(g_File);
+  }
+
+  struct Case
+  {
+    const char* Name;
+    int Threads;
+    int PerThread;
+    int PaceEvery; // Sleep half a millisecond after this many messages
+  };
+
+  template<typename Log>
+  void Run(const char* name, Case const& c, Log log, void(*finish)())
+  {
+    std::vector<std::vector<double>> latencies(c.Threads);
+    auto start = Clock::now();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < c.Threads; ++t)
+    {
+      threads.emplace_back([&, t]
+      {
+        latencies[t].reserve(c.PerThread);
+        for (int i = 0; i < c.PerThread; ++i)
+        {
+          auto logged = Clock::now();
+          log("Present hook frame %d draw %d of %s took %.3f ms", i, t, "scene", 0.25 * i);
+          latencies[t].push_back(std::chrono::duration<double, std::nano>(Clock::now() - logged).count());
+
+          if (c.PaceEvery && i % c.PaceEvery == c.PaceEvery - 1)
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+      });
+    }
+
+    for (auto& thread : threads)
+      thread.join();
+    finish();
+    std::chrono::duration<double> total = Clock::now() - start;
+
+    std::vector<double> all;
+    for (auto const& l : latencies)
+      all.insert(all.end(), l.begin(), l.end());
+    std::sort(all.begin(), all.end());
+    auto at = [&](double q) { return all[std::min(all.size() - 1, size_t(q * all.size()))]; };
+
+    printf("%-6s %-30s %8.0f %8.0f %9.0f %10.0f %10.0f\n", name, c.Name,
+      at(0.5), at(0.99), at(0.999), all.back(), c.Threads * c.PerThread / total.count());
+  }
+}
+
+// Latency seen by the logging threads, old logger against the queue
+int main()
+{
+  g_Console = fopen("/dev/null", "w");
+  g_File = tmpfile();
+  if (!g_Console || !g_File)
+    return 1;
+
+  const Case cases[] =
+  {
+    { "1 thread, burst", 1, 200000, 0 },
+    { "4 threads, burst", 4, 50000, 0 },
+    { "4 threads, 20 per 0.5 ms", 4, 20000, 20 },
+  };
+
+  printf("%-37s %8s %8s %9s %10s %10s\n", "", "p50 ns", "p99 ns", "p99.9 ns", "max ns", "msgs/s");
+  for (auto const& c : cases)
+  {
+    Run("locked", c, LockedLog, [] {});
+
+    LogQueue queue(4096, 1u << 30);
+    g_pQueue = &queue;
+    g_Written = g_Dropped = 0;
+    queue.Start(WriteBatch);
+    Run("queue", c, QueuedLog, [] { g_pQueue->Stop(); });
+    printf("%-37s written %zu, dropped %zu\n", "", g_Written, g_Dropped);
+  }
+
+  return 0;
+}
@@ -0,0 +1,32 @@
+#include "../Camera/OSCWriter.h"
+#include "../../Alien Isolation/Camera/OSCPose.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Parsing and publishing a position + rotation bundle, the work the
+// receive thread does for every datagram of a tracker
+int main()
+{
+  std::vector<char> packet = OSCWriter::Bundle(OSCWriter::TimeTag(1), {
+    OSCWriter::Message("/position", { 1, 2, 3 }),
+    OSCWriter::Message("/rotation", { 0, 0, 0, 1 }),
+  });
+
+  OSCPoseStream stream;
+  OSCMessageHandler handler = [&](OSCMessage& message) { stream.HandleMessage(message); };
+
+  const int bundleCount = 5000000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < bundleCount; ++i)
+  {
+    ParseOSCPacket(packet.data(), packet.size(), handler);
+    stream.EndPacket(i);
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  printf("parse + publish: %.0f ns per bundle, %.1fM bundles/s\n",
+    elapsed.count() / bundleCount * 1e9, bundleCount / elapsed.count() / 1e6);
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include "../../Alien Isolation/Util/PatternScanner.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+using util::offsets::PatternScanner;
+
+namespace
+{
+  // Roughly what FindPattern did, one pass per signature that
+  // compares the rest of the pattern wherever the first byte matches
+  size_t FindPattern(uint8_t const* pData, size_t size, std::vector<uint8_t> const& bytes, std::string const& mask)
+  {
+    for (size_t i = 0; i + bytes.size() <= size; ++i)
+    {
+      if (pData[i] != bytes[0])
+        continue;
+
+      size_t j = 1;
+      while (j < bytes.size() && (mask[j] != 'x' || pData[i + j] == bytes[j]))
+        ++j;
+
+      if (j == bytes.size())
+        return i;
+    }
+    return PatternScanner::NotFound;
+  }
+
+  double Milliseconds(std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+}
+
+// 64 MB synthetic image and 60 signatures, a third of them missing
+int main()
+{
+  std::mt19937 random(7);
+  const size_t size = 64 * 1024 * 1024;
+
+  std::vector<uint8_t> image(size);
+  const uint8_t common[] = { 0x00, 0xCC, 0x48, 0x8B, 0x89, 0xE8, 0x0F, 0xFF };
+  for (auto& byte : image)
+    byte = (random() % 3) ? common[random() % 8] : static_cast<uint8_t>(random());
+
+  std::vector<std::vector<uint8_t>> patterns;
+  std::vector<std::string> masks;
+  for (int i = 0; i < 60; ++i)
+  {
+    std::vector<uint8_t> bytes;
+    std::string mask;
+    for (int j = 0; j < 16; ++j)
+    {
+      bytes.push_back(j == 0 ? 0x48 : static_cast<uint8_t>(random()));
+      mask += (j % 5 == 4) ? '?' : 'x';
+    }
+
+    if (i % 3 != 0)
+    {
+      size_t offset = random() % (size - bytes.size());
+      for (size_t j = 0; j < bytes.size(); ++j)
+        if (mask[j] == 'x') image[offset + j] = bytes[j];
+    }
+
+    patterns.push_back(bytes);
+    masks.push_back(mask);
+  }
+
+  PatternScanner scanner;
+  for (size_t i = 0; i < patterns.size(); ++i)
+    scanner.AddPattern(patterns[i], masks[i]);
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<size_t> results = scanner.Scan(image.data(), image.size());
+  double scanTime = Milliseconds(start);
+
+  start = std::chrono::steady_clock::now();
+  size_t mismatches = 0;
+  for (size_t i = 0; i < patterns.size(); ++i)
+    mismatches += FindPattern(image.data(), size, patterns[i], masks[i]) != results[i];
+  double naiveTime = Milliseconds(start);
+
+  printf("%zu signatures over %zu MB: single pass %.1f ms, one pass per signature %.1f ms\n",
+    patterns.size(), size >> 20, scanTime, naiveTime);
+  if (mismatches)
+    printf("%zu results differ\n", mismatches);
+
+  return mismatches == 0 ? 0 : 1;
+}
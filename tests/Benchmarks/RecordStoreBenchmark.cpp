@@ -0,0 +1,120 @@
+#include "../../Alien Isolation/Util/RecordStore.h"
+#include "../../Alien Isolation/Util/ConfigWriter.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace util;
+
+namespace
+{
+  typedef std::chrono::steady_clock Clock;
+
+  double Milliseconds(Clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  }
+
+  std::string ProfileData(int i)
+  {
+    std::string data(48, '\0');
+    for (int k = 0; k < 48; ++k)
+      data[k] = char(i * 31 + k * 7);
+    return data;
+  }
+
+  // What a profile looked like as its own ini file
+  const char* g_ProfileIni =
+    "[CameraProfile]\nFieldOfView = 50.000000\nMovementSpeed = 1.000000\n"
+    "RotationSpeed = 0.785398\nRollSpeed = 0.392699\nFovSpeed = 5.000000\n"
+    "DofScale = 1.000000\nDofStrength = 0.040000\nFocusDistance = 2.000000\n"
+    "MouseFilter = 1\nMouseSmoothTime = 0.200000\nIsProfile = true\n";
+}
+
+// One store file against one ini file per profile
+int main()
+{
+  char dirTemplate[] = "/tmp/ct_store_XXXXXX";
+  if (!mkdtemp(dirTemplate))
+    return 1;
+
+  std::string dir = dirTemplate;
+  std::string iniDir = dir + "/ini";
+  std::string path = dir + "/profiles.db";
+
+  for (int count : { 100, 1000, 5000 })
+  {
+    mkdir(iniDir.c_str(), 0755);
+
+    auto start = Clock::now();
+    for (int i = 0; i < count; ++i)
+    {
+      std::ofstream file(iniDir + "/Profile " + std::to_string(i) + ".ini", std::ios::trunc);
+      file << g_ProfileIni;
+    }
+    double iniSave = Milliseconds(start);
+
+    start = Clock::now();
+    DIR* pDir = opendir(iniDir.c_str());
+    while (dirent* pEntry = readdir(pDir))
+    {
+      std::string content;
+      if (pEntry->d_name[0] != '.')
+        ConfigWriter::Read(iniDir + "/" + pEntry->d_name, content);
+    }
+    closedir(pDir);
+    double iniLoad = Milliseconds(start);
+
+    remove(path.c_str());
+    start = Clock::now();
+    {
+      RecordStore store;
+      store.Open(path);
+      for (int i = 0; i < count; ++i)
+        store.Put("Profile " + std::to_string(i), ProfileData(i));
+      store.Sync();
+    }
+    double storeSave = Milliseconds(start);
+
+    // Unchanged profiles aren't written again
+    start = Clock::now();
+    {
+      RecordStore store;
+      store.Open(path);
+      for (int i = 0; i < count; ++i)
+        store.Put("Profile " + std::to_string(i), ProfileData(i));
+      store.Sync();
+    }
+    double storeResave = Milliseconds(start);
+
+    start = Clock::now();
+    RecordStore store;
+    store.Open(path);
+    double storeOpen = Milliseconds(start);
+
+    const int lookups = 100000;
+    volatile int found = 0;
+    start = Clock::now();
+    for (int k = 0; k < lookups; ++k)
+      found = found + store.Find("Profile " + std::to_string(k % count));
+    double find = Milliseconds(start) * 1e6 / lookups;
+
+    printf("%5d profiles  ini: save %7.2f ms, load %7.2f ms | store: save %6.2f ms, resave %6.2f ms, open %5.2f ms, find %4.0f ns\n",
+      count, iniSave, iniLoad, storeSave, storeResave, storeOpen, find);
+
+    store.Close();
+    for (int i = 0; i < count; ++i)
+      remove((iniDir + "/Profile " + std::to_string(i) + ".ini").c_str());
+    rmdir(iniDir.c_str());
+  }
+
+  remove(path.c_str());
+  rmdir(dir.c_str());
+  return 0;
+}
@@ -0,0 +1,50 @@
+#include "../Camera/Takes.h"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace takes;
+
+// Compression and error of recorded takes, the error measured
+// independently of what ReduceTake reports
+int main()
+{
+  struct Case
+  {
+    const char* Name;
+    double Seconds;
+    double Fps;
+    double Shake;
+    float Position;
+    float Rotation;
+  };
+
+  const Case cases[] =
+  {
+    { "tripod 60s@60", 60, 60, 0, 0.01f, 0.1f },
+    { "handheld 60s@60", 60, 60, 1, 0.01f, 0.1f },
+    { "handheld 60s@60 loose", 60, 60, 1, 0.03f, 0.3f },
+    { "handheld 60s@60 tight", 60, 60, 1, 0.003f, 0.03f },
+    { "shaky 60s@144", 60, 144, 3, 0.01f, 0.1f },
+    { "handheld 10min@120", 600, 120, 1, 0.01f, 0.1f },
+  };
+
+  printf("%-24s %7s %6s %7s %9s %9s %8s\n", "take", "frames", "nodes", "ratio", "pos err", "rot err", "ms");
+  for (auto const& c : cases)
+  {
+    std::vector<TakeSample> take = Record(c.Seconds, c.Fps, 11, c.Shake, true);
+    TakeTolerance tolerance;
+    tolerance.Position = c.Position;
+    tolerance.Rotation = c.Rotation;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<size_t> kept = ReduceTake(take.data(), take.size(), tolerance);
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    TakeError error = Measure(take, kept);
+    printf("%-24s %7zu %6zu %6.1fx %9.5f %9.4f %8.1f\n", c.Name, take.size(), kept.size(),
+      double(take.size()) / kept.size(), error.Position, error.Rotation, elapsed.count());
+  }
+
+  return 0;
+}
@@ -0,0 +1,189 @@
+#include "Test.h"
+#include "OSCWriter.h"
+#include "../../Alien Isolation/Camera/OSCDispatcher.h"
+
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace
+{
+  bool Match(const char* pattern, const char* name)
+  {
+    return OSCDispatcher::MatchSegment(pattern, strlen(pattern), name, strlen(name));
+  }
+
+  int Send(OSCDispatcher const& dispatcher, std::vector<char> const& packet, std::vector<OSCDispatcher::Call>* pCalls = nullptr)
+  {
+    int methods = 0;
+    ParseOSCPacket(packet.data(), packet.size(), [&](OSCMessage& message) { methods = dispatcher.Dispatch(message, pCalls); });
+    return methods;
+  }
+
+  int Send(OSCDispatcher const& dispatcher, const char* address, float value)
+  {
+    return Send(dispatcher, OSCWriter::Message(address, { value }));
+  }
+
+  std::vector<char> NoArguments(const char* address)
+  {
+    OSCWriter writer;
+    writer.String(address);
+    writer.String(",");
+    return writer.Data;
+  }
+}
+
+TEST(MatchesSegmentPatterns)
+{
+  CHECK(Match("fader1", "fader1"));
+  CHECK(!Match("fader1", "fader10"));
+  CHECK(!Match("fader10", "fader1"));
+
+  CHECK(Match("fader?", "fader1"));
+  CHECK(!Match("fader?", "fader"));
+  CHECK(Match("*", ""));
+  CHECK(Match("*", "abc"));
+  CHECK(Match("f*r*", "fader12"));
+  CHECK(Match("*[13]", "fader3"));
+  CHECK(!Match("*[13]", "fader2"));
+
+  CHECK(Match("fader[0-9]", "fader5"));
+  CHECK(!Match("fader[0-9]", "faderx"));
+  CHECK(Match("fader[!0-9]", "faderx"));
+  CHECK(!Match("fader[!0-9]", "fader5"));
+
+  CHECK(Match("{fader,knob}1", "knob1"));
+  CHECK(Match("{fader,knob}1", "fader1"));
+  CHECK(!Match("{fader,knob}1", "slider1"));
+  CHECK(Match("{a,ab}c", "abc"));
+
+  // Unterminated lists never match
+  CHECK(!Match("[abc", "a"));
+  CHECK(!Match("{a,b", "a"));
+}
+
+TEST(RejectsInvalidAddresses)
+{
+  OSCDispatcher dispatcher;
+  float value = 0;
+  CHECK(!dispatcher.BindFloat("fader", &value));
+  CHECK(!dispatcher.BindFloat("/a//b", &value));
+  CHECK(!dispatcher.BindFloat("/a/*", &value));
+  CHECK(!dispatcher.BindFloat("/a/{b,c}", &value));
+  CHECK(dispatcher.BindFloat("/a/b", &value));
+}
+
+TEST(PlainAddresses)
+{
+  OSCDispatcher dispatcher;
+  float faders[64] = { 0 };
+  for (int i = 0; i < 64; ++i)
+    CHECK(dispatcher.BindFloat("/1/fader" + std::to_string(i + 1), &faders[i]));
+
+  CHECK(Send(dispatcher, "/1/fader3", 0.5f) == 1);
+  CHECK(faders[2] == 0.5f);
+
+  // Prefixes and extensions of bound addresses aren't bound
+  CHECK(Send(dispatcher, "/1/fader", 1) == 0);
+  CHECK(Send(dispatcher, "/2/fader3", 1) == 0);
+  CHECK(Send(dispatcher, "/1/fader3/x", 1) == 0);
+  CHECK(Send(dispatcher, "/1", 1) == 0);
+  CHECK(faders[2] == 0.5f);
+
+  // Binding again replaces the method
+  float other = 0;
+  CHECK(dispatcher.BindFloat("/1/fader3", &other));
+  CHECK(Send(dispatcher, "/1/fader3", 9) == 1);
+  CHECK(other == 9 && faders[2] == 0.5f);
+}
+
+TEST(PatternsReachEveryMatch)
+{
+  OSCDispatcher dispatcher;
+  float faders[64] = { 0 };
+  for (int i = 0; i < 64; ++i)
+    dispatcher.BindFloat("/1/fader" + std::to_string(i + 1), &faders[i]);
+
+  CHECK(Send(dispatcher, "/1/fader[1-4]", 0.25f) == 4);
+  CHECK(faders[0] == 0.25f && faders[3] == 0.25f && faders[4] == 0);
+
+  CHECK(Send(dispatcher, "/*/fader6?", 0.75f) == 5);
+  CHECK(faders[59] == 0.75f && faders[63] == 0.75f && faders[58] == 0);
+
+  CHECK(Send(dispatcher, "/{1,2}/fader{1,10}", 2) == 2);
+  CHECK(faders[0] == 2 && faders[9] == 2);
+}
+
+TEST(ButtonsFireOnPress)
+{
+  OSCDispatcher dispatcher;
+  bool toggle = false;
+  int presses = 0;
+  dispatcher.BindBool("/1/toggle1", &toggle);
+  dispatcher.BindButton("/1/push1", [&] { ++presses; });
+
+  CHECK(Send(dispatcher, "/1/toggle1", 1) == 1 && toggle);
+  CHECK(Send(dispatcher, "/1/toggle1", 0) == 1 && !toggle);
+
+  // Surfaces send true on press and false on release
+  CHECK(Send(dispatcher, "/1/push1", 1) == 1 && presses == 1);
+  CHECK(Send(dispatcher, "/1/push1", 0) == 1 && presses == 1);
+  CHECK(Send(dispatcher, NoArguments("/1/push1")) == 1 && presses == 2);
+}
+
+TEST(HandlersGetTheArguments)
+{
+  OSCDispatcher dispatcher;
+  float received = 0;
+  dispatcher.Bind("/handler", [&](OSCMessage& message) { message.ReadFloat(received); });
+
+  CHECK(Send(dispatcher, "/handler", 2.5f) == 1);
+  CHECK(received == 2.5f);
+}
+
+TEST(DeferredCallsRunOutsideTheLock)
+{
+  // What OSCReceiver does: dispatch under the binding lock and run the
+  // buttons after letting go of it. This button binds, so it would
+  // deadlock if it ran under the lock.
+  OSCDispatcher dispatcher;
+  std::mutex bindingMutex;
+  int presses = 0;
+  float received = 0;
+
+  dispatcher.BindButton("/bind", [&]
+  {
+    ++presses;
+    std::lock_guard<std::mutex> lock(bindingMutex);
+    dispatcher.BindButton("/other", [] {});
+  });
+  dispatcher.Bind("/handler", [&](OSCMessage& message) { message.ReadFloat(received); });
+
+  std::vector<std::vector<char>> packets =
+  {
+    OSCWriter::Message("/bind", { 1 }),
+    OSCWriter::Message("/handler", { 2.5f }),
+    OSCWriter::Message("/bind", { 0 }),
+  };
+
+  std::vector<OSCDispatcher::Call> calls;
+  for (auto const& packet : packets)
+  {
+    int pressesBefore = presses;
+    {
+      std::lock_guard<std::mutex> lock(bindingMutex);
+      Send(dispatcher, packet, &calls);
+      CHECK(presses == pressesBefore);
+    }
+
+    for (auto& call : calls)
+      call.Run();
+    calls.clear();
+  }
+
+  CHECK(presses == 1);
+  CHECK(received == 2.5f);
+  CHECK(Send(dispatcher, NoArguments("/other")) == 1);
+}
@@ -0,0 +1,140 @@
+#include "Test.h"
+#include "OSCWriter.h"
+#include "../../Alien Isolation/Camera/OSCPacket.h"
+
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST(PlainMessage)
+{
+  std::vector<char> packet = OSCWriter::Message("/position", { 1, 2, 3 });
+
+  int count = 0;
+  bool parsed = ParseOSCPacket(packet.data(), packet.size(), [&](OSCMessage& message)
+  {
+    ++count;
+    CHECK(strcmp(message.GetAddress(), "/position") == 0);
+    CHECK(strcmp(message.GetTypes(), "fff") == 0);
+    CHECK(message.GetTimeTag() == OSCTimeTagImmediately);
+
+    float value = 0;
+    CHECK(message.ReadFloat(value) && value == 1);
+    CHECK(message.ReadFloat(value) && value == 2);
+    CHECK(message.ReadFloat(value) && value == 3);
+    CHECK(!message.HasMoreArguments());
+    CHECK(!message.ReadFloat(value) && value == 3);
+  });
+
+  CHECK(parsed);
+  CHECK(count == 1);
+}
+
+TEST(NestedBundlesKeepTheirTimeTags)
+{
+  std::vector<char> packet = OSCWriter::Bundle(OSCWriter::TimeTag(5), {
+    OSCWriter::Message("/a", { 1 }),
+    OSCWriter::Bundle(OSCWriter::TimeTag(6), { OSCWriter::Message("/b", { 2 }) }),
+    OSCWriter::Message("/c", { 3 }),
+  });
+
+  std::vector<std::string> addresses;
+  std::vector<uint64_t> timeTags;
+  CHECK(ParseOSCPacket(packet.data(), packet.size(), [&](OSCMessage& message)
+  {
+    addresses.push_back(message.GetAddress());
+    timeTags.push_back(message.GetTimeTag());
+  }));
+
+  CHECK(addresses == std::vector<std::string>({ "/a", "/b", "/c" }));
+  CHECK(timeTags == std::vector<uint64_t>({ OSCWriter::TimeTag(5), OSCWriter::TimeTag(6), OSCWriter::TimeTag(5) }));
+  CHECK(OSCTimeTagToSeconds(OSCWriter::TimeTag(5.5)) == 5.5);
+}
+
+TEST(ConvertsArguments)
+{
+  OSCWriter writer;
+  writer.String("/mixed");
+  writer.String(",TFif");
+  writer.Int32(7);
+  writer.Float(0.25f);
+
+  int count = 0;
+  CHECK(ParseOSCPacket(writer.Data.data(), writer.Data.size(), [&](OSCMessage& message)
+  {
+    ++count;
+    bool flag = false;
+    int32_t number = 0;
+    float value = 0;
+    CHECK(message.ReadBool(flag) && flag);
+    CHECK(message.ReadBool(flag) && !flag);
+    CHECK(message.ReadInt32(number) && number == 7);
+    CHECK(message.ReadFloat(value) && value == 0.25f);
+  }));
+  CHECK(count == 1);
+}
+
+TEST(RejectsTruncatedPackets)
+{
+  std::vector<char> packet = OSCWriter::Bundle(7, {
+    OSCWriter::Message("/position", { 1, 2, 3 }),
+    OSCWriter::Message("/rotation", { 0, 0, 0, 1 }),
+  });
+
+  // Cut right after the bundle header or the first element, what's
+  // left is still a valid bundle
+  size_t headerEnd = 16;
+  size_t firstEnd = headerEnd + 4 + OSCWriter::Message("/position", { 1, 2, 3 }).size();
+
+  for (size_t length = 0; length < packet.size(); ++length)
+  {
+    std::vector<char> truncated(packet.begin(), packet.begin() + length);
+    int count = 0;
+    bool parsed = ParseOSCPacket(truncated.data(), truncated.size(), [&](OSCMessage&) { ++count; });
+    CHECK(parsed == (length == headerEnd || length == firstEnd));
+    CHECK(count == (length >= firstEnd ? 1 : 0));
+  }
+}
+
+TEST(MutatedPacketsStayInBounds)
+{
+  // Meant to be run under ASan, every packet gets its own exactly
+  // sized allocation so any read past the end is caught
+  std::mt19937 random(1);
+  std::vector<char> good = OSCWriter::Bundle(7, {
+    OSCWriter::Message("/position", { 1, 2, 3 }),
+    OSCWriter::Bundle(8, { OSCWriter::Message("/rotation", { 0, 0, 0, 1 }) }),
+  });
+
+  int parsed = 0;
+  for (int i = 0; i < 50000; ++i)
+  {
+    std::vector<char> packet = good;
+    int mutations = 1 + random() % 4;
+    for (int j = 0; j < mutations; ++j)
+      packet[random() % packet.size()] = static_cast<char>(random());
+    if (random() % 3 == 0)
+      packet.resize(random() % packet.size());
+
+    std::unique_ptr<char[]> pData(new char[packet.size() + 1]);
+    memcpy(pData.get(), packet.data(), packet.size());
+
+    parsed += ParseOSCPacket(pData.get(), packet.size(), [](OSCMessage& message)
+    {
+      float value;
+      int32_t number;
+      bool flag;
+      while (message.HasMoreArguments())
+      {
+        message.ReadFloat(value);
+        message.ReadInt32(number);
+        message.ReadBool(flag);
+      }
+    });
+  }
+
+  // Some mutations only change values
+  CHECK(parsed > 0);
+}
@@ -0,0 +1,170 @@
+#include "Test.h"
+#include "OSCWriter.h"
+#include "../../Alien Isolation/Camera/OSCPose.h"
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+  void Feed(OSCPoseStream& stream, std::vector<char> const& packet, double receiveTime)
+  {
+    ParseOSCPacket(packet.data(), packet.size(), [&](OSCMessage& message) { stream.HandleMessage(message); });
+    stream.EndPacket(receiveTime);
+  }
+
+  std::vector<char> PoseBundle(uint64_t timeTag, float value)
+  {
+    return OSCWriter::Bundle(timeTag, {
+      OSCWriter::Message("/position", { value, value, value }),
+      OSCWriter::Message("/rotation", { value, value, value, value }),
+    });
+  }
+}
+
+TEST(PublishesWholePacket)
+{
+  std::vector<char> packet = OSCWriter::Bundle(OSCWriter::TimeTag(5), {
+    OSCWriter::Message("/position", { 1, 2, 3 }),
+    OSCWriter::Bundle(OSCWriter::TimeTag(6), { OSCWriter::Message("/rotation", { 0, 0, 0, 1 }) }),
+  });
+
+  OSCPoseStream stream;
+  OSCPose pose;
+
+  // Nothing goes out until the whole datagram has been handled
+  ParseOSCPacket(packet.data(), packet.size(), [&](OSCMessage& message) { CHECK(stream.HandleMessage(message)); });
+  CHECK(!stream.TryLoad(pose));
+
+  stream.EndPacket(1.5);
+  CHECK(stream.TryLoad(pose));
+  CHECK(pose.Position[0] == 1 && pose.Position[1] == 2 && pose.Position[2] == 3);
+  CHECK(pose.Rotation[3] == 1);
+  CHECK(pose.ReceiveTime == 1.5);
+  CHECK(pose.Sequence == 1);
+  CHECK(pose.TimeTag == OSCWriter::TimeTag(6));
+}
+
+TEST(IgnoresIncompleteMessages)
+{
+  OSCPoseStream stream;
+  Feed(stream, OSCWriter::Message("/rotation", { 1, 2 }), 0);
+
+  OSCPose pose;
+  CHECK(!stream.TryLoad(pose));
+
+  // Not part of a pose, left for the dispatcher
+  std::vector<char> other = OSCWriter::Message("/fader", { 1 });
+  ParseOSCPacket(other.data(), other.size(), [&](OSCMessage& message) { CHECK(!stream.HandleMessage(message)); });
+}
+
+TEST(HistoryKeepsTheNewestPoses)
+{
+  OSCPoseStream stream;
+  for (int i = 1; i <= 40; ++i)
+    Feed(stream, PoseBundle(i, static_cast<float>(i)), i);
+
+  OSCPoseHistory history;
+  CHECK(stream.TryLoadHistory(history));
+  CHECK(history.Newest == 40);
+
+  for (uint32_t sequence = 40 - OSCPoseHistory::Size + 1; sequence <= 40; ++sequence)
+  {
+    OSCPose const& pose = history.Poses[sequence % OSCPoseHistory::Size];
+    CHECK(pose.Sequence == sequence);
+    CHECK(pose.ReceiveTime == sequence);
+    CHECK(pose.Position[0] == sequence);
+  }
+}
+
+TEST(LoopbackPosesAreNeverTorn)
+{
+  // Same receive loop as OSCReceiver::ReadData, fed over a real UDP
+  // socket. Every field of pose k is k, so a reader that got parts of
+  // two poses sees different values.
+  int receiveSocket = socket(AF_INET, SOCK_DGRAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  CHECK(bind(receiveSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+
+  socklen_t addressLength = sizeof(address);
+  getsockname(receiveSocket, reinterpret_cast<sockaddr*>(&address), &addressLength);
+
+  int bufferSize = 8 << 20;
+  setsockopt(receiveSocket, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+  timeval timeout = { 0, 100000 };
+  setsockopt(receiveSocket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  OSCPoseStream stream;
+  std::atomic<bool> done(false);
+  std::atomic<long> packets(0);
+
+  std::thread receiver([&]
+  {
+    std::vector<char> buffer(65536);
+    OSCMessageHandler handler = [&](OSCMessage& message) { stream.HandleMessage(message); };
+    while (!done)
+    {
+      ssize_t length = recv(receiveSocket, buffer.data(), buffer.size(), 0);
+      if (length <= 0)
+        continue;
+
+      ParseOSCPacket(buffer.data(), static_cast<size_t>(length), handler);
+      stream.EndPacket(static_cast<double>(packets.load()));
+      ++packets;
+    }
+  });
+
+  std::atomic<long> reads(0), torn(0), backwards(0);
+  std::thread reader([&]
+  {
+    OSCPose pose;
+    uint32_t lastSequence = 0;
+    while (!done)
+    {
+      if (!stream.TryLoad(pose))
+        continue;
+
+      ++reads;
+      float value = pose.Position[0];
+      for (int i = 0; i < 3; ++i)
+        torn += pose.Position[i] != value;
+      for (int i = 0; i < 4; ++i)
+        torn += pose.Rotation[i] != value;
+      torn += pose.TimeTag != static_cast<uint64_t>(value);
+
+      backwards += pose.Sequence < lastSequence;
+      lastSequence = pose.Sequence;
+    }
+  });
+
+  int sendSocket = socket(AF_INET, SOCK_DGRAM, 0);
+  const int bundleCount = 20000;
+  for (int k = 1; k <= bundleCount; ++k)
+  {
+    std::vector<char> packet = PoseBundle(k, static_cast<float>(k));
+    sendto(sendSocket, packet.data(), packet.size(), 0, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+  }
+
+  // Let the receiver catch up before stopping
+  for (int i = 0; i < 100 && packets < bundleCount; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  done = true;
+  receiver.join();
+  reader.join();
+  close(sendSocket);
+  close(receiveSocket);
+
+  CHECK(packets > 0);
+  CHECK(reads > 0);
+  CHECK(torn == 0);
+  CHECK(backwards == 0);
+}
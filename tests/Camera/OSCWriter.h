@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Builds OSC packets the way a sender would, big-endian and padded
+// to four bytes
+class OSCWriter
+{
+public:
+  std::vector<char> Data;
+
+  void Int32(uint32_t value)
+  {
+    for (int i = 3; i >= 0; --i)
+      Data.push_back(static_cast<char>(value >> (i * 8)));
+  }
+
+  void Float(float value)
+  {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    Int32(bits);
+  }
+
+  void String(const char* value)
+  {
+    Data.insert(Data.end(), value, value + strlen(value) + 1);
+    while (Data.size() % 4)
+      Data.push_back(0);
+  }
+
+  static std::vector<char> Message(const char* address, std::vector<float> const& values)
+  {
+    OSCWriter writer;
+    writer.String(address);
+    writer.String((std::string(",") + std::string(values.size(), 'f')).c_str());
+    for (float value : values)
+      writer.Float(value);
+    return writer.Data;
+  }
+
+  static std::vector<char> Bundle(uint64_t timeTag, std::vector<std::vector<char>> const& elements)
+  {
+    OSCWriter writer;
+    writer.String("#bundle");
+    writer.Int32(static_cast<uint32_t>(timeTag >> 32));
+    writer.Int32(static_cast<uint32_t>(timeTag));
+    for (auto const& element : elements)
+    {
+      writer.Int32(static_cast<uint32_t>(element.size()));
+      writer.Data.insert(writer.Data.end(), element.begin(), element.end());
+    }
+    return writer.Data;
+  }
+
+  // Seconds since 1900 as a time tag
+  static uint64_t TimeTag(double seconds)
+  {
+    return static_cast<uint64_t>(seconds * 4294967296.0);
+  }
+};
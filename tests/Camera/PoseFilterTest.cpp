@@ -0,0 +1,270 @@
+#include "Test.h"
+#include "../../Alien Isolation/Camera/PoseFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+  const double Pi = 3.14159265358979323846;
+
+  // Handheld-like motion the recorded streams are made of
+  void Truth(double t, float* pPosition, float* pRotation)
+  {
+    pPosition[0] = float(0.5 * std::sin(1.3 * t) + 0.05 * std::sin(7.1 * t));
+    pPosition[1] = float(0.2 * std::sin(0.7 * t + 1));
+    pPosition[2] = float(0.3 * t + 0.1 * std::cos(2.3 * t));
+
+    // Yaw about y, then pitch about x
+    double yaw = 0.8 * std::sin(0.9 * t);
+    double pitch = 0.2 * std::sin(1.7 * t);
+    double cy = std::cos(yaw / 2), sy = std::sin(yaw / 2);
+    double cp = std::cos(pitch / 2), sp = std::sin(pitch / 2);
+    pRotation[0] = float(cy * sp);
+    pRotation[1] = float(sy * cp);
+    pRotation[2] = float(-sy * sp);
+    pRotation[3] = float(cy * cp);
+  }
+
+  struct Received
+  {
+    double SentTime;
+    double ReceiveTime;
+    PoseSample Pose;
+  };
+
+  // A 250 Hz stream with 4 ms base latency, exponential jitter, sensor
+  // noise and 2% loss, in the order it arrives. The sender clock is
+  // somewhere else entirely. Only uses mt19937 directly, so the stream
+  // is the same with every standard library.
+  std::vector<Received> Record(double jitter, double noise, unsigned int seed)
+  {
+    std::mt19937 rng(seed);
+    auto uniform = [&] { return (rng() + 0.5) / 4294967296.0; };
+    auto gaussian = [&] { return std::sqrt(-2 * std::log(uniform())) * std::cos(2 * Pi * uniform()); };
+
+    const double clockOffset = 1234.5;
+    std::vector<Received> stream;
+    for (int i = 0; i < 20 * 250; ++i)
+    {
+      double t = i / 250.0;
+      if (uniform() < 0.02)
+        continue;
+
+      Received received;
+      received.SentTime = t + clockOffset;
+      received.ReceiveTime = t + 0.004 - jitter * std::log(uniform());
+      Truth(t, received.Pose.Position, received.Pose.Rotation);
+      for (float& p : received.Pose.Position)
+        p += float(gaussian() * noise);
+      received.Pose.Rotation[0] += float(gaussian() * noise * 0.5);
+      stream.push_back(received);
+    }
+
+    std::stable_sort(stream.begin(), stream.end(), [](Received const& a, Received const& b)
+    {
+      return a.ReceiveTime < b.ReceiveTime;
+    });
+    return stream;
+  }
+
+  struct Error
+  {
+    double Position; // RMS, mm
+    double Angle;    // RMS, degrees
+    double Step;     // RMS second difference of the position, mm
+  };
+
+  // Replays a stream at 60 fps. With time tags the sender time is mapped
+  // onto the local clock, otherwise samples are stamped on arrival.
+  // lastOnly is what the receiver did before: use the newest sample.
+  Error Replay(std::vector<Received> const& stream, PoseFilterSettings const& settings, bool useTimeTags, bool lastOnly)
+  {
+    PoseFilter filter(settings);
+    ClockOffsetEstimator clock;
+    PoseSample last;
+    size_t next = 0;
+
+    double position = 0, angle = 0, step = 0;
+    float previous[2][3] = { { 0 } };
+    int frames = 0;
+
+    for (double now = 1; now < 19.5; now += 1.0 / 60)
+    {
+      while (next < stream.size() && stream[next].ReceiveTime <= now)
+      {
+        Received const& received = stream[next++];
+        PoseSample sample = received.Pose;
+        sample.Time = useTimeTags ? clock.ToLocal(received.SentTime, received.ReceiveTime) : received.ReceiveTime;
+        filter.AddSample(sample);
+        last = sample;
+      }
+
+      PoseSample out = last;
+      if (!lastOnly)
+        CHECK(filter.Evaluate(now, out));
+
+      // The best anything can do is the pose as of the base latency ago
+      float truePosition[3], trueRotation[4];
+      Truth(now - 0.004, truePosition, trueRotation);
+
+      for (int i = 0; i < 3; ++i)
+        position += (out.Position[i] - truePosition[i]) * (out.Position[i] - truePosition[i]);
+
+      double dot = 0;
+      for (int i = 0; i < 4; ++i)
+        dot += out.Rotation[i] * trueRotation[i];
+      double a = 2 * std::acos(std::min(1.0, std::fabs(dot)));
+      angle += a * a;
+
+      if (frames >= 2)
+      {
+        for (int i = 0; i < 3; ++i)
+        {
+          double acceleration = out.Position[i] - 2 * previous[0][i] + previous[1][i];
+          step += acceleration * acceleration;
+        }
+      }
+
+      for (int i = 0; i < 3; ++i)
+      {
+        previous[1][i] = previous[0][i];
+        previous[0][i] = out.Position[i];
+      }
+      frames++;
+    }
+
+    return { std::sqrt(position / frames) * 1000, std::sqrt(angle / frames) * 180 / Pi, std::sqrt(step / (frames - 2)) * 1000 };
+  }
+}
+
+TEST(InterpolatesAndPredicts)
+{
+  PoseFilterSettings settings;
+  settings.Prediction = PosePrediction_ConstantVelocity;
+  PoseFilter filter(settings);
+
+  PoseSample out;
+  CHECK(!filter.Evaluate(1, out));
+
+  // 90 degrees about y over one second
+  PoseSample a, b;
+  a.Time = 1;
+  b.Time = 2;
+  b.Position[0] = 10;
+  b.Rotation[1] = b.Rotation[3] = std::sqrt(0.5f);
+  filter.AddSample(a);
+  filter.AddSample(b);
+
+  CHECK(filter.Evaluate(1.5, out));
+  CHECK_NEAR(out.Position[0], 5, 1e-5);
+  CHECK_NEAR(out.Rotation[1], std::sin(Pi / 8), 1e-5);
+
+  CHECK(filter.Evaluate(0, out));
+  CHECK(out.Position[0] == 0);
+
+  CHECK(filter.Evaluate(2.05, out));
+  CHECK_NEAR(out.Position[0], 10.5, 1e-4);
+  CHECK_NEAR(out.Rotation[1], std::sin(Pi / 2 * 1.05 / 2), 1e-4);
+
+  // Prediction stops at MaxPrediction
+  CHECK(filter.Evaluate(3, out));
+  CHECK_NEAR(out.Position[0], 11, 1e-4);
+
+  // Samples older than the newest one are dropped
+  filter.AddSample(a);
+  CHECK(filter.Evaluate(1.5, out));
+  CHECK_NEAR(out.Position[0], 5, 1e-5);
+
+  settings.Prediction = PosePrediction_None;
+  filter.SetSettings(settings);
+  CHECK(filter.Evaluate(2.05, out));
+  CHECK(out.Position[0] == 10);
+}
+
+TEST(KalmanFindsTheVelocity)
+{
+  PoseFilterSettings settings;
+  settings.Prediction = PosePrediction_Kalman;
+  PoseFilter filter(settings);
+
+  PoseSample sample;
+  for (int i = 0; i < 500; ++i)
+  {
+    sample.Time = i / 250.0;
+    sample.Position[0] = float(2 * sample.Time);
+    filter.AddSample(sample);
+  }
+
+  PoseSample out;
+  CHECK(filter.Evaluate(sample.Time + 0.05, out));
+  CHECK_NEAR(out.Position[0], 2 * sample.Time + 0.1, 1e-3);
+}
+
+TEST(BufferWraps)
+{
+  PoseFilter filter;
+  PoseSample sample;
+  for (int i = 0; i < 1000; ++i)
+  {
+    sample.Time = i;
+    sample.Position[0] = float(i);
+    filter.AddSample(sample);
+  }
+
+  PoseSample out;
+  CHECK(filter.Evaluate(998.5, out));
+  CHECK_NEAR(out.Position[0], 998.5, 1e-3);
+
+  // Older than anything buffered holds the oldest sample
+  CHECK(filter.Evaluate(0, out));
+  CHECK(out.Position[0] == 1000 - PoseFilter::BufferSize);
+}
+
+TEST(ClockOffsetFollowsTheFastestPacket)
+{
+  ClockOffsetEstimator clock;
+  CHECK_NEAR(clock.ToLocal(100, 5.010), 5.010, 1e-9);
+  CHECK_NEAR(clock.ToLocal(100.004, 5.012), 5.012, 1e-9);
+
+  // Arrived 14 ms late, placed 4 ms after the previous one
+  CHECK_NEAR(clock.ToLocal(100.008, 5.030), 5.016, 1e-4);
+}
+
+TEST(BeatsTheNewestSampleOnRecordedStreams)
+{
+  PoseFilterSettings none;
+  none.Prediction = PosePrediction_None;
+  PoseFilterSettings constantVelocity;
+  constantVelocity.Prediction = PosePrediction_ConstantVelocity;
+  PoseFilterSettings kalman;
+  kalman.Prediction = PosePrediction_Kalman;
+
+  for (double jitter : { 0.002, 0.008 })
+  {
+    std::vector<Received> stream = Record(jitter, 0.0005, 7);
+
+    Error newest = Replay(stream, none, false, true);
+    Error cv = Replay(stream, constantVelocity, true, false);
+    Error filtered = Replay(stream, kalman, true, false);
+
+    CHECK(cv.Position < newest.Position);
+    CHECK(filtered.Position < newest.Position);
+    CHECK(filtered.Angle < newest.Angle);
+    CHECK(filtered.Step < newest.Step);
+  }
+}
+
+TEST(ReplayIsDeterministic)
+{
+  std::vector<Received> stream = Record(0.008, 0.0005, 7);
+  PoseFilterSettings kalman;
+  kalman.Prediction = PosePrediction_Kalman;
+
+  Error a = Replay(stream, kalman, true, false);
+  Error b = Replay(stream, kalman, true, false);
+  CHECK(a.Position == b.Position);
+  CHECK(a.Step == b.Step);
+}
@@ -0,0 +1,177 @@
+#include "Test.h"
+#include "Takes.h"
+#include "../../Alien Isolation/Camera/TakeRecorder.h"
+
+#include <cmath>
+#include <thread>
+
+using namespace takes;
+
+TEST(KeepsShortTakes)
+{
+  TakeTolerance tolerance;
+  CHECK(ReduceTake(nullptr, 0, tolerance).empty());
+
+  std::vector<TakeSample> take = Record(1, 60, 1, 1, false);
+  std::vector<size_t> one = ReduceTake(take.data(), 1, tolerance);
+  CHECK(one.size() == 1 && one[0] == 0);
+
+  std::vector<size_t> two = ReduceTake(take.data(), 2, tolerance);
+  CHECK(two.size() == 2 && two[0] == 0 && two[1] == 1);
+}
+
+TEST(ConstantVelocityNeedsTwoNodes)
+{
+  // The eased ends of the time curve cancel the eased ends of the path
+  std::vector<TakeSample> take;
+  for (int i = 0; i <= 600; ++i)
+  {
+    float t = i / 60.f;
+    TakeSample sample = { t, { 1 + 2 * t, 5 - t, 0.5f * t, 0, 0, 0, 1, 50, 2, 1, 0.04f } };
+    take.push_back(sample);
+  }
+
+  TakeError error;
+  std::vector<size_t> kept = ReduceTake(take.data(), take.size(), TakeTolerance(), &error);
+  CHECK(kept.size() == 2);
+  CHECK(error.Position < 0.001f);
+}
+
+TEST(StaysWithinTolerance)
+{
+  for (unsigned int seed = 1; seed <= 5; ++seed)
+  {
+    std::vector<TakeSample> take = Record(30, 60, seed, 1 + seed % 2, seed % 2 == 0);
+    TakeTolerance tolerance;
+    TakeError reported;
+    std::vector<size_t> kept = ReduceTake(take.data(), take.size(), tolerance, &reported);
+
+    CHECK(kept.front() == 0 && kept.back() == take.size() - 1);
+    for (size_t i = 1; i < kept.size(); ++i)
+      CHECK(kept[i] > kept[i - 1]);
+    CHECK(kept.size() < take.size() / 2);
+
+    // The reference looks mu up in a table instead of solving for it
+    TakeError measured = Measure(take, kept);
+    CHECK(measured.Position <= tolerance.Position * 1.02f);
+    CHECK(measured.Rotation <= tolerance.Rotation * 1.02f);
+    CHECK(measured.FieldOfView <= tolerance.FieldOfView * 1.02f);
+    CHECK(measured.DepthOfField <= tolerance.DepthOfField * 1.02f);
+
+    CHECK(reported.Position <= tolerance.Position);
+    CHECK(reported.Rotation <= tolerance.Rotation);
+    CHECK_NEAR(reported.Position, measured.Position, 0.001f);
+  }
+}
+
+TEST(EasedTimeNeverRunsBackwards)
+{
+  for (unsigned int seed = 1; seed <= 5; ++seed)
+  {
+    std::vector<TakeSample> take = Record(30, 60, seed, 1 + seed % 2, seed % 2 == 0);
+    std::vector<size_t> kept = ReduceTake(take.data(), take.size(), TakeTolerance());
+
+    for (size_t segment = 0; segment + 1 < kept.size(); ++segment)
+    {
+      size_t ids[4];
+      SegmentNodes(kept, segment, ids);
+
+      double previous = take[ids[1]].Time;
+      bool monotonic = true;
+      for (int i = 1; i <= 256; ++i)
+      {
+        double t = CatmullRom(take[ids[0]].Time, take[ids[1]].Time, take[ids[2]].Time, take[ids[3]].Time, i / 256.0);
+        monotonic &= t >= previous - 1e-6;
+        previous = t;
+      }
+      CHECK(monotonic);
+    }
+  }
+}
+
+TEST(TighterToleranceKeepsMore)
+{
+  std::vector<TakeSample> take = Record(20, 60, 7, 2, false);
+  size_t previous = 0;
+  for (float position : { 0.1f, 0.03f, 0.01f, 0.003f, 0.001f })
+  {
+    TakeTolerance tolerance;
+    tolerance.Position = position;
+    tolerance.Rotation = position * 10;
+    size_t count = ReduceTake(take.data(), take.size(), tolerance).size();
+    CHECK(count >= previous);
+    previous = count;
+  }
+
+  TakeTolerance zero;
+  zero.Position = zero.Rotation = zero.FieldOfView = zero.DepthOfField = 0;
+  TakeError error;
+  ReduceTake(take.data(), take.size(), zero, &error);
+  CHECK(error.Position < 1e-4f);
+}
+
+TEST(RecorderHandsOutOneResult)
+{
+  TakeRecorder recorder(100);
+  ReducedTake result;
+  CHECK(!recorder.IsRecording());
+  CHECK(!recorder.Stop(TakeTolerance()));
+  CHECK(!recorder.TryGetResult(result));
+
+  float values[TrackChannel_Count] = { 0, 0, 0, 0, 0, 0, 1, 50, 2, 1, 0.04f };
+  CHECK(recorder.Start());
+  recorder.AddFrame(0.016f, values);
+  CHECK(!recorder.Stop(TakeTolerance())); // Too short
+  CHECK(!recorder.IsRecording());
+
+  // Frames without time passing are dropped, rotations are flipped
+  // into one hemisphere
+  CHECK(recorder.Start());
+  for (int i = 0; i < 150; ++i)
+  {
+    float angle = i * 0.01f;
+    float sign = i % 2 ? -1.f : 1.f;
+    values[0] = float(i);
+    values[TrackChannel_RotationY] = std::sin(angle / 2) * sign;
+    values[TrackChannel_RotationW] = std::cos(angle / 2) * sign;
+    recorder.AddFrame(i == 5 ? 0.f : 0.01f, values);
+  }
+  CHECK(recorder.IsFull());
+  CHECK(recorder.Stop(TakeTolerance()));
+  CHECK(!recorder.IsRecording());
+
+  while (recorder.IsReducing())
+    std::this_thread::yield();
+
+  CHECK(recorder.TryGetResult(result));
+  CHECK(!recorder.TryGetResult(result));
+  CHECK(result.SampleCount == 100);
+  CHECK_NEAR(result.Duration, 0.99f, 1e-4f);
+  CHECK(result.Nodes.front().Values[0] == 0);
+  CHECK(result.Nodes.back().Values[0] == 100); // Frame 5 was dropped
+  for (auto const& node : result.Nodes)
+    CHECK(node.Values[TrackChannel_RotationW] > 0);
+  CHECK(result.Error.Rotation <= TakeTolerance().Rotation);
+}
+
+TEST(RecorderWaitsForTheReduction)
+{
+  std::vector<TakeSample> take = Record(300, 200, 3, 3, true);
+  TakeRecorder recorder(take.size());
+  CHECK(recorder.Start());
+  for (size_t i = 0; i < take.size(); ++i)
+    recorder.AddFrame(i ? take[i].Time - take[i - 1].Time : 0, take[i].Values);
+
+  TakeTolerance tolerance;
+  tolerance.Position = 0.0005f;
+  CHECK(recorder.Stop(tolerance));
+  CHECK(!recorder.Start() || !recorder.IsReducing());
+
+  while (recorder.IsReducing())
+    std::this_thread::yield();
+
+  ReducedTake result;
+  CHECK(recorder.TryGetResult(result));
+  CHECK(recorder.Start());
+  CHECK(recorder.IsRecording());
+}
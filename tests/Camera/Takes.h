@@ -0,0 +1,222 @@
+#pragma once
+#include "../../Alien Isolation/Camera/TakeReducer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Recorded takes and an independent double precision reference of how
+// tracks play them back, for the take reducer tests and benchmark
+namespace takes
+{
+  inline double CatmullRom(double y0, double y1, double y2, double y3, double mu)
+  {
+    double mu2 = mu * mu;
+    double a0 = -0.5 * y0 + 1.5 * y1 - 1.5 * y2 + 0.5 * y3;
+    double a1 = y0 - 2.5 * y1 + 2 * y2 - 0.5 * y3;
+    double a2 = -0.5 * y0 + 0.5 * y2;
+    return a0 * mu * mu2 + a1 * mu2 + a2 * mu + y1;
+  }
+
+  inline void EulerToQuaternion(double yaw, double pitch, double roll, float* q)
+  {
+    double cy = std::cos(yaw / 2), sy = std::sin(yaw / 2);
+    double cp = std::cos(pitch / 2), sp = std::sin(pitch / 2);
+    double cr = std::cos(roll / 2), sr = std::sin(roll / 2);
+    q[0] = float(cy * sp * cr + sy * cp * sr);
+    q[1] = float(sy * cp * cr - cy * sp * sr);
+    q[2] = float(cy * cp * sr - sy * sp * cr);
+    q[3] = float(cy * cp * cr + sy * sp * sr);
+  }
+
+  // A smooth move with low-passed shake on top and a zoom in the middle.
+  // Frame times vary by 20% with jitterFrames.
+  inline std::vector<TakeSample> Record(double seconds, double fps, unsigned int seed, double shake, bool jitterFrames)
+  {
+    std::mt19937 rng(seed);
+    std::normal_distribution<double> noise(0, 1);
+    std::uniform_real_distribution<double> frameJitter(0.8, 1.2);
+
+    std::vector<TakeSample> take;
+    double shakes[5] = { 0 };
+    float previous[4] = { 0, 0, 0, 1 };
+
+    for (double t = 0; t <= seconds; t += (jitterFrames ? frameJitter(rng) : 1) / fps)
+    {
+      for (double& s : shakes)
+        s += 0.05 * (noise(rng) - s);
+
+      TakeSample sample;
+      sample.Time = float(t);
+      sample.Values[TrackChannel_PositionX] = float(3 * std::sin(0.3 * t) + 0.5 * t + shake * shakes[0] * 0.02);
+      sample.Values[TrackChannel_PositionY] = float(1.7 + 0.2 * std::sin(1.1 * t) + shake * shakes[1] * 0.02);
+      sample.Values[TrackChannel_PositionZ] = float(2 * std::cos(0.2 * t) + shake * shakes[2] * 0.02);
+
+      float* q = &sample.Values[TrackChannel_RotationX];
+      EulerToQuaternion(0.4 * t + shake * shakes[3] * 0.01, 0.2 * std::sin(0.5 * t) + shake * shakes[4] * 0.01, 0.05 * std::sin(0.7 * t), q);
+
+      // Same hemisphere as the frame before, like TakeRecorder does
+      float dot = 0;
+      for (int i = 0; i < 4; ++i)
+        dot += previous[i] * q[i];
+      for (int i = 0; i < 4; ++i)
+        previous[i] = q[i] = dot < 0 ? -q[i] : q[i];
+
+      sample.Values[TrackChannel_FieldOfView] = float(t < 10 ? 50 : (t < 14 ? 50 - (t - 10) * 5 : 30));
+      sample.Values[TrackChannel_FocusDistance] = 2;
+      sample.Values[TrackChannel_DofScale] = 1;
+      sample.Values[TrackChannel_DofStrength] = 0.04f;
+      take.push_back(sample);
+    }
+
+    return take;
+  }
+
+  // Quaternions are x y z w, Hamilton product
+  inline void Multiply(double const* a, double const* b, double* r)
+  {
+    r[0] = a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1];
+    r[1] = a[3] * b[1] - a[0] * b[2] + a[1] * b[3] + a[2] * b[0];
+    r[2] = a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + a[2] * b[3];
+    r[3] = a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2];
+  }
+
+  inline void Log(double const* q, double* r)
+  {
+    double s = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2]);
+    double k = s > 1e-15 ? std::atan2(s, q[3]) / s : 1;
+    for (int i = 0; i < 3; ++i)
+      r[i] = q[i] * k;
+    r[3] = 0;
+  }
+
+  inline void Exp(double const* v, double* r)
+  {
+    double a = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    double k = a > 1e-15 ? std::sin(a) / a : 1;
+    for (int i = 0; i < 3; ++i)
+      r[i] = v[i] * k;
+    r[3] = std::cos(a);
+  }
+
+  inline void Slerp(double const* a, double const* b, double t, double* r)
+  {
+    double dot = 0;
+    for (int i = 0; i < 4; ++i)
+      dot += a[i] * b[i];
+    double sign = dot < 0 ? -1 : 1;
+    double omega = std::acos(std::min(1.0, dot * sign));
+
+    double wa = 1 - t, wb = t;
+    if (omega > 1e-9)
+    {
+      wa = std::sin((1 - t) * omega) / std::sin(omega);
+      wb = std::sin(t * omega) / std::sin(omega);
+    }
+
+    for (int i = 0; i < 4; ++i)
+      r[i] = wa * a[i] + wb * sign * b[i];
+  }
+
+  // SQUAD control point of q between p and next
+  inline void Control(double const* p, double const* q, double const* next, double* r)
+  {
+    double inverse[4] = { -q[0], -q[1], -q[2], q[3] };
+    double m[4], toNext[4], toPrevious[4], e[4], tangent[4];
+    Multiply(inverse, next, m);
+    Log(m, toNext);
+    Multiply(inverse, p, m);
+    Log(m, toPrevious);
+    for (int i = 0; i < 3; ++i)
+      tangent[i] = -(toNext[i] + toPrevious[i]) / 4;
+    tangent[3] = 0;
+    Exp(tangent, e);
+    Multiply(q, e, r);
+  }
+
+  inline void Squad(double q[4][4], double mu, double* r)
+  {
+    double s1[4], s2[4], a[4], b[4];
+    Control(q[0], q[1], q[2], s1);
+    Control(q[1], q[2], q[3], s2);
+    Slerp(q[1], q[2], mu, a);
+    Slerp(s1, s2, mu, b);
+    Slerp(a, b, 2 * mu * (1 - mu), r);
+  }
+
+  // Neighbours of segment i of the kept nodes, ends repeated
+  inline void SegmentNodes(std::vector<size_t> const& kept, size_t i, size_t* ids)
+  {
+    ids[0] = kept[i > 0 ? i - 1 : i];
+    ids[1] = kept[i];
+    ids[2] = kept[i + 1];
+    ids[3] = kept[i + 2 < kept.size() ? i + 2 : i + 1];
+  }
+
+  // Largest difference between the take and the track made of the kept
+  // samples played at eased timing. Mu is looked up in a dense table of
+  // the time curve instead of solved for.
+  inline TakeError Measure(std::vector<TakeSample> const& take, std::vector<size_t> const& kept)
+  {
+    TakeError error;
+    const int tableSize = 8192;
+    std::vector<double> table(tableSize + 1);
+
+    for (size_t segment = 0; segment + 1 < kept.size(); ++segment)
+    {
+      size_t ids[4];
+      SegmentNodes(kept, segment, ids);
+      TakeSample const* n[4] = { &take[ids[0]], &take[ids[1]], &take[ids[2]], &take[ids[3]] };
+
+      for (int i = 0; i <= tableSize; ++i)
+        table[i] = CatmullRom(n[0]->Time, n[1]->Time, n[2]->Time, n[3]->Time, double(i) / tableSize);
+
+      for (size_t j = kept[segment] + 1; j < kept[segment + 1]; ++j)
+      {
+        double t = take[j].Time;
+        size_t k = std::upper_bound(table.begin() + 1, table.end() - 1, t) - table.begin();
+        double f = (t - table[k - 1]) / (table[k] - table[k - 1]);
+        double mu = (k - 1 + std::max(0.0, std::min(1.0, f))) / tableSize;
+
+        double v[TrackChannel_Count];
+        for (int c = 0; c < TrackChannel_Count; ++c)
+          v[c] = CatmullRom(n[0]->Values[c], n[1]->Values[c], n[2]->Values[c], n[3]->Values[c], mu);
+
+        double q[4][4];
+        for (int a = 0; a < 4; ++a)
+        {
+          float const* r = &n[a]->Values[TrackChannel_RotationX];
+          double length = std::sqrt(double(r[0]) * r[0] + double(r[1]) * r[1] + double(r[2]) * r[2] + double(r[3]) * r[3]);
+          for (int c = 0; c < 4; ++c)
+            q[a][c] = r[c] / length;
+        }
+        Squad(q, mu, &v[TrackChannel_RotationX]);
+
+        float const* r = take[j].Values;
+        double dx = v[0] - r[0], dy = v[1] - r[1], dz = v[2] - r[2];
+        error.Position = std::max(error.Position, float(std::sqrt(dx * dx + dy * dy + dz * dz)));
+
+        // Angle from the chord, acos of the dot product is too noisy
+        // at these angles
+        double length = 0, dot = 0, chord = 0;
+        for (int c = TrackChannel_RotationX; c <= TrackChannel_RotationW; ++c)
+        {
+          length += double(r[c]) * r[c];
+          dot += v[c] * r[c];
+        }
+        length = std::sqrt(length);
+        double sign = dot < 0 ? -1 : 1;
+        for (int c = TrackChannel_RotationX; c <= TrackChannel_RotationW; ++c)
+          chord += (v[c] - sign * r[c] / length) * (v[c] - sign * r[c] / length);
+        error.Rotation = std::max(error.Rotation, float(4 * std::asin(std::min(1.0, std::sqrt(chord) / 2)) * 57.29577951308232));
+
+        error.FieldOfView = std::max(error.FieldOfView, float(std::fabs(v[TrackChannel_FieldOfView] - r[TrackChannel_FieldOfView])));
+        for (int c = TrackChannel_FocusDistance; c <= TrackChannel_DofStrength; ++c)
+          error.DepthOfField = std::max(error.DepthOfField, float(std::fabs(v[c] - r[c])));
+      }
+    }
+
+    return error;
+  }
+}
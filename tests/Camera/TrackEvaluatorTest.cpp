@@ -0,0 +1,198 @@
+#include "Test.h"
+#include "../../Alien Isolation/Camera/TrackEvaluator.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+  // Scalar version of the kernel, the same as util::math::CatmullRomInterpolate
+  float CatmullRom(float y0, float y1, float y2, float y3, float mu)
+  {
+    float mu2 = mu * mu;
+    float a0 = -0.5f * y0 + 1.5f * y1 - 1.5f * y2 + 0.5f * y3;
+    float a1 = y0 - 2.5f * y1 + 2.f * y2 - 0.5f * y3;
+    float a2 = -0.5f * y0 + 0.5f * y2;
+    return a0 * mu * mu2 + a1 * mu2 + a2 * mu + y1;
+  }
+
+  struct Track
+  {
+    TrackEvaluator Evaluator;
+    std::vector<float> Times;
+    std::vector<std::vector<float>> Values;
+
+    void Add(float time, std::vector<float> const& values)
+    {
+      Times.push_back(time);
+      Values.push_back(values);
+      Evaluator.AddNode(time, values.data());
+    }
+
+    // Reference value of a channel, clamped to the ends like Evaluate
+    float Reference(float time, int channel) const
+    {
+      int last = static_cast<int>(Times.size()) - 1;
+      int segment = 0;
+      while (segment < last - 1 && time >= Times[segment + 1])
+        ++segment;
+
+      float mu = (time - Times[segment]) / (Times[segment + 1] - Times[segment]);
+      mu = std::fmax(0.f, std::fmin(1.f, mu));
+
+      int n0 = segment > 0 ? segment - 1 : segment;
+      int n3 = segment + 1 < last ? segment + 2 : segment + 1;
+      return CatmullRom(Values[n0][channel], Values[segment][channel],
+        Values[segment + 1][channel], Values[n3][channel], mu);
+    }
+  };
+
+  Track MakeTrack(int nodeCount)
+  {
+    Track track;
+    for (int i = 0; i < nodeCount; ++i)
+    {
+      std::vector<float> values(TrackChannel_Count);
+      for (int c = 0; c < TrackChannel_Count; ++c)
+        values[c] = std::sin(i * 0.3f + c);
+
+      // Uneven spacing so segments have different lengths
+      track.Add(i * 2.f + (i % 3) * 0.5f, values);
+    }
+    return track;
+  }
+
+  bool IsRotation(int channel)
+  {
+    return channel >= TrackChannel_RotationX && channel <= TrackChannel_RotationW;
+  }
+}
+
+TEST(MatchesScalarCatmullRom)
+{
+  Track track = MakeTrack(40);
+
+  // Not a multiple of four, so the last batch has unused lanes
+  std::vector<float> times;
+  for (float t = -1.f; t < track.Times.back() + 1.f; t += 0.037f)
+    times.push_back(t);
+  CHECK(times.size() % 4 != 0);
+
+  TrackSamples samples;
+  track.Evaluator.Evaluate(times.data(), times.size(), samples);
+  CHECK(samples.Count == times.size());
+
+  for (size_t i = 0; i < times.size(); ++i)
+  {
+    for (int c = 0; c < TrackChannel_Count; ++c)
+    {
+      if (!IsRotation(c))
+        CHECK_NEAR(samples.Channels[c][i], track.Reference(times[i], c), 1e-4);
+    }
+  }
+}
+
+TEST(NormalizesRotation)
+{
+  Track track = MakeTrack(10);
+
+  std::vector<float> times;
+  for (float t = 0; t < track.Times.back(); t += 0.1f)
+    times.push_back(t);
+
+  TrackSamples samples;
+  track.Evaluator.Evaluate(times.data(), times.size(), samples);
+
+  for (size_t i = 0; i < times.size(); ++i)
+  {
+    float reference[4];
+    float lengthSq = 0;
+    for (int c = 0; c < 4; ++c)
+    {
+      reference[c] = track.Reference(times[i], TrackChannel_RotationX + c);
+      lengthSq += reference[c] * reference[c];
+    }
+
+    for (int c = 0; c < 4; ++c)
+      CHECK_NEAR(samples.Channels[TrackChannel_RotationX + c][i], reference[c] / std::sqrt(lengthSq), 1e-4);
+  }
+}
+
+TEST(ClampsToTheEnds)
+{
+  Track track = MakeTrack(5);
+
+  float times[] = { -100.f, track.Times.front(), track.Times.back(), 1000.f };
+  TrackSamples samples;
+  track.Evaluator.Evaluate(times, 4, samples);
+
+  for (int c = 0; c < TrackChannel_Count; ++c)
+  {
+    if (IsRotation(c)) continue;
+    CHECK_NEAR(samples.Channels[c][0], track.Values.front()[c], 1e-5);
+    CHECK_NEAR(samples.Channels[c][1], track.Values.front()[c], 1e-5);
+    CHECK_NEAR(samples.Channels[c][2], track.Values.back()[c], 1e-5);
+    CHECK_NEAR(samples.Channels[c][3], track.Values.back()[c], 1e-5);
+  }
+}
+
+TEST(UnsortedTimesMatchSorted)
+{
+  Track track = MakeTrack(60);
+
+  std::vector<float> sorted;
+  for (float t = 0; t < track.Times.back(); t += 0.25f)
+    sorted.push_back(t);
+
+  // Same timestamps, visited in a scrambled order
+  std::vector<float> shuffled(sorted.size());
+  for (size_t i = 0; i < sorted.size(); ++i)
+    shuffled[i] = sorted[(i * 7919) % sorted.size()];
+
+  TrackSamples sortedSamples, shuffledSamples;
+  track.Evaluator.Evaluate(sorted.data(), sorted.size(), sortedSamples);
+  track.Evaluator.Evaluate(shuffled.data(), shuffled.size(), shuffledSamples);
+
+  for (size_t i = 0; i < sorted.size(); ++i)
+  {
+    size_t j = (i * 7919) % sorted.size();
+    for (int c = 0; c < TrackChannel_Count; ++c)
+      CHECK(shuffledSamples.Channels[c][i] == sortedSamples.Channels[c][j]);
+  }
+}
+
+TEST(SingleAndNoNodes)
+{
+  TrackEvaluator evaluator;
+  float times[] = { -1.f, 0.f, 3.f };
+
+  TrackSamples samples;
+  evaluator.Evaluate(times, 3, samples);
+  for (int c = 0; c < TrackChannel_Count; ++c)
+    CHECK(samples.Channels[c][0] == 0 && samples.Channels[c][2] == 0);
+
+  float values[TrackChannel_Count] = { 1, 2, 3, 0, 0, 0, 1, 60, 5, 6, 7 };
+  evaluator.AddNode(0.f, values);
+  evaluator.Evaluate(times, 3, samples);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    for (int c = 0; c < TrackChannel_Count; ++c)
+      CHECK(samples.Channels[c][i] == values[c]);
+  }
+}
+
+TEST(RemoveLastNode)
+{
+  Track track = MakeTrack(6);
+  track.Evaluator.RemoveLastNode();
+  track.Times.pop_back();
+  track.Values.pop_back();
+
+  CHECK(track.Evaluator.GetNodeCount() == 5);
+  CHECK(track.Evaluator.GetEndTime() == track.Times.back());
+
+  float time = track.Times.back() - 0.5f;
+  TrackSamples samples;
+  track.Evaluator.Evaluate(&time, 1, samples);
+  CHECK_NEAR(samples.Channels[TrackChannel_FieldOfView][0], track.Reference(time, TrackChannel_FieldOfView), 1e-4);
+}
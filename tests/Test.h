@@ -0,0 +1,32 @@
+#pragma once
+#include <cmath>
+#include <cstdio>
+
+// Just enough of a test framework for the tests in this directory.
+// TEST functions register themselves and TestMain.cpp runs them all,
+// a failed CHECK reports and carries on with the rest of the test.
+namespace test
+{
+  typedef void(*TestFunc)();
+
+  struct Registrar
+  {
+    Registrar(const char* name, TestFunc func);
+  };
+
+  void Fail(const char* file, int line, const char* expression);
+
+  // Directory for files written by the test, emptied before each test
+  const char* TempDir();
+}
+
+#define TEST(name) \
+  static void name(); \
+  static test::Registrar name##_registrar(#name, &name); \
+  static void name()
+
+#define CHECK(expression) \
+  do { if (!(expression)) test::Fail(__FILE__, __LINE__, #expression); } while (0)
+
+#define CHECK_NEAR(a, b, tolerance) \
+  do { if (!(std::fabs(double(a) - double(b)) <= double(tolerance))) test::Fail(__FILE__, __LINE__, #a " ~= " #b); } while (0)
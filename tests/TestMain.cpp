@@ -0,0 +1,76 @@
+#include "Test.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+namespace
+{
+  struct TestCase
+  {
+    const char* Name;
+    test::TestFunc Func;
+  };
+
+  std::vector<TestCase>& GetTests()
+  {
+    static std::vector<TestCase> tests;
+    return tests;
+  }
+
+  std::string g_TempDir;
+  int g_Failures = 0;
+}
+
+test::Registrar::Registrar(const char* name, TestFunc func)
+{
+  GetTests().push_back({ name, func });
+}
+
+void test::Fail(const char* file, int line, const char* expression)
+{
+  fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+  ++g_Failures;
+}
+
+const char* test::TempDir()
+{
+  return g_TempDir.c_str();
+}
+
+int main(int argc, char** argv)
+{
+  char dirTemplate[] = "/tmp/ct_test_XXXXXX";
+  if (!mkdtemp(dirTemplate))
+  {
+    perror("mkdtemp");
+    return 1;
+  }
+
+  int failedTests = 0;
+  for (TestCase const& testCase : GetTests())
+  {
+    // A test name on the command line runs only that test
+    if (argc > 1 && std::string(argv[1]) != testCase.Name)
+      continue;
+
+    g_TempDir = std::string(dirTemplate) + "/" + testCase.Name;
+    std::string command = "rm -rf '" + g_TempDir + "' && mkdir -p '" + g_TempDir + "'";
+    if (system(command.c_str()) != 0)
+      return 1;
+
+    int failuresBefore = g_Failures;
+    testCase.Func();
+
+    bool passed = g_Failures == failuresBefore;
+    printf("%s %s\n", passed ? "[ OK ]" : "[FAIL]", testCase.Name);
+    failedTests += passed ? 0 : 1;
+  }
+
+  std::string command = std::string("rm -rf '") + dirTemplate + "'";
+  if (system(command.c_str()) != 0)
+    fprintf(stderr, "Couldn't remove %s\n", dirTemplate);
+
+  return failedTests == 0 ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+#include "Test.h"
+#include "../../Alien Isolation/Util/ConfigWriter.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace util;
+
+namespace
+{
+  std::string ReadFile(std::string const& path)
+  {
+    std::string content;
+    ConfigWriter::Read(path, content);
+    return content;
+  }
+
+  void WriteFile(std::string const& path, std::string const& content)
+  {
+    FILE* pFile = fopen(path.c_str(), "wb");
+    fwrite(content.data(), 1, content.size(), pFile);
+    fclose(pFile);
+  }
+
+  bool Exists(std::string const& path)
+  {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0;
+  }
+
+  // Big enough that writing it takes a while, and says at the end
+  // which version it is
+  std::string MakeConfig(int version, size_t lines)
+  {
+    std::string config = "[Camera]\n";
+    for (size_t i = 0; i < lines; ++i)
+      config += "Setting" + std::to_string(i) + " = " + std::to_string(version * 1000 + int(i % 1000)) + "\n";
+    config += "[End]\nVersion = " + std::to_string(version) + "\n";
+    return config;
+  }
+
+  // -1 unless the content is one whole version
+  int GetVersion(std::string const& config, size_t lines)
+  {
+    size_t end = config.rfind("[End]\nVersion = ");
+    if (end == std::string::npos)
+      return -1;
+
+    int version = atoi(config.c_str() + end + 16);
+    return config == MakeConfig(version, lines) ? version : -1;
+  }
+}
+
+TEST(SkipsContentThatIsOnDisk)
+{
+  std::string path = std::string(test::TempDir()) + "/config.ini";
+  WriteFile(path, "[Camera]\nSpeed = 1\n");
+  WriteFile(path + ".tmp", "[Cam");
+
+  std::vector<std::string> errors;
+  ConfigWriter writer;
+  writer.Start(path, [&](const char* error) { errors.push_back(error); });
+
+  // Left over from a write that didn't finish
+  CHECK(!Exists(path + ".tmp"));
+
+  writer.Submit("[Camera]\nSpeed = 1\n");
+  writer.Flush();
+  CHECK(writer.GetWriteCount() == 0);
+
+  writer.Submit("[Camera]\nSpeed = 2\n");
+  writer.Flush();
+  CHECK(writer.GetWriteCount() == 1);
+  CHECK(ReadFile(path) == "[Camera]\nSpeed = 2\n");
+
+  writer.Submit("[Camera]\nSpeed = 2\n");
+  writer.Flush();
+  CHECK(writer.GetWriteCount() == 1);
+
+  writer.Stop();
+  CHECK(errors.empty());
+}
+
+TEST(CoalescesQuickEdits)
+{
+  std::string path = std::string(test::TempDir()) + "/config.ini";
+  ConfigWriter writer;
+  writer.Start(path, nullptr);
+
+  // Dragging a slider, a new value every frame for half a second
+  for (int i = 0; i < 500; ++i)
+  {
+    writer.Submit(MakeConfig(i, 200));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  writer.Flush();
+
+  CHECK(writer.GetWriteCount() >= 1 && writer.GetWriteCount() <= 6);
+  CHECK(GetVersion(ReadFile(path), 200) == 499);
+
+  // Stop writes what's still queued
+  writer.Submit(MakeConfig(1000, 200));
+  writer.Stop();
+  CHECK(GetVersion(ReadFile(path), 200) == 1000);
+
+  // Afterwards the caller writes
+  writer.Submit(MakeConfig(1001, 200));
+  CHECK(GetVersion(ReadFile(path), 200) == 1001);
+  CHECK(!Exists(path + ".tmp"));
+}
+
+TEST(ReportsFailedWrites)
+{
+  std::string dir = std::string(test::TempDir()) + "/missing";
+  std::vector<std::string> errors;
+  ConfigWriter writer;
+  writer.Start(dir + "/config.ini", [&](const char* error) { errors.push_back(error); });
+
+  writer.Submit("a");
+  writer.Flush();
+  CHECK(errors.size() == 1);
+
+  // The same content is tried again
+  writer.Submit("a");
+  writer.Flush();
+  CHECK(errors.size() == 2);
+
+  mkdir(dir.c_str(), 0755);
+  writer.Submit("a");
+  writer.Flush();
+  CHECK(errors.size() == 2);
+  CHECK(ReadFile(dir + "/config.ini") == "a");
+  writer.Stop();
+
+  // A read only directory leaves the file as it was
+  if (geteuid() != 0)
+  {
+    chmod(dir.c_str(), 0555);
+    CHECK(!ConfigWriter::Write(dir + "/config.ini", "b"));
+    CHECK(ReadFile(dir + "/config.ini") == "a");
+    chmod(dir.c_str(), 0755);
+  }
+}
+
+TEST(KillDuringWriteLeavesAWholeFile)
+{
+  const size_t lines = 20000;
+  const int rounds = 40;
+  std::string path = std::string(test::TempDir()) + "/config.ini";
+  std::mt19937 rng(1234);
+
+  int whole = 0;
+  for (int round = 0; round < rounds; ++round)
+  {
+    WriteFile(path, MakeConfig(0, lines));
+
+    // The child writes new versions as fast as it can until it's killed
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+      ConfigWriter writer;
+      writer.Start(path, nullptr);
+      for (int version = 1;; ++version)
+      {
+        writer.Submit(MakeConfig(version, lines));
+        writer.Flush();
+      }
+    }
+
+    std::this_thread::sleep_for(std::chrono::microseconds(2000 + rng() % 30000));
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+
+    if (GetVersion(ReadFile(path), lines) >= 0)
+      whole++;
+
+    // The next start cleans up after the killed write
+    ConfigWriter writer;
+    writer.Start(path, nullptr);
+    CHECK(!Exists(path + ".tmp"));
+    writer.Stop();
+  }
+
+  CHECK(whole == rounds);
+}
+
+TEST(KeepsBinaryContentAsItIs)
+{
+  // Newlines, carriage returns and the end of file character of MSVC's
+  // text mode, next to each other and at the ends
+  std::string content("\x0A\x0D\x1A", 3);
+  for (int i = 0; i < 256; ++i)
+  {
+    content += char(i);
+    content += "\x0D\x0A\x0A\x0D\x1A";
+  }
+  content += std::string("\x1A\x0D", 2);
+
+  std::string path = std::string(test::TempDir()) + "/profiles.db";
+  CHECK(ConfigWriter::Write(path, content));
+  CHECK(ReadFile(path) == content);
+
+  ConfigWriter writer;
+  writer.Start(path, nullptr);
+  writer.Submit(content);
+  writer.Flush();
+  CHECK(writer.GetWriteCount() == 0);
+
+  content += std::string("\x0D\x0A", 2);
+  writer.Submit(content);
+  writer.Stop();
+  CHECK(writer.GetWriteCount() == 1);
+  CHECK(ReadFile(path) == content);
+}
@@ -0,0 +1,150 @@
+#include "Test.h"
+#include "../../Alien Isolation/Util/FileWatcher.h"
+#include "../../Alien Isolation/Util/ConfigWriter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace util;
+
+namespace
+{
+  void WriteFile(std::string const& path, std::string const& content)
+  {
+    FILE* pFile = fopen(path.c_str(), "wb");
+    fwrite(content.data(), 1, content.size(), pFile);
+    fclose(pFile);
+  }
+
+  // Polls the way the tools do every update, for a while
+  std::vector<std::string> PollFor(FileWatcher& watcher, int milliseconds, bool* pComplete = nullptr)
+  {
+    std::vector<std::string> changed;
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(milliseconds);
+    while (std::chrono::steady_clock::now() < end)
+    {
+      if (!watcher.Poll(changed) && pComplete)
+        *pComplete = false;
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    std::sort(changed.begin(), changed.end());
+    return changed;
+  }
+}
+
+TEST(NeedsADirectory)
+{
+  FileWatcher watcher;
+  CHECK(!watcher.Watch(std::string(test::TempDir()) + "/missing"));
+  CHECK(!watcher.IsWatching());
+
+  CHECK(watcher.Watch(test::TempDir()));
+  CHECK(watcher.IsWatching());
+  watcher.Stop();
+  CHECK(!watcher.IsWatching());
+}
+
+TEST(ReportsSavesOnceSettled)
+{
+  std::string dir = std::string(test::TempDir()) + "/";
+  FileWatcher watcher;
+  CHECK(watcher.Watch(dir));
+
+  // Saved in two steps, reported once after both
+  WriteFile(dir + "a.ini", "1");
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  WriteFile(dir + "a.ini", "12");
+
+  std::vector<std::string> changed;
+  CHECK(watcher.Poll(changed));
+  CHECK(changed.empty());
+
+  changed = PollFor(watcher, 500);
+  CHECK(changed.size() == 1 && changed[0] == "a.ini");
+
+  // Saved by renaming a temporary file over it
+  CHECK(ConfigWriter::Write(dir + "config.ini", "x=1\n"));
+  changed = PollFor(watcher, 500);
+  CHECK(std::count(changed.begin(), changed.end(), "config.ini") == 1);
+
+  WriteFile(dir + "b.ini", "b");
+  changed = PollFor(watcher, 500);
+  CHECK(changed.size() == 1 && changed[0] == "b.ini");
+
+  remove((dir + "b.ini").c_str());
+  changed = PollFor(watcher, 500);
+  CHECK(changed.size() == 1 && changed[0] == "b.ini");
+
+  CHECK(PollFor(watcher, 300).empty());
+}
+
+TEST(ReportsLostChanges)
+{
+  std::string dir = std::string(test::TempDir()) + "/";
+  FileWatcher watcher;
+  CHECK(watcher.Watch(dir));
+
+  // More changes than the kernel queues
+  int maxEvents = 16384;
+  if (FILE* pFile = fopen("/proc/sys/fs/inotify/max_queued_events", "r"))
+  {
+    if (fscanf(pFile, "%d", &maxEvents) != 1)
+      maxEvents = 16384;
+    fclose(pFile);
+  }
+
+  for (int i = 0; i < maxEvents + 100; ++i)
+    WriteFile(dir + "c.ini", std::to_string(i));
+
+  bool complete = true;
+  PollFor(watcher, 400, &complete);
+  CHECK(!complete);
+
+  // Everything was assumed changed, nothing is left over
+  CHECK(PollFor(watcher, 400).empty());
+}
+
+TEST(KnowsItsOwnWrites)
+{
+  std::string path = std::string(test::TempDir()) + "/config.ini";
+  CHECK(ConfigWriter::Write(path, "x=1\n"));
+
+  ConfigWriter writer;
+  writer.Start(path, nullptr);
+
+  std::string content;
+  CHECK(ConfigWriter::Read(path, content) && content == "x=1\n");
+  CHECK(writer.IsOwnContent(content));
+
+  writer.Submit("x=2\n");
+  writer.Flush();
+  CHECK(writer.IsOwnContent("x=2\n"));
+  CHECK(writer.IsOwnContent("x=1\n"));
+  CHECK(!writer.IsOwnContent("x=3\n"));
+
+  // An edit from outside becomes the current version
+  writer.SetCurrent("x=3\n");
+  CHECK(writer.IsOwnContent("x=3\n"));
+  CHECK(!writer.IsOwnContent("x=2\n"));
+
+  uint64_t writes = writer.GetWriteCount();
+  writer.Submit("x=3\n");
+  writer.Flush();
+  CHECK(writer.GetWriteCount() == writes);
+
+  // Only the last few versions are remembered
+  for (int i = 0; i < 20; ++i)
+  {
+    writer.Submit("v" + std::to_string(i));
+    writer.Flush();
+  }
+  CHECK(writer.IsOwnContent("v19"));
+  CHECK(writer.IsOwnContent("v12"));
+  CHECK(!writer.IsOwnContent("v11"));
+  writer.Stop();
+}
@@ -0,0 +1,291 @@
+#include "Test.h"
+#include "../../Alien Isolation/Util/LogQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cwchar>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace util;
+
+namespace
+{
+  // Call sites are never throttled with this burst
+  const unsigned Unthrottled = 1u << 30;
+
+  struct Capture
+  {
+    std::mutex Mutex;
+    std::vector<std::pair<int, std::string>> Messages;
+    uint64_t Dropped = 0;
+
+    LogQueue::Sink MakeSink()
+    {
+      return [this](LogMessage const* pMessages, size_t count, uint64_t dropped)
+      {
+        std::lock_guard<std::mutex> lock(Mutex);
+        for (size_t i = 0; i < count; ++i)
+          Messages.emplace_back(pMessages[i].Level, std::string(pMessages[i].pText, pMessages[i].Length));
+        Dropped += dropped;
+      };
+    }
+  };
+
+  bool Push(LogQueue& queue, int level, const char* format, ...)
+  {
+    va_list args;
+    va_start(args, format);
+    bool pushed = queue.Push(level, format, args);
+    va_end(args);
+    return pushed;
+  }
+
+  std::string Format(const char* format, ...)
+  {
+    char buffer[4096];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    return buffer;
+  }
+}
+
+TEST(FormatsLikePrintf)
+{
+  Capture capture;
+  LogQueue queue;
+  queue.Start(capture.MakeSink());
+  std::vector<std::string> expected;
+
+#define SAME(format, ...) \
+  Push(queue, 1, format, ##__VA_ARGS__); \
+  expected.push_back(Format(format, ##__VA_ARGS__))
+
+  std::string temporary = "temporary";
+  SAME("plain text");
+  SAME("Cinematic Tools for %s\n", "Alien: Isolation");
+  SAME("Device 0x%X DeviceContext 0x%X SwapChain 0x%X", 0x1234u, 0xDEADBEEFu, 0u);
+  SAME("%d %i %u %o %x %X %c", -5, 42, 7u, 8, 255, 255, 'z');
+  SAME("%.2f %.4f %.3f %.1f %e %g %10.3f|%-8.2f|", 3.14159, 2.0, -1.5, 1e10, 6.02e23, 0.0001, 2.5, 1.25);
+  SAME("%s and %s", temporary.c_str(), std::string("gone after this line").c_str());
+  SAME("%5d|%-5d|%05d|%+d|% d", 42, 42, 42, 42, 42);
+  SAME("%*d|%-*d|%.*f|%*.*f", 6, 1, 6, 2, 3, 3.14159, 9, 2, 2.71828);
+  SAME("%lld %llx %zu %ld %hd %hhu", -1234567890123LL, 0xFEDCBA9876543210ULL, size_t(99), -77L, short(-3), (unsigned char)200);
+  SAME("100%% done %s", "ok");
+  SAME("%p", reinterpret_cast<void*>(0x1000));
+  SAME("%ls %lc", L"wide", wint_t(L'W'));
+  SAME("%.3s|%10s|%-10s|", "abcdef", "right", "left");
+  SAME("%Lf", 1.5L);
+#undef SAME
+
+  // MSVC spellings are rewritten to the standard ones
+  Push(queue, 1, "Offset %I64X %S %I32d %Iu", 0x123456789ABCULL, L"wide", 12, size_t(34));
+  expected.push_back(Format("Offset %llX %ls %d %zu", 0x123456789ABCULL, L"wide", 12, size_t(34)));
+
+  // Null strings print the way MSVC prints them
+  Push(queue, 1, "null %s", static_cast<const char*>(nullptr));
+  expected.push_back("null (null)");
+
+  // Unknown conversions are kept as text
+  Push(queue, 1, "odd %y end");
+  expected.push_back("odd %y end");
+
+  Push(queue, 7, "level");
+  expected.push_back("level");
+
+  queue.Flush();
+  {
+    std::lock_guard<std::mutex> lock(capture.Mutex);
+    CHECK(capture.Messages.size() == expected.size());
+    for (size_t i = 0; i < expected.size() && i < capture.Messages.size(); ++i)
+      CHECK(capture.Messages[i].second == expected[i]);
+    CHECK(capture.Messages.back().first == 7);
+  }
+
+  queue.Stop();
+  CHECK(!Push(queue, 1, "after stop"));
+}
+
+TEST(LongArgumentsAreCut)
+{
+  Capture capture;
+  LogQueue queue;
+  queue.Start(capture.MakeSink());
+
+  std::string longText(2000, 'x');
+  Push(queue, 1, "long %s tail", longText.c_str());
+  Push(queue, 1, "%s %d %s", longText.c_str(), 5, "more");
+  Push(queue, 1, "%d %s %d", 1, longText.c_str(), 3);
+  queue.Flush();
+
+  std::lock_guard<std::mutex> lock(capture.Mutex);
+  CHECK(capture.Messages.size() == 3);
+
+  // The string is cut short, the rest of the format still follows
+  std::string const& a = capture.Messages[0].second;
+  CHECK(a.compare(0, 5, "long ") == 0);
+  CHECK(a.size() > 400 && a.size() < 520);
+  CHECK(a.substr(a.size() - 5) == " tail");
+
+  // Arguments that don't fit anymore end the message
+  std::string const& b = capture.Messages[1].second;
+  CHECK(b.size() > 400 && b.substr(b.size() - 4) == " ...");
+  std::string const& c = capture.Messages[2].second;
+  CHECK(c.compare(0, 2, "1 ") == 0 && c.substr(c.size() - 4) == " ...");
+}
+
+TEST(KeepsEveryThreadsOrder)
+{
+  for (bool paced : { false, true })
+  {
+    const int threadCount = 8;
+    const int perThread = 20000;
+
+    Capture capture;
+    LogQueue queue(4096, Unthrottled);
+    queue.Start(capture.MakeSink());
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+      threads.emplace_back([&, t]
+      {
+        for (int i = 0; i < perThread; ++i)
+        {
+          Push(queue, t, "thread %d message %d %s", t, i, "payload");
+          // Never more than a ring's worth in flight
+          if (paced && i % 1000 == 999)
+            queue.Flush();
+        }
+        queue.Flush();
+      });
+    }
+
+    for (auto& thread : threads)
+      thread.join();
+    queue.Stop();
+
+    // Lost messages are counted, the rest arrive in order
+    std::vector<int> next(threadCount, 0);
+    size_t total = 0;
+    bool ordered = true, gaps = false, parsed = true;
+    for (auto const& message : capture.Messages)
+    {
+      int t, i;
+      if (sscanf(message.second.c_str(), "thread %d message %d", &t, &i) != 2 || t != message.first)
+      {
+        parsed = false;
+        continue;
+      }
+      ordered &= i >= next[t];
+      gaps |= i > next[t];
+      next[t] = i + 1;
+      total++;
+    }
+
+    CHECK(parsed);
+    CHECK(ordered);
+    CHECK(total + capture.Dropped == size_t(threadCount) * perThread);
+    CHECK(!gaps || capture.Dropped > 0);
+    if (paced)
+      CHECK(capture.Dropped == 0);
+  }
+}
+
+TEST(ThreadsThatExitLoseNothing)
+{
+  // Their rings are freed once drained, which ASan checks
+  Capture capture;
+  LogQueue queue(16, Unthrottled);
+  queue.Start(capture.MakeSink());
+  for (int round = 0; round < 200; ++round)
+  {
+    std::thread([&]
+    {
+      for (int i = 0; i < 10; ++i)
+        Push(queue, 0, "short %d", i);
+    }).join();
+  }
+  queue.Stop();
+
+  CHECK(capture.Messages.size() == 2000);
+  CHECK(capture.Dropped == 0);
+}
+
+TEST(StopWritesEverything)
+{
+  Capture capture;
+  LogQueue queue(4096, Unthrottled);
+  queue.Start(capture.MakeSink());
+  for (int i = 0; i < 3000; ++i)
+    Push(queue, 0, "before stop %d", i);
+  queue.Stop();
+  CHECK(capture.Messages.size() == 3000);
+
+  queue.Start(capture.MakeSink());
+  Push(queue, 0, "again");
+  queue.Flush();
+  CHECK(capture.Messages.back().second == "again");
+}
+
+TEST(PushesRacingStopAreWritten)
+{
+  // A push that returned true is written or counted as dropped,
+  // even when it lands just as the background thread stops
+  for (int round = 0; round < 200; ++round)
+  {
+    Capture capture;
+    LogQueue queue(256, Unthrottled);
+    queue.Start(capture.MakeSink());
+
+    std::atomic<uint64_t> accepted(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t)
+    {
+      threads.emplace_back([&]
+      {
+        while (Push(queue, 0, "racing %d", round))
+          accepted++;
+      });
+    }
+
+    std::this_thread::sleep_for(std::chrono::microseconds(100 + round * 10));
+    queue.Stop();
+    for (std::thread& thread : threads)
+      thread.join();
+
+    CHECK(capture.Messages.size() + capture.Dropped == accepted);
+  }
+}
+
+TEST(FullRingsDropInsteadOfBlocking)
+{
+  std::atomic<bool> release(false);
+  size_t written = 0;
+  uint64_t dropped = 0;
+
+  LogQueue queue(64, Unthrottled);
+  queue.Start([&](LogMessage const*, size_t count, uint64_t lost)
+  {
+    while (!release)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    written += count;
+    dropped += lost;
+  });
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 100000; ++i)
+    Push(queue, 0, "flood %d", i);
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  release = true;
+  queue.Stop();
+
+  CHECK(written + dropped == 100000);
+  CHECK(dropped > 0);
+  CHECK(elapsed.count() < 1);
+}
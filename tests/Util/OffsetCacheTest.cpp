@@ -0,0 +1,184 @@
+#include "Test.h"
+#include "../../Alien Isolation/Util/OffsetCache.h"
+#include "../../Alien Isolation/Util/PatternScanner.h"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace util::offsets;
+
+namespace
+{
+  // Random bytes, patterns are copied out of it so they
+  // occur exactly where they were taken from
+  struct Image
+  {
+    std::vector<uint8_t> Bytes;
+    std::vector<CachedPattern> Patterns;
+
+    Image() : Bytes(4 << 20)
+    {
+      std::mt19937 random(1);
+      for (auto& byte : Bytes)
+        byte = static_cast<uint8_t>(random());
+
+      for (int i = 0; i < 10; ++i)
+      {
+        CachedPattern pattern;
+        pattern.Name = "OFFSET_" + std::to_string(i);
+        size_t offset = random() % (Bytes.size() - 64);
+        pattern.Bytes.assign(Bytes.begin() + offset, Bytes.begin() + offset + 12);
+        pattern.Mask = "xxxx????xxxx";
+        Patterns.push_back(pattern);
+      }
+
+      CachedPattern missing;
+      missing.Name = "OFFSET_MISSING";
+      missing.Bytes.assign(12, 0xCC);
+      missing.Mask.assign(12, 'x');
+      Patterns.push_back(missing);
+    }
+
+    std::vector<size_t> Scan() const
+    {
+      PatternScanner scanner;
+      for (auto const& pattern : Patterns)
+        scanner.AddPattern(pattern.Bytes, pattern.Mask);
+      return scanner.Scan(Bytes.data(), Bytes.size());
+    }
+  };
+
+  std::string CachePath(const char* name = "offsets.cache")
+  {
+    return std::string(test::TempDir()) + "/" + name;
+  }
+
+  void WriteFile(std::string const& path, const char* contents)
+  {
+    FILE* pFile = fopen(path.c_str(), "w");
+    fputs(contents, pFile);
+    fclose(pFile);
+  }
+}
+
+TEST(SecondLaunchSkipsTheScan)
+{
+  Image image;
+  std::vector<size_t> expected = image.Scan();
+
+  OffsetCache cache;
+  CHECK(!cache.Load(CachePath()));
+
+  size_t scanned = 0;
+  CHECK(cache.FindPatterns(image.Bytes.data(), image.Bytes.size(), image.Patterns, &scanned) == expected);
+  CHECK(scanned == image.Patterns.size());
+  CHECK(cache.IsDirty());
+
+  cache.SetModuleHash(OffsetCache::Hash(image.Bytes.data(), image.Bytes.size()));
+  CHECK(cache.Save(CachePath()));
+
+  OffsetCache loaded;
+  CHECK(loaded.Load(CachePath()));
+  CHECK(loaded.GetModuleHash() == cache.GetModuleHash());
+
+  // Only the pattern that was never found is scanned for again
+  CHECK(loaded.FindPatterns(image.Bytes.data(), image.Bytes.size(), image.Patterns, &scanned) == expected);
+  CHECK(scanned == 1);
+  CHECK(!loaded.IsDirty());
+}
+
+TEST(HealsAfterAPatch)
+{
+  Image image;
+  std::vector<size_t> before = image.Scan();
+
+  OffsetCache cache;
+  cache.FindPatterns(image.Bytes.data(), image.Bytes.size(), image.Patterns);
+  CHECK(cache.Save(CachePath()));
+
+  // Code inserted in front of one pattern moves it
+  image.Bytes.insert(image.Bytes.begin() + before[3] - 5, 7, 0x90);
+  image.Bytes.resize(4 << 20);
+  std::vector<size_t> after = image.Scan();
+  CHECK(after[3] == before[3] + 7);
+
+  OffsetCache loaded;
+  CHECK(loaded.Load(CachePath()));
+
+  std::vector<size_t> results = loaded.FindPatterns(image.Bytes.data(), image.Bytes.size(), image.Patterns);
+  CHECK(results[3] == after[3]);
+  CHECK(loaded.IsDirty());
+
+  // Other cached offsets are kept as long as their bytes still match
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    if (results[i] == PatternScanner::NotFound)
+      CHECK(after[i] == PatternScanner::NotFound);
+    else
+      CHECK(OffsetCache::Matches(image.Bytes.data(), image.Bytes.size(), results[i], image.Patterns[i].Bytes, image.Patterns[i].Mask));
+  }
+}
+
+TEST(ChangedSignatureIsRescanned)
+{
+  Image image;
+
+  OffsetCache cache;
+  cache.FindPatterns(image.Bytes.data(), image.Bytes.size(), image.Patterns);
+  CHECK(cache.Save(CachePath()));
+
+  image.Patterns[0].Mask = "xxxxxxxxxxxx";
+
+  OffsetCache loaded;
+  CHECK(loaded.Load(CachePath()));
+
+  size_t scanned = 0;
+  std::vector<size_t> results = loaded.FindPatterns(image.Bytes.data(), image.Bytes.size(), image.Patterns, &scanned);
+  CHECK(scanned == 2);
+  CHECK(results == image.Scan());
+}
+
+TEST(RejectsDamagedFiles)
+{
+  OffsetCache cache;
+
+  WriteFile(CachePath(), "CTOFFSETS 1 abc\nOFFSET_0 zz 12\n");
+  CHECK(!cache.Load(CachePath()));
+
+  WriteFile(CachePath(), "CTOFFSETS 2 abc\n");
+  CHECK(!cache.Load(CachePath()));
+
+  WriteFile(CachePath(), "");
+  CHECK(!cache.Load(CachePath()));
+  CHECK(cache.GetModuleHash() == 0);
+}
+
+TEST(FailedSaveKeepsTheOldCache)
+{
+  Image image;
+  OffsetCache cache;
+  cache.SetModuleHash(1);
+  cache.FindPatterns(image.Bytes.data(), image.Bytes.size(), image.Patterns);
+  CHECK(cache.Save(CachePath()));
+
+  // Saving replaces the file without leaving the temporary one behind
+  CHECK(cache.Save(CachePath()));
+  CHECK(fopen((CachePath() + ".tmp").c_str(), "r") == nullptr);
+
+  CHECK(!cache.Save(CachePath("missing/offsets.cache")));
+
+  OffsetCache loaded;
+  CHECK(loaded.Load(CachePath()));
+  CHECK(loaded.GetModuleHash() == 1);
+}
+
+TEST(MatchesStaysInsideTheImage)
+{
+  std::vector<uint8_t> bytes = { 1, 2, 3, 4 };
+  CHECK(OffsetCache::Matches(bytes.data(), bytes.size(), 2, { 3, 4 }, "xx"));
+  CHECK(!OffsetCache::Matches(bytes.data(), bytes.size(), 3, { 4, 5 }, "x?"));
+  CHECK(!OffsetCache::Matches(bytes.data(), bytes.size(), 100, { 4 }, "x"));
+  CHECK(!OffsetCache::Matches(bytes.data(), bytes.size(), static_cast<size_t>(-1), { 4 }, "x"));
+}
@@ -0,0 +1,183 @@
+#include "Test.h"
+#include "../../Alien Isolation/Util/PatternScanner.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using util::offsets::PatternScanner;
+
+namespace
+{
+  struct TestPattern
+  {
+    std::vector<uint8_t> Bytes;
+    std::string Mask;
+  };
+
+  size_t FindFirst(std::vector<uint8_t> const& image, TestPattern const& pattern)
+  {
+    if (pattern.Bytes.empty() || pattern.Bytes.size() > image.size())
+      return PatternScanner::NotFound;
+
+    for (size_t start = 0; start + pattern.Bytes.size() <= image.size(); ++start)
+    {
+      size_t i = 0;
+      while (i < pattern.Bytes.size() && (pattern.Mask[i] != 'x' || image[start + i] == pattern.Bytes[i]))
+        ++i;
+
+      if (i == pattern.Bytes.size())
+        return start;
+    }
+    return PatternScanner::NotFound;
+  }
+
+  // Code-like image, some bytes are much more common than others
+  std::vector<uint8_t> MakeImage(size_t size, std::mt19937& random)
+  {
+    std::vector<uint8_t> image(size);
+    std::discrete_distribution<int> common({ 30, 10, 10, 5, 5, 40 });
+    const uint8_t commonBytes[] = { 0x00, 0xCC, 0x48, 0x8B, 0x89 };
+    for (auto& byte : image)
+    {
+      int pick = common(random);
+      byte = pick < 5 ? commonBytes[pick] : static_cast<uint8_t>(random());
+    }
+    return image;
+  }
+
+  TestPattern MakePattern(size_t length, std::mt19937& random)
+  {
+    TestPattern pattern;
+    for (size_t i = 0; i < length; ++i)
+    {
+      pattern.Bytes.push_back(static_cast<uint8_t>(random()));
+      pattern.Mask += (random() % 4 == 0) ? '?' : 'x';
+    }
+    pattern.Mask[0] = 'x';
+    return pattern;
+  }
+
+  void Plant(std::vector<uint8_t>& image, TestPattern const& pattern, size_t offset)
+  {
+    for (size_t i = 0; i < pattern.Bytes.size(); ++i)
+    {
+      if (pattern.Mask[i] == 'x')
+        image[offset + i] = pattern.Bytes[i];
+    }
+  }
+
+  void CheckScan(std::vector<uint8_t> const& image, std::vector<TestPattern> const& patterns, unsigned int threads)
+  {
+    PatternScanner scanner;
+    for (auto const& pattern : patterns)
+      scanner.AddPattern(pattern.Bytes, pattern.Mask);
+
+    std::vector<size_t> results = scanner.Scan(image.data(), image.size(), threads);
+    CHECK(results.size() == patterns.size());
+
+    for (size_t i = 0; i < patterns.size() && i < results.size(); ++i)
+      CHECK(results[i] == FindFirst(image, patterns[i]));
+  }
+}
+
+TEST(MatchesNaiveSearch)
+{
+  std::mt19937 random(1);
+  std::vector<uint8_t> image = MakeImage(256 * 1024, random);
+
+  std::vector<TestPattern> patterns;
+  for (int i = 0; i < 40; ++i)
+  {
+    TestPattern pattern = MakePattern(4 + random() % 20, random);
+    if (i % 4 != 0)
+      Plant(image, pattern, random() % (image.size() - pattern.Bytes.size()));
+    patterns.push_back(pattern);
+  }
+
+  CheckScan(image, patterns, 1);
+}
+
+TEST(ManyAnchorBytes)
+{
+  // More distinct anchors than the SIMD path compares,
+  // so the lookup table path is used
+  std::mt19937 random(2);
+  std::vector<uint8_t> image = MakeImage(128 * 1024, random);
+
+  std::vector<TestPattern> patterns;
+  for (int i = 0; i < 64; ++i)
+  {
+    TestPattern pattern = MakePattern(8, random);
+    Plant(image, pattern, random() % (image.size() - 8));
+    patterns.push_back(pattern);
+  }
+
+  CheckScan(image, patterns, 1);
+}
+
+TEST(FirstMatchAcrossChunks)
+{
+  // Big enough to be split into four chunks, with matches straddling
+  // each boundary and a later duplicate in another chunk
+  std::mt19937 random(3);
+  const size_t chunk = 1024 * 1024;
+  std::vector<uint8_t> image = MakeImage(4 * chunk, random);
+
+  std::vector<TestPattern> patterns;
+  for (size_t boundary = 1; boundary < 4; ++boundary)
+  {
+    TestPattern pattern = MakePattern(16, random);
+    Plant(image, pattern, boundary * chunk - 7);
+    Plant(image, pattern, 4 * chunk - 20);
+    patterns.push_back(pattern);
+  }
+
+  CheckScan(image, patterns, 4);
+  CheckScan(image, patterns, 1);
+}
+
+TEST(EdgesOfTheImage)
+{
+  std::mt19937 random(4);
+  std::vector<uint8_t> image = MakeImage(4096, random);
+
+  TestPattern atStart = MakePattern(6, random);
+  TestPattern atEnd = MakePattern(6, random);
+  Plant(image, atStart, 0);
+  Plant(image, atEnd, image.size() - 6);
+
+  // Would match if it could run past the end
+  TestPattern pastEnd;
+  pastEnd.Bytes.assign(image.end() - 3, image.end());
+  pastEnd.Bytes.push_back(0x42);
+  pastEnd.Mask = "xxxx";
+  image[image.size() - 4] ^= 0x5A;
+
+  TestPattern tooLong;
+  tooLong.Bytes.assign(5000, 0);
+  tooLong.Mask.assign(5000, 'x');
+
+  CheckScan(image, { atStart, atEnd, pastEnd, tooLong }, 1);
+}
+
+TEST(WildcardsOnlyMatchAtStart)
+{
+  std::vector<uint8_t> image(100, 0x90);
+  PatternScanner scanner;
+  scanner.AddPattern({ 1, 2, 3 }, "???");
+  scanner.AddPattern({}, "");
+
+  std::vector<size_t> results = scanner.Scan(image.data(), image.size(), 1);
+  CHECK(results[0] == 0);
+  CHECK(results[1] == PatternScanner::NotFound);
+}
+
+TEST(EmptyImage)
+{
+  PatternScanner scanner;
+  scanner.AddPattern({ 1, 2 }, "xx");
+
+  std::vector<size_t> results = scanner.Scan(nullptr, 0);
+  CHECK(results.size() == 1 && results[0] == PatternScanner::NotFound);
+}
@@ -0,0 +1,290 @@
+#include "Test.h"
+#include "../../Alien Isolation/Util/RecordStore.h"
+#include "../../Alien Isolation/Util/ConfigWriter.h"
+
+#include <random>
+#include <string>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace util;
+
+namespace
+{
+  std::string ReadFile(std::string const& path)
+  {
+    std::string content;
+    ConfigWriter::Read(path, content);
+    return content;
+  }
+
+  void WriteFile(std::string const& path, std::string const& content)
+  {
+    FILE* pFile = fopen(path.c_str(), "wb");
+    fwrite(content.data(), 1, content.size(), pFile);
+    fclose(pFile);
+  }
+
+  std::string StorePath()
+  {
+    return std::string(test::TempDir()) + "/profiles.db";
+  }
+
+  std::string ProfileName(int i)
+  {
+    return "Profile " + std::to_string(i);
+  }
+
+  // Binary, like the camera profiles the store keeps
+  std::string ProfileData(int i)
+  {
+    std::string data(48, '\0');
+    for (int k = 0; k < 48; ++k)
+      data[k] = char(i * 31 + k * 7);
+    return data;
+  }
+
+  void Fill(std::string const& path, int count)
+  {
+    remove(path.c_str());
+    RecordStore store;
+    CHECK(store.Open(path));
+    for (int i = 0; i < count; ++i)
+      CHECK(store.Put(ProfileName(i), ProfileData(i)));
+    CHECK(store.Sync());
+  }
+
+  // How many of the profiles are there, all of them have to be intact
+  int CountIntact(RecordStore& store, int count)
+  {
+    int intact = 0;
+    std::string data;
+    for (int i = 0; i < count; ++i)
+    {
+      if (store.Get(ProfileName(i), data))
+      {
+        CHECK(data == ProfileData(i));
+        intact++;
+      }
+    }
+    return intact;
+  }
+
+  bool Exists(std::string const& path)
+  {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0;
+  }
+}
+
+TEST(PutsAndGets)
+{
+  std::string path = StorePath();
+  {
+    RecordStore store;
+    std::string error;
+    CHECK(store.Open(path, &error));
+    CHECK(store.GetCount() == 0);
+
+    bool changed = false;
+    CHECK(store.Put("a", "1", &changed) && changed);
+    CHECK(store.Put("b", "22", &changed) && changed);
+    CHECK(store.Put("a", "1", &changed) && !changed);
+    CHECK(store.Put("a", "333", &changed) && changed);
+    CHECK(store.Find("a") == 0 && store.Find("b") == 1 && store.Find("c") == -1);
+
+    std::string data;
+    CHECK(store.Get("a", data) && data == "333");
+    CHECK(!store.Get("c", data));
+    CHECK(!store.Put("", "x"));
+    CHECK(store.Put("empty", ""));
+    CHECK(store.Get("empty", data) && data.empty());
+
+    CHECK(store.GetDeadBytes() > 0);
+    CHECK(store.Compact());
+    CHECK(store.GetDeadBytes() == 0);
+    CHECK(store.Get("a", data) && data == "333");
+    CHECK(store.Put("c", "4"));
+  }
+
+  RecordStore store;
+  CHECK(store.Open(path));
+  CHECK(store.GetCount() == 4);
+  CHECK(store.GetNames()[0] == "a" && store.GetNames()[3] == "c");
+
+  std::string data;
+  CHECK(store.Get("c", data) && data == "4");
+  CHECK(store.GetDamagedBytes() == 0);
+}
+
+TEST(TornRecordLosesOnlyItself)
+{
+  std::string path = StorePath();
+  Fill(path, 10);
+  std::string full = ReadFile(path);
+
+  // Record header, name and data of the last profile
+  size_t last = full.size() - (16 + ProfileName(9).size() + 48);
+
+  for (size_t cut = last + 1; cut < full.size(); ++cut)
+  {
+    WriteFile(path, full.substr(0, cut));
+
+    RecordStore store;
+    CHECK(store.Open(path));
+    CHECK(store.GetCount() == 9);
+    CHECK(CountIntact(store, 10) == 9);
+
+    // Saving again after the torn record works
+    CHECK(store.Put(ProfileName(9), ProfileData(9)));
+    store.Close();
+    CHECK(store.Open(path));
+    CHECK(store.GetDamagedBytes() == 0);
+    CHECK(CountIntact(store, 10) == 10);
+  }
+}
+
+TEST(FlippedByteLosesOneRecord)
+{
+  std::string path = StorePath();
+  std::mt19937 rng(1);
+
+  for (int round = 0; round < 100; ++round)
+  {
+    Fill(path, 50);
+    std::string content = ReadFile(path);
+    size_t position = 8 + rng() % (content.size() - 8);
+    content[position] ^= char(1 + rng() % 255);
+    WriteFile(path, content);
+
+    RecordStore store;
+    CHECK(store.Open(path));
+    int intact = CountIntact(store, 50);
+    CHECK(intact >= 49);
+
+    std::string data;
+    for (auto const& name : store.GetNames())
+      CHECK(store.Get(name, data));
+    store.Close();
+
+    // The damage was compacted away and kept aside
+    CHECK(store.Open(path));
+    CHECK(store.GetDamagedBytes() == 0);
+    CHECK(CountIntact(store, 50) == intact);
+    CHECK(Exists(path + ".damaged"));
+  }
+}
+
+TEST(RecoversFromBadFiles)
+{
+  std::string path = StorePath();
+
+  // Missing header
+  Fill(path, 5);
+  WriteFile(path, ReadFile(path).substr(8));
+  RecordStore store;
+  CHECK(store.Open(path));
+  CHECK(CountIntact(store, 5) == 5);
+  store.Close();
+  CHECK(ReadFile(path).compare(0, 8, "CTSTORE1") == 0);
+
+  WriteFile(path, "hello, not a store");
+  CHECK(store.Open(path));
+  CHECK(store.GetCount() == 0);
+  CHECK(ReadFile(path + ".damaged") == "hello, not a store");
+  store.Close();
+
+  WriteFile(path, "");
+  CHECK(store.Open(path));
+  CHECK(store.GetCount() == 0);
+  store.Close();
+
+  // Garbage after the last record that's longer than the next one
+  Fill(path, 3);
+  WriteFile(path, ReadFile(path) + std::string(300, '\x55'));
+  CHECK(store.Open(path));
+  CHECK(CountIntact(store, 3) == 3);
+  CHECK(store.Put("x", "y"));
+  store.Close();
+  CHECK(store.Open(path));
+  CHECK(store.GetDamagedBytes() == 0);
+  CHECK(store.GetCount() == 4);
+}
+
+TEST(CompactsOutdatedCopies)
+{
+  std::string path = StorePath();
+  RecordStore store;
+  CHECK(store.Open(path));
+  for (int i = 0; i < 3000; ++i)
+    store.Put("p", ProfileData(i));
+  store.Close();
+
+  CHECK(store.Open(path));
+  CHECK(ReadFile(path).size() < 200);
+
+  std::string data;
+  CHECK(store.Get("p", data) && data == ProfileData(2999));
+}
+
+TEST(KillDuringPutLeavesAReadableStore)
+{
+  std::string path = StorePath();
+  for (int round = 0; round < 40; ++round)
+  {
+    remove(path.c_str());
+
+    // The child saves profiles as fast as it can until it's killed
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+      RecordStore store;
+      store.Open(path);
+      for (int i = 0;; ++i)
+        store.Put(ProfileName(i % 200), ProfileData(i));
+    }
+
+    usleep(2000 + round * 100);
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+
+    RecordStore store;
+    CHECK(store.Open(path));
+    std::string data;
+    for (auto const& name : store.GetNames())
+      CHECK(store.Get(name, data) && data.size() == 48);
+  }
+}
+
+TEST(RecordsRoundTripControlBytes)
+{
+  std::string path = StorePath();
+  std::string newline("\x0A", 1), carriageReturn("\x0D", 1), endOfFile("\x1A", 1);
+  std::string data[] =
+  {
+    newline,
+    carriageReturn + newline,
+    endOfFile,
+    newline + carriageReturn + endOfFile + newline,
+    std::string(64, '\x0A') + std::string(64, '\x0D') + std::string(64, '\x1A'),
+  };
+
+  {
+    RecordStore store;
+    CHECK(store.Open(path));
+    for (size_t i = 0; i < 5; ++i)
+      CHECK(store.Put("Profile\x0D\x0A" + std::to_string(i), data[i]));
+    CHECK(store.Compact());
+  }
+
+  RecordStore store;
+  CHECK(store.Open(path));
+  CHECK(store.GetDamagedBytes() == 0);
+  CHECK(store.GetCount() == 5);
+
+  std::string read;
+  for (size_t i = 0; i < 5; ++i)
+    CHECK(store.Get("Profile\x0D\x0A" + std::to_string(i), read) && read == data[i]);
+}
@@ -0,0 +1,95 @@
+#include "Test.h"
+#include "Symbols.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace util::symbols;
+
+namespace
+{
+  int Answer() { return 42; }
+  void SetFlag(int* pValue, bool set) { *pValue = set ? 2 : 1; }
+  int g_Data = 7;
+
+  // Export table of modules that aren't really loaded
+  class FakeModules : public ExportResolver
+  {
+  public:
+    std::map<std::string, std::map<std::string, void*>> Modules;
+    int FindCount = 0;
+
+    void* Find(const char* moduleName, const char* symbolName) override
+    {
+      ++FindCount;
+
+      auto module = Modules.find(moduleName);
+      if (module == Modules.end())
+        return nullptr;
+
+      auto symbol = module->second.find(symbolName);
+      return symbol == module->second.end() ? nullptr : symbol->second;
+    }
+  };
+
+  struct Exports
+  {
+    int(*Answer)();
+    void(*SetFlag)(int*, bool);
+    int* pData;
+    int(*Missing)();
+    void(*NotLoaded)();
+  };
+}
+
+TEST(BindsEveryExportOnce)
+{
+  FakeModules modules;
+  modules.Modules["game.dll"]["Answer"] = reinterpret_cast<void*>(&Answer);
+  modules.Modules["game.dll"]["SetFlag"] = reinterpret_cast<void*>(&SetFlag);
+  modules.Modules["engine.dll"]["Data"] = &g_Data;
+
+  Exports exports;
+  exports.Missing = &Answer;
+  exports.NotLoaded = nullptr;
+
+  std::vector<SymbolBinding> bindings =
+  {
+    Bind(exports.Answer, "game.dll", "Answer"),
+    Bind(exports.SetFlag, "game.dll", "SetFlag"),
+    Bind(exports.pData, "engine.dll", "Data"),
+    Bind(exports.Missing, "game.dll", "Missing"),
+    Bind(exports.NotLoaded, "other.dll", "Anything"),
+  };
+
+  std::vector<std::string> missing = BindAll(modules, bindings);
+  CHECK(modules.FindCount == 5);
+
+  // Missing exports are all reported up front, in binding order
+  CHECK(missing.size() == 2);
+  CHECK(missing.size() == 2 && missing[0] == "game.dll!Missing");
+  CHECK(missing.size() == 2 && missing[1] == "other.dll!Anything");
+
+  CHECK(exports.Answer() == 42);
+  int flag = 0;
+  exports.SetFlag(&flag, true);
+  CHECK(flag == 2);
+  CHECK(*exports.pData == 7);
+
+  // A target that was set before is cleared if its export is missing
+  CHECK(exports.Missing == nullptr);
+  CHECK(exports.NotLoaded == nullptr);
+
+  // Calls through the bound pointers don't go back to the resolver
+  for (int i = 0; i < 100; ++i)
+    exports.Answer();
+  CHECK(modules.FindCount == 5);
+}
+
+TEST(NoBindings)
+{
+  FakeModules modules;
+  CHECK(BindAll(modules, {}).empty());
+  CHECK(modules.FindCount == 0);
+}
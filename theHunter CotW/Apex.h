@@ -14,7 +14,7 @@ namespace Apex
   public:
     static CClock* Singleton()
     {
-      return *(CClock**)(util::offsets::GetOffset("OFFSET_CLOCK"));
+      return *(CClock**)(util::offsets::GetOffset(OFFSET_CLOCK));
     }
   };
 
@@ -54,7 +54,7 @@ namespace Apex
   public:
     static CGraphicsEngine* Singleton()
     {
-      return *(CGraphicsEngine**)(util::offsets::GetOffset("OFFSET_GRAPHICSENGINE"));
+      return *(CGraphicsEngine**)(util::offsets::GetOffset(OFFSET_GRAPHICSENGINE));
     }
   };
 
@@ -67,7 +67,7 @@ namespace Apex
   public:
     static CUIManager* Singleton()
     {
-      return *(CUIManager**)(util::offsets::GetOffset("OFFSET_UIMANAGER"));
+      return *(CUIManager**)(util::offsets::GetOffset(OFFSET_UIMANAGER));
     }
   };
 
@@ -82,12 +82,12 @@ namespace Apex
   public:
     static CWorldTime * Singleton()
     {
-      return *(CWorldTime**)(util::offsets::GetOffset("OFFSET_WORLDTIME"));
+      return *(CWorldTime**)(util::offsets::GetOffset(OFFSET_WORLDTIME));
     }
   };
 
   static float* GetTimeScale()
   {
-    return (float*)(util::offsets::GetOffset("OFFSET_TIMESCALE"));
+    return (float*)(util::offsets::GetOffset(OFFSET_TIMESCALE));
   }
 }
\ No newline at end of file
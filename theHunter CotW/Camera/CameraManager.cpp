@@ -23,63 +23,42 @@ CameraManager::~CameraManager()
 
 }
 
-void CameraManager::HotkeyUpdate()
+void CameraManager::SubscribeHotkeys(InputSystem* pInput)
 {
-  InputSystem* pInput = g_mainHandle->GetInputSystem();
-
-  if (pInput->IsActionDown(Action::ToggleCamera))
-  {
-    ToggleCamera();
-    while (pInput->IsActionDown(Action::ToggleCamera))
-      Sleep(1);
-  }
+  // Handlers run once per key press on the hotkey thread
+  pInput->SubscribeAction(Action::ToggleCamera, [this](ActionEvent const&) { ToggleCamera(); });
 
-  if (pInput->IsActionDown(Action::ToggleHUD))
+  pInput->SubscribeAction(Action::ToggleHUD, [](ActionEvent const&)
   {
     Apex::CUIManager* pUIManager = Apex::CUIManager::Singleton();
     if (pUIManager)
       pUIManager->m_Enabled = !pUIManager->m_Enabled;
+  });
 
-    while (pInput->IsActionDown(Action::ToggleHUD))
-      Sleep(1);
-  }
-
-  if (pInput->IsActionDown(Action::ToggleFreezeTime))
+  pInput->SubscribeAction(Action::ToggleFreezeTime, [](ActionEvent const&)
   {
     float* pTimeScale = Apex::GetTimeScale();
     if (pTimeScale)
       *pTimeScale = (*pTimeScale == 1.0f) ? 0.f : 1.0f;
+  });
 
-    while (pInput->IsActionDown(Action::ToggleFreezeTime))
-      Sleep(1);
-  }
-
-  if (m_CameraEnabled)
+  pInput->SubscribeAction(Action::Track_CreateNode, [this](ActionEvent const&)
   {
-    if (pInput->IsActionDown(Action::Track_CreateNode))
-    {
+    if (m_CameraEnabled)
       m_TrackPlayer.CreateNode(m_Camera);
+  });
 
-      while (pInput->IsActionDown(Action::Track_CreateNode))
-        Sleep(1);
-    }
-
-    if (pInput->IsActionDown(Action::Track_DeleteNode))
-    {
+  pInput->SubscribeAction(Action::Track_DeleteNode, [this](ActionEvent const&)
+  {
+    if (m_CameraEnabled)
       m_TrackPlayer.DeleteNode();
+  });
 
-      while (pInput->IsActionDown(Action::Track_DeleteNode))
-        Sleep(1);
-    }
-
-    if (pInput->IsActionDown(Action::Track_Play))
-    {
+  pInput->SubscribeAction(Action::Track_Play, [this](ActionEvent const&)
+  {
+    if (m_CameraEnabled)
       m_TrackPlayer.Toggle();
-
-      while (pInput->IsActionDown(Action::Track_Play))
-        Sleep(1);
-    }
-  }
+  });
 }
 
 void CameraManager::Update(double dt)
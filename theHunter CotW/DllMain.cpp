@@ -1,4 +1,5 @@
 #include "Main.h"
+#include "Util/Util.h"
 
 DWORD WINAPI RunCT(LPVOID lpArg)
 {
@@ -7,6 +8,7 @@ DWORD WINAPI RunCT(LPVOID lpArg)
     g_mainHandle->Run();
 
   delete g_mainHandle;
+  util::log::Shutdown();
 
   FreeLibraryAndExitThread(g_dllHandle, 0);
   return 0;
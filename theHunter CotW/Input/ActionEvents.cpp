@@ -0,0 +1,117 @@
+#include "ActionEvents.h"
+
+#include <chrono>
+
+ActionEdgeDetector::ActionEdgeDetector(size_t actionCount, double repeatDelay /* = 0.5 */, double repeatInterval /* = 0.1 */) :
+  m_States(actionCount, State{ false, 0 }),
+  m_RepeatDelay(repeatDelay),
+  m_RepeatInterval(repeatInterval)
+{
+
+}
+
+void ActionEdgeDetector::Update(bool const* pDown, double time, std::vector<ActionEvent>& events)
+{
+  for (size_t i = 0; i < m_States.size(); ++i)
+  {
+    State& state = m_States[i];
+    int action = static_cast<int>(i);
+
+    if (pDown[i] && !state.Down)
+    {
+      state.Down = true;
+      state.NextRepeat = time + m_RepeatDelay;
+      events.push_back(ActionEvent{ action, ActionEvent_Press, time });
+    }
+    else if (!pDown[i] && state.Down)
+    {
+      state.Down = false;
+      events.push_back(ActionEvent{ action, ActionEvent_Release, time });
+    }
+    else if (state.Down && time >= state.NextRepeat)
+    {
+      // One repeat per update even if updates are late,
+      // a stall shouldn't turn into a burst of repeats
+      state.NextRepeat += m_RepeatInterval;
+      if (state.NextRepeat <= time)
+        state.NextRepeat = time + m_RepeatInterval;
+
+      events.push_back(ActionEvent{ action, ActionEvent_Repeat, time });
+    }
+  }
+}
+
+void ActionEdgeDetector::ReleaseAll(double time, std::vector<ActionEvent>& events)
+{
+  for (size_t i = 0; i < m_States.size(); ++i)
+  {
+    if (!m_States[i].Down) continue;
+
+    m_States[i].Down = false;
+    events.push_back(ActionEvent{ static_cast<int>(i), ActionEvent_Release, time });
+  }
+}
+
+ActionDispatcher::ActionDispatcher(size_t actionCount) :
+  m_Handlers(actionCount * ActionEvent_TypeCount),
+  m_Woken(false)
+{
+
+}
+
+void ActionDispatcher::Subscribe(int action, ActionEventType type, ActionHandler handler)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Handlers[action * ActionEvent_TypeCount + type].push_back(handler);
+}
+
+void ActionDispatcher::Post(std::vector<ActionEvent> const& events)
+{
+  if (events.empty()) return;
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Queue.insert(m_Queue.end(), events.begin(), events.end());
+  }
+
+  m_Posted.notify_one();
+}
+
+size_t ActionDispatcher::Dispatch(unsigned int timeoutMs)
+{
+  std::vector<ActionEvent> events;
+  std::vector<ActionHandler> handlers;
+
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Posted.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return !m_Queue.empty() || m_Woken; });
+
+    m_Woken = false;
+    events.swap(m_Queue);
+  }
+
+  for (auto const& event : events)
+  {
+    // Handlers are copied so they can run without the lock,
+    // and may subscribe more handlers themselves
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      handlers = m_Handlers[event.Action * ActionEvent_TypeCount + event.Type];
+    }
+
+    for (auto const& handler : handlers)
+      handler(event);
+  }
+
+  return events.size();
+}
+
+void ActionDispatcher::Wake()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Woken = true;
+  }
+
+  m_Posted.notify_one();
+}
@@ -18,6 +18,8 @@ InputSystem::InputSystem() :
   m_WantedActionStates(),
   m_SmoothActionStates(),
   m_GamepadKeyStates(),
+  m_ActionEdges(Action::ActionCount),
+  m_ActionEvents(Action::ActionCount),
   m_MouseState(),
   m_KeyboardKeyNames(),
   m_ShowUI(false)
@@ -27,6 +29,7 @@ InputSystem::InputSystem() :
 
 InputSystem::~InputSystem()
 {
+  m_ActionEvents.Wake();
   m_ActionThread.join();
   m_ControllerThread.join();
   m_HotkeyThread.join();
@@ -54,6 +57,8 @@ void InputSystem::Initialize()
     }
   }
 
+  SubscribeAction(ToggleUI, [](ActionEvent const&) { g_mainHandle->GetUI()->Toggle(); });
+
   m_ActionThread = std::thread(&InputSystem::ActionUpdate, this);
   m_ControllerThread = std::thread(&InputSystem::ControllerUpdate, this);
   m_HotkeyThread = std::thread(&InputSystem::HotkeyUpdate, this);
@@ -176,6 +181,11 @@ void InputSystem::DrawUI()
 
 }
 
+void InputSystem::SubscribeAction(Action action, ActionHandler handler, ActionEventType type /* = ActionEvent_Press */)
+{
+  m_ActionEvents.Subscribe(action, type, handler);
+}
+
 bool InputSystem::IsActionDown(Action action)
 {
   return m_WantedActionStates[action] != 0.f;
@@ -254,7 +264,11 @@ void InputSystem::ActionUpdate()
   // Processes keyboard + gamepad input and updates
   // action states based on bindings.
 
-  auto lastUpdate = boost::chrono::high_resolution_clock::now();
+  auto startTime = boost::chrono::high_resolution_clock::now();
+  auto lastUpdate = startTime;
+
+  std::array<bool, Action::ActionCount> actionsDown;
+  std::vector<ActionEvent> events;
 
   while (!g_shutdown)
   {
@@ -319,8 +333,17 @@ void InputSystem::ActionUpdate()
       }
     }
 
-    // Copy new values and perform smoothing
+    // Copy new values, queue press/release events for the hotkey thread
+    // and perform smoothing
     m_WantedActionStates = newWantedStates;
+
+    for (int i = 0; i < Action::ActionCount; ++i)
+      actionsDown[i] = newWantedStates[i] != 0.f;
+
+    boost::chrono::duration<double> time = lastUpdate - startTime;
+    events.clear();
+    m_ActionEdges.Update(actionsDown.data(), time.count(), events);
+    m_ActionEvents.Post(events);
     for (int i = 0; i < Action::ActionCount; ++i)
     {
       float& currentState = m_SmoothActionStates[i];
@@ -397,26 +420,15 @@ void InputSystem::ControllerUpdate()
 void InputSystem::HotkeyUpdate()
 {
   // Hotkey thread
-  // This is in its own thread so when you press and hold
-  // for example HUD Toggle, you can still move the camera
-  // and it doesn't block other updates until you lift the
-  // key up again.
+  // Runs the handlers subscribed to action events. ActionUpdate
+  // sends each press once, so holding a key down doesn't block
+  // other hotkeys.
+  //
+  // Actions are all up while the game is out of focus,
+  // so no events arrive then.
 
   while (!g_shutdown)
-  {
-    if (g_hasFocus)
-    {
-      if (IsActionDown(ToggleUI))
-      {
-        g_mainHandle->GetUI()->Toggle();
-        while (IsActionDown(ToggleUI))
-          Sleep(10);
-      }
-
-      g_mainHandle->GetCameraManager()->HotkeyUpdate();
-    }
-    Sleep(10);
-  }
+    m_ActionEvents.Dispatch(100);
 }
 
 void InputSystem::UpdateXInput()
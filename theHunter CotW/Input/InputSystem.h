@@ -1,5 +1,6 @@
 #pragma once
 #include "ActionDefs.h"
+#include "ActionEvents.h"
 #include "../inih/cpp/INIReader.h"
 
 #include <array>
@@ -49,6 +50,9 @@ public:
   void ShowUI();
   void DrawUI();
 
+  // Handlers run on the hotkey thread, one event at a time
+  void SubscribeAction(Action action, ActionHandler handler, ActionEventType type = ActionEvent_Press);
+
   bool IsActionDown(Action action);
   float GetActionState(Action action);
   DirectX::XMFLOAT3 GetMouseState();
@@ -84,6 +88,9 @@ private:
   std::array<float, Action::ActionCount>            m_SmoothActionStates;
   std::array<float, GamepadKey::GamepadKey_Count>   m_GamepadKeyStates;
 
+  ActionEdgeDetector m_ActionEdges;
+  ActionDispatcher m_ActionEvents;
+
   DirectX::XMFLOAT2 m_PrevMousePos;
   DirectX::XMFLOAT2 m_MouseState;
   LPDIRECTINPUTDEVICE8 m_DIMouse;
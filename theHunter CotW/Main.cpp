@@ -3,7 +3,6 @@
 #include "Apex.h"
 #include <boost/filesystem.hpp>
 #include <boost/chrono.hpp>
-#include <fstream>
 
 static const char* g_gameName = "theHunter: CoTW";
 static const char* g_moduleName = "theHunterCotW_F.exe";
@@ -71,6 +70,8 @@ bool Main::Initialize()
   // the tools support. If versions mismatch, scan for offsets.
   if (!util::offsets::CheckVersion(g_supportedVersion))
     util::offsets::Scan();
+  else
+    util::offsets::Resolve();
 
   g_d3d11Device = Apex::CGraphicsEngine::Singleton()->m_D3Objects->Device; // Fetch ID3D11Device
   g_dxgiSwapChain = Apex::CGraphicsEngine::Singleton()->m_D3Objects->SwapChain; // Fetch SwapChain
@@ -88,6 +89,7 @@ bool Main::Initialize()
   m_pInputSystem = std::make_unique<InputSystem>();
   m_pUI = std::make_unique<UI>();
 
+  m_pCameraManager->SubscribeHotkeys(m_pInputSystem.get());
   m_pInputSystem->Initialize();
   if (!m_pUI->Initialize())
     return false;
@@ -102,6 +104,11 @@ bool Main::Initialize()
     return false;
   }
 
+  m_ConfigWriter.Start(g_configFile, [](const char* error)
+  {
+    util::log::Error("Could not save config. %s", error);
+  });
+
   LoadConfig();
   return true;
 }
@@ -119,7 +126,7 @@ void Main::Run()
     m_pUI->Update(dt.count());
 
     m_dtConfigCheck += dt.count();
-    if (m_dtConfigCheck > 10.f)
+    if (m_dtConfigCheck > 1.f)
     {
       m_dtConfigCheck = 0;
       if (m_ConfigChanged)
@@ -134,6 +141,7 @@ void Main::Run()
 
   // Save config and disable hooks before exit
   SaveConfig();
+  m_ConfigWriter.Stop();
   util::hooks::SetHookState(false);
 }
 
@@ -158,19 +166,8 @@ void Main::LoadConfig()
 
 void Main::SaveConfig()
 {
-  std::fstream file;
-  file.open(g_configFile, std::ios_base::out | std::ios_base::trunc);
-
-  if (!file.is_open())
-  {
-    util::log::Error("Could not save config, failed to open file for writing. GetLastError 0x%X", GetLastError());
-    return;
-  }
-
-  file << m_pCameraManager->GetConfig() << std::endl;
-  file << m_pInputSystem->GetConfig() << std::endl;
-  
-  file.close();
+  // Nothing is written if the content is the same as before
+  m_ConfigWriter.Submit(m_pCameraManager->GetConfig() + "\n" + m_pInputSystem->GetConfig() + "\n");
 }
 
 extern LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
@@ -2,6 +2,7 @@
 #include "Camera/CameraManager.h"
 #include "Input/InputSystem.h"
 #include "UI.h"
+#include "Util/ConfigWriter.h"
 
 #include "inih/cpp/INIReader.h"
 #include <memory>
@@ -30,6 +31,7 @@ private:
 
 private:
   std::unique_ptr<INIReader> m_pConfig;
+  util::ConfigWriter m_ConfigWriter;
 
   std::unique_ptr<CameraManager> m_pCameraManager;
   std::unique_ptr<InputSystem> m_pInputSystem;
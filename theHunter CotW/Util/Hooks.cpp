@@ -188,9 +188,9 @@ void util::hooks::Init()
   if (status != MH_OK)
     util::log::Error("Failed to initialize MinHook, MH_STATUS 0x%X", status);
 
-  CreateHook("CameraUpdate", util::offsets::GetOffset("OFFSET_CAMERAUPDATE"), hCameraUpdate, &oCameraUpdate);
-  //CreateHook("CameraUpdate", util::offsets::GetOffset("OFFSET_CAMERAUPDATE2"), hCameraUpdate2, &oCameraUpdate2);
-  CreateHook("InputUpdate", util::offsets::GetOffset("OFFSET_INPUTUPDATE"), hInputUpdate, &oInputUpdate);
+  CreateHook("CameraUpdate", util::offsets::GetOffset(OFFSET_CAMERAUPDATE), hCameraUpdate, &oCameraUpdate);
+  //CreateHook("CameraUpdate", util::offsets::GetOffset(OFFSET_CAMERAUPDATE2), hCameraUpdate2, &oCameraUpdate2);
+  CreateHook("InputUpdate", util::offsets::GetOffset(OFFSET_INPUTUPDATE), hInputUpdate, &oInputUpdate);
   CreateVTableHook("SwapChainPresent", (PDWORD64*)g_dxgiSwapChain, hIDXGISwapChain_Present, 8, &oIDXGISwapChain_Present);
 
   util::log::Ok("Hooks initialized");
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace util
+{
+  // A log file with a size cap. Once the file is over the cap it's
+  // renamed to CT.1.log, the older ones move up to CT.2.log and so on,
+  // and writing carries on in a new file. At most maxSize * (backups + 1)
+  // bytes stay on disk.
+  class LogFile
+  {
+  public:
+    LogFile();
+    ~LogFile();
+
+    bool Open(std::string const& path, uint64_t maxSize, unsigned backups);
+    void Close();
+
+    bool IsOpen() const { return m_pFile != nullptr; }
+
+    void Write(const char* pData, size_t length);
+    void Write(const char* pText);
+
+    // Rotates when the file is over the cap, so a message
+    // never gets split between two files
+    void Flush();
+
+  private:
+    std::string GetBackupPath(unsigned index) const;
+    void Rotate();
+
+  private:
+    FILE* m_pFile;
+    std::string m_Path;
+    uint64_t m_MaxSize;
+    unsigned m_Backups;
+    uint64_t m_Size;
+
+  public:
+    LogFile(LogFile const&) = delete;
+    void operator=(LogFile const&) = delete;
+  };
+}
@@ -11,19 +11,34 @@ using namespace boost::assign;
 namespace
 {
   bool m_UseScannedResults = false;
-  std::unordered_map<std::string, util::offsets::Signature> m_Signatures;
+  std::vector<std::pair<OffsetId, util::offsets::Signature>> m_Signatures;
 
   // Fill with hardcoded offsets if you don't want to use scanning
   // These should be relative to the module base.
-  std::unordered_map<std::string, __int64> m_HardcodedOffsets = map_list_of
-  ("OFFSET_ENVIRONMENTGFX", 0x1E58D00)
-    ("OFFSET_CLOCK", 0x1E58D08)
-    ("OFFSET_GRAPHICSENGINE", 0x1DCE460)
-    ("OFFSET_INPUTUPDATE", 0x370AA0)
-    ("OFFSET_TIMESCALE", 0x1CEA6BC)
-    ("OFFSET_WORLDTIME", 0x1E7EDD0)
-    ("OFFSET_UIMANAGER", 0x1DCE470)
-    ("OFFSET_CAMERAUPDATE", 0x301EF0);
+  std::unordered_map<OffsetId, __int64> m_HardcodedOffsets = map_list_of
+  (OFFSET_ENVIRONMENTGFX, 0x1E58D00)
+    (OFFSET_CLOCK, 0x1E58D08)
+    (OFFSET_GRAPHICSENGINE, 0x1DCE460)
+    (OFFSET_INPUTUPDATE, 0x370AA0)
+    (OFFSET_TIMESCALE, 0x1CEA6BC)
+    (OFFSET_WORLDTIME, 0x1E7EDD0)
+    (OFFSET_UIMANAGER, 0x1DCE470)
+    (OFFSET_CAMERAUPDATE, 0x301EF0);
+
+  // Same order as OffsetId, used for logging
+  const char* g_offsetNames[] =
+  {
+    "OFFSET_ENVIRONMENTGFX",
+    "OFFSET_CLOCK",
+    "OFFSET_GRAPHICSENGINE",
+    "OFFSET_INPUTUPDATE",
+    "OFFSET_TIMESCALE",
+    "OFFSET_WORLDTIME",
+    "OFFSET_UIMANAGER",
+    "OFFSET_CAMERAUPDATE"
+  };
+
+  static_assert(sizeof(g_offsetNames) / sizeof(g_offsetNames[0]) == OffsetCount, "Every OffsetId needs a name");
 
   bool DataCompare(BYTE* pData, BYTE* bSig, const char* szMask)
   {
@@ -65,6 +80,8 @@ namespace
   }
 }
 
+__int64 util::offsets::g_resolvedOffsets[OffsetCount] = { 0 };
+
 util::offsets::Signature::Signature(std::string const& sig, int offset /* = 0 */)
 {
   Pattern = new BYTE[sig.size()]();
@@ -160,15 +177,16 @@ void util::offsets::Scan()
   // The last argument is the offset to be added to the result, useful when
   // you need a code offset for byte patches.
 
-  m_Signatures.emplace("OFFSET_CLOCK", Signature("72 BB 48 8B 0D [ ?? ?? ?? ?? ]"));
-  m_Signatures.emplace("OFFSET_ENVIRONMENTGFX", Signature("48 89 73 60 48 8B 0D [ ?? ?? ?? ?? ]"));
-  m_Signatures.emplace("OFFSET_GRAPHICSENGINE", Signature("48 8B 0D [ ?? ?? ?? ?? ] 0F B6 05"));
-  m_Signatures.emplace("OFFSET_UIMANAGER", Signature("48 8B 0D [ ?? ?? ?? ?? ] E8 ?? ?? ?? ?? 84 C0 74 0C 48 8B 0D"));
-  m_Signatures.emplace("OFFSET_WORLDTIME", Signature("74 21 48 8B 05 [ ?? ?? ?? ?? ] 48 85 C0"));
-  m_Signatures.emplace("OFFSET_TIMESCALE", Signature("F3 0F 59 6F ?? F3 44 0F 59 0D [ ?? ?? ?? ?? ]"));
-  m_Signatures.emplace("OFFSET_CAMERAUPDATE", Signature("F3 0F 10 4E ?? 48 8B CF E8 [ ?? ?? ?? ?? ] EB 0B"));
-  //m_Signatures.emplace("OFFSET_CAMERAUPDATE2", Signature("F3 0F 10 4E ?? 48 8B CF E8 [ ?? ?? ?? ?? ] EB 0B", 0x1200));
-  m_Signatures.emplace("OFFSET_INPUTUPDATE", Signature("E8 [ ?? ?? ?? ?? ] 48 8B 0D ?? ?? ?? ?? 48 85 C9 74 0A F3 0F 10 4B"));
+  m_Signatures.clear();
+  m_Signatures.emplace_back(OFFSET_CLOCK, Signature("72 BB 48 8B 0D [ ?? ?? ?? ?? ]"));
+  m_Signatures.emplace_back(OFFSET_ENVIRONMENTGFX, Signature("48 89 73 60 48 8B 0D [ ?? ?? ?? ?? ]"));
+  m_Signatures.emplace_back(OFFSET_GRAPHICSENGINE, Signature("48 8B 0D [ ?? ?? ?? ?? ] 0F B6 05"));
+  m_Signatures.emplace_back(OFFSET_UIMANAGER, Signature("48 8B 0D [ ?? ?? ?? ?? ] E8 ?? ?? ?? ?? 84 C0 74 0C 48 8B 0D"));
+  m_Signatures.emplace_back(OFFSET_WORLDTIME, Signature("74 21 48 8B 05 [ ?? ?? ?? ?? ] 48 85 C0"));
+  m_Signatures.emplace_back(OFFSET_TIMESCALE, Signature("F3 0F 59 6F ?? F3 44 0F 59 0D [ ?? ?? ?? ?? ]"));
+  m_Signatures.emplace_back(OFFSET_CAMERAUPDATE, Signature("F3 0F 10 4E ?? 48 8B CF E8 [ ?? ?? ?? ?? ] EB 0B"));
+  //m_Signatures.emplace_back(OFFSET_CAMERAUPDATE2, Signature("F3 0F 10 4E ?? 48 8B CF E8 [ ?? ?? ?? ?? ] EB 0B", 0x1200));
+  m_Signatures.emplace_back(OFFSET_INPUTUPDATE, Signature("E8 [ ?? ?? ?? ?? ] 48 8B 0D ?? ?? ?? ?? 48 85 C9 74 0A F3 0F 10 4B"));
 
   util::log::Write("Scanning for offsets...");
 
@@ -177,6 +195,7 @@ void util::offsets::Scan()
   {
     util::log::Error("GetModuleInformation failed, GetLastError 0x%X", GetLastError());
     util::log::Error("Offset scanning unavailable");
+    Resolve();
     return;
   }
 
@@ -188,7 +207,7 @@ void util::offsets::Scan()
     __int64 result = (__int64)FindPattern((BYTE*)info.lpBaseOfDll, info.SizeOfImage, sig.Pattern, sig.Mask.c_str());
     if (!result)
     {
-      util::log::Error("Could not find pattern for %s", entry.first.c_str());
+      util::log::Error("Could not find pattern for %s", GetOffsetName(entry.first));
       allFound = false;
       continue;
     }
@@ -215,35 +234,43 @@ void util::offsets::Scan()
   std::fstream file;
   file.open("./Cinematic Tools/Offsets.log", std::fstream::in | std::fstream::out | std::fstream::trunc);
   for (auto& sig : m_Signatures)
-    file << "(\"" + sig.first + "\", \t\t0x" << std::hex << std::uppercase << sig.second.Result << " )\n";
+    file << "(\"" << GetOffsetName(sig.first) << "\", \t\t0x" << std::hex << std::uppercase << sig.second.Result << " )\n";
 
   m_UseScannedResults = true;
+  Resolve();
 }
 
-__int64 util::offsets::GetOffset(std::string const& name)
+void util::offsets::Resolve()
 {
-  // If a scan was done, prefer those results.
-  // If something couldn't be found or there was no scan,
-  // use the hardcoded offsets.
+  // Both scanned and hardcoded offsets are relative to the module,
+  // it's not 100% guaranteed the game module will load at the same
+  // address space.
 
+  for (int i = 0; i < OffsetCount; ++i)
+    g_resolvedOffsets[i] = 0;
+
+  for (auto& entry : m_HardcodedOffsets)
+    g_resolvedOffsets[entry.first] = entry.second + (__int64)g_gameHandle;
+
+  // If a scan was done, prefer those results.
+  // If something couldn't be found, keep the hardcoded offset.
   if (m_UseScannedResults)
   {
-    auto result = m_Signatures.find(name);
-    if (result != m_Signatures.end())
+    for (auto& entry : m_Signatures)
     {
-      if (result->second.Result)
-        return result->second.Result + (__int64)g_gameHandle;
+      if (entry.second.Result)
+        g_resolvedOffsets[entry.first] = entry.second.Result + (__int64)g_gameHandle;
     }
   }
 
-  // If the offsets were scanned, their absolute position is known.
-  // With hardcoded offsets, use relative offset because it's not
-  // 100% guaranteed the game module will load at the same address space.
-
-  auto hardcodedResult = m_HardcodedOffsets.find(name);
-  if (hardcodedResult != m_HardcodedOffsets.end())
-    return hardcodedResult->second + (__int64)g_gameHandle;
+  for (int i = 0; i < OffsetCount; ++i)
+  {
+    if (!g_resolvedOffsets[i])
+      util::log::Error("Offset %s does not exist", g_offsetNames[i]);
+  }
+}
 
-  util::log::Error("Offset %s does not exist", name.c_str());
-  return 0;
+const char* util::offsets::GetOffsetName(OffsetId id)
+{
+  return g_offsetNames[id];
 }
\ No newline at end of file